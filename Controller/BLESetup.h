@@ -8,9 +8,10 @@
  *   2. BLE turns ON, advertises as "FlexPool"
  *   3. User opens the FlexPool webpage (Chrome on PC or Android)
  *   4. Browser connects via BLE
- *   5. Browser sends WiFi SSID + password over BLE
+ *   5. Browser sends WiFi SSID + password over BLE (and, optionally,
+ *      the MQTT broker / site / pad, MqttConfig.h)
  *   6. ESP32 saves credentials, connects to WiFi
- *   7. ESP32 sends back Device ID over BLE
+ *   7. ESP32 sends back Device ID (and site) over BLE
  *   8. BLE turns OFF, ESP32 reboots into normal mode
  * 
  * NOTE: Web Bluetooth requires Chrome (Windows/Mac/Android).
@@ -18,12 +19,19 @@
  * 
  * EVERY BOOT AFTER:
  *   - BLE never turns on
- *   - ESP32 connects to WiFi using saved credentials
+ *   - ESP32 connects to WiFi using saved credentials, in the
+ *     background (beginSaved) so the pumps don't wait for it
  * 
  * TIMEOUT:
  *   - BLE stays on for 5 minutes
  *   - If nobody connects, ESP32 restarts and tries again
  * 
+ * WITHOUT BLE (FEATURE_BLE 0, Config.h):
+ *   Only the credential store is built (beginSaved, saveCredentials,
+ *   clearCredentials...). Credentials then come from the console
+ *   ('wifi join') or WIFI_DEFAULT_SSID / WIFI_DEFAULT_PASS, which are
+ *   also used on any build until something is saved.
+ * 
  * REQUIRES: ESP32 BLE Arduino library (built-in with ESP32 board package)
  */
 
@@ -32,10 +40,15 @@
 
 #include <WiFi.h>
 #include <Preferences.h>
+#include "Config.h"
+#include "MqttConfig.h"
+#include "StatusFormat.h"
+#if FEATURE_BLE
 #include <BLEDevice.h>
 #include <BLEServer.h>
 #include <BLEUtils.h>
 #include <BLE2902.h>
+#endif
 
 // =============================================
 // CONFIGURATION
@@ -49,6 +62,7 @@
 #define PREFS_KEY_SSID     "ssid"
 #define PREFS_KEY_PASS     "pass"
 
+#if FEATURE_BLE
 // =============================================
 // BLE UUIDs (custom, unique to FlexPool)
 // =============================================
@@ -57,10 +71,12 @@
 
 // Characteristic: browser WRITES WiFi credentials here
 // Format: JSON string {"ssid":"MyWiFi","pass":"mypassword"}
+//   optional MQTT fields: "broker":"mqtts://host:8883","user":"u","mqttPass":"p",
+//                         "site":"north","pad":"pad-3"
 #define CHAR_WIFI_UUID         "beb5483e-36e1-4688-b7f5-ea07361b26a8"
 
 // Characteristic: ESP32 WRITES status/result here, browser reads/gets notified
-// Format: JSON string {"ok":true,"id":"A1B2C3","ip":"192.168.1.50"}
+// Format: JSON string {"ok":true,"id":"24DCC3A1B2C3","site":"north","ip":"192.168.1.50"}
 //   or on failure:    {"ok":false,"error":"Connection failed"}
 #define CHAR_STATUS_UUID       "d1a7e0c2-4f3b-4b1e-9c5d-8a6f2b3e4d5c"
 
@@ -75,11 +91,13 @@ class BLESetup;
 
 // Global pointer for BLE callbacks to access
 static BLESetup* _bleSetupInstance = nullptr;
+#endif
 
 // =============================================
 // BLESetup CLASS
 // =============================================
 class BLESetup {
+#if FEATURE_BLE
 private:
   BLEServer*         _server = nullptr;
   BLECharacteristic* _charWifi = nullptr;
@@ -90,6 +108,7 @@ private:
   bool _shouldRestart = false;
   String _receivedSSID = "";
   String _receivedPass = "";
+  String _receivedJson = "";    // For the optional MQTT fields
   bool _credentialsReceived = false;
   bool _scanRequested = false;
 
@@ -114,13 +133,23 @@ private:
     return json.substring(idx + 1, end);
   }
 
-  // ---- Generate Device ID from MAC address ----
+  // ---- Device ID from the MAC address (StatusFormat.h) ----
   String getDeviceId() {
-    uint8_t mac[6];
-    WiFi.macAddress(mac);
-    char id[7];
-    snprintf(id, sizeof(id), "%02X%02X%02X", mac[3], mac[4], mac[5]);
-    return String(id);
+    return String(deviceId());
+  }
+
+  // ---- Optional MQTT fields of the credentials write ----
+  // Only the ones present change; false if one of them is unusable
+  bool applyMqttFields(const String& json, MqttConfig& cfg) {
+    static const char* const KEYS[][2] = {
+      { "broker", "broker" }, { "site", "site" }, { "pad", "pad" },
+      { "user", "user" }, { "mqttPass", "pass" },
+    };
+    for (const auto& k : KEYS) {
+      String value = extractJsonString(json, k[0]);
+      if (value.length() && !cfg.set(k[1], value)) return false;
+    }
+    return true;
   }
 
   // ---- Try connecting to WiFi with given credentials ----
@@ -141,16 +170,6 @@ private:
     return (WiFi.status() == WL_CONNECTED);
   }
 
-  // ---- Save credentials to flash ----
-  void saveCredentials(const String& ssid, const String& pass) {
-    Preferences prefs;
-    prefs.begin(PREFS_NAMESPACE, false);
-    prefs.putString(PREFS_KEY_SSID, ssid);
-    prefs.putString(PREFS_KEY_PASS, pass);
-    prefs.end();
-    Serial.printf("[BLE] Credentials saved for \"%s\"\n", ssid.c_str());
-  }
-
   // ---- Send status back to browser via BLE ----
   void sendStatus(const String& json) {
     if (_charStatus && _deviceConnected) {
@@ -166,6 +185,13 @@ private:
     
     Serial.printf("[BLE] Received WiFi credentials: SSID=\"%s\"\n", _receivedSSID.c_str());
     
+    MqttConfig mqttCfg;
+    mqttCfg.load();
+    if (!applyMqttFields(_receivedJson, mqttCfg)) {
+      sendStatus("{\"ok\":false,\"error\":\"Bad broker URL, site or pad.\"}");
+      return;
+    }
+    
     // Notify phone: trying to connect
     sendStatus("{\"status\":\"connecting\"}");
     delay(200);
@@ -178,11 +204,14 @@ private:
       
       Serial.printf("[BLE] Connected! IP: %s, Device ID: %s\n", ip.c_str(), deviceId.c_str());
       
-      // Save credentials to flash
+      // Save credentials (and the MQTT settings with them) to flash
       saveCredentials(_receivedSSID, _receivedPass);
+      mqttCfg.save();
       
-      // Send success + device ID back to phone
-      String response = "{\"ok\":true,\"id\":\"" + deviceId + "\",\"ip\":\"" + ip + "\"}";
+      // Send success + device ID back to phone; the site completes
+      // the topic path (flexpool/{site}/{id})
+      String response = "{\"ok\":true,\"id\":\"" + deviceId + "\",\"site\":\"" +
+                        mqttCfg.site + "\",\"ip\":\"" + ip + "\"}";
       sendStatus(response);
       
       // Wait for phone to receive the response
@@ -249,68 +278,70 @@ public:
   void onWifiWrite(const String& value) {
     _receivedSSID = extractJsonString(value, "ssid");
     _receivedPass = extractJsonString(value, "pass");
+    _receivedJson = value;
     _credentialsReceived = true;
   }
   
   void onScanWrite() {
     _scanRequested = true;
   }
+#endif
 
+public:
   // =============================================
   // PUBLIC: Check if credentials exist
   // =============================================
   static bool hasSavedCredentials() {
-    Preferences prefs;
-    prefs.begin(PREFS_NAMESPACE, true);
-    String ssid = prefs.getString(PREFS_KEY_SSID, "");
-    prefs.end();
-    return (ssid.length() > 0);
+    return getSavedSSID().length() > 0;
   }
 
   // =============================================
-  // PUBLIC: Get saved SSID
+  // PUBLIC: Get saved SSID (or the built-in default)
   // =============================================
   static String getSavedSSID() {
     Preferences prefs;
     prefs.begin(PREFS_NAMESPACE, true);
     String ssid = prefs.getString(PREFS_KEY_SSID, "");
     prefs.end();
-    return ssid;
+    return ssid.length() ? ssid : String(WIFI_DEFAULT_SSID);
   }
 
   // =============================================
-  // PUBLIC: Connect using saved credentials
+  // PUBLIC: Start connecting with saved credentials
+  // Returns at once; the station keeps trying in the
+  // background until WiFi.status() is WL_CONNECTED.
   // =============================================
-  static bool connectSaved() {
+  static bool beginSaved() {
     Preferences prefs;
     prefs.begin(PREFS_NAMESPACE, true);
     String ssid = prefs.getString(PREFS_KEY_SSID, "");
     String pass = prefs.getString(PREFS_KEY_PASS, "");
     prefs.end();
     
+    if (ssid.length() == 0) {
+      ssid = WIFI_DEFAULT_SSID;
+      pass = WIFI_DEFAULT_PASS;
+    }
     if (ssid.length() == 0) return false;
     
     Serial.printf("[WiFi] Connecting to \"%s\"", ssid.c_str());
     
     WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(true);
     WiFi.begin(ssid.c_str(), pass.c_str());
-    
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < WIFI_CONNECT_TIMEOUT * 2) {
-      delay(500);
-      Serial.print(".");
-      attempts++;
-    }
-    
-    if (WiFi.status() == WL_CONNECTED) {
-      Serial.println(" Connected!");
-      Serial.printf("[WiFi] IP Address: %s\n", WiFi.localIP().toString().c_str());
-      Serial.printf("[WiFi] Signal: %d dBm\n", WiFi.RSSI());
-      return true;
-    } else {
-      Serial.println(" FAILED!");
-      return false;
-    }
+    return true;
+  }
+
+  // =============================================
+  // PUBLIC: Save credentials to flash
+  // =============================================
+  static void saveCredentials(const String& ssid, const String& pass) {
+    Preferences prefs;
+    prefs.begin(PREFS_NAMESPACE, false);
+    prefs.putString(PREFS_KEY_SSID, ssid);
+    prefs.putString(PREFS_KEY_PASS, pass);
+    prefs.end();
+    Serial.printf("[WiFi] Credentials saved for \"%s\"\n", ssid.c_str());
   }
 
   // =============================================
@@ -324,6 +355,7 @@ public:
     Serial.println("[WiFi] Saved credentials cleared.");
   }
 
+#if FEATURE_BLE
   // =============================================
   // PUBLIC: Run BLE provisioning (blocking)
   // Runs for up to 5 minutes, then restarts
@@ -452,6 +484,7 @@ public:
     delay(500);
     ESP.restart();
   }
+#endif
 };
 
 #endif // BLE_SETUP_H
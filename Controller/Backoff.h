@@ -0,0 +1,66 @@
+/*
+ * =============================================
+ * Backoff.h - Jittered exponential retry delay
+ * =============================================
+ *
+ * For reconnects (WiFi, MQTT): the first retry comes after about
+ * minMs, each failure doubles the delay up to maxMs, and a success
+ * starts over. Each delay is drawn from [d/2, d) so a house full of
+ * controllers that lost the same AP or broker doesn't come back in
+ * lock step.
+ *
+ * USAGE:
+ *   Backoff retry(1000, 60000);
+ *   if (retry.due()) { startAttempt(); }
+ *   on failure:  retry.fail();      next attempt later
+ *   on success:  retry.reset();     next failure retries quickly
+ *   link back:   retry.now();       try at once, keep the delay
+ */
+
+#ifndef BACKOFF_H
+#define BACKOFF_H
+
+#include <Arduino.h>
+
+class Backoff {
+private:
+  uint32_t      _min;
+  uint32_t      _max;
+  uint32_t      _delay;                  // Current ceiling, doubles per failure
+  unsigned long _at = 0;                 // Next attempt (millis)
+  uint16_t      _failures = 0;
+
+public:
+  Backoff(uint32_t minMs, uint32_t maxMs) : _min(minMs), _max(maxMs), _delay(minMs) {}
+
+  // Time for the next attempt?
+  bool due() const { return (long)(millis() - _at) >= 0; }
+
+  // Milliseconds until due() (0 if it already is)
+  unsigned long msUntilDue() const {
+    long left = (long)(_at - millis());
+    return left > 0 ? left : 0;
+  }
+
+  // Attempt failed: schedule the next one, and back off further
+  void fail() {
+    uint32_t half = _delay / 2;
+    _at = millis() + half + random(half + 1);
+    _delay = _delay >= _max / 2 ? _max : _delay * 2;
+    _failures++;
+  }
+
+  // Connected: next time start from minMs again
+  void reset() {
+    _delay = _min;
+    _failures = 0;
+    _at = millis();
+  }
+
+  // Retry right away (e.g. WiFi just came back) without resetting
+  void now() { _at = millis(); }
+
+  uint16_t failures() const { return _failures; }
+};
+
+#endif // BACKOFF_H
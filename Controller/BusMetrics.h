@@ -0,0 +1,244 @@
+/*
+ * =============================================
+ * BusMetrics.h - RS-485 bus health, latency and throughput
+ * =============================================
+ *
+ * Counted where it happens, read by anyone:
+ *
+ *   RS485Uart / PentairParser   bytes in/out, overruns, truncated frames,
+ *                               preamble resyncs + bytes skipped to find one
+ *   RS485Bus                    frames in/out, bad checksums, utilisation,
+ *                               bus task iteration time
+ *   TransactionTable            timeouts, retries, failures, and the
+ *                               request -> reply latency histogram
+ *   Controller.ino loop()       loop iteration time
+ *
+ * bus.metrics() gathers them into one BusMetrics. They are plain 32-bit
+ * counters written only by the bus task; each read is atomic, so no
+ * lock - a reader may see one counter a frame ahead of another.
+ *
+ * LATENCY is measured from the end of our transmission to the last
+ * byte of the reply that completes it (the attempt that succeeded).
+ * Fixed buckets, percentiles are interpolated within a bucket.
+ *
+ * UTILISATION is the share of the last METRICS_UTIL_WINDOW_MS the line
+ * carried bytes (ours and everyone else's): bytes x 10 bits / baud.
+ *
+ * ITERATION PEAKS are the longest iteration over the last one to two
+ * METRICS_PEAK_WINDOW_MS - recent stalls, not the worst since boot.
+ *
+ * EXPORT:
+ *   GET /metrics                       Prometheus text (printPrometheus)
+ *   flexpool/{deviceId}/diagnostics    JSON every MQTT_DIAG_INTERVAL
+ *                                      (formatDiagnostics, MQTTHandler.h)
+ */
+
+#ifndef BUS_METRICS_H
+#define BUS_METRICS_H
+
+#include <Arduino.h>
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define METRICS_UTIL_WINDOW_MS   10000   // Utilisation averaging window
+#define METRICS_PEAK_WINDOW_MS   60000   // Iteration peak window (see ITERATION PEAKS)
+#define METRICS_LATENCY_BUCKETS  12      // Upper bounds below, then +Inf
+
+const uint16_t METRICS_LATENCY_LE_MS[METRICS_LATENCY_BUCKETS - 1] = {
+  5, 10, 15, 20, 30, 50, 75, 100, 150, 200, 300
+};
+
+// =============================================
+// LATENCY HISTOGRAM
+// =============================================
+struct LatencyHistogram {
+  uint32_t buckets[METRICS_LATENCY_BUCKETS] = {0};   // Per bucket, not cumulative
+  uint32_t count = 0;
+  uint32_t sumMs = 0;
+  uint32_t maxMs = 0;
+
+  void record(uint32_t ms) {
+    int i = 0;
+    while (i < METRICS_LATENCY_BUCKETS - 1 && ms > METRICS_LATENCY_LE_MS[i]) i++;
+    buckets[i]++;
+    count++;
+    sumMs += ms;
+    if (ms > maxMs) maxMs = ms;
+  }
+
+  // Estimated q-quantile (0..1) in ms, 0 while empty
+  float quantile(float q) const {
+    uint32_t total = 0;
+    for (uint32_t b : buckets) total += b;
+    if (!total) return 0;
+
+    float rank = q * total;
+    uint32_t below = 0;
+    for (int i = 0; i < METRICS_LATENCY_BUCKETS; i++) {
+      if (!buckets[i] || below + buckets[i] < rank) {
+        below += buckets[i];
+        continue;
+      }
+      float lo = i ? METRICS_LATENCY_LE_MS[i - 1] : 0;
+      if (i == METRICS_LATENCY_BUCKETS - 1) return maxMs;   // +Inf: best we know
+      float hi = METRICS_LATENCY_LE_MS[i];
+      if (hi > maxMs) hi = maxMs;
+      return lo + (hi - lo) * (rank - below) / buckets[i];
+    }
+    return maxMs;
+  }
+};
+
+// =============================================
+// PEAK OVER A SLIDING WINDOW
+// =============================================
+// Two back-to-back windows: peak() covers the current one and the one
+// before, so a stall stays visible for at least one full window.
+struct PeakTracker {
+  volatile uint32_t cur = 0;
+  volatile uint32_t prev = 0;
+  volatile unsigned long start = 0;
+
+  // Owning task only
+  void record(uint32_t v) {
+    unsigned long age = millis() - start;
+    if (age >= METRICS_PEAK_WINDOW_MS) {
+      prev = (age >= 2 * METRICS_PEAK_WINDOW_MS) ? 0 : cur;
+      cur = 0;
+      start = millis();
+    }
+    if (v > cur) cur = v;
+  }
+
+  // Any task
+  uint32_t peak() const {
+    unsigned long age = millis() - start;
+    if (age >= 2 * METRICS_PEAK_WINDOW_MS) return 0;
+    if (age >= METRICS_PEAK_WINDOW_MS) return cur;
+    return cur > prev ? cur : prev;
+  }
+};
+
+// =============================================
+// EVERYTHING, GATHERED (bus.metrics())
+// =============================================
+struct BusMetrics {
+  // Transport
+  uint32_t framesTx = 0;
+  uint32_t framesRx = 0;          // Valid frames, any address
+  uint32_t bytesTx = 0;
+  uint32_t bytesRx = 0;
+  uint32_t checksumErrors = 0;
+  uint32_t resyncs = 0;           // Preamble found after skipping bytes
+  uint32_t skippedBytes = 0;
+  uint32_t overruns = 0;
+  uint32_t truncated = 0;
+
+  // Transactions
+  uint32_t timeouts = 0;          // Attempts that got no reply
+  uint32_t retries = 0;
+  uint32_t failures = 0;          // Transactions out of retries
+  LatencyHistogram latency;
+
+  // Line + task
+  uint32_t baud = 9600;
+  uint16_t utilPermille = 0;      // Over the last METRICS_UTIL_WINDOW_MS
+  uint32_t busIterPeakUs = 0;
+
+  // Seconds the line carried bytes since boot (10 bits per byte)
+  float busySeconds() const { return (float)(bytesTx + bytesRx) * 10 / baud; }
+};
+
+// =============================================
+// PROMETHEUS TEXT (GET /metrics)
+// =============================================
+// out: anything with printf() - an AsyncResponseStream, Serial
+template <typename Out>
+void printPrometheus(Out& out, const BusMetrics& m, uint32_t loopIterPeakUs) {
+#define PROM_HEAD(name, type, help) \
+  out.printf("# HELP flexpool_" name " " help "\n# TYPE flexpool_" name " " type "\n")
+#define PROM_VALUE(name, fmt, value) \
+  out.printf("flexpool_" name " " fmt "\n", value)
+#define PROM_COUNTER(name, help, value) \
+  PROM_HEAD(name, "counter", help); PROM_VALUE(name, "%lu", (unsigned long)(value))
+
+  PROM_HEAD("rs485_frames_total", "counter", "Frames on the bus (rx: valid, any address)");
+  PROM_VALUE("rs485_frames_total{dir=\"tx\"}", "%lu", (unsigned long)m.framesTx);
+  PROM_VALUE("rs485_frames_total{dir=\"rx\"}", "%lu", (unsigned long)m.framesRx);
+  PROM_HEAD("rs485_bytes_total", "counter", "Bytes on the bus");
+  PROM_VALUE("rs485_bytes_total{dir=\"tx\"}", "%lu", (unsigned long)m.bytesTx);
+  PROM_VALUE("rs485_bytes_total{dir=\"rx\"}", "%lu", (unsigned long)m.bytesRx);
+  PROM_COUNTER("rs485_checksum_errors_total", "Frames dropped for a bad checksum", m.checksumErrors);
+  PROM_COUNTER("rs485_resyncs_total", "Preambles found only after skipping bytes", m.resyncs);
+  PROM_COUNTER("rs485_skipped_bytes_total", "Bytes skipped hunting for a preamble", m.skippedBytes);
+  PROM_COUNTER("rs485_overruns_total", "UART FIFO / driver buffer overflows", m.overruns);
+  PROM_COUNTER("rs485_truncated_frames_total", "Frames cut off by an idle line", m.truncated);
+  PROM_COUNTER("rs485_timeouts_total", "Request attempts that got no reply", m.timeouts);
+  PROM_COUNTER("rs485_retries_total", "Request attempts resent", m.retries);
+  PROM_COUNTER("rs485_failures_total", "Requests that ran out of retries", m.failures);
+
+  PROM_HEAD("rs485_reply_latency_seconds", "histogram", "End of request to end of reply");
+  uint32_t cumulative = 0;
+  for (int i = 0; i < METRICS_LATENCY_BUCKETS - 1; i++) {
+    cumulative += m.latency.buckets[i];
+    out.printf("flexpool_rs485_reply_latency_seconds_bucket{le=\"%.3f\"} %lu\n",
+               METRICS_LATENCY_LE_MS[i] / 1000.0, (unsigned long)cumulative);
+  }
+  cumulative += m.latency.buckets[METRICS_LATENCY_BUCKETS - 1];
+  out.printf("flexpool_rs485_reply_latency_seconds_bucket{le=\"+Inf\"} %lu\n", (unsigned long)cumulative);
+  PROM_VALUE("rs485_reply_latency_seconds_sum", "%.3f", m.latency.sumMs / 1000.0);
+  PROM_VALUE("rs485_reply_latency_seconds_count", "%lu", (unsigned long)cumulative);
+
+  PROM_HEAD("rs485_busy_seconds_total", "counter", "Time the line carried bytes");
+  PROM_VALUE("rs485_busy_seconds_total", "%.3f", m.busySeconds());
+  PROM_HEAD("rs485_utilization_ratio", "gauge", "Share of the recent window the line was busy");
+  PROM_VALUE("rs485_utilization_ratio", "%.3f", m.utilPermille / 1000.0);
+
+  PROM_HEAD("task_iteration_peak_seconds", "gauge", "Longest iteration over the last 1-2 minutes");
+  PROM_VALUE("task_iteration_peak_seconds{task=\"rs485\"}", "%.6f", m.busIterPeakUs / 1e6);
+  PROM_VALUE("task_iteration_peak_seconds{task=\"loop\"}", "%.6f", loopIterPeakUs / 1e6);
+
+  PROM_HEAD("uptime_seconds", "counter", "Time since boot");
+  PROM_VALUE("uptime_seconds", "%lu", (unsigned long)(millis() / 1000));
+  PROM_HEAD("heap_free_bytes", "gauge", "Free heap");
+  PROM_VALUE("heap_free_bytes", "%lu", (unsigned long)ESP.getFreeHeap());
+
+#undef PROM_COUNTER
+#undef PROM_VALUE
+#undef PROM_HEAD
+}
+
+// =============================================
+// DIAGNOSTICS JSON (MQTT .../diagnostics)
+// =============================================
+/*
+ * {"uptime":s,"frames":{"tx":..,"rx":..},"checksumErrors":..,"resyncs":..,
+ *  "skippedBytes":..,"overruns":..,"truncated":..,"timeouts":..,"retries":..,
+ *  "failures":..,"latencyMs":{"count":..,"p50":..,"p90":..,"p99":..,"max":..},
+ *  "utilization":0.042,"peakUs":{"rs485":..,"loop":..},"heap":..}
+ * Returns the length, or 0 if it didn't fit.
+ */
+inline size_t formatDiagnostics(char* json, size_t size, const BusMetrics& m, uint32_t loopIterPeakUs) {
+  int n = snprintf(json, size,
+    "{\"uptime\":%lu,\"frames\":{\"tx\":%lu,\"rx\":%lu},\"checksumErrors\":%lu,"
+    "\"resyncs\":%lu,\"skippedBytes\":%lu,\"overruns\":%lu,\"truncated\":%lu,"
+    "\"timeouts\":%lu,\"retries\":%lu,\"failures\":%lu,"
+    "\"latencyMs\":{\"count\":%lu,\"p50\":%.1f,\"p90\":%.1f,\"p99\":%.1f,\"max\":%lu},"
+    "\"utilization\":%.3f,\"peakUs\":{\"rs485\":%lu,\"loop\":%lu},\"heap\":%lu}",
+    (unsigned long)(millis() / 1000),
+    (unsigned long)m.framesTx, (unsigned long)m.framesRx,
+    (unsigned long)m.checksumErrors, (unsigned long)m.resyncs,
+    (unsigned long)m.skippedBytes, (unsigned long)m.overruns,
+    (unsigned long)m.truncated, (unsigned long)m.timeouts,
+    (unsigned long)m.retries, (unsigned long)m.failures,
+    (unsigned long)m.latency.count, m.latency.quantile(0.5f),
+    m.latency.quantile(0.9f), m.latency.quantile(0.99f),
+    (unsigned long)m.latency.maxMs,
+    m.utilPermille / 1000.0,
+    (unsigned long)m.busIterPeakUs, (unsigned long)loopIterPeakUs,
+    (unsigned long)ESP.getFreeHeap());
+  return (n > 0 && n < (int)size) ? n : 0;
+}
+
+#endif // BUS_METRICS_H
@@ -0,0 +1,468 @@
+/*
+ * =============================================
+ * Capture.h - RS-485 capture (RAM + LittleFS) and replay
+ * =============================================
+ *
+ * Every frame on the line - sent, received, good or bad - is copied
+ * into a RAM ring of CaptureRecords by the bus task (captureFrame() in
+ * RS485Bus.h). From there:
+ *
+ *   recording   loop() appends the new records to LittleFS every
+ *               CAPTURE_FLUSH_MS. Two files make a ring: cur.fpc
+ *               grows to half of CAPTURE_FILE_MAX, then replaces
+ *               old.fpc. Off by default (flash wear); the RAM ring
+ *               always runs.
+ *   live        /api/capture?live=S streams records as they happen
+ *   replay      a stored capture is fed back to the bus task at wire
+ *               speed (or N times faster, or flat out). It goes through
+ *               a parser and the same frame handling as live traffic,
+ *               into a registry of its own (RS485Bus.h): /events, the
+ *               web UI and /metrics show it; energy totals, history and
+ *               MQTT skip replayed snapshots (BusSnapshot::replay), and
+ *               the live registry is back when it ends. The bus is
+ *               listen-only meanwhile, so a replay is refused while the
+ *               schedule runs a program (its keep-alive would stop and
+ *               the pump drop it within 30 s); rule changes wait until
+ *               the replay is over.
+ *
+ * Format: CaptureFormat.h. tools/bench -r reads the same files.
+ *
+ * HTTP (FEATURE_HTTP; the Serial 'capture' / 'replay' commands work
+ * without it):
+ *   GET  /api/capture              stored capture, one .fpc file
+ *   GET  /api/capture?live=S       header, then live records for S seconds
+ *   POST /api/capture?record=1|0   start / stop recording to LittleFS
+ *   POST /api/capture?clear=1      delete the stored capture (and an upload)
+ *   PUT  /api/capture              body = an .fpc file, kept for replay
+ *   POST /api/replay?speed=N       replay: the uploaded file if there is
+ *                                  one, else the stored capture
+ *                                  (N x wire speed, 0 = flat out, default 1)
+ *   POST /api/replay?stop=1
+ *
+ * THREADING:
+ *   record() runs on the bus task, the HTTP streams and the upload on
+ *   the AsyncTCP task, files and replay pacing on the loop task.
+ *   Records are copied in and out of the ring under a spinlock.
+ */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "Config.h"
+#if FEATURE_HTTP
+#include <ESPAsyncWebServer.h>
+#endif
+#include "CaptureFormat.h"
+#include "RS485Bus.h"
+#include "Schedule.h"
+#include "Log.h"
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define CAPTURE_RING_LEN     64            // Records in RAM (~3.5 KB)
+#define CAPTURE_FLUSH_MS     2000          // Batch flash writes
+#define CAPTURE_FILE_MAX     (128 * 1024)  // Both ring files together
+#define CAPTURE_LIVE_MAX_S   3600          // Longest ?live= stream
+#define CAPTURE_DIR          "/cap"
+#define CAPTURE_CUR          CAPTURE_DIR "/cur.fpc"
+#define CAPTURE_OLD          CAPTURE_DIR "/old.fpc"
+#define CAPTURE_UPLOAD       CAPTURE_DIR "/replay.fpc"
+#define CAPTURE_STOP         0x10000       // requestReplay(): stop it
+
+extern RS485Bus bus;
+extern Schedule schedule;
+
+// =============================================
+// Capture CLASS
+// =============================================
+class Capture {
+private:
+  CaptureRecord     _ring[CAPTURE_RING_LEN];
+  volatile uint32_t _written = 0;        // Records ever put in the ring
+  portMUX_TYPE      _mux = portMUX_INITIALIZER_UNLOCKED;
+  uint32_t          _baud = 9600;
+  bool              _fs = false;
+
+  // Recording (loop task)
+  bool          _recording = false;
+  uint32_t      _flushed = 0;            // Next ring record to write out
+  uint32_t      _lost = 0;               // Overwritten before they were written
+  unsigned long _lastFlush = 0;
+
+  // Upload (AsyncTCP task)
+  File          _upload;
+
+  // Asked for over HTTP, done by loop(): -1 = nothing
+  volatile int8_t  _wantRecord = -1;
+  volatile bool    _wantClear = false;
+  volatile int32_t _wantReplay = -1;     // Speed, or CAPTURE_STOP
+
+  // Replay (loop task)
+  bool          _replaying = false;
+  bool          _wasListenOnly = false;
+  const char*   _paths[2];
+  uint8_t       _pathCount = 0;
+  uint8_t       _path = 0;
+  File          _in;
+  CaptureRecord _next;                   // Read, not handed to the bus yet
+  bool          _haveNext = false;
+  uint32_t      _prevT = 0;              // Capture time of the last record read
+  uint32_t      _at = 0;                 // Capture ms from the first record to _next
+  unsigned long _start = 0;
+  uint16_t      _speed = 1;
+  uint32_t      _replayed = 0;
+
+  uint32_t first() const { return _written > CAPTURE_RING_LEN ? _written - CAPTURE_RING_LEN : 0; }
+
+  // Copy record k out; false if not written yet or already overwritten
+  bool recordAt(uint32_t k, CaptureRecord& out) {
+    bool ok;
+    portENTER_CRITICAL(&_mux);
+    ok = k >= first() && k < _written;
+    if (ok) out = _ring[k % CAPTURE_RING_LEN];
+    portEXIT_CRITICAL(&_mux);
+    return ok;
+  }
+
+  // ---- Recording ----
+  File openCurrent() {
+    File f = LittleFS.open(CAPTURE_CUR, "a");
+    if (f && f.size() == 0) {
+      uint8_t h[CAPTURE_HEADER_LEN];
+      captureHeader(h, _baud);
+      f.write(h, sizeof(h));
+    }
+    return f;
+  }
+
+  // New ring records into cur.fpc; rotate it once it is full
+  void flush() {
+    uint32_t written = _written;
+    if (_flushed == written) return;
+    File f = openCurrent();
+    if (!f) return;
+
+    uint8_t buf[CAPTURE_RECORD_HDR + CAPTURE_MAX_FRAME];
+    CaptureRecord r;
+    for (; _flushed < written; _flushed++) {
+      if (!recordAt(_flushed, r)) {
+        uint32_t oldest = first();
+        _lost += oldest - _flushed;
+        _flushed = oldest - 1;
+        continue;
+      }
+      f.write(buf, captureEncode(r, buf));
+    }
+    size_t size = f.size();
+    f.close();
+
+    if (size >= CAPTURE_FILE_MAX / 2) {
+      LittleFS.remove(CAPTURE_OLD);
+      LittleFS.rename(CAPTURE_CUR, CAPTURE_OLD);
+    }
+  }
+
+  // ---- Replay ----
+  // Next record of the replay, across its files
+  bool readNext() {
+    uint32_t baud;
+    while (!(_in && captureRead(_in, _next))) {
+      if (_in) _in.close();
+      if (_path >= _pathCount) return false;
+      const char* path = _paths[_path++];
+      _in = LittleFS.open(path, "r");
+      if (!_in) continue;
+      if (!captureReadHeader(_in, baud)) {
+        LOGW("CAP", "%s is not a capture - skipped", path);
+        _in.close();
+        continue;
+      }
+      if (baud != _baud) {
+        LOGW("CAP", "%s was taken at %lu baud (bus: %lu)", path,
+             (unsigned long)baud, (unsigned long)_baud);
+      }
+    }
+    return true;
+  }
+
+  void endReplay(const char* why) {
+    if (_in) _in.close();
+    _replaying = false;
+    _haveNext = false;
+    bus.setListenOnly(_wasListenOnly);
+    bus.setReplaying(false);
+    LOGI("CAP", "Replay %s: %lu frames", why, (unsigned long)_replayed);
+  }
+
+  // When _next is due on the bus
+  unsigned long dueAt() const {
+    return _speed ? _start + _at / _speed : 0;
+  }
+
+  // readNext(), and move the capture clock up to the new record
+  bool advance() {
+    if (!readNext()) return false;
+    _at += captureGap(_prevT, _next.t);
+    _prevT = _next.t;
+    return true;
+  }
+
+public:
+  // Remember the baud rate, make the directory (setup, after History::begin)
+  void begin(uint32_t baud) {
+    _baud = baud;
+    _fs = LittleFS.begin(true);
+    if (_fs) LittleFS.mkdir(CAPTURE_DIR);
+  }
+
+  // One frame from the line (bus task)
+  void record(uint8_t flags, const uint8_t* frame, size_t len) {
+    portENTER_CRITICAL(&_mux);
+    _ring[_written % CAPTURE_RING_LEN].set(millis(), flags, frame, len);
+    _written++;
+    portEXIT_CRITICAL(&_mux);
+  }
+
+  // Flush to LittleFS, pace the replay (loop task)
+  void loop() {
+    if (_wantClear) {
+      _wantClear = false;
+      clear();
+    }
+    if (_wantRecord >= 0) {
+      setRecording(_wantRecord);
+      _wantRecord = -1;
+    }
+    if (_wantReplay >= 0) {
+      int32_t speed = _wantReplay;
+      _wantReplay = -1;
+      if (speed == CAPTURE_STOP) stopReplay();
+      else startReplay(speed);
+    }
+
+    if (_recording && millis() - _lastFlush >= CAPTURE_FLUSH_MS) {
+      _lastFlush = millis();
+      flush();
+    }
+
+    while (_replaying) {
+      if (!_haveNext) {
+        if (!advance()) {
+          endReplay("done");
+          break;
+        }
+        _haveNext = true;
+      }
+      if (_speed && (long)(millis() - dueAt()) < 0) break;
+      if (!bus.replay(_next)) break;         // Bus task is behind: next loop()
+      _haveNext = false;
+      _replayed++;
+    }
+  }
+
+  // Milliseconds until loop() has capture work
+  unsigned long msUntilDue() const {
+    unsigned long now = millis();
+    unsigned long wait = UINT32_MAX;
+    if (_recording) {
+      unsigned long since = now - _lastFlush;
+      wait = since >= CAPTURE_FLUSH_MS ? 0 : CAPTURE_FLUSH_MS - since;
+    }
+    if (_replaying) {
+      unsigned long due = (_haveNext && _speed) ? dueAt() : now;
+      unsigned long w = (long)(due - now) > 0 ? due - now : 10;   // 10: replay queue full
+      if (w < wait) wait = w;
+    }
+    return wait;
+  }
+
+  // ---- Control (loop task) ----
+  bool setRecording(bool on) {
+    if (on && !_fs) {
+      LOGW("CAP", "LittleFS not mounted - cannot record");
+      return false;
+    }
+    if (on && !_recording) {
+      _flushed = _written;                   // From now on
+      _lastFlush = millis();
+    } else if (!on && _recording) {
+      flush();
+    }
+    _recording = on;
+    LOGI("CAP", "Recording %s", on ? "ON (" CAPTURE_DIR ")" : "off");
+    return true;
+  }
+  bool recording() const { return _recording; }
+
+  void clear() {
+    LittleFS.remove(CAPTURE_CUR);
+    LittleFS.remove(CAPTURE_OLD);
+    LittleFS.remove(CAPTURE_UPLOAD);
+    LOGI("CAP", "Stored and uploaded captures deleted");
+  }
+
+  /*
+   * Replay the uploaded capture, else the stored one, at speed x wire
+   * speed (0 = as fast as the bus task takes it). Stops recording;
+   * the bus is listen-only until the replay ends. Refused while a
+   * scheduled program runs (see replay above).
+   */
+  bool startReplay(uint16_t speed) {
+    if (_replaying) endReplay("stopped");
+    if (!_fs) return false;
+    if (schedule.programRunning()) {
+      LOGW("CAP", "A scheduled program is running - no replay (it would lapse)");
+      return false;
+    }
+    if (_recording) setRecording(false);
+
+    _pathCount = 0;
+    if (LittleFS.exists(CAPTURE_UPLOAD)) {
+      _paths[_pathCount++] = CAPTURE_UPLOAD;
+    } else {
+      _paths[_pathCount++] = CAPTURE_OLD;
+      _paths[_pathCount++] = CAPTURE_CUR;
+    }
+    _path = 0;
+    _speed = speed;
+    _replayed = 0;
+    _haveNext = false;
+    if (!readNext()) {
+      LOGW("CAP", "Nothing to replay");
+      return false;
+    }
+    _haveNext = true;
+    _prevT = _next.t;
+    _at = 0;
+    _start = millis();
+    _replaying = true;
+    _wasListenOnly = bus.listenOnly();
+    bus.setListenOnly(true);
+    bus.setReplaying(true);                  // Before the first bus.replay()
+    LOGI("CAP", "Replaying %s at %s", _paths[0],
+         speed ? (speed == 1 ? "wire speed" : "accelerated speed") : "full speed");
+    return true;
+  }
+
+  void stopReplay() {
+    if (_replaying) endReplay("stopped");
+  }
+  bool replaying() const { return _replaying; }
+
+  void print() {
+    Serial.printf("[CAP] %lu frames seen, recording %s, %lu lost before flush\n",
+                  (unsigned long)_written, _recording ? "ON" : "off", (unsigned long)_lost);
+    const char* files[] = { CAPTURE_OLD, CAPTURE_CUR, CAPTURE_UPLOAD };
+    for (const char* path : files) {
+      if (!_fs || !LittleFS.exists(path)) continue;
+      File f = LittleFS.open(path, "r");
+      Serial.printf("[CAP]   %s  %lu bytes\n", path, (unsigned long)f.size());
+      f.close();
+    }
+    if (_replaying) {
+      Serial.printf("[CAP] Replay: %lu frames so far (speed %u)\n", (unsigned long)_replayed, _speed);
+    }
+  }
+
+  // ---- Requests from other tasks (carried out by the next loop()) ----
+  void requestRecording(bool on) { _wantRecord = on; }
+  void requestClear() { _wantClear = true; }
+  void requestReplay(uint16_t speed) { _wantReplay = speed; }
+  void requestStop() { _wantReplay = CAPTURE_STOP; }
+
+#if FEATURE_HTTP
+  // ---- HTTP (AsyncTCP task) ----
+  // The stored ring as one file: our header, then old.fpc and cur.fpc
+  // without theirs
+  AsyncWebServerResponse* streamStored(AsyncWebServerRequest* request) {
+    File old = LittleFS.open(CAPTURE_OLD, "r");
+    File cur = LittleFS.open(CAPTURE_CUR, "r");
+    if (old) old.seek(CAPTURE_HEADER_LEN);
+    if (cur) cur.seek(CAPTURE_HEADER_LEN);
+    uint32_t baud = _baud;
+    bool header = true;
+
+    AsyncWebServerResponse* response = request->beginChunkedResponse("application/octet-stream",
+      [old, cur, baud, header](uint8_t* buf, size_t max, size_t) mutable -> size_t {
+        size_t len = 0;
+        if (header) {
+          if (max < CAPTURE_HEADER_LEN) return RESPONSE_TRY_AGAIN;
+          captureHeader(buf, baud);
+          len = CAPTURE_HEADER_LEN;
+          header = false;
+        }
+        File* files[] = { &old, &cur };
+        for (File* f : files) {
+          if (len == max || !*f) continue;
+          size_t n = f->read(buf + len, max - len);
+          len += n;
+          if (len < max) f->close();        // This one is done
+        }
+        return len;
+      });
+    response->addHeader("Content-Disposition", "attachment; filename=\"flexpool.fpc\"");
+    return response;
+  }
+
+  // Header, then each record as it is captured, for seconds
+  AsyncWebServerResponse* streamLive(AsyncWebServerRequest* request, uint32_t seconds) {
+    Capture* self = this;
+    uint32_t k = _written;
+    uint32_t baud = _baud;
+    unsigned long until = millis() + (seconds > CAPTURE_LIVE_MAX_S ? CAPTURE_LIVE_MAX_S : seconds) * 1000UL;
+    bool header = true;
+
+    return request->beginChunkedResponse("application/octet-stream",
+      [self, k, baud, until, header](uint8_t* buf, size_t max, size_t) mutable -> size_t {
+        const size_t ROOM = CAPTURE_RECORD_HDR + CAPTURE_MAX_FRAME;
+        size_t len = 0;
+        if (header) {
+          if (max < CAPTURE_HEADER_LEN) return RESPONSE_TRY_AGAIN;
+          captureHeader(buf, baud);
+          len = CAPTURE_HEADER_LEN;
+          header = false;
+        }
+        // Past the deadline: nothing more (0 ends the stream), even with
+        // frames still coming in
+        if ((long)(millis() - until) >= 0) return len;
+        CaptureRecord r;
+        while (max - len >= ROOM) {
+          if (!self->recordAt(k, r)) {
+            // Too slow a client: skip to the oldest record still there
+            uint32_t oldest = self->first();
+            if (k < oldest) { k = oldest; continue; }
+            break;                            // Caught up
+          }
+          k++;
+          len += captureEncode(r, buf + len);
+        }
+        return len ? len : RESPONSE_TRY_AGAIN;
+      });
+  }
+
+  // PUT body, piece by piece: becomes the replay file
+  void uploadChunk(const uint8_t* data, size_t len, size_t index, size_t total) {
+    if (index == 0) {
+      if (_upload) _upload.close();
+      _upload = LittleFS.open(CAPTURE_UPLOAD, "w");
+    }
+    if (_upload) _upload.write(data, len);
+    if (index + len >= total && _upload) _upload.close();
+  }
+
+  // After a PUT: is what arrived a capture?
+  bool uploadValid() {
+    File f = LittleFS.open(CAPTURE_UPLOAD, "r");
+    uint32_t baud;
+    bool ok = f && captureReadHeader(f, baud);
+    if (f) f.close();
+    if (!ok) LittleFS.remove(CAPTURE_UPLOAD);
+    return ok;
+  }
+#endif
+};
+
+#endif // CAPTURE_H
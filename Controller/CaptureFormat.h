@@ -0,0 +1,127 @@
+/*
+ * =============================================
+ * CaptureFormat.h - Binary RS-485 capture records (.fpc)
+ * =============================================
+ *
+ * One record per frame on the line, ours and everyone else's. The
+ * device writes them (Capture.h), tools/bench reads them on the host
+ * (bench -r), so this file has no ESP32 dependencies.
+ *
+ * FILE (little-endian):
+ *   "FPC1"              magic (bump the digit if a record changes)
+ *   u32  baud           line speed the capture was taken at
+ *   records, back to back:
+ *     u32  t            millis() when the frame's last byte arrived
+ *                       (TX: when it finished going out)
+ *     u8   flags        CAPTURE_TX, CAPTURE_BAD, CAPTURE_CUT
+ *     u8   len          frame bytes that follow
+ *     len  bytes        the frame, preamble through checksum
+ *
+ * Six bytes of overhead per frame: a status poll and its reply are
+ * 50 bytes; a saturated 9600 baud line fills about 70 KB a minute.
+ * Only differences between timestamps mean anything, and t goes back
+ * to 0 where the device rebooted in the middle of a recording (cur.fpc
+ * is appended to across boots): readers take the gap between records
+ * from captureGap(), which counts such a step back as no time at all.
+ *
+ * A capture is a plain concatenation of records after one header, so
+ * two files are joined by dropping the second's header - that is how
+ * /api/capture sends the LittleFS ring.
+ */
+
+#ifndef CAPTURE_FORMAT_H
+#define CAPTURE_FORMAT_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#endif
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define CAPTURE_MAX_FRAME   48     // Longer frames are cut (CAPTURE_CUT)
+#define CAPTURE_HEADER_LEN  8
+#define CAPTURE_RECORD_HDR  6
+
+// Record flags
+#define CAPTURE_TX    0x01         // We transmitted it (else received)
+#define CAPTURE_BAD   0x02         // Checksum mismatch
+#define CAPTURE_CUT   0x04         // Longer than CAPTURE_MAX_FRAME, rest dropped
+
+const uint8_t CAPTURE_MAGIC[4] = { 'F', 'P', 'C', '1' };
+
+// =============================================
+// ONE RECORD (in RAM: fixed size, on file: 6 + len bytes)
+// =============================================
+struct CaptureRecord {
+  uint32_t t;
+  uint8_t  flags;
+  uint8_t  len;
+  uint8_t  data[CAPTURE_MAX_FRAME];
+
+  void set(uint32_t when, uint8_t f, const uint8_t* frame, size_t n) {
+    t = when;
+    flags = f;
+    if (n > CAPTURE_MAX_FRAME) {
+      n = CAPTURE_MAX_FRAME;
+      flags |= CAPTURE_CUT;
+    }
+    len = n;
+    memcpy(data, frame, n);
+  }
+};
+
+// =============================================
+// ENCODE
+// =============================================
+inline void captureHeader(uint8_t* out, uint32_t baud) {
+  memcpy(out, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+  for (int i = 0; i < 4; i++) out[4 + i] = baud >> (8 * i);
+}
+
+// Record as stored; out needs CAPTURE_RECORD_HDR + CAPTURE_MAX_FRAME.
+// Returns the bytes written.
+inline size_t captureEncode(const CaptureRecord& r, uint8_t* out) {
+  for (int i = 0; i < 4; i++) out[i] = r.t >> (8 * i);
+  out[4] = r.flags;
+  out[5] = r.len;
+  memcpy(out + CAPTURE_RECORD_HDR, r.data, r.len);
+  return CAPTURE_RECORD_HDR + r.len;
+}
+
+// =============================================
+// DECODE (Source: anything with size_t read(uint8_t*, size_t))
+// =============================================
+// Check the magic; false if this isn't a capture
+template <typename Source>
+bool captureReadHeader(Source& in, uint32_t& baud) {
+  uint8_t h[CAPTURE_HEADER_LEN];
+  if (in.read(h, sizeof(h)) != sizeof(h) || memcmp(h, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0) {
+    return false;
+  }
+  baud = h[4] | (uint32_t)h[5] << 8 | (uint32_t)h[6] << 16 | (uint32_t)h[7] << 24;
+  return true;
+}
+
+// Next record; false at the end (or a record cut short by a full disk)
+template <typename Source>
+bool captureRead(Source& in, CaptureRecord& r) {
+  uint8_t h[CAPTURE_RECORD_HDR];
+  if (in.read(h, sizeof(h)) != sizeof(h)) return false;
+  r.t = h[0] | (uint32_t)h[1] << 8 | (uint32_t)h[2] << 16 | (uint32_t)h[3] << 24;
+  r.flags = h[4];
+  r.len = h[5];
+  if (r.len > CAPTURE_MAX_FRAME) return false;
+  return in.read(r.data, r.len) == r.len;
+}
+
+// Milliseconds between two records' t; 0 if t went backwards (reboot)
+inline uint32_t captureGap(uint32_t prevT, uint32_t t) {
+  return (int32_t)(t - prevT) > 0 ? t - prevT : 0;
+}
+
+#endif // CAPTURE_FORMAT_H
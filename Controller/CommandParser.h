@@ -0,0 +1,182 @@
+/*
+ * =============================================
+ * CommandParser.h - MQTT command schema + allocation-free JSON parser
+ * =============================================
+ *
+ * SCHEMA (one command):
+ *   {"cmd":"<name>", "pump":1-4, "rpm":450-3450}
+ *     cmd    required   fullstart, fullstop, start, stop, rpm,
+ *                       remote, local, query
+ *     pump   optional   default: the Controller's selected pump
+ *     rpm    per cmd    fullstart / rpm ("value" is accepted as an alias,
+ *                       which is what the Web UI sends for "rpm")
+ *
+ * BATCH: a JSON array of commands, run in order:
+ *   [{"cmd":"rpm","pump":2,"rpm":1800},{"cmd":"stop","pump":1}]
+ *
+ * The whole message is parsed and checked before anything runs, so a
+ * bad entry rejects the batch instead of leaving half a scene applied.
+ * Unknown keys are errors (a typo'd "rpm" must not start a pump at a
+ * default speed).
+ *
+ * Single pass over the payload, no String / heap: the parser reads the
+ * bytes in place and fills a caller-provided array of ParsedCommand.
+ */
+
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+#include <Arduino.h>
+#include "PumpStatus.h"
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define CMD_MAX_BATCH     8      // Commands per message
+#define CMD_NAME_LEN      12     // Longest command name + NUL
+
+// =============================================
+// ONE PARSED COMMAND
+// =============================================
+struct ParsedCommand {
+  char    name[CMD_NAME_LEN] = "";
+  uint8_t pump   = 0;          // 1-4, 0 = not given
+  bool    hasRpm = false;
+  int32_t rpm    = 0;
+};
+
+// =============================================
+// CommandParser CLASS
+// =============================================
+class CommandParser {
+private:
+  const char* _p;
+  const char* _end;
+  const char* _error = nullptr;
+
+  bool fail(const char* why) {
+    if (!_error) _error = why;
+    return false;
+  }
+
+  void skipWs() {
+    while (_p < _end && (*_p == ' ' || *_p == '\t' || *_p == '\r' || *_p == '\n')) _p++;
+  }
+
+  bool peek(char c) {
+    skipWs();
+    return _p < _end && *_p == c;
+  }
+
+  // Consume c if it is next
+  bool accept(char c) {
+    if (!peek(c)) return false;
+    _p++;
+    return true;
+  }
+
+  bool expect(char c) {
+    if (!peek(c)) return fail("malformed JSON");
+    _p++;
+    return true;
+  }
+
+  // "..." into out (simple escapes only; our names are plain ASCII)
+  bool string(char* out, size_t size) {
+    if (!expect('"')) return false;
+    size_t n = 0;
+    while (_p < _end && *_p != '"') {
+      char c = *_p++;
+      if (c == '\\') {
+        if (_p >= _end) break;
+        c = *_p++;
+      }
+      if (n + 1 >= size) return fail("string too long");
+      out[n++] = c;
+    }
+    if (_p >= _end) return fail("unterminated string");
+    _p++;
+    out[n] = '\0';
+    return true;
+  }
+
+  // Integer (a fraction or exponent is rejected, not rounded)
+  bool integer(int32_t& out) {
+    skipWs();
+    bool neg = (_p < _end && *_p == '-');
+    if (neg) _p++;
+    if (_p >= _end || *_p < '0' || *_p > '9') return fail("expected a number");
+    int32_t v = 0;
+    while (_p < _end && *_p >= '0' && *_p <= '9') {
+      if (v > 100000) return fail("number out of range");
+      v = v * 10 + (*_p++ - '0');
+    }
+    if (_p < _end && (*_p == '.' || *_p == 'e' || *_p == 'E')) return fail("expected an integer");
+    out = neg ? -v : v;
+    return true;
+  }
+
+  // {"key":value,...} into cmd
+  bool object(ParsedCommand& cmd) {
+    cmd = ParsedCommand();
+    if (!expect('{')) return false;
+    if (peek('}')) return fail("empty command");
+
+    do {
+      char key[8];
+      if (!string(key, sizeof(key)) || !expect(':')) return fail("unknown key");
+
+      if (strcmp(key, "cmd") == 0) {
+        if (!string(cmd.name, sizeof(cmd.name))) return fail("bad \"cmd\"");
+      } else if (strcmp(key, "pump") == 0) {
+        int32_t n;
+        if (!integer(n)) return false;
+        if (n < 1 || n > PUMP_COUNT) return fail("\"pump\" must be 1-4");
+        cmd.pump = n;
+      } else if (strcmp(key, "rpm") == 0 || strcmp(key, "value") == 0) {
+        if (!integer(cmd.rpm)) return false;
+        cmd.hasRpm = true;
+      } else {
+        return fail("unknown key");
+      }
+    } while (accept(','));
+
+    if (!expect('}')) return false;
+    if (!cmd.name[0]) return fail("missing \"cmd\"");
+    return true;
+  }
+
+public:
+  /*
+   * Parse one command object or an array of them.
+   * Returns the number of commands in out[], or -1 (see error()).
+   */
+  int parse(const char* json, size_t length, ParsedCommand* out, int max) {
+    _p = json;
+    _end = json + length;
+    _error = nullptr;
+    int count = 0;
+
+    if (accept('[')) {
+      if (!peek(']')) {
+        do {
+          if (count >= max) { fail("too many commands"); return -1; }
+          if (!object(out[count++])) return -1;
+        } while (accept(','));
+      }
+      if (!expect(']')) return -1;
+    } else {
+      if (!object(out[count++])) return -1;
+    }
+
+    skipWs();
+    if (_p != _end) { fail("trailing data"); return -1; }
+    if (count == 0) { fail("empty batch"); return -1; }
+    return count;
+  }
+
+  // Why the last parse() failed
+  const char* error() const { return _error ? _error : "ok"; }
+};
+
+#endif // COMMAND_PARSER_H
@@ -0,0 +1,245 @@
+/*
+ * =============================================
+ * CommandSequencer.h - Non-blocking command sequences
+ * =============================================
+ *
+ * Runs multi-step pump sequences (full start, full stop) without
+ * blocking. A sequence is a small list of steps:
+ *
+ *   [TX frame] -> wait for reply CFI (or timeout) -> post-delay -> next step
+ *
+ * A step with no frame is a plain wait (post-delay only), and a step
+ * with a 0 ms timeout is sent without waiting for a reply.
+ *
+ * Each frame is sent as a transaction (Transactions.h), which handles
+ * reply matching, per-attempt timeouts and retries. Several sequencers
+ * can share one table; their frames interleave on the bus.
+ *
+ * USAGE:
+ *   CommandSequence seq;                      // built on any task
+ *   seq.begin("fullstart", onDone, true);
+ *   seq.addFrame("Starting motor", frame, len, CMD_RUN, TXN_ATTEMPT_TIMEOUT_MS, 0);
+ *   seq.addWait("Waiting 1 second", 1000);
+ *   bus.submit(seq);                          // copied into the bus queue
+ *
+ * The RS-485 bus task owns the CommandSequencers that run it:
+ *   sequencer.begin(table);
+ *   sequencer.run(seq);
+ *   sequencer.loop();              every bus task iteration
+ *   sequencer.msUntilDue();        how long the bus task may sleep
+ */
+
+#ifndef COMMAND_SEQUENCER_H
+#define COMMAND_SEQUENCER_H
+
+#include <Arduino.h>
+#include "PentairProtocol.h"
+#include "Transactions.h"
+#include "Log.h"
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define SEQ_MAX_STEPS      8     // Longest sequence we build is 6 steps
+#define SEQ_MAX_FRAME_LEN  TXN_MAX_FRAME_LEN
+
+// Called when a sequence ends; ok = every step got its reply
+typedef void (*SequenceDoneFn)(uint8_t addr, bool ok);
+
+// =============================================
+// SEQUENCE STEP
+// =============================================
+struct SequenceStep {
+  const char* label;                    // Shown in serial log and status
+  uint8_t  frame[SEQ_MAX_FRAME_LEN];    // Packet to transmit
+  uint8_t  frameLen;                    // 0 = wait-only step
+  uint8_t  expectCmd;                   // Reply CFI that completes the step
+  uint16_t timeoutMs;                   // Per attempt; 0 = don't wait for a reply
+  uint16_t postDelayMs;                 // Gap before the next step starts
+};
+
+// =============================================
+// COMMAND SEQUENCE (plain data, safe to copy through a queue)
+// =============================================
+struct CommandSequence {
+  const char*    name    = "none";
+  SequenceDoneFn onDone  = nullptr;
+  bool           preempt = false;       // Abort the same pump's sequences to start this one
+  uint8_t        addr    = 0;           // Target pump (from the first frame), 0 = none
+  uint8_t        count   = 0;
+  SequenceStep   steps[SEQ_MAX_STEPS];
+
+  // Start building a new sequence
+  void begin(const char* seqName, SequenceDoneFn done = nullptr, bool preemptRunning = false) {
+    name    = seqName;
+    onDone  = done;
+    preempt = preemptRunning;
+    addr    = 0;
+    count   = 0;
+  }
+
+  // Add a step that transmits a frame and waits for a reply with expectCmd
+  bool addFrame(const char* label, const uint8_t* frame, size_t len,
+                uint8_t expectCmd, uint16_t timeoutMs, uint16_t postDelayMs) {
+    if (count >= SEQ_MAX_STEPS || len > SEQ_MAX_FRAME_LEN) return false;
+
+    if (addr == 0 && len > PKT_IDX_DST) addr = frame[PKT_IDX_DST];
+
+    SequenceStep& step = steps[count++];
+    step.label       = label;
+    memcpy(step.frame, frame, len);
+    step.frameLen    = len;
+    step.expectCmd   = expectCmd;
+    step.timeoutMs   = timeoutMs;
+    step.postDelayMs = postDelayMs;
+    return true;
+  }
+
+  // Add a step that only waits
+  bool addWait(const char* label, uint16_t delayMs) {
+    if (count >= SEQ_MAX_STEPS) return false;
+
+    SequenceStep& step = steps[count++];
+    step.label       = label;
+    step.frameLen    = 0;
+    step.expectCmd   = 0;
+    step.timeoutMs   = 0;
+    step.postDelayMs = delayMs;
+    return true;
+  }
+};
+
+// =============================================
+// CommandSequencer CLASS
+// =============================================
+class CommandSequencer {
+private:
+  enum State : uint8_t { IDLE, SEND, WAIT_REPLY, POST_DELAY };
+
+  CommandSequence   _seq;
+  TransactionTable* _txns = nullptr;
+  uint8_t         _current = 0;
+  State           _state = IDLE;
+  bool            _allReplied = true;
+  unsigned long   _stateStart = 0;
+
+  void enter(State s) {
+    _state = s;
+    _stateStart = millis();
+  }
+
+  // Transmit the current step's frame (or go straight to its delay)
+  void startStep() {
+    SequenceStep& step = _seq.steps[_current];
+    if (_seq.count > 1) {
+      LOGD("SEQ", "Step %d/%d: %s...", _current + 1, _seq.count, step.label);
+    }
+
+    if (step.frameLen == 0) {
+      enter(POST_DELAY);
+      return;
+    }
+    // Table full (other sequencers busy): try again next loop()
+    if (!_txns->start(step.frame, step.frameLen, step.expectCmd, step.timeoutMs,
+                      onStepDone, this)) {
+      return;
+    }
+    enter(WAIT_REPLY);
+  }
+
+  // Transaction callback: reply arrived, or every retry timed out
+  static void onStepDone(void* ctx, bool ok) {
+    CommandSequencer* self = static_cast<CommandSequencer*>(ctx);
+    if (self->_state != WAIT_REPLY) return;
+    if (!ok) {
+      LOGW("SEQ", "No response from 0x%02X to \"%s\" (timeout)",
+           self->_seq.addr, self->_seq.steps[self->_current].label);
+      self->_allReplied = false;
+    }
+    self->enter(POST_DELAY);
+  }
+
+  void finish() {
+    if (_seq.count > 1) {
+      LOGI("SEQ", "\"%s\" finished%s", _seq.name,
+           _allReplied ? "" : " (some steps timed out)");
+    }
+    _state = IDLE;
+    if (_seq.onDone) _seq.onDone(_seq.addr, _allReplied);
+  }
+
+public:
+  void begin(TransactionTable& txns) { _txns = &txns; }
+
+  // Stop the running sequence (its callback is not called)
+  void abort() {
+    if (_state == IDLE) return;
+    LOGI("SEQ", "Aborting \"%s\" at step %d/%d",
+         _seq.name, _current + 1, _seq.count);
+    _txns->cancel(this);
+    _state = IDLE;
+  }
+
+  /*
+   * Start running a sequence (copied).
+   * Any sequence still running is aborted (its callback is not called).
+   */
+  void run(const CommandSequence& seq) {
+    abort();
+    _seq = seq;
+    _current = 0;
+    _allReplied = true;
+    if (_seq.count == 0) {
+      _state = IDLE;
+      return;
+    }
+    enter(SEND);
+  }
+
+  // Call this every bus task iteration
+  void loop() {
+    switch (_state) {
+      case IDLE:
+        return;
+
+      case SEND:
+        startStep();
+        break;
+
+      case WAIT_REPLY:
+        break;   // Transaction table calls onStepDone()
+
+      case POST_DELAY:
+        if (millis() - _stateStart >= _seq.steps[_current].postDelayMs) {
+          if (++_current >= _seq.count) {
+            finish();
+          } else {
+            enter(SEND);
+          }
+        }
+        break;
+    }
+  }
+
+  // Milliseconds until loop() has something to do (UINT32_MAX when idle)
+  uint32_t msUntilDue() const {
+    switch (_state) {
+      case IDLE:
+      case WAIT_REPLY: return UINT32_MAX;   // Woken by the transaction table
+      case SEND:       return 0;
+      default:         break;
+    }
+    uint32_t elapsed = millis() - _stateStart;
+    uint32_t wait = _seq.steps[_current].postDelayMs;
+    return (elapsed >= wait) ? 0 : wait - elapsed;
+  }
+
+  // ---- Progress (for status reporting) ----
+  bool busy() const { return _state != IDLE; }
+  const char* name() const { return busy() ? _seq.name : "none"; }
+  uint8_t addr() const { return busy() ? _seq.addr : 0; }
+  uint8_t step() const { return busy() ? _current + 1 : 0; }
+  uint8_t stepCount() const { return busy() ? _seq.count : 0; }
+};
+
+#endif // COMMAND_SEQUENCER_H
@@ -0,0 +1,229 @@
+/*
+ * =============================================
+ * Config.h - Build profile, feature toggles, board settings
+ * =============================================
+ *
+ * Everything a build can leave out, and the board-level settings
+ * (pins, baud rates, pumps polled from boot), in one place. Module
+ * tuning (intervals, deadbands) stays in each module's CONFIGURATION
+ * block; the few sizes a profile changes are marked there.
+ *
+ * PROFILES (FLEXPOOL_PROFILE):
+ *   PROFILE_FULL     everything (default): BLE setup, web UI + REST API,
+ *                    history, MQTT, Serial console, frame hex dumps
+ *   PROFILE_BRIDGE   headless RS-485 -> MQTT bridge: MQTT and the
+ *                    Serial console only. No BLE stack, no web server
+ *                    (so no history either); the heap that frees goes to
+ *                    a deeper MQTT offline queue. WiFi comes from
+ *                    WIFI_DEFAULT_SSID or 'wifi join' on the console.
+ *   PROFILE_LOCAL    LAN only: BLE setup, web UI + REST API, history and
+ *                    the console, no cloud MQTT
+ *
+ * SELECTING ONE:
+ *   Arduino IDE   edit the FLEXPOOL_PROFILE default below
+ *   arduino-cli   --build-property "build.extra_flags=-DFLEXPOOL_PROFILE=PROFILE_BRIDGE"
+ *   PlatformIO    build_flags = -DFLEXPOOL_PROFILE=PROFILE_BRIDGE
+ * Any single toggle can be overridden on top of a profile the same way
+ * (e.g. -DFEATURE_HEX_LOG=1 on a bridge being debugged on the bench).
+ *
+ * FEATURES (1 = built in, 0 = not compiled or linked at all):
+ *   FEATURE_BLE       Bluetooth provisioning ('setup'). Linking the BLE
+ *                     stack keeps the controller's memory reserved from
+ *                     boot, used or not; without it the core releases it.
+ *   FEATURE_HTTP      Web server: REST API (/api/...), /metrics, /events,
+ *                     mDNS. Needs ESPAsyncWebServer + AsyncTCP.
+ *   FEATURE_WEBUI     The control panel page on "/" (WebUI.h, ~7 KB of
+ *                     flash). Needs FEATURE_HTTP.
+ *   FEATURE_HISTORY   Telemetry rings for /api/history (~48 KB of RAM per
+ *                     recorded pump; HISTORY_PUMPS, default 1, records
+ *                     pumps 1..N). Needs FEATURE_HTTP.
+ *   FEATURE_MQTT      Cloud MQTT: status, deltas, energy, events,
+ *                     commands. Needs PubSubClient.
+ *   FEATURE_CONSOLE   Serial command menu. Log output is always on.
+ *   FEATURE_HEX_LOG   Compiles LOG_TRACE in: a hex dump of every frame
+ *                     sent and received, plus its header line. Off, the
+ *                     most a build logs is LOG_DEBUG (decoded replies).
+ *
+ * LOGGING (Log.h): LOG_LEVEL_DEFAULT is what shows from boot ('log
+ * LEVEL' changes it until the next one). Besides Serial, log lines can
+ * go to a syslog server (LOG_SYSLOG_HOST) and to MQTT .../log
+ * (LOG_MQTT_LEVEL).
+ *
+ * MQTT: MQTT_DEFAULT_* are the broker, credentials and site a unit
+ * uses until others are saved in NVS (MqttConfig.h).
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+// =============================================
+// BUILD PROFILE
+// =============================================
+#define PROFILE_FULL    0
+#define PROFILE_BRIDGE  1
+#define PROFILE_LOCAL   2
+
+#ifndef FLEXPOOL_PROFILE
+#define FLEXPOOL_PROFILE  PROFILE_FULL
+#endif
+
+#if FLEXPOOL_PROFILE == PROFILE_BRIDGE
+#define PROFILE_NAME      "bridge"
+#define PROFILE_BLE       0
+#define PROFILE_HTTP      0
+#define PROFILE_MQTT      1
+#define PROFILE_HEX_LOG   0
+#define PROFILE_LOG_LEVEL LOG_INFO    // Connects, commands, warnings; no per-frame lines
+#ifndef OUTQ_LEN
+#define OUTQ_LEN          64      // ~25 KB: rides out a longer broker outage in RAM
+#endif
+#elif FLEXPOOL_PROFILE == PROFILE_LOCAL
+#define PROFILE_NAME      "local"
+#define PROFILE_BLE       1
+#define PROFILE_HTTP      1
+#define PROFILE_MQTT      0
+#define PROFILE_HEX_LOG   1
+#define PROFILE_LOG_LEVEL LOG_TRACE
+#elif FLEXPOOL_PROFILE == PROFILE_FULL
+#define PROFILE_NAME      "full"
+#define PROFILE_BLE       1
+#define PROFILE_HTTP      1
+#define PROFILE_MQTT      1
+#define PROFILE_HEX_LOG   1
+#define PROFILE_LOG_LEVEL LOG_TRACE
+#else
+#error "FLEXPOOL_PROFILE must be PROFILE_FULL, PROFILE_BRIDGE or PROFILE_LOCAL"
+#endif
+
+// =============================================
+// FEATURES (profile defaults, each one overridable)
+// =============================================
+#ifndef FEATURE_BLE
+#define FEATURE_BLE       PROFILE_BLE
+#endif
+#ifndef FEATURE_HTTP
+#define FEATURE_HTTP      PROFILE_HTTP
+#endif
+#ifndef FEATURE_WEBUI
+#define FEATURE_WEBUI     FEATURE_HTTP
+#endif
+#ifndef FEATURE_HISTORY
+#define FEATURE_HISTORY   FEATURE_HTTP
+#endif
+#ifndef FEATURE_MQTT
+#define FEATURE_MQTT      PROFILE_MQTT
+#endif
+#ifndef FEATURE_CONSOLE
+#define FEATURE_CONSOLE   1
+#endif
+#ifndef FEATURE_HEX_LOG
+#define FEATURE_HEX_LOG   PROFILE_HEX_LOG
+#endif
+
+// =============================================
+// LOGGING (levels: Log.h, which reads these - keep Config.h first)
+// =============================================
+#ifndef LOG_LEVEL_MAX
+#if FEATURE_HEX_LOG
+#define LOG_LEVEL_MAX      LOG_TRACE
+#else
+#define LOG_LEVEL_MAX      LOG_DEBUG
+#endif
+#endif
+#ifndef LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_DEFAULT  PROFILE_LOG_LEVEL   // Capped at LOG_LEVEL_MAX
+#endif
+#ifndef LOG_SYSLOG_HOST
+#define LOG_SYSLOG_HOST    ""                  // Syslog server (name or IP), "" = off
+#endif
+#ifndef LOG_SYSLOG_PORT
+#define LOG_SYSLOG_PORT    514
+#endif
+#ifndef LOG_SYSLOG_LEVEL
+#define LOG_SYSLOG_LEVEL   LOG_INFO
+#endif
+#if FEATURE_MQTT && !defined(LOG_MQTT_LEVEL)
+#define LOG_MQTT_LEVEL     LOG_WARN            // Published on .../log, 0 = off
+#endif
+
+#if FEATURE_WEBUI && !FEATURE_HTTP
+#error "FEATURE_WEBUI needs FEATURE_HTTP"
+#endif
+#if FEATURE_HISTORY && !FEATURE_HTTP
+#error "FEATURE_HISTORY needs FEATURE_HTTP (/api/history is its only reader)"
+#endif
+
+// =============================================
+// WIFI (used when nothing is saved in NVS yet)
+// =============================================
+// For builds without BLE: bake the site's network in, or use
+// 'wifi join SSID PASSWORD' on the console once.
+#ifndef WIFI_DEFAULT_SSID
+#define WIFI_DEFAULT_SSID  ""
+#endif
+#ifndef WIFI_DEFAULT_PASS
+#define WIFI_DEFAULT_PASS  ""
+#endif
+
+#if !FEATURE_BLE && !FEATURE_CONSOLE
+static_assert(sizeof(WIFI_DEFAULT_SSID) > 1,
+              "without BLE or the console, WIFI_DEFAULT_SSID is the only way onto WiFi");
+#endif
+
+// =============================================
+// MQTT (used when nothing is saved in NVS yet, MqttConfig.h)
+// =============================================
+// A fleet build bakes its broker and site in here; single units use
+// 'mqtt broker ...' on the console, POST /api/mqtt or the BLE setup.
+#ifndef MQTT_DEFAULT_BROKER
+#define MQTT_DEFAULT_BROKER  "mqtt://broker.hivemq.com:1883"   // Public, no signup
+#endif
+#ifndef MQTT_DEFAULT_USER
+#define MQTT_DEFAULT_USER    ""
+#endif
+#ifndef MQTT_DEFAULT_PASS
+#define MQTT_DEFAULT_PASS    ""
+#endif
+#ifndef MQTT_DEFAULT_SITE
+#define MQTT_DEFAULT_SITE    ""        // Topic level above the device ID, "" = none
+#endif
+#ifndef MQTT_DEFAULT_CA
+#define MQTT_DEFAULT_CA      ""        // PEM root for mqtts://, "" = not verified
+#endif
+
+// =============================================
+// PIN CONFIGURATION
+// =============================================
+#ifndef RS485_TX_PIN
+#define RS485_TX_PIN    18    // ESP32 TX -> MAX3485 DI
+#endif
+#ifndef RS485_RX_PIN
+#define RS485_RX_PIN    19    // ESP32 RX <- MAX3485 RO
+#endif
+#ifndef RS485_DE_RE_PIN
+#define RS485_DE_RE_PIN 4     // ESP32 -> MAX3485 DE & RE
+#endif
+
+// =============================================
+// COMMUNICATION SETTINGS
+// =============================================
+#define RS485_BAUD  9600      // Pentair uses 9600 baud, 8N1
+#ifndef USB_BAUD
+#define USB_BAUD    115200    // USB Serial Monitor speed
+#endif
+#ifndef USB_HOST_WAIT_MS
+#define USB_HOST_WAIT_MS 3000 // Native USB only: time for a plugged-in terminal to open
+#endif
+
+// mDNS hostname - access at http://flexpool.local (FEATURE_HTTP)
+#ifndef MDNS_HOSTNAME
+#define MDNS_HOSTNAME   "flexpool"
+#endif
+
+// Pumps polled from boot: bit i = ADDR_PUMP_1 + i (others are found by
+// 'scan' or when they show up on the bus)
+#ifndef PUMP_POLL_MASK
+#define PUMP_POLL_MASK  0x01
+#endif
+
+#endif // CONFIG_H
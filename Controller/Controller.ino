@@ -22,6 +22,20 @@
  *   ...repeats periodically to keep pump running...
  *   To stop: Set drive stop (CMD 0x06, data=0x04), then local (CMD 0x04, data=0x00)
  * 
+ * MULTIPLE PUMPS:
+ *   Up to four IntelliFlos (0x60-0x63) can share the bus. Pumps in
+ *   PUMP_POLL_MASK, found by 'scan', or heard on the bus are polled
+ *   round-robin. Commands target the Serial-selected pump ('pump N'),
+ *   or ?pump=N on the /api/ endpoints and "pump":N in MQTT commands.
+ * 
+ * BOOT (e.g. after a brown-out):
+ *   RS-485 first: the bus runs before WiFi is even tried, and each
+ *   pump gets back what it was doing (last full-start RPM, or its
+ *   scheduled program) as soon as it answers a poll. WiFi, mDNS, the
+ *   web server and MQTT come up in the background whenever the AP is
+ *   there. Serial output isn't held back for a terminal either, except
+ *   on native-USB boards with a host plugged in.
+ * 
  * Wiring:
  *   ESP32 GPIO 18 --> MAX3485 DI
  *   ESP32 GPIO 19 <-- MAX3485 RO
@@ -31,354 +45,1009 @@
  *   MAX3485 A     --> (wire to Pump ESP32's MAX3485 A)
  *   MAX3485 B     --> (wire to Pump ESP32's MAX3485 B)
  *   120 ohm resistor between A and B (termination)
+ * 
+ * BUILD PROFILES (Config.h):
+ *   PROFILE_FULL (default) has everything. PROFILE_BRIDGE is a headless
+ *   RS-485 -> MQTT bridge (no BLE, no web server), PROFILE_LOCAL a LAN
+ *   panel without cloud MQTT. Features can also be toggled one by one;
+ *   what is off isn't compiled or linked.
+ * 
+ * LOGGING (Log.h):
+ *   Leveled (error / warn / info / debug / trace) and non-blocking: the
+ *   bus task only formats a line into a RAM ring, a low-priority task
+ *   writes it out. 'log LEVEL' on the console picks what is shown; at
+ *   debug every reply is one decoded line, at trace the frames come in
+ *   hex too. Syslog and MQTT .../log can get a copy (Config.h).
+ * 
+ * MQTT (MQTTHandler.h, MqttConfig.h):
+ *   Broker (mqtt:// or mqtts://), login and site are kept in NVS and
+ *   set with 'mqtt ...', POST /api/mqtt or the BLE setup. Topics live
+ *   under flexpool/{site}/{full MAC}/, and every unit sends a compact
+ *   rollup that matches flexpool/+/summary for fleet dashboards.
+ * 
+ * REQUIRES: ESPAsyncWebServer + AsyncTCP libraries (FEATURE_HTTP)
+ *   Arduino IDE → Sketch → Include Library → Manage Libraries
+ *   Search "ESPAsyncWebServer" (ESP32Async) → Install (pulls in AsyncTCP)
+ *   PubSubClient for FEATURE_MQTT (see MQTTHandler.h)
+ *   History and RS-485 captures are kept in LittleFS (part of the ESP32 core): pick a
+ *   partition scheme with a SPIFFS/LittleFS partition.
  */
 
+// Features, pins, baud rates, PUMP_POLL_MASK: see Config.h
+#include "Config.h"
+#include "Log.h"
 #include <WiFi.h>
-#include <WebServer.h>
+#if FEATURE_HTTP
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
 #include <ESPmDNS.h>
+#endif
 #include <HardwareSerial.h>
 #include "PentairProtocol.h"
 #include "PumpStatus.h"
-#include "BLESetup.h"
+#include "BLESetup.h"          // WiFi credentials; BLE provisioning with FEATURE_BLE
+#include "StatusFormat.h"
+#if FEATURE_MQTT
 #include "MQTTHandler.h"
+#endif
+#if FEATURE_HTTP
+#include "LiveStatus.h"
+#endif
+#if FEATURE_HISTORY
+#include "History.h"
+#endif
+#include "Energy.h"
+#include "Schedule.h"
+#include "LoopEvents.h"
+#include "BusMetrics.h"
+#include "CommandSequencer.h"
+#include "RS485Bus.h"
+#include "Capture.h"
+#include "Backoff.h"
+#include "Syslog.h"
+#if FEATURE_WEBUI
 #include "WebUI.h"
+#endif
 
-// mDNS hostname - access at http://flexpool.local
-const char* MDNS_HOSTNAME = "flexpool";
+// Log lines: ring + drain task (Log.h), from any task
+Logger logger;
 
 // =============================================
-// PIN CONFIGURATION
+// OUR ADDRESSES
 // =============================================
-#define RS485_TX_PIN    18    // ESP32 TX -> MAX3485 DI
-#define RS485_RX_PIN    19    // ESP32 RX <- MAX3485 RO
-#define RS485_DE_RE_PIN 4     // ESP32 -> MAX3485 DE & RE
+constexpr uint8_t controllerAddr = ADDR_REMOTE_CONTROLLER;  // 0x20
+uint8_t pumpAddr = ADDR_PUMP_1;                              // 0x60 - default command target
 
 // =============================================
-// COMMUNICATION SETTINGS
+// FIXED FRAMES (built at compile time)
 // =============================================
-#define RS485_BAUD  9600      // Pentair uses 9600 baud, 8N1
-#define USB_BAUD    115200    // USB Serial Monitor speed
+// Every frame without a variable payload, per pump, checksum included.
+// Sending one is a plain copy into the bus queue.
+struct PumpFrames {
+  PentairFixedFrame query;    // CMD_STATUS
+  PentairFixedFrame remote;   // CMD_CTRL  [CTRL_REMOTE]
+  PentairFixedFrame local;    // CMD_CTRL  [CTRL_LOCAL]
+  PentairFixedFrame start;    // CMD_RUN   [RUN_START]
+  PentairFixedFrame stop;     // CMD_RUN   [RUN_STOP]
+};
 
-// =============================================
-// OUR ADDRESSES
-// =============================================
-uint8_t controllerAddr = ADDR_REMOTE_CONTROLLER;  // 0x20
-uint8_t pumpAddr       = ADDR_PUMP_1;              // 0x60
+#define PUMP_FRAMES(addr) {                                        \
+    pentairFixedFrame(addr, controllerAddr, CMD_STATUS),           \
+    pentairFixedFrame(addr, controllerAddr, CMD_CTRL, CTRL_REMOTE), \
+    pentairFixedFrame(addr, controllerAddr, CMD_CTRL, CTRL_LOCAL),  \
+    pentairFixedFrame(addr, controllerAddr, CMD_RUN, RUN_START),    \
+    pentairFixedFrame(addr, controllerAddr, CMD_RUN, RUN_STOP) }
 
-// =============================================
-// BUFFERS
-// =============================================
-uint8_t txBuffer[48];   // Outgoing packet
-uint8_t rxBuffer[96];   // Incoming response buffer
-size_t  rxLen = 0;
+static_assert(PUMP_COUNT == 4, "pumpFrames[] needs one entry per pump");
+constexpr PumpFrames pumpFrames[PUMP_COUNT] = {
+  PUMP_FRAMES(ADDR_PUMP_1), PUMP_FRAMES(ADDR_PUMP_2),
+  PUMP_FRAMES(ADDR_PUMP_3), PUMP_FRAMES(ADDR_PUMP_4)
+};
 
 // =============================================
-// STATE (tracked for web UI display)
+// STATE (owned by the RS-485 bus task)
 // =============================================
-bool remoteControlActive = false;
+// Written only from the bus task (reply parsing, sequence callbacks).
+// Other tasks read a consistent copy via bus.snapshot().
+// Pump registry, indexed by pumpIndex(addr) (struct defined in PumpStatus.h)
+PumpStatus pumps[PUMP_COUNT];
 
-// Pump status (struct defined in PumpStatus.h, shared with MQTTHandler)
-PumpStatus pumpStatus;
+// RS-485 transport, runs in its own FreeRTOS task
+RS485Bus bus(UART_NUM_2);
 
-// Web server on port 80
-WebServer server(80);
+#if FEATURE_HTTP
+// Web server on port 80. Requests are handled on the AsyncTCP task,
+// several connections at once, never on loop() or the bus task.
+AsyncWebServer server(80);
 
+// Set by GET /wifi/reset: loop() clears credentials and restarts once the
+// response has gone out (the web task must not block)
+unsigned long wifiResetAt = 0;
+
+// Set by POST / PUT /api/mqtt: loop() restarts onto the saved settings
+unsigned long restartAt = 0;
+
+// Status pushed to local browsers on /events
+LiveStatus live;
+#endif
+
+#if FEATURE_BLE
 // BLE provisioning handler
 BLESetup bleSetup;
+#endif
 
+#if FEATURE_MQTT
 // MQTT handler for remote control
 MQTTHandler mqtt;
+#endif
+
+#if FEATURE_HISTORY
+// Telemetry history (1 s / 1 min / 15 min rings), served on /api/history
+History history;
+#endif
+
+// Every RS-485 frame (RAM ring, LittleFS when recording), /api/capture + replay
+Capture capture;
+
+// kWh per pump (day / week / lifetime, per RPM band), kept in NVS
+EnergyMeter energy;
 
-// Auto-query timer
-unsigned long lastAutoQuery = 0;
-#define AUTO_QUERY_INTERVAL  5000  // Query pump status every 5 seconds when running
+// Time-of-day rules driving the pumps' external programs (+ keep-alive)
+Schedule schedule;
+
+// What loop() sleeps on between events (bus, Serial, MQTT socket, WiFi)
+LoopEvents loopEvents;
+
+// Longest recent loop() iteration (µs), on /metrics and .../diagnostics
+PeakTracker loopPeak;
+
+uint16_t sequenceRPM[PUMP_COUNT] = {0};   // Target of each pump's full start
+
+// Adaptive status poller (bus task)
+// Polls fast while a pump is changing, then backs off exponentially.
+#define POLL_MIN_INTERVAL      500    // Ramping, just commanded, or faulted
+#define POLL_MAX_INTERVAL      10000  // Slowest poll while running and steady
+#define POLL_STOPPED_INTERVAL  STATUS_QUERY_INTERVAL  // Heartbeat while stopped / not answering
+#define POLL_RPM_DEADBAND      20     // RPM change that still counts as "moving"
+#define POLL_WATTS_DEADBAND    15     // Watts change that still counts as "moving"
+#define AUTO_QUERY_GAP         100    // Min spacing between polls (leaves room for commands)
+unsigned long lastPollSent = 0;
+uint8_t       pollCursor   = 0;    // Next registry slot to look at
 
 // Track WiFi state
-bool wifiConnected = false;
+#define WIFI_RETRY_MIN_MS   15000     // Kick a stuck reconnect after 7.5-15 s...
+#define WIFI_RETRY_MAX_MS   300000    // ...backing off to 2.5-5 min
+bool wifiConnected = false;           // Services started (stays true across drops)
+volatile bool    wifiLinkUp = false;  // Station has an IP (WiFi events)
+volatile uint8_t wifiDropReason = 0;  // Last STA_DISCONNECTED reason code
+unsigned long wifiStartedAt = 0;      // (Re)connecting since, 0 = up or not configured
+bool wifiSlowReported = false;
+Backoff wifiRetry(WIFI_RETRY_MIN_MS, WIFI_RETRY_MAX_MS);
+
+// Last full start per pump (NVS), restarted after a reboot
+#define LASTRUN_PREFS_NAMESPACE "lastrun"
+#define LASTRUN_PREFS_KEY       "rpm"
+uint16_t     lastRunRPM[PUMP_COUNT] = {0};   // 0 = stopped, or on the schedule
+uint8_t      resumePending = 0;              // Pumps to restore once they answer (bit = slot)
+portMUX_TYPE lastRunMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Network info for /api/status, read once per connection instead of
+// opening NVS (saved SSID) and formatting the IP on every request
+char netSSID[33] = "";
+char netIP[16]   = "";
 
 // =============================================
 // SETUP
 // =============================================
 void setup() {
   Serial.begin(USB_BAUD);
-  delay(3000);
+  waitForUsbHost();
   
-  // RS-485 direction control
-  pinMode(RS485_DE_RE_PIN, OUTPUT);
-  digitalWrite(RS485_DE_RE_PIN, LOW);  // Start in receive mode
+  printBanner();
   
-  // RS-485 UART (Pentair: 9600 baud, 8N1)
-  Serial2.begin(RS485_BAUD, SERIAL_8N1, RS485_RX_PIN, RS485_TX_PIN);
+  // Log lines go through the drain task from here on
+  logger.begin();
+  if (LOG_SYSLOG_HOST[0]) logger.addSink(Syslog::sink, LOG_SYSLOG_LEVEL);
+#if FEATURE_MQTT && LOG_MQTT_LEVEL
+  logger.addSink(MQTTHandler::logSink, LOG_MQTT_LEVEL);
+#endif
   
-  printBanner();
+  // Wake sources for loop() + CPU frequency scaling
+  loopEvents.begin();
+  
+  for (int i = 0; i < PUMP_COUNT; i++) {
+    pumps[i].present = (PUMP_POLL_MASK >> i) & 1;
+  }
+  
+  // RS-485 UART + direction pin, serviced by the bus task from here on
+  bus.begin(RS485_BAUD, RS485_RX_PIN, RS485_TX_PIN, RS485_DE_RE_PIN);
   
   // ---- RS-485 is now READY ----
   // Serial commands and RS-485 work immediately, even without WiFi!
   Serial.println("[RS-485] Ready! You can send commands via Serial Monitor now.");
   Serial.println();
   
+  // Reload saved history from LittleFS and energy totals from NVS;
+  // sampling starts in loop()
+#if FEATURE_HISTORY
+  history.begin();
+#endif
+  capture.begin(RS485_BAUD);
+  energy.begin();
+  schedule.begin();
+  
+  // What each pump was doing before the reboot (restored by loop())
+  loadLastRun();
+  
   // ---- WiFi Setup (optional — RS-485 works without it) ----
-  if (BLESetup::hasSavedCredentials()) {
-    // Try connecting with saved credentials
-    if (BLESetup::connectSaved()) {
-      wifiConnected = true;
-      startWiFiServices();
-    } else {
-      Serial.println("[WiFi] Saved credentials failed. WiFi disabled.");
-      Serial.println("[WiFi] Type 'reset' to clear credentials and restart BLE setup.");
-      Serial.println("[WiFi] RS-485 commands still work without WiFi!\n");
-    }
+  // In the background: loop() starts the services once it connects
+  WiFi.onEvent(onWiFiEvent);
+  if (BLESetup::beginSaved()) {
+    Serial.println(" (in the background)");
+    wifiStartedAt = millis();
+    wifiRetry.fail();
   } else {
     Serial.println("[WiFi] No saved credentials. WiFi/MQTT disabled.");
+#if FEATURE_BLE
     Serial.println("[WiFi] Type 'setup' to start Bluetooth WiFi setup.");
+#elif FEATURE_CONSOLE
+    Serial.println("[WiFi] Type 'wifi join SSID PASSWORD' to connect.");
+#endif
     Serial.println("[WiFi] RS-485 commands still work without WiFi!\n");
   }
   
+#if FEATURE_CONSOLE
   printMenu();
+#endif
+}
+
+// Native-USB boards (S2/S3/C3...): give a terminal that is plugged in
+// a moment to open the port, so the banner isn't lost. Through a
+// USB-UART bridge there is no telling, and no waiting: 'help' reprints
+// the menu.
+void waitForUsbHost() {
+#if ARDUINO_USB_CDC_ON_BOOT
+#if ARDUINO_USB_MODE
+  if (!HWCDC::isPlugged()) return;   // Powered, but no host on the other end
+#endif
+  unsigned long start = millis();
+  while (!Serial && millis() - start < USB_HOST_WAIT_MS) delay(10);
+#endif
+}
+
+// =============================================
+// WIFI LINK (events + background reconnect)
+// =============================================
+// WiFi event task: just note the link state, loop() acts on it
+// (LoopEvents wakes loop() on every WiFi event)
+void onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+  if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+    wifiLinkUp = true;
+  } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+    wifiLinkUp = false;
+    wifiDropReason = info.wifi_sta_disconnected.reason;
+  } else if (event == ARDUINO_EVENT_WIFI_STA_LOST_IP) {
+    wifiLinkUp = false;
+  }
+}
+
+/*
+ * Link changes and reconnects (loop task). Never waits: the driver's
+ * auto-reconnect normally gets the link back by itself; if it hasn't
+ * within wifiRetry, WiFi.reconnect() gives it a kick, backing off.
+ */
+void pollWiFi() {
+  static bool wasUp = false;
+  bool up = wifiLinkUp;
+  if (up != wasUp) {
+    wasUp = up;
+    if (up) {
+      LOGI("WiFi", "Connected after %lu ms, IP %s, signal %d dBm",
+           millis() - wifiStartedAt, WiFi.localIP().toString().c_str(), WiFi.RSSI());
+      wifiStartedAt = 0;
+      wifiSlowReported = false;
+      wifiRetry.reset();
+      if (!wifiConnected) {
+        wifiConnected = true;
+        startWiFiServices();
+      } else {
+        refreshNetInfo();
+#if FEATURE_MQTT
+        mqtt.onWiFiUp();
+#endif
+      }
+    } else if (wifiConnected) {
+      LOGW("WiFi", "Connection lost (reason %u), reconnecting in the background",
+           wifiDropReason);
+      wifiStartedAt = millis();
+      wifiRetry.fail();
+#if FEATURE_MQTT
+      mqtt.onWiFiDown();
+#endif
+    }
+  }
+  if (up || !wifiStartedAt) return;
+  
+  if (!wifiSlowReported && millis() - wifiStartedAt > WIFI_CONNECT_TIMEOUT * 1000UL) {
+    wifiSlowReported = true;
+    LOGW("WiFi", "Not connected yet - still trying in the background.");
+#if FEATURE_BLE
+    LOGI("WiFi", "Type 'reset' to clear credentials and restart BLE setup.");
+#elif FEATURE_CONSOLE
+    LOGI("WiFi", "Type 'wifi join SSID PASSWORD' to use another network.");
+#endif
+    LOGI("WiFi", "RS-485 commands still work without WiFi!");
+  }
+  if (wifiRetry.due()) {
+    WiFi.reconnect();
+    wifiRetry.fail();
+  }
+}
+
+// =============================================
+// LAST RUN (NVS): resume the pumps after a reboot
+// =============================================
+void loadLastRun() {
+  Preferences prefs;
+  prefs.begin(LASTRUN_PREFS_NAMESPACE, true);
+  if (prefs.getBytesLength(LASTRUN_PREFS_KEY) == sizeof(lastRunRPM)) {
+    prefs.getBytes(LASTRUN_PREFS_KEY, lastRunRPM, sizeof(lastRunRPM));
+  }
+  prefs.end();
+  for (int i = 0; i < PUMP_COUNT; i++) {
+    if (lastRunRPM[i] || schedule.resumable(i)) resumePending |= 1 << i;
+  }
+  if (resumePending) {
+    Serial.printf("[BOOT] Resuming pump(s) 0x%02X as they answer\n", resumePending);
+  }
+}
+
+// Every new command: what to resume (any task; 0 = nothing but the schedule)
+void saveLastRun(uint8_t addr, uint16_t rpm) {
+  int idx = pumpIndex(addr);
+  if (idx < 0) return;
+  portENTER_CRITICAL(&lastRunMux);
+  resumePending &= ~(1 << idx);      // Superseded
+  bool changed = lastRunRPM[idx] != rpm;
+  lastRunRPM[idx] = rpm;
+  uint16_t copy[PUMP_COUNT];
+  memcpy(copy, lastRunRPM, sizeof(copy));
+  portEXIT_CRITICAL(&lastRunMux);
+  if (!changed) return;
+  Preferences prefs;
+  prefs.begin(LASTRUN_PREFS_NAMESPACE, false);
+  prefs.putBytes(LASTRUN_PREFS_KEY, copy, sizeof(copy));
+  prefs.end();
+}
+
+// First status from a pump with something to resume (loop task)
+void resumeLastRun(const BusSnapshot& snap) {
+  for (int i = 0; i < PUMP_COUNT; i++) {
+    portENTER_CRITICAL(&lastRunMux);
+    bool due = (resumePending >> i & 1) && snap.pumps[i].valid;
+    if (due) resumePending &= ~(1 << i);
+    uint16_t rpm = lastRunRPM[i];
+    portEXIT_CRITICAL(&lastRunMux);
+    if (!due) continue;
+    if (rpm) {
+      LOGI("BOOT", "Pump 0x%02X: resuming %u RPM", pumpAddress(i), rpm);
+      runFullSpeedSequence(pumpAddress(i), rpm);
+    } else {
+      schedule.resume(i);
+    }
+  }
 }
 
 // =============================================
 // START WIFI SERVICES (mDNS, web server, MQTT)
 // =============================================
 void startWiFiServices() {
+#if FEATURE_HTTP
   // Setup mDNS (http://flexpool.local)
   if (MDNS.begin(MDNS_HOSTNAME)) {
-    Serial.printf("[WiFi] mDNS started: http://%s.local\n", MDNS_HOSTNAME);
+    LOGI("WiFi", "mDNS started: http://%s.local", MDNS_HOSTNAME);
     MDNS.addService("http", "tcp", 80);
   } else {
-    Serial.println("[WiFi] mDNS failed to start");
+    LOGW("WiFi", "mDNS failed to start");
   }
+#endif
   
-  // Setup web server routes
-  setupWebServer();
-  server.begin();
-  Serial.println("[WiFi] Web server started on port 80");
+  // Local time for the schedule (and history / energy timestamps)
+  scheduleStartClock();
   
+#if FEATURE_MQTT
   // Start MQTT for remote control
   mqtt.begin();
+#endif
+  
+  refreshNetInfo();
+  
+#if FEATURE_HTTP
+  // Setup web server routes
+  setupWebServer();
+  live.begin(server);
+  server.begin();
+  LOGI("WiFi", "Web server started on port 80");
+#endif
+}
+
+// Cache SSID / IP for the web handlers (after every (re)connect)
+void refreshNetInfo() {
+  snprintf(netSSID, sizeof(netSSID), "%s", BLESetup::getSavedSSID().c_str());
+  snprintf(netIP, sizeof(netIP), "%s", WiFi.localIP().toString().c_str());
 }
 
 // =============================================
 // LOOP
 // =============================================
 void loop() {
-  // Handle web server requests (only if WiFi connected)
+  // Sleep until the bus, Serial, the MQTT socket or WiFi has news, or the
+  // next history sample is due (at most a second, see LoopEvents.h)
+  unsigned long due = capture.msUntilDue();
+#if FEATURE_HISTORY
+  if (history.msUntilDue() < due) due = history.msUntilDue();
+#endif
+#if FEATURE_MQTT
+  if (wifiConnected && mqtt.msUntilDue() < due) due = mqtt.msUntilDue();
+#endif
+  loopEvents.wait(due);
+  uint32_t woke = micros();
+  
+  // WiFi link up / down, background reconnect
+  pollWiFi();
+  
+#if FEATURE_MQTT
+  // Web requests are served by the AsyncTCP task; only MQTT runs here
   if (wifiConnected) {
-    server.handleClient();
     mqtt.loop();
+    loopEvents.watchSocket(mqtt.socketFd());
   }
+#endif
   
+#if FEATURE_HTTP
+  // /wifi/reset was requested: give the response a second to go out
+  if (wifiResetAt && millis() - wifiResetAt > 1000) {
+    BLESetup::clearCredentials();
+    delay(500);
+    ESP.restart();
+  }
+  if (restartAt && millis() - restartAt > 1000) {
+    ESP.restart();
+  }
+#endif
+  
+#if FEATURE_HISTORY
+  // Once a second: sample the pumps into the history rings
+  history.loop();
+#endif
+  
+  // Capture to LittleFS, replayed frames to the bus task
+  capture.loop();
+  
+#if FEATURE_CONSOLE
   // Check for user input from Serial Monitor
-  if (Serial.available()) {
+  while (Serial.available()) {
     String input = Serial.readStringUntil('\n');
     input.trim();
     if (input.length() > 0) {
       handleSerialCommand(input);
     }
   }
-  
-  // Check for RS-485 responses from pump
-  if (Serial2.available()) {
-    delay(200);  // Wait 200ms for full packet to arrive
-    rxLen = 0;
-    while (Serial2.available() && rxLen < sizeof(rxBuffer)) {
-      rxBuffer[rxLen++] = Serial2.read();
-    }
-    
-    if (rxLen > 0) {
-      Serial.println("\n--- PUMP RESPONSE ---");
-      printPacketHex("RX", rxBuffer, rxLen);
-      parseAndDisplayResponse(rxBuffer, rxLen);
-      Serial.println("---------------------\n");
-      if (wifiConnected) mqtt.publishStatus();  // Push update to cloud
-      printMenu();
+#endif
+  
+  // Whenever the bus task reports new data: account the energy, push
+  // an update to the cloud and to local browsers
+  static uint32_t lastBusUpdate = 0;
+  uint32_t busUpdate = bus.updateCount();
+  if (busUpdate != lastBusUpdate) {
+    lastBusUpdate = busUpdate;
+    BusSnapshot snap = bus.snapshot();
+    if (resumePending && !snap.replay) resumeLastRun(snap);
+    energy.update(snap);
+    if (wifiConnected) {
+#if FEATURE_MQTT
+      mqtt.publishStatus();
+#endif
+#if FEATURE_HTTP
+      live.publish(snap);
+#endif
     }
   }
+  energy.loop();
   
-  // Auto-query pump status periodically (when running)
-  if (pumpStatus.running && millis() - lastAutoQuery > AUTO_QUERY_INTERVAL) {
-    sendStatusQuery();
-    lastAutoQuery = millis();
-  }
+  // Start / end scheduled programs (the keep-alive runs on the bus task).
+  // Held while listen-only (e.g. a replay): the bus would refuse them.
+  if (!bus.listenOnly()) schedule.loop();
   
-  // Keep WiFi alive (only if we were connected before)
-  if (wifiConnected && WiFi.status() != WL_CONNECTED) {
-    static unsigned long lastReconnect = 0;
-    if (millis() - lastReconnect > 30000) {  // Try every 30 seconds
-      Serial.println("[WiFi] Connection lost, reconnecting...");
-      BLESetup::connectSaved();
-      lastReconnect = millis();
-    }
-  }
+  loopPeak.record(micros() - woke);
 }
 
+#if FEATURE_HTTP
 // =============================================
 // WEB SERVER ROUTES
 // =============================================
+// Handlers run on the AsyncTCP task: they only read bus.snapshot() and
+// queue work with bus.submit(), never touch the UART or wait.
 void setupWebServer() {
-  // Serve the HTML control panel (inject device ID for MQTT)
-  server.on("/", HTTP_GET, []() {
-    String html = String(WEBUI_HTML);
-    html.replace("%%DEVICE_ID%%", mqtt.getDeviceId());
-    server.send(200, "text/html", html);
+#if FEATURE_WEBUI
+  // Serve the HTML control panel straight from flash, gzip'd.
+  // "no-cache" = revalidate every time; an unchanged page is a bodiless 304.
+  server.on("/", HTTP_GET, [](AsyncWebServerRequest* request) {
+    if (request->hasHeader("If-None-Match") &&
+        request->header("If-None-Match") == WEBUI_ETAG) {
+      request->send(304);
+      return;
+    }
+    AsyncWebServerResponse* response =
+      request->beginResponse_P(200, "text/html", WEBUI_HTML_GZ, WEBUI_HTML_GZ_LEN);
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", WEBUI_ETAG);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
   });
+#endif
   
-  // GET /api/status - Returns current pump status as JSON
+  // GET /api/status - Returns current pump status as JSON (or CBOR, see handleApiStatus)
+  // (the Web UI reads it once, then follows /events - see LiveStatus.h)
   server.on("/api/status", HTTP_GET, handleApiStatus);
   
+#if FEATURE_HISTORY
+  // GET /api/history?pump=N&from=T&to=T&res=1|60|900 - Recorded samples,
+  // streamed (see History.h)
+  server.on("/api/history", HTTP_GET, handleApiHistory);
+#endif
+  
+  // GET /api/energy?pump=N - kWh today / this week / lifetime, per RPM band
+  server.on("/api/energy", HTTP_GET, [](AsyncWebServerRequest* request) {
+    uint8_t addr = apiPumpAddr(request);
+    if (!addr) return;
+    AsyncResponseStream* response = request->beginResponseStream("application/json");
+    energy.printJson(*response, pumpIndex(addr));
+    request->send(response);
+  });
+  
+  // GET /metrics - Bus health, reply latency, utilisation (Prometheus text, see BusMetrics.h)
+  server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest* request) {
+    AsyncResponseStream* response = request->beginResponseStream("text/plain; version=0.0.4");
+    printPrometheus(*response, bus.metrics(), loopPeak.peak());
+    request->send(response);
+  });
+  
+  // GET /api/capture - Stored RS-485 capture (.fpc, see CaptureFormat.h)
+  // ?live=S: live frames for S seconds instead
+  server.on("/api/capture", HTTP_GET, [](AsyncWebServerRequest* request) {
+    const AsyncWebParameter* live = apiArg(request, "live");
+    request->send(live ? capture.streamLive(request, live->value().toInt())
+                       : capture.streamStored(request));
+  });
+  
+  // POST /api/capture - ?record=1|0 (LittleFS recording), ?clear=1
+  server.on("/api/capture", HTTP_POST, [](AsyncWebServerRequest* request) {
+    const AsyncWebParameter* arg;
+    if ((arg = apiArg(request, "record"))) {
+      capture.requestRecording(arg->value().toInt());
+      sendJsonResponse(request, true, arg->value().toInt() ? "recording" : "recording stopped");
+    } else if ((arg = apiArg(request, "clear")) && arg->value().toInt()) {
+      capture.requestClear();
+      sendJsonResponse(request, true, "capture cleared");
+    } else {
+      sendJsonResponse(request, false, "record=1|0 or clear=1");
+    }
+  });
+  
+  // PUT /api/capture - Body is an .fpc file to replay on this unit
+  server.on("/api/capture", HTTP_PUT, [](AsyncWebServerRequest* request) {
+    bool ok = capture.uploadValid();
+    sendJsonResponse(request, ok, ok ? "capture stored for replay" : "not a capture file");
+  }, nullptr, [](AsyncWebServerRequest*, uint8_t* data, size_t len, size_t index, size_t total) {
+    capture.uploadChunk(data, len, index, total);
+  });
+  
+  // POST /api/replay - ?speed=N (x wire speed, 0 = flat out, default 1), or ?stop=1
+  server.on("/api/replay", HTTP_POST, [](AsyncWebServerRequest* request) {
+    const AsyncWebParameter* arg;
+    if ((arg = apiArg(request, "stop")) && arg->value().toInt()) {
+      capture.requestStop();
+      sendJsonResponse(request, true, "replay stopped");
+      return;
+    }
+    if (schedule.programRunning()) {
+      sendJsonResponse(request, false, "a scheduled program is running (it would lapse)");
+      return;
+    }
+    int speed = (arg = apiArg(request, "speed")) ? arg->value().toInt() : 1;
+    capture.requestReplay(constrain(speed, 0, 1000));
+    sendJsonResponse(request, true, "replay starting (bus is listen-only until it ends)");
+  });
+  
+  // GET /api/schedule - Rules, and which one each pump is running
+  server.on("/api/schedule", HTTP_GET, [](AsyncWebServerRequest* request) {
+    char json[1536];
+    if (!schedule.formatJson(json, sizeof(json))) {
+      sendJsonResponse(request, false, "schedule too large");
+      return;
+    }
+    request->send(200, "application/json", json);
+  });
+  
+  // POST /api/schedule?slot=1-8&start=HH:MM&end=HH:MM&rpm=N
+  //                   [&pump=N&days=12345&program=1-4&enabled=0|1]
+  // or ?slot=N&clear=1 to delete a rule
+  server.on("/api/schedule", HTTP_POST, handleApiSchedulePost);
+  
+  // Every /api/* command takes an optional ?pump=N (1-4, default: selected pump)
+  
   // POST /api/remote - Set remote control
-  server.on("/api/remote", HTTP_POST, []() {
-    sendRemoteControl();
-    sendJsonResponse(true, "Remote control set");
+  server.on("/api/remote", HTTP_POST, [](AsyncWebServerRequest* request) {
+    uint8_t addr = apiPumpAddr(request);
+    if (!addr) return;
+    sendRemoteControl(addr);
+    sendJsonResponse(request, true, "Remote control set");
   });
   
   // POST /api/local - Set local control
-  server.on("/api/local", HTTP_POST, []() {
-    sendLocalControl();
-    sendJsonResponse(true, "Local control set");
+  server.on("/api/local", HTTP_POST, [](AsyncWebServerRequest* request) {
+    uint8_t addr = apiPumpAddr(request);
+    if (!addr) return;
+    sendLocalControl(addr);
+    sendJsonResponse(request, true, "Local control set");
   });
   
   // POST /api/start - Start pump motor
-  server.on("/api/start", HTTP_POST, []() {
-    sendRunPump(true);
-    sendJsonResponse(true, "Start command sent");
+  server.on("/api/start", HTTP_POST, [](AsyncWebServerRequest* request) {
+    uint8_t addr = apiPumpAddr(request);
+    if (!addr) return;
+    sendRunPump(addr, true);
+    sendJsonResponse(request, true, "Start command sent");
   });
   
   // POST /api/stop - Stop pump motor
-  server.on("/api/stop", HTTP_POST, []() {
-    sendRunPump(false);
-    sendJsonResponse(true, "Stop command sent");
+  server.on("/api/stop", HTTP_POST, [](AsyncWebServerRequest* request) {
+    uint8_t addr = apiPumpAddr(request);
+    if (!addr) return;
+    sendRunPump(addr, false);
+    sendJsonResponse(request, true, "Stop command sent");
   });
   
   // POST /api/query - Query pump status
-  server.on("/api/query", HTTP_POST, []() {
-    sendStatusQuery();
-    sendJsonResponse(true, "Status query sent");
+  server.on("/api/query", HTTP_POST, [](AsyncWebServerRequest* request) {
+    uint8_t addr = apiPumpAddr(request);
+    if (!addr) return;
+    sendStatusQuery(addr);
+    sendJsonResponse(request, true, "Status query sent");
   });
   
   // POST /api/rpm?value=XXXX - Set RPM directly
-  server.on("/api/rpm", HTTP_POST, []() {
-    if (!server.hasArg("value")) {
-      sendJsonResponse(false, "Missing 'value' parameter");
+  server.on("/api/rpm", HTTP_POST, [](AsyncWebServerRequest* request) {
+    uint8_t addr = apiPumpAddr(request);
+    if (!addr) return;
+    const AsyncWebParameter* value = apiArg(request, "value");
+    if (!value) {
+      sendJsonResponse(request, false, "Missing 'value' parameter");
       return;
     }
-    int rpm = server.arg("value").toInt();
+    int rpm = value->value().toInt();
     if (rpm < 450 || rpm > 3450) {
-      sendJsonResponse(false, "RPM must be 450-3450");
+      sendJsonResponse(request, false, "RPM must be 450-3450");
       return;
     }
-    sendSetRPM(rpm);
+    sendSetRPM(addr, rpm);
     char msg[40];
     snprintf(msg, sizeof(msg), "RPM set to %d", rpm);
-    sendJsonResponse(true, msg);
+    sendJsonResponse(request, true, msg);
   });
   
   // POST /api/fullstart?rpm=XXXX - Full start sequence
-  server.on("/api/fullstart", HTTP_POST, []() {
-    if (!server.hasArg("rpm")) {
-      sendJsonResponse(false, "Missing 'rpm' parameter");
+  server.on("/api/fullstart", HTTP_POST, [](AsyncWebServerRequest* request) {
+    uint8_t addr = apiPumpAddr(request);
+    if (!addr) return;
+    const AsyncWebParameter* rpmArg = apiArg(request, "rpm");
+    if (!rpmArg) {
+      sendJsonResponse(request, false, "Missing 'rpm' parameter");
       return;
     }
-    int rpm = server.arg("rpm").toInt();
+    int rpm = rpmArg->value().toInt();
     if (rpm < 450 || rpm > 3450) {
-      sendJsonResponse(false, "RPM must be 450-3450");
+      sendJsonResponse(request, false, "RPM must be 450-3450");
       return;
     }
-    runFullSpeedSequence(rpm);
+    runFullSpeedSequence(addr, rpm);
     char msg[50];
-    snprintf(msg, sizeof(msg), "Full start sequence sent (%d RPM)", rpm);
-    sendJsonResponse(true, msg);
+    snprintf(msg, sizeof(msg), "Full start sequence started (%d RPM)", rpm);
+    sendJsonResponse(request, true, msg);
   });
   
   // POST /api/fullstop - Full stop sequence
-  server.on("/api/fullstop", HTTP_POST, []() {
-    runFullStopSequence();
-    sendJsonResponse(true, "Full stop sequence sent");
+  server.on("/api/fullstop", HTTP_POST, [](AsyncWebServerRequest* request) {
+    uint8_t addr = apiPumpAddr(request);
+    if (!addr) return;
+    runFullStopSequence(addr);
+    sendJsonResponse(request, true, "Full stop sequence started");
   });
   
   // GET /wifi/reset - Clear saved WiFi credentials and reboot into BLE setup mode
-  server.on("/wifi/reset", HTTP_GET, []() {
-    server.send(200, "text/html",
+  server.on("/wifi/reset", HTTP_GET, [](AsyncWebServerRequest* request) {
+    request->send(200, "text/html",
       "<html><body style='background:#0f172a;color:#e2e8f0;font-family:sans-serif;"
       "display:flex;justify-content:center;align-items:center;height:100vh'>"
       "<div style='text-align:center'><h1 style='color:#f59e0b'>WiFi Reset</h1>"
       "<p>Credentials cleared. ESP32 is restarting into Bluetooth setup mode.</p>"
       "<p style='color:#64748b;margin-top:16px'>Open Chrome on your PC or Android to reconfigure via Bluetooth.</p>"
       "</div></body></html>");
-    delay(1000);
-    BLESetup::clearCredentials();
-    delay(500);
-    ESP.restart();
+    wifiResetAt = millis();   // loop() does the actual reset
   });
   
   // GET /wifi/info - Show current WiFi info
-  server.on("/wifi/info", HTTP_GET, []() {
+  server.on("/wifi/info", HTTP_GET, [](AsyncWebServerRequest* request) {
     char json[256];
     snprintf(json, sizeof(json),
       "{\"ssid\":\"%s\",\"ip\":\"%s\",\"rssi\":%d,\"mac\":\"%s\"}",
-      BLESetup::getSavedSSID().c_str(),
-      WiFi.localIP().toString().c_str(),
+      netSSID,
+      netIP,
       WiFi.RSSI(),
       WiFi.macAddress().c_str());
-    server.send(200, "application/json", json);
+    request->send(200, "application/json", json);
+  });
+  
+#if FEATURE_MQTT
+  // GET /api/mqtt - Broker, user, site and pad in use (MqttConfig.h; no password)
+  server.on("/api/mqtt", HTTP_GET, [](AsyncWebServerRequest* request) {
+    const MqttConfig& cfg = mqtt.config();
+    char json[512];
+    JsonWriter w(json, sizeof(json));    // Quotes the free-text user and broker
+    w.beginMap(0);
+    w.text("broker",    cfg.broker().c_str());
+    w.text("user",      cfg.user.c_str());
+    w.text("site",      cfg.site.c_str());
+    w.text("pad",       cfg.pad.c_str());
+    w.flag("ca",        cfg.ca.length() || MQTT_DEFAULT_CA[0]);
+    w.text("topicBase", mqtt.getTopicBase().c_str());
+    w.flag("connected", mqtt.isConnected());
+    w.endMap();
+    if (!w.finish()) {
+      request->send(500, "text/plain", "mqtt settings too large");
+      return;
+    }
+    request->send(200, "application/json", json);
   });
+  
+  // POST /api/mqtt?broker=mqtts://host:8883&user=U&pass=P&site=S&pad=P - Save
+  // the ones given ("" clears user / site / pad) and restart onto them
+  server.on("/api/mqtt", HTTP_POST, [](AsyncWebServerRequest* request) {
+    static const char* const KEYS[] = { "broker", "user", "pass", "site", "pad" };
+    MqttConfig cfg;
+    cfg.load();
+    bool any = false;
+    for (const char* key : KEYS) {
+      const AsyncWebParameter* arg = apiArg(request, key);
+      if (!arg) continue;
+      if (!cfg.set(key, arg->value())) {
+        sendJsonResponse(request, false, "bad value (broker: mqtt[s]://host[:port], "
+                                         "site / pad: A-Z a-z 0-9 - _ .)");
+        return;
+      }
+      any = true;
+    }
+    if (!any) {
+      sendJsonResponse(request, false, "broker, user, pass, site or pad");
+      return;
+    }
+    cfg.save();
+    sendJsonResponse(request, true, "saved, restarting");
+    restartAt = millis();
+  });
+  
+  // PUT /api/mqtt - Body is the broker's PEM root certificate (mqtts://),
+  // empty to go back to MQTT_DEFAULT_CA; saved, then a restart
+  server.on("/api/mqtt", HTTP_PUT, [](AsyncWebServerRequest* request) {
+    const char* pem = (const char*)request->_tempObject;   // Freed with the request
+    if (request->contentLength() > MQTT_CA_MAX ||
+        (pem && strncmp(pem, "-----BEGIN CERTIFICATE-----", 27) != 0)) {
+      sendJsonResponse(request, false, "not a PEM certificate (or too big)");
+      return;
+    }
+    MqttConfig cfg;
+    cfg.load();
+    cfg.ca = pem ? pem : "";
+    cfg.save();
+    sendJsonResponse(request, true, pem ? "certificate saved, restarting" : "certificate cleared, restarting");
+    restartAt = millis();
+  }, nullptr, [](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+    if (total > MQTT_CA_MAX) return;
+    if (index == 0) request->_tempObject = calloc(total + 1, 1);
+    if (request->_tempObject) memcpy((char*)request->_tempObject + index, data, len);
+  });
+#endif
 }
 
 // =============================================
 // JSON HELPERS
 // =============================================
-void sendJsonResponse(bool success, const char* message) {
+// MQTT link state for /api/status (false without FEATURE_MQTT)
+bool mqttConnected() {
+#if FEATURE_MQTT
+  return mqtt.isConnected();
+#else
+  return false;
+#endif
+}
+
+// Where this unit's MQTT topics live, for the web UI ("" without FEATURE_MQTT)
+const char* mqttTopicBase() {
+#if FEATURE_MQTT
+  return mqtt.getTopicBase().c_str();
+#else
+  return "";
+#endif
+}
+
+void sendJsonResponse(AsyncWebServerRequest* request, bool success, const char* message) {
   char json[128];
   snprintf(json, sizeof(json), "{\"success\":%s,\"message\":\"%s\"}",
            success ? "true" : "false", message);
-  server.send(200, "application/json", json);
-}
-
-void handleApiStatus() {
-  char json[384];
-  snprintf(json, sizeof(json),
-    "{"
-    "\"running\":%s,"
-    "\"rpm\":%d,"
-    "\"watts\":%d,"
-    "\"gpm\":%d,"
-    "\"mode\":\"%s\","
-    "\"error\":%d,"
-    "\"drive\":%d,"
-    "\"timer\":%d,"
-    "\"hour\":%d,"
-    "\"minute\":%d,"
-    "\"remote\":%s,"
-    "\"valid\":%s,"
-    "\"age\":%lu,"
-    "\"ssid\":\"%s\","
-    "\"ip\":\"%s\","
-    "\"rssi\":%d,"
-    "\"deviceId\":\"%s\","
-    "\"mqttConnected\":%s"
-    "}",
-    pumpStatus.running ? "true" : "false",
-    pumpStatus.rpm,
-    pumpStatus.watts,
-    pumpStatus.gpm,
-    modeName(pumpStatus.mode),
-    pumpStatus.errCode,
-    pumpStatus.drive,
-    pumpStatus.timer,
-    pumpStatus.hour,
-    pumpStatus.minute,
-    remoteControlActive ? "true" : "false",
-    pumpStatus.valid ? "true" : "false",
-    pumpStatus.valid ? (millis() - pumpStatus.lastUpdate) / 1000 : 0,
-    BLESetup::getSavedSSID().c_str(),
-    WiFi.localIP().toString().c_str(),
-    WiFi.RSSI(),
-    mqtt.getDeviceId().c_str(),
-    mqtt.isConnected() ? "true" : "false"
-  );
-  server.send(200, "application/json", json);
+  request->send(200, "application/json", json);
+}
+
+// Request argument from the query string or a form body, or nullptr
+const AsyncWebParameter* apiArg(AsyncWebServerRequest* request, const char* name) {
+  if (request->hasParam(name)) return request->getParam(name);
+  if (request->hasParam(name, true)) return request->getParam(name, true);
+  return nullptr;
+}
+
+// Target pump for an /api/* request: ?pump=N (1-4), else the selected pump.
+// Sends the error response and returns 0 if N is out of range.
+uint8_t apiPumpAddr(AsyncWebServerRequest* request) {
+  const AsyncWebParameter* pump = apiArg(request, "pump");
+  if (!pump) return pumpAddr;
+  int n = pump->value().toInt();
+  if (n < 1 || n > PUMP_COUNT) {
+    sendJsonResponse(request, false, "pump must be 1-4");
+    return 0;
+  }
+  return pumpAddress(n - 1);
+}
+
+#define API_STATUS_JSON_MAX  1280   // Full /api/status (worst case ~940 bytes)
+
+void handleApiStatus(AsyncWebServerRequest* request) {
+  uint8_t addr = apiPumpAddr(request);
+  if (!addr) return;
+  
+  BusSnapshot snap = bus.snapshot();
+  
+  // "Accept: application/cbor": just the compact status record
+  // (StatusFormat.h), as MQTT_STATUS_CBOR publishes it
+  if (request->hasHeader("Accept") &&
+      request->header("Accept").indexOf("application/cbor") >= 0) {
+    uint8_t cbor[STATUS_CBOR_MAX];
+    size_t len = formatStatusCbor(cbor, sizeof(cbor), snap, pumpIndex(addr));
+    if (!len) {
+      request->send(500, "text/plain", "status record too large");
+      return;
+    }
+    AsyncResponseStream* response = request->beginResponseStream("application/cbor");
+    response->write(cbor, len);
+    request->send(response);
+    return;
+  }
+  
+  // The shared status record, then what only this page needs
+  const PumpStatus& pumpStatus = snap.pumps[pumpIndex(addr)];
+  char json[API_STATUS_JSON_MAX];
+  JsonWriter w(json, sizeof(json));
+  w.beginMap(0);
+  writeStatusFields(w, snap, pumpIndex(addr), deviceId());
+  w.num ("drive",         pumpStatus.drive);
+  w.num ("timer",         pumpStatus.timer);
+  w.num ("hour",          pumpStatus.hour);
+  w.num ("minute",        pumpStatus.minute);
+  w.num ("age",           pumpStatus.valid ? (millis() - pumpStatus.lastUpdate) / 1000 : 0);
+  w.text("ssid",          netSSID);
+  w.text("ip",            netIP);
+  w.flag("mqttConnected", mqttConnected());
+  w.text("topicBase",     mqttTopicBase());
+  w.num ("seqPump",       snap.seqPump ? pumpIndex(snap.seqPump) + 1 : 0);
+  w.flag("listenOnly",    bus.listenOnly());
+  w.flag("replay",        snap.replay);
+  w.num ("otherMaster",   snap.foreignMaster);
+  
+  // Short summary of every pump in the registry
+  w.beginArray("pumps");
+  for (int i = 0; i < PUMP_COUNT; i++) {
+    const PumpStatus& p = snap.pumps[i];
+    w.beginMap(0);
+    w.num ("pump",    i + 1);
+    w.flag("present", p.present);
+    w.flag("valid",   p.valid);
+    w.flag("running", p.running);
+    w.num ("rpm",     p.rpm);
+    w.num ("watts",   p.watts);
+    w.flag("remote",  p.remote);
+    w.endMap();
+  }
+  w.endArray();
+  w.endMap();
+  if (!w.finish()) {
+    request->send(500, "text/plain", "status too large");
+    return;
+  }
+  request->send(200, "application/json", json);
+}
+
+#if FEATURE_HISTORY
+// Samples with from <= t <= to (seconds, see History.h TIME) at res
+// seconds each; without res, the finest tier that reaches back to from
+void handleApiHistory(AsyncWebServerRequest* request) {
+  uint8_t addr = apiPumpAddr(request);
+  if (!addr) return;
+  int idx = pumpIndex(addr);
+  if (!history.records(idx)) {
+    sendJsonResponse(request, false, "no history for this pump");
+    return;
+  }
+  
+  const AsyncWebParameter* arg;
+  uint32_t from = (arg = apiArg(request, "from")) ? strtoul(arg->value().c_str(), nullptr, 10) : 0;
+  uint32_t to   = (arg = apiArg(request, "to"))   ? strtoul(arg->value().c_str(), nullptr, 10) : UINT32_MAX;
+  
+  HistoryTier tier;
+  if ((arg = apiArg(request, "res"))) {
+    tier = History::tierFor(strtoul(arg->value().c_str(), nullptr, 10));
+    if (tier == HT_COUNT) {
+      sendJsonResponse(request, false, "res must be 1, 60 or 900");
+      return;
+    }
+  } else {
+    tier = history.tierReaching(idx, from);
+  }
+  
+  request->send(history.stream(request, idx, from, to, tier));
 }
+#endif
 
+// Set or clear one schedule rule (see the route for the arguments)
+void handleApiSchedulePost(AsyncWebServerRequest* request) {
+  const AsyncWebParameter* arg = apiArg(request, "slot");
+  int slot = arg ? arg->value().toInt() : 0;
+  if (slot < 1 || slot > SCHEDULE_MAX_RULES) {
+    sendJsonResponse(request, false, "slot must be 1-8");
+    return;
+  }
+  
+  ScheduleRule r;
+  if (!((arg = apiArg(request, "clear")) && arg->value().toInt())) {
+    uint8_t addr = apiPumpAddr(request);
+    if (!addr) return;
+    r.pump    = pumpIndex(addr) + 1;
+    r.enabled = !(arg = apiArg(request, "enabled")) || arg->value().toInt();
+    int days  = (arg = apiArg(request, "days")) ? scheduleParseDays(arg->value().c_str()) : 0x7F;
+    int start = (arg = apiArg(request, "start")) ? scheduleParseTime(arg->value().c_str()) : -1;
+    int end   = (arg = apiArg(request, "end"))   ? scheduleParseTime(arg->value().c_str()) : -1;
+    int prog  = (arg = apiArg(request, "program")) ? arg->value().toInt() : 1;
+    int rpm   = (arg = apiArg(request, "rpm")) ? arg->value().toInt() : 0;
+    if (start < 0 || end < 0) {
+      sendJsonResponse(request, false, "start and end must be HH:MM");
+      return;
+    }
+    r.days    = days < 0 ? 0 : days;
+    r.start   = start;
+    r.end     = end;
+    r.program = constrain(prog, 0, 255);
+    r.rpm     = constrain(rpm, 0, 65535);
+    const char* error = scheduleRuleError(r);
+    if (error) {
+      sendJsonResponse(request, false, error);
+      return;
+    }
+  }
+  
+  schedule.setRule(slot - 1, r);
+  sendJsonResponse(request, true, r.rpm ? "rule saved" : "rule cleared");
+}
+#endif // FEATURE_HTTP
+
+#if FEATURE_CONSOLE
 // =============================================
 // SERIAL MONITOR COMMAND HANDLER
 // =============================================
@@ -386,13 +1055,16 @@ void handleSerialCommand(String input) {
   // Special text commands
   if (input.equalsIgnoreCase("reset") || input.equalsIgnoreCase("wifi reset")) {
     Serial.println("\n[WiFi] Clearing saved credentials and restarting...");
+#if FEATURE_BLE
     Serial.println("[WiFi] BLE setup will start on next boot (use Chrome on PC or Android).");
+#endif
     BLESetup::clearCredentials();
     delay(500);
     ESP.restart();
     return;
   }
   
+#if FEATURE_BLE
   if (input.equalsIgnoreCase("setup") || input.equalsIgnoreCase("wifi setup")) {
     Serial.println("\n[WiFi] Starting Bluetooth setup...");
     Serial.println("[WiFi] Open Chrome on PC or Android:");
@@ -400,33 +1072,170 @@ void handleSerialCommand(String input) {
     bleSetup.runProvisioning();  // Blocks, then reboots
     return;
   }
+#endif
+  
+  // 'wifi join SSID PASSWORD' - save credentials and restart onto them
+  // (headless units without BLE; an SSID with spaces goes in quotes)
+  if (input.startsWith("wifi join ")) {
+    String args = input.substring(10);
+    args.trim();
+    String ssid, pass;
+    if (args.startsWith("\"")) {
+      int end = args.indexOf('"', 1);
+      if (end > 0) {
+        ssid = args.substring(1, end);
+        pass = args.substring(end + 1);
+      }
+    } else {
+      int space = args.indexOf(' ');
+      ssid = space < 0 ? args : args.substring(0, space);
+      pass = space < 0 ? String() : args.substring(space + 1);
+    }
+    pass.trim();
+    if (ssid.length() == 0 || ssid.length() > 32 || pass.length() > 63) {
+      Serial.println("ERROR: wifi join SSID PASSWORD  (\"SSID with spaces\" in quotes)");
+      return;
+    }
+    BLESetup::saveCredentials(ssid, pass);
+    Serial.println("[WiFi] Restarting to connect...");
+    delay(500);
+    ESP.restart();
+    return;
+  }
   
   if (input.equalsIgnoreCase("wifi")) {
-    if (wifiConnected) {
+    if (wifiLinkUp) {
       Serial.printf("[WiFi] Connected to \"%s\"\n", BLESetup::getSavedSSID().c_str());
       Serial.printf("[WiFi] IP: %s  Signal: %d dBm\n", WiFi.localIP().toString().c_str(), WiFi.RSSI());
-    } else if (BLESetup::hasSavedCredentials()) {
-      Serial.println("[WiFi] Not connected. Trying saved credentials...");
-      if (BLESetup::connectSaved()) {
-        wifiConnected = true;
-        startWiFiServices();
-      } else {
-        Serial.println("[WiFi] Failed. Type 'reset' to clear and 'setup' to reconfigure.");
-      }
+    } else if (wifiStartedAt) {
+      Serial.printf("[WiFi] Connecting in the background (%lu s so far)...\n",
+                    (millis() - wifiStartedAt) / 1000);
+    } else if (BLESetup::beginSaved()) {
+      Serial.println(" (in the background)");
+      wifiStartedAt = millis();
+      wifiRetry.fail();
     } else {
       Serial.println("[WiFi] No credentials saved. Type 'setup' to configure via Bluetooth.");
     }
     return;
   }
   
+  if (input.equalsIgnoreCase("help")) {
+    printMenu();
+    return;
+  }
+  
+  // 'log' - level and losses; 'log error|warn|info|debug|trace'
+  if (input.equalsIgnoreCase("log")) {
+    Serial.printf("[LOG] Level %s (built with up to %s), %lu lines lost to the ring, %lu rate-limited\n",
+                  Logger::levelName(logger.level()), Logger::levelName(LOG_LEVEL_MAX),
+                  (unsigned long)logger.dropped(), (unsigned long)logger.limited());
+    return;
+  }
+  if (input.startsWith("log ")) {
+    int level = Logger::parseLevel(input.substring(4).c_str());
+    if (level < 0) {
+      Serial.println("ERROR: log error|warn|info|debug|trace");
+      return;
+    }
+    logger.setLevel(level);
+    Serial.printf("[LOG] Level %s\n", Logger::levelName(logger.level()));
+    return;
+  }
+  
+  // 'pump N' - choose which pump the numbered commands target
+  if (input.startsWith("pump ")) {
+    int n = input.substring(5).toInt();
+    if (n >= 1 && n <= PUMP_COUNT) {
+      pumpAddr = pumpAddress(n - 1);
+      Serial.printf("Commands now target pump %d (0x%02X)\n", n, pumpAddr);
+    } else {
+      Serial.println("ERROR: pump must be 1-4");
+    }
+    return;
+  }
+  
+  // 'listen' / 'listen off' - passive sniffer mode (never transmit)
+  if (input.equalsIgnoreCase("listen")) {
+    bus.setListenOnly(true);
+    return;
+  }
+  if (input.equalsIgnoreCase("listen off")) {
+    bus.setListenOnly(false);
+    return;
+  }
+  
+  if (input.equalsIgnoreCase("pumps")) {
+    printPumps();
+    return;
+  }
+  
+  // 'sched' - list rules
+  // 'sched N P DAYS HH:MM HH:MM PROG RPM' - set rule N (e.g. sched 1 1 12345 08:00 18:00 2 2000)
+  // 'sched N on|off|clear'
+  if (input.equalsIgnoreCase("sched")) {
+    schedule.print();
+    return;
+  }
+  if (input.startsWith("sched ")) {
+    handleScheduleCommand(input.substring(6));
+    return;
+  }
+  
+#if FEATURE_MQTT
+  // 'mqtt' - broker and topics; 'mqtt broker|user|pass|site|pad VALUE',
+  // 'mqtt reset', 'mqtt apply' (saved in NVS, used from the next boot)
+  if (input.equalsIgnoreCase("mqtt") || input.startsWith("mqtt ")) {
+    handleMqttCommand(input.length() > 5 ? input.substring(5) : String());
+    return;
+  }
+#endif
+  
+  if (input.equalsIgnoreCase("energy")) {
+    energy.print(pumpIndex(pumpAddr));
+    return;
+  }
+  
+  if (input.equalsIgnoreCase("metrics")) {
+    printPrometheus(Serial, bus.metrics(), loopPeak.peak());
+    return;
+  }
+  
+  // 'capture' - status; 'capture on|off|clear'
+  // 'replay [SPEED]' - replay the stored / uploaded capture; 'replay stop'
+  if (input.equalsIgnoreCase("capture")) {
+    capture.print();
+    return;
+  }
+  if (input.startsWith("capture ")) {
+    String arg = input.substring(8);
+    if (arg.equalsIgnoreCase("on"))         capture.setRecording(true);
+    else if (arg.equalsIgnoreCase("off"))   capture.setRecording(false);
+    else if (arg.equalsIgnoreCase("clear")) capture.clear();
+    else Serial.println("ERROR: capture on|off|clear");
+    return;
+  }
+  if (input.equalsIgnoreCase("replay") || input.startsWith("replay ")) {
+    String arg = input.length() > 7 ? input.substring(7) : String("1");
+    if (arg.equalsIgnoreCase("stop")) capture.stopReplay();
+    else capture.startReplay(constrain(arg.toInt(), 0, 1000));
+    return;
+  }
+  
+  if (input.equalsIgnoreCase("scan")) {
+    Serial.println("\n>> Scanning for pumps 0x60-0x63 (status query to each)");
+    for (int i = 0; i < PUMP_COUNT; i++) sendStatusQuery(pumpAddress(i));
+    return;
+  }
+  
   int cmd = input.toInt();
   
   switch (cmd) {
-    case 1:  sendRemoteControl(); break;
-    case 2:  sendLocalControl(); break;
-    case 3:  sendRunPump(true); break;
-    case 4:  sendRunPump(false); break;
-    case 5:  sendStatusQuery(); break;
+    case 1:  sendRemoteControl(pumpAddr); break;
+    case 2:  sendLocalControl(pumpAddr); break;
+    case 3:  sendRunPump(pumpAddr, true); break;
+    case 4:  sendRunPump(pumpAddr, false); break;
+    case 5:  sendStatusQuery(pumpAddr); break;
     case 6: {
       Serial.println("Enter RPM (450-3450):");
       while (!Serial.available()) { delay(10); }
@@ -434,16 +1243,16 @@ void handleSerialCommand(String input) {
       rpmStr.trim();
       int rpm = rpmStr.toInt();
       if (rpm >= 450 && rpm <= 3450) {
-        sendSetRPM(rpm);
+        sendSetRPM(pumpAddr, rpm);
       } else {
         Serial.println("ERROR: RPM must be 450-3450");
       }
       break;
     }
-    case 7:  sendSetMode(MODE_SPEED_1); break;
-    case 8:  sendSetMode(MODE_SPEED_2); break;
-    case 9:  sendSetMode(MODE_SPEED_3); break;
-    case 10: sendSetMode(MODE_SPEED_4); break;
+    case 7:  sendSetMode(pumpAddr, MODE_SPEED_1); break;
+    case 8:  sendSetMode(pumpAddr, MODE_SPEED_2); break;
+    case 9:  sendSetMode(pumpAddr, MODE_SPEED_3); break;
+    case 10: sendSetMode(pumpAddr, MODE_SPEED_4); break;
     case 11: {
       Serial.println("Enter RPM (450-3450):");
       while (!Serial.available()) { delay(10); }
@@ -451,31 +1260,25 @@ void handleSerialCommand(String input) {
       rpmStr.trim();
       int rpm = rpmStr.toInt();
       if (rpm >= 450 && rpm <= 3450) {
-        runFullSpeedSequence(rpm);
+        runFullSpeedSequence(pumpAddr, rpm);
       } else {
         Serial.println("ERROR: RPM must be 450-3450");
       }
       break;
     }
-    case 12: runFullStopSequence(); break;
+    case 12: runFullStopSequence(pumpAddr); break;
     case 99: {
       // RAW TEST: Send a simple known pattern to diagnose RS-485 link
       Serial.println("\n>> RAW TEST: Sending 5 bytes: AA BB CC DD EE");
       uint8_t testData[] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE};
       
-      // Clear stale RX
-      while (Serial2.available()) Serial2.read();
-      
-      digitalWrite(RS485_DE_RE_PIN, HIGH);
-      delayMicroseconds(500);
-      
-      Serial2.write(testData, 5);
-      Serial2.flush();
-      delay(10);  // 5 bytes at 9600 = ~5.2ms, plus margin
+      // Not a Pentair frame: send on the bus without waiting for a reply
+      CommandSequence seq;
+      seq.begin("rawtest");
+      seq.addFrame("Raw test", testData, sizeof(testData), 0, 0, 0);
+      bus.submit(seq);
       
-      digitalWrite(RS485_DE_RE_PIN, LOW);
-      
-      Serial.println("   Sent! Check Pump Serial Monitor for: AA BB CC DD EE");
+      Serial.println("   Queued! Check Pump Serial Monitor for: AA BB CC DD EE");
       break;
     }
     default:
@@ -485,323 +1288,545 @@ void handleSerialCommand(String input) {
   }
 }
 
+// 'sched ...' arguments (see handleSerialCommand)
+void handleScheduleCommand(const String& args) {
+  int slot;
+  char word[8] = "";
+  int pump, prog, rpm;
+  char days[8], start[6], end[6];
+  
+  if (sscanf(args.c_str(), "%d %7s", &slot, word) < 1 || slot < 1 || slot > SCHEDULE_MAX_RULES) {
+    Serial.println("ERROR: sched N ... (N = 1-8)");
+    return;
+  }
+  ScheduleRule r = schedule.rule(slot - 1);
+  
+  if (strcmp(word, "on") == 0 || strcmp(word, "off") == 0) {
+    if (!r.rpm) { Serial.printf("ERROR: rule %d is empty\n", slot); return; }
+    r.enabled = (strcmp(word, "on") == 0);
+  } else if (strcmp(word, "clear") == 0) {
+    r = ScheduleRule();
+  } else if (sscanf(args.c_str(), "%d %d %7s %5s %5s %d %d",
+                    &slot, &pump, days, start, end, &prog, &rpm) == 7) {
+    int d = scheduleParseDays(days);
+    int s = scheduleParseTime(start);
+    int e = scheduleParseTime(end);
+    r.enabled = true;
+    r.pump    = constrain(pump, 0, 255);
+    r.days    = d < 0 ? 0 : d;
+    r.start   = s < 0 ? 0 : s;
+    r.end     = e < 0 ? 0 : e;
+    r.program = constrain(prog, 0, 255);
+    r.rpm     = constrain(rpm, 0, 65535);
+    const char* error = (s < 0 || e < 0) ? "start / end must be HH:MM" : scheduleRuleError(r);
+    if (error) { Serial.printf("ERROR: %s\n", error); return; }
+  } else {
+    Serial.println("ERROR: sched N PUMP DAYS HH:MM HH:MM PROGRAM RPM  |  sched N on|off|clear");
+    return;
+  }
+  
+  schedule.setRule(slot - 1, r);
+  schedule.print();
+}
+#if FEATURE_MQTT
+// 'mqtt ...' arguments (see handleSerialCommand); "-" clears a value
+void handleMqttCommand(const String& args) {
+  static bool pending = false;     // Saved settings not in use yet
+  if (args.length() == 0) {
+    const MqttConfig& cfg = mqtt.config();
+    Serial.printf("[MQTT] Broker %s%s%s (%s)\n", cfg.broker().c_str(),
+                  cfg.user.length() ? " as " : "", cfg.user.c_str(),
+                  mqtt.isConnected() ? "connected" : "not connected");
+    if (cfg.tls) {
+      Serial.printf("[MQTT] TLS, %s\n", cfg.ca.length() || MQTT_DEFAULT_CA[0]
+                    ? "broker verified against the CA certificate" : "broker NOT verified (no CA)");
+    }
+    Serial.printf("[MQTT] Site \"%s\", pad \"%s\"\n", cfg.site.c_str(), cfg.pad.c_str());
+    Serial.printf("[MQTT] Topics %s/..., summary on %s\n", mqtt.getTopicBase().c_str(),
+                  cfg.topicSummary(deviceId()).c_str());
+    if (pending) Serial.println("[MQTT] Changed settings are saved: 'mqtt apply' to restart onto them");
+    return;
+  }
+  if (args.equalsIgnoreCase("apply")) {
+    Serial.println("[MQTT] Restarting onto the saved settings...");
+    delay(500);
+    ESP.restart();
+    return;
+  }
+  if (args.equalsIgnoreCase("reset")) {
+    MqttConfig::clear();
+    pending = true;
+    Serial.printf("[MQTT] Back to the build defaults (%s) from the next boot\n", MQTT_DEFAULT_BROKER);
+    return;
+  }
+  
+  int space = args.indexOf(' ');
+  String key = space < 0 ? args : args.substring(0, space);
+  String value = space < 0 ? String() : args.substring(space + 1);
+  value.trim();
+  if (value == "-") value = "";
+  key.toLowerCase();
+  
+  MqttConfig cfg;
+  cfg.load();
+  bool ok = value.length() || key != "broker";
+  if (ok && key == "user") {
+    // 'mqtt user NAME PASSWORD'
+    int sp = value.indexOf(' ');
+    ok = cfg.set("user", sp < 0 ? value : value.substring(0, sp)) &&
+         cfg.set("pass", sp < 0 ? String() : value.substring(sp + 1));
+  } else if (ok) {
+    ok = cfg.set(key, value);
+  }
+  if (!ok) {
+    Serial.println("ERROR: mqtt broker mqtt[s]://HOST[:PORT] | user NAME PASSWORD | pass PASSWORD");
+    Serial.println("       mqtt site SITE | pad LABEL (A-Z a-z 0-9 - _ ., \"-\" clears) | reset | apply");
+    return;
+  }
+  cfg.save();
+  pending = true;
+  Serial.printf("[MQTT] %s saved. 'mqtt apply' restarts onto it.\n", key.c_str());
+}
+#endif
+
+#endif // FEATURE_CONSOLE
+
 // =============================================
 // SEND: Set Remote Control (CMD 0x04)
 // nodejs-poolController: action:4, payload:[255]
 // =============================================
-void sendRemoteControl() {
-  Serial.println("\n>> SENDING: Set Remote Control");
-  Serial.println("   nodejs-poolController: action:4, payload:[255]");
-  
-  uint8_t data[] = { CTRL_REMOTE };  // 0xFF
-  size_t len = pentairBuildPacket(txBuffer, pumpAddr, controllerAddr, CMD_CTRL, data, 1);
+void sendRemoteControl(uint8_t addr) {
+  LOGI("CMD", "Set Remote Control (pump 0x%02X)", addr);
+  LOGD("CMD", "nodejs-poolController: action:4, payload:[255]");
   
-  sendRS485(txBuffer, len);
-  remoteControlActive = true;
+  const PentairFixedFrame& f = pumpFrames[pumpIndex(addr)].remote;
+  submitFrame("remote", f.bytes, f.len, nullptr);
 }
 
 // =============================================
 // SEND: Set Local Control (CMD 0x04)
 // nodejs-poolController: action:4, payload:[0]
 // =============================================
-void sendLocalControl() {
-  Serial.println("\n>> SENDING: Set Local Control");
-  Serial.println("   nodejs-poolController: action:4, payload:[0]");
-  
-  uint8_t data[] = { CTRL_LOCAL };  // 0x00
-  size_t len = pentairBuildPacket(txBuffer, pumpAddr, controllerAddr, CMD_CTRL, data, 1);
+void sendLocalControl(uint8_t addr) {
+  LOGI("CMD", "Set Local Control (pump 0x%02X)", addr);
+  LOGD("CMD", "nodejs-poolController: action:4, payload:[0]");
   
-  sendRS485(txBuffer, len);
-  remoteControlActive = false;
+  const PentairFixedFrame& f = pumpFrames[pumpIndex(addr)].local;
+  submitFrame("local", f.bytes, f.len, nullptr);
 }
 
 // =============================================
 // SEND: Run/Stop Pump (CMD 0x06)
 // nodejs-poolController: action:6, payload:[10] or [4]
 // =============================================
-void sendRunPump(bool start) {
-  Serial.printf("\n>> SENDING: %s Pump\n", start ? "START" : "STOP");
-  Serial.printf("   nodejs-poolController: action:6, payload:[%d]\n", start ? 10 : 4);
+void sendRunPump(uint8_t addr, bool start) {
+  LOGI("CMD", "%s Pump 0x%02X", start ? "START" : "STOP", addr);
+  LOGD("CMD", "nodejs-poolController: action:6, payload:[%d]", start ? 10 : 4);
   
-  uint8_t data[] = { start ? RUN_START : RUN_STOP };  // 0x0A or 0x04
-  size_t len = pentairBuildPacket(txBuffer, pumpAddr, controllerAddr, CMD_RUN, data, 1);
-  
-  sendRS485(txBuffer, len);
+  const PumpFrames& frames = pumpFrames[pumpIndex(addr)];
+  const PentairFixedFrame& f = start ? frames.start : frames.stop;
+  submitFrame(start ? "start" : "stop", f.bytes, f.len, nullptr);
 }
 
 // =============================================
 // SEND: Query Status (CMD 0x07)
 // nodejs-poolController: action:7, payload:[]
 // =============================================
-void sendStatusQuery() {
-  Serial.println("\n>> SENDING: Status Query");
-  Serial.println("   nodejs-poolController: action:7, payload:[]");
-  
-  size_t len = pentairBuildPacket(txBuffer, pumpAddr, controllerAddr, CMD_STATUS, NULL, 0);
+void sendStatusQuery(uint8_t addr) {
+  LOGI("CMD", "Status Query (pump 0x%02X)", addr);
+  LOGD("CMD", "nodejs-poolController: action:7, payload:[]");
   
-  sendRS485(txBuffer, len);
+  const PentairFixedFrame& f = pumpFrames[pumpIndex(addr)].query;
+  submitFrame("query", f.bytes, f.len, nullptr);
 }
 
 // =============================================
 // SEND: Set RPM directly (CMD 0x01, Register 0x02C4)
 // nodejs-poolController: action:1, payload:[2, 196, rpm_hi, rpm_lo]
 // =============================================
-void sendSetRPM(uint16_t rpm) {
-  Serial.printf("\n>> SENDING: Set RPM = %d (direct, register 0x02C4)\n", rpm);
-  Serial.printf("   nodejs-poolController: action:1, payload:[2, 196, %d, %d]\n",
-                (rpm >> 8) & 0xFF, rpm & 0xFF);
-  
-  uint8_t data[] = {
-    (uint8_t)(REG_SET_RPM >> 8),     // 0x02
-    (uint8_t)(REG_SET_RPM & 0xFF),   // 0xC4
-    (uint8_t)(rpm >> 8),              // RPM high byte
-    (uint8_t)(rpm & 0xFF)             // RPM low byte
-  };
-  
-  size_t len = pentairBuildPacket(txBuffer, pumpAddr, controllerAddr, CMD_WRITE_REG, data, 4);
-  sendRS485(txBuffer, len);
+void sendSetRPM(uint8_t addr, uint16_t rpm) {
+  LOGI("CMD", "Set RPM = %d (direct, register 0x02C4, pump 0x%02X)", rpm, addr);
+  LOGD("CMD", "nodejs-poolController: action:1, payload:[2, 196, %d, %d]",
+       (rpm >> 8) & 0xFF, rpm & 0xFF);
+  
+  uint8_t frame[SEQ_MAX_FRAME_LEN];
+  size_t len = PentairFrameWriter(frame, sizeof(frame))
+                 .begin(addr, controllerAddr, CMD_WRITE_REG)
+                 .u16(REG_SET_RPM)   // 0x02C4
+                 .u16(rpm)
+                 .finish();
+  submitFrame("rpm", frame, len, nullptr);
 }
 
 // =============================================
 // SEND: Set Mode (CMD 0x05)
 // =============================================
-void sendSetMode(uint8_t mode) {
-  Serial.printf("\n>> SENDING: Set Mode 0x%02X (%s)\n", mode, modeName(mode));
-  
-  uint8_t data[] = { mode };
-  size_t len = pentairBuildPacket(txBuffer, pumpAddr, controllerAddr, CMD_MODE, data, 1);
-  
-  sendRS485(txBuffer, len);
+void sendSetMode(uint8_t addr, uint8_t mode) {
+  LOGI("CMD", "Set Mode 0x%02X (%s, pump 0x%02X)", mode, modeName(mode), addr);
+  
+  uint8_t frame[SEQ_MAX_FRAME_LEN];
+  size_t len = PentairFrameWriter(frame, sizeof(frame))
+                 .begin(addr, controllerAddr, CMD_MODE)
+                 .u8(mode)
+                 .finish();
+  submitFrame("mode", frame, len, nullptr);
+}
+
+// =============================================
+// SUBMIT: Queue one frame on the RS-485 bus
+// The bus task sends it, then waits for the echoed CFI
+// (reply is parsed and logged there as it arrives).
+// =============================================
+void submitFrame(const char* name, const uint8_t* frame, size_t len, SequenceDoneFn done) {
+  CommandSequence seq;
+  seq.begin(name, done);
+  seq.addFrame(name, frame, len, frame[PKT_IDX_CMD], TXN_ATTEMPT_TIMEOUT_MS, 0);
+  bus.submit(seq);
 }
 
 // =============================================
 // FULL SEQUENCE: Set speed and run
-// Matches nodejs-poolController's setPumpStateAsync() exactly
+// Matches nodejs-poolController's setPumpStateAsync() exactly.
+// Queued on the bus and returns immediately; the bus task
+// advances it as replies arrive (progress is shown in status).
 // =============================================
-void runFullSpeedSequence(uint16_t rpm) {
-  Serial.println("\n========================================");
-  Serial.printf("  FULL SEQUENCE (nodejs-poolController)\n");
-  Serial.printf("  Set pump to %d RPM\n", rpm);
-  Serial.println("========================================");
+void runFullSpeedSequence(uint8_t addr, uint16_t rpm) {
+  LOGI("CMD", "FULL SEQUENCE: Set pump 0x%02X to %d RPM", addr, rpm);
+  
+  bool scheduled = schedule.cancel(addr);   // Manual speed wins over the schedule
+  saveLastRun(addr, rpm);
+  sequenceRPM[pumpIndex(addr)] = rpm;
+  const PumpFrames& frames = pumpFrames[pumpIndex(addr)];
+  CommandSequence seq;
+  seq.begin("fullstart", onFullSpeedSequenceDone, true);
+  
+  // Step 0 (pump was on the schedule): program off, so it can't
+  // override the manual speed
+  if (scheduled) addExtProgramOff(seq, addr);
   
   // Step 1: Start motor
-  Serial.println("\nStep 1/5: Starting motor...");
-  {
-    uint8_t data[] = { RUN_START };
-    size_t len = pentairBuildPacket(txBuffer, pumpAddr, controllerAddr, CMD_RUN, data, 1);
-    sendRS485(txBuffer, len);
-  }
-  waitForResponse();
+  seq.addFrame("Starting motor", frames.start.bytes, frames.start.len,
+               CMD_RUN, TXN_ATTEMPT_TIMEOUT_MS, 0);
   
   // Step 2: Set RPM directly
-  Serial.printf("\nStep 2/5: Setting RPM to %d...\n", rpm);
   {
-    uint8_t data[] = {
-      (uint8_t)(REG_SET_RPM >> 8),
-      (uint8_t)(REG_SET_RPM & 0xFF),
-      (uint8_t)(rpm >> 8),
-      (uint8_t)(rpm & 0xFF)
-    };
-    size_t len = pentairBuildPacket(txBuffer, pumpAddr, controllerAddr, CMD_WRITE_REG, data, 4);
-    sendRS485(txBuffer, len);
+    uint8_t frame[SEQ_MAX_FRAME_LEN];
+    size_t len = PentairFrameWriter(frame, sizeof(frame))
+                   .begin(addr, controllerAddr, CMD_WRITE_REG)
+                   .u16(REG_SET_RPM)
+                   .u16(rpm)
+                   .finish();
+    seq.addFrame("Setting RPM", frame, len, CMD_WRITE_REG, TXN_ATTEMPT_TIMEOUT_MS, 0);
   }
-  waitForResponse();
   
   // Step 3: Wait 1 second
-  Serial.println("\nStep 3/5: Waiting 1 second...");
-  delay(1000);
+  seq.addWait("Waiting 1 second", 1000);
   
   // Step 4: Request status
-  Serial.println("\nStep 4/5: Requesting pump status...");
-  {
-    size_t len = pentairBuildPacket(txBuffer, pumpAddr, controllerAddr, CMD_STATUS, NULL, 0);
-    sendRS485(txBuffer, len);
-  }
-  waitForResponse();
+  // (500ms gap afterwards to let pump finish processing previous response)
+  seq.addFrame("Requesting pump status", frames.query.bytes, frames.query.len,
+               CMD_STATUS, TXN_ATTEMPT_TIMEOUT_MS, 500);
   
   // Step 5: Set remote control
-  delay(500);  // Small gap to let pump finish processing previous response
-  Serial.println("\nStep 5/5: Setting remote control...");
-  {
-    uint8_t data[] = { CTRL_REMOTE };
-    size_t len = pentairBuildPacket(txBuffer, pumpAddr, controllerAddr, CMD_CTRL, data, 1);
-    sendRS485(txBuffer, len);
-  }
-  waitForResponse();
+  seq.addFrame("Setting remote control", frames.remote.bytes, frames.remote.len,
+               CMD_CTRL, TXN_ATTEMPT_TIMEOUT_MS, 0);
   
-  Serial.println("\n========================================");
-  Serial.printf("  SEQUENCE COMPLETE: Pump set to %d RPM\n", rpm);
-  Serial.println("========================================\n");
+  bus.submit(seq);
+}
+
+void onFullSpeedSequenceDone(uint8_t addr, bool ok) {
+  if (!ok) {
+    // Keep polling on schedule: the next status shows what the pump did
+    LOGW("CMD", "SEQUENCE FAILED: Pump 0x%02X not set to %d RPM",
+         addr, sequenceRPM[pumpIndex(addr)]);
+    return;
+  }
+  LOGI("CMD", "SEQUENCE COMPLETE: Pump 0x%02X set to %d RPM",
+       addr, sequenceRPM[pumpIndex(addr)]);
   
-  remoteControlActive = true;
-  lastAutoQuery = millis();  // Reset auto-query timer
+  pumps[pumpIndex(addr)].lastQuery = millis();  // Reset auto-query timer
 }
 
 // =============================================
 // FULL SEQUENCE: Stop pump
+// (non-blocking, see runFullSpeedSequence)
 // =============================================
-void runFullStopSequence() {
-  Serial.println("\n========================================");
-  Serial.println("  FULL SEQUENCE: Stop pump");
-  Serial.println("========================================");
+void runFullStopSequence(uint8_t addr) {
+  LOGI("CMD", "FULL SEQUENCE: Stop pump 0x%02X", addr);
+  
+  bool scheduled = schedule.cancel(addr);
+  saveLastRun(addr, 0);
+  const PumpFrames& frames = pumpFrames[pumpIndex(addr)];
+  CommandSequence seq;
+  seq.begin("fullstop", onFullStopSequenceDone, true);
+  
+  // Step 0 (pump was on the schedule): program off
+  if (scheduled) addExtProgramOff(seq, addr);
   
   // Step 1: Stop motor
-  Serial.println("\nStep 1/2: Stopping motor...");
-  {
-    uint8_t data[] = { RUN_STOP };
-    size_t len = pentairBuildPacket(txBuffer, pumpAddr, controllerAddr, CMD_RUN, data, 1);
-    sendRS485(txBuffer, len);
-  }
-  waitForResponse();
+  // (500ms gap afterwards to let pump finish processing previous response)
+  seq.addFrame("Stopping motor", frames.stop.bytes, frames.stop.len,
+               CMD_RUN, TXN_ATTEMPT_TIMEOUT_MS, 500);
   
   // Step 2: Return to local control
-  delay(500);  // Small gap to let pump finish processing previous response
-  Serial.println("\nStep 2/2: Returning to local control...");
-  {
-    uint8_t data[] = { CTRL_LOCAL };
-    size_t len = pentairBuildPacket(txBuffer, pumpAddr, controllerAddr, CMD_CTRL, data, 1);
-    sendRS485(txBuffer, len);
-  }
-  waitForResponse();
-  
-  Serial.println("\n========================================");
-  Serial.println("  SEQUENCE COMPLETE: Pump stopped");
-  Serial.println("========================================\n");
+  seq.addFrame("Returning to local control", frames.local.bytes, frames.local.len,
+               CMD_CTRL, TXN_ATTEMPT_TIMEOUT_MS, 0);
   
-  remoteControlActive = false;
+  bus.submit(seq);
+}
+
+void onFullStopSequenceDone(uint8_t addr, bool ok) {
+  if (!ok) {
+    LOGW("CMD", "SEQUENCE FAILED: Pump 0x%02X may still be running", addr);
+    return;
+  }
+  LOGI("CMD", "SEQUENCE COMPLETE: Pump 0x%02X stopped", addr);
 }
 
 // =============================================
-// WAIT FOR PUMP RESPONSE
+// EXTERNAL PROGRAMS (driven by the schedule, Schedule.h)
+// Program N: select value N * 8 (EPRG_1..EPRG_4) in REG_EXT_PROG,
+// speed in REG_EXT_PROG_1_RPM + N - 1. The pump drops the program
+// unless it is re-selected within EXT_PROG_REPEAT_INTERVAL.
 // =============================================
-void waitForResponse() {
-  unsigned long start = millis();
-  
-  while (millis() - start < CMD_RESPONSE_TIMEOUT) {
-    if (Serial2.available()) {
-      delay(50);  // Wait for full packet
-      rxLen = 0;
-      while (Serial2.available() && rxLen < sizeof(rxBuffer)) {
-        rxBuffer[rxLen++] = Serial2.read();
-      }
-      
-      if (rxLen > 0) {
-        printPacketHex("  RX", rxBuffer, rxLen);
-        parseAndDisplayResponse(rxBuffer, rxLen);
-        return;
-      }
-    }
-    delay(10);
-  }
-  
-  Serial.println("  WARNING: No response from pump (timeout)");
+size_t extProgFrame(uint8_t* frame, uint8_t addr, uint16_t reg, uint16_t value) {
+  return PentairFrameWriter(frame, SEQ_MAX_FRAME_LEN)
+           .begin(addr, controllerAddr, CMD_WRITE_REG)
+           .u16(reg)
+           .u16(value)
+           .finish();
 }
 
+// Remote, program RPM, select program, run
+void runExtProgramSequence(uint8_t addr, uint8_t program, uint16_t rpm) {
+  saveLastRun(addr, 0);      // The schedule has the pump again
+  const PumpFrames& frames = pumpFrames[pumpIndex(addr)];
+  uint8_t frame[SEQ_MAX_FRAME_LEN];
+  size_t len;
+  CommandSequence seq;
+  seq.begin("extprog", nullptr, true);
+  
+  seq.addFrame("Setting remote control", frames.remote.bytes, frames.remote.len,
+               CMD_CTRL, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  len = extProgFrame(frame, addr, REG_EXT_PROG_1_RPM + program - 1, rpm);
+  seq.addFrame("Setting program RPM", frame, len, CMD_WRITE_REG, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  len = extProgFrame(frame, addr, REG_EXT_PROG, program * EPRG_1);
+  seq.addFrame("Selecting program", frame, len, CMD_WRITE_REG, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  seq.addFrame("Starting motor", frames.start.bytes, frames.start.len,
+               CMD_RUN, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  
+  bus.submit(seq);
+}
+
+// Deselect the program: first step of extstop, and of a manual full
+// start / stop that overrides the schedule (one sequence, so nothing
+// else for this pump can run in between)
+void addExtProgramOff(CommandSequence& seq, uint8_t addr) {
+  uint8_t frame[SEQ_MAX_FRAME_LEN];
+  size_t len = extProgFrame(frame, addr, REG_EXT_PROG, EPRG_OFF);
+  seq.addFrame("Program off", frame, len, CMD_WRITE_REG, TXN_ATTEMPT_TIMEOUT_MS, 0);
+}
+
+// Program off, stop, local
+void runExtProgramStopSequence(uint8_t addr) {
+  const PumpFrames& frames = pumpFrames[pumpIndex(addr)];
+  CommandSequence seq;
+  seq.begin("extstop", nullptr, true);
+  
+  addExtProgramOff(seq, addr);
+  seq.addFrame("Stopping motor", frames.stop.bytes, frames.stop.len,
+               CMD_RUN, TXN_ATTEMPT_TIMEOUT_MS, 500);
+  seq.addFrame("Returning to local control", frames.local.bytes, frames.local.len,
+               CMD_CTRL, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  
+  bus.submit(seq);
+}
+
+// Re-select a running program (bus task, from schedule.keepAlive())
+void sendExtProgramKeepAlive(uint8_t addr, uint8_t program) {
+  const PumpFrames& frames = pumpFrames[pumpIndex(addr)];
+  uint8_t frame[SEQ_MAX_FRAME_LEN];
+  size_t len = extProgFrame(frame, addr, REG_EXT_PROG, program * EPRG_1);
+  CommandSequence seq;
+  seq.begin("keepalive");
+  
+  seq.addFrame("Remote control", frames.remote.bytes, frames.remote.len,
+               CMD_CTRL, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  seq.addFrame("Program select", frame, len, CMD_WRITE_REG, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  
+  bus.submit(seq);
+}
+
+#if FEATURE_MQTT
 // =============================================
-// RS-485 SEND
+// MQTT HOOK (runs on the MQTT connect task)
 // =============================================
-void sendRS485(uint8_t* data, size_t length) {
-  printPacketHex("  TX", data, length);
-  
-  // Clear any stale bytes in the receive buffer
-  while (Serial2.available()) Serial2.read();
-  
-  // Enable transmitter and start data IMMEDIATELY after —
-  // minimizing the dead time where the bus is driven but no data flows.
-  // (Long dead time causes the receiver to pick up phantom bytes from the bus transition.)
-  digitalWrite(RS485_DE_RE_PIN, HIGH);
-  delayMicroseconds(500);  // MAX3485 DE needs 0.2μs; 500μs is 2500× margin
-  
-  // Bulk write all bytes at once into the 128-byte UART TX FIFO
-  Serial2.write(data, length);
-  Serial2.flush();  // Wait for FIFO to drain into shift register
-  
-  // After flush(), the last byte may still be in the shift register.
-  // At 9600 baud (8N1): 1 byte = 10 bits / 9600 = 1.042ms.
-  // Wait for (all bytes × 1.1ms) + 5ms margin, just in case flush() returned early.
-  unsigned int safetyMs = ((length * 11) / 10) + 5;
-  delay(safetyMs);
+// An attempt finished: wake loop() to take the client back
+void onMqttConnectDone() {
+  loopEvents.signal(LOOP_EV_NET);
+}
+#endif
+
+// =============================================
+// BUS TASK HOOKS (run on the RS-485 bus task)
+// =============================================
+// New snapshot: wake loop() to publish it
+void onBusUpdated() {
+  loopEvents.signal(LOOP_EV_BUS);
+}
+
+// Every frame sent or received, into the capture ring
+void captureFrame(uint8_t flags, const uint8_t* frame, size_t len) {
+  capture.record(flags, frame, len);
+}
+
+// Every valid frame received from the bus
+void handleBusFrame(const uint8_t* frame, size_t len) {
+  LOG_HEX(LOG_TRACE, "BUS", "RX", frame, len);
+  parseAndDisplayResponse(frame, len);
+}
+
+// Nothing queued or in progress: poll known pumps whose interval is up,
+// round-robin. At most one poll per AUTO_QUERY_GAP, so a full pad never
+// floods the bus and each pump gets its turn even if another is always due.
+void onBusIdle() {
+  if (bus.listenOnly() || millis() - lastPollSent < AUTO_QUERY_GAP) return;
+  
+  // A scheduled program about to lapse goes before any poll
+  if (schedule.keepAlive()) {
+    lastPollSent = millis();
+    return;
+  }
   
-  digitalWrite(RS485_DE_RE_PIN, LOW);   // Switch back to receive mode
+  for (int n = 0; n < PUMP_COUNT; n++) {
+    int i = (pollCursor + n) % PUMP_COUNT;
+    PumpStatus& p = pumps[i];
+    if (!p.present || millis() - p.lastQuery < p.pollMs) continue;
+    
+    pollPump(pumpAddress(i));
+    p.lastQuery = lastPollSent = millis();
+    pollCursor = (i + 1) % PUMP_COUNT;
+    return;
+  }
+}
+
+// Background status query (quiet: the reply is still logged)
+void pollPump(uint8_t addr) {
+  const PentairFixedFrame& f = pumpFrames[pumpIndex(addr)].query;
+  submitFrame("poll", f.bytes, f.len, onPollDone);
+}
+
+// A pump that stops answering drops to the heartbeat rate
+void onPollDone(uint8_t addr, bool ok) {
+  if (!ok) pumps[pumpIndex(addr)].pollMs = POLL_STOPPED_INTERVAL;
+}
+
+// Pick the next poll interval after a status reply or command ack.
+// fast = still moving / just commanded / faulted; otherwise double up to the cap.
+void adaptPolling(PumpStatus& p, bool fast) {
+  uint32_t cap = p.running ? POLL_MAX_INTERVAL : POLL_STOPPED_INTERVAL;
+  uint32_t next = fast ? POLL_MIN_INTERVAL
+                       : (p.pollMs < POLL_MIN_INTERVAL ? POLL_MIN_INTERVAL : (uint32_t)p.pollMs * 2);
+  p.pollMs = (next > cap) ? cap : next;
 }
 
 // =============================================
 // PARSE AND DISPLAY RESPONSE
 // (also updates pumpStatus struct for web UI)
 // =============================================
-void parseAndDisplayResponse(uint8_t* data, size_t length) {
+void parseAndDisplayResponse(const uint8_t* data, size_t length) {
   int msgStart = pentairFindMessage(data, length);
   if (msgStart < 0) {
-    Serial.println("  Could not find valid Pentair preamble (FF 00 FF A5)");
+    LOGW("BUS", "No Pentair preamble (FF 00 FF A5) in frame");
     return;
   }
   
-  uint8_t* pkt = &data[msgStart];
-  size_t remaining = length - msgStart;
+  PentairFrameView pkt(&data[msgStart], length - msgStart);
   
-  if (remaining < PENTAIR_MIN_PKT_LEN) {
-    Serial.println("  Packet too short");
+  if (pkt.size() < PENTAIR_MIN_PKT_LEN) {
+    LOGW("BUS", "Packet too short (%u bytes)", (unsigned)pkt.size());
     return;
   }
   
-  uint8_t version = pkt[PKT_IDX_VER];
-  uint8_t src     = pkt[PKT_IDX_SRC];
-  uint8_t dst     = pkt[PKT_IDX_DST];
-  uint8_t cmd     = pkt[PKT_IDX_CMD];
-  uint8_t dataLen = pkt[PKT_IDX_LEN];
+  uint8_t src     = pkt.src();
+  uint8_t dst     = pkt.dst();
+  uint8_t cmd     = pkt.cmd();
+  uint8_t dataLen = pkt.dataLen();   // Clipped to what was received
   
-  size_t totalLen = pentairPacketLength(pkt);
+  LOGT("BUS", "Ver: 0x%02X  Src: 0x%02X  Dst: 0x%02X  Cmd: 0x%02X  Len: %d  Checksum: %s",
+       pkt.version(), src, dst, cmd, dataLen, pkt.valid() ? "OK" : "BAD");
   
-  bool checksumOK = false;
-  if (totalLen <= remaining) {
-    checksumOK = pentairVerifyChecksum(pkt, totalLen);
+  // Another master talking to a pump (e.g. an IntelliCenter's status poll)
+  int idx = pumpIndex(src);
+  if (idx < 0) {
+    if (pumpIndex(dst) >= 0) {
+      LOGD("BUS", "Request from 0x%02X to pump 0x%02X: CMD 0x%02X (%s)",
+           src, dst, cmd, cmdName(cmd));
+    } else {
+      LOGT("BUS", "0x%02X -> 0x%02X: not pump traffic - ignored", src, dst);
+    }
+    return;
   }
   
-  Serial.printf("  Ver: 0x%02X  Src: 0x%02X  Dst: 0x%02X  Cmd: 0x%02X  Len: %d  Checksum: %s\n",
-                version, src, dst, cmd, dataLen, checksumOK ? "OK" : "BAD");
+  // Pump replies update the registry, whoever asked.
+  // Acks to other masters don't change our control state or polling.
+  bool ours = (dst == controllerAddr);
+  PumpStatus& pumpStatus = pumps[idx];
+  if (!pumpStatus.present) {
+    LOGI("BUS", "New pump on the bus: 0x%02X (pump %d)", src, idx + 1);
+    pumpStatus.present = true;
+  }
   
-  if (dataLen > 0 && PKT_IDX_DATA + dataLen <= remaining) {
-    uint8_t* respData = &pkt[PKT_IDX_DATA];
-    
+  if (pkt.complete() && dataLen > 0) {
     switch (cmd) {
       case CMD_CTRL:
-        Serial.printf("  >> Control mode: %s\n",
-                      respData[0] == CTRL_REMOTE ? "REMOTE" : "LOCAL");
+        LOGD("BUS", "0x%02X control mode: %s", src,
+             pkt.u8(0) == CTRL_REMOTE ? "REMOTE" : "LOCAL");
+        if (ours) pumpStatus.remote = (pkt.u8(0) == CTRL_REMOTE);
         break;
         
       case CMD_RUN:
-        Serial.printf("  >> Pump: %s\n",
-                      respData[0] == RUN_START ? "STARTED" : "STOPPED");
+        LOGD("BUS", "0x%02X pump: %s", src,
+             pkt.u8(0) == RUN_START ? "STARTED" : "STOPPED");
         // Update status from run/stop acknowledgment
-        pumpStatus.running = (respData[0] == RUN_START);
+        pumpStatus.running = (pkt.u8(0) == RUN_START);
         pumpStatus.lastUpdate = millis();
+        if (ours) commandAcked(pumpStatus);
         break;
         
       case CMD_MODE:
-        Serial.printf("  >> Mode set to: 0x%02X (%s)\n", respData[0], modeName(respData[0]));
-        pumpStatus.mode = respData[0];
+        LOGD("BUS", "0x%02X mode set to: 0x%02X (%s)", src, pkt.u8(0), modeName(pkt.u8(0)));
+        pumpStatus.mode = pkt.u8(0);
         pumpStatus.lastUpdate = millis();
+        if (ours) commandAcked(pumpStatus);
         break;
         
       case CMD_WRITE_REG:
         if (dataLen >= 2) {
-          uint16_t val = ((uint16_t)respData[0] << 8) | respData[1];
-          Serial.printf("  >> Register write confirmed, value: %d (0x%04X)\n", val, val);
+          uint16_t val = pkt.u16(0);
+          LOGD("BUS", "0x%02X register write confirmed, value: %d (0x%04X)", src, val, val);
         }
+        if (ours) commandAcked(pumpStatus);
         break;
         
       case CMD_STATUS:
-        if (dataLen >= STAT_DATA_LEN) {
-          uint8_t  runState = respData[STAT_RUN];
-          uint8_t  mode     = respData[STAT_MODE];
-          uint8_t  drive    = respData[STAT_DRIVE];
-          uint16_t watts    = ((uint16_t)respData[STAT_PWR_HI] << 8) | respData[STAT_PWR_LO];
-          uint16_t rpm      = ((uint16_t)respData[STAT_RPM_HI] << 8) | respData[STAT_RPM_LO];
-          uint8_t  gpm      = respData[STAT_GPM];
-          uint8_t  errCode  = respData[STAT_ERR];
-          uint8_t  timer    = respData[STAT_TIMER];
-          uint8_t  hour     = respData[STAT_CLK_HOUR];
-          uint8_t  minute   = respData[STAT_CLK_MIN];
+        if (pkt.has(STAT_DATA_LEN)) {
+          uint8_t  runState = pkt.u8(STAT_RUN);
+          uint8_t  mode     = pkt.u8(STAT_MODE);
+          uint8_t  drive    = pkt.u8(STAT_DRIVE);
+          uint16_t watts    = pkt.u16(STAT_PWR_HI);
+          uint16_t rpm      = pkt.u16(STAT_RPM_HI);
+          uint8_t  gpm      = pkt.u8(STAT_GPM);
+          uint8_t  errCode  = pkt.u8(STAT_ERR);
+          uint8_t  timer    = pkt.u8(STAT_TIMER);
+          uint8_t  hour     = pkt.u8(STAT_CLK_HOUR);
+          uint8_t  minute   = pkt.u8(STAT_CLK_MIN);
+          
+          // Still ramping / changing? (compared with the previous reading)
+          bool moving = !pumpStatus.valid ||
+                        (runState == RUN_START) != pumpStatus.running ||
+                        abs((int)rpm - (int)pumpStatus.rpm) > POLL_RPM_DEADBAND ||
+                        abs((int)watts - (int)pumpStatus.watts) > POLL_WATTS_DEADBAND;
           
           // Update pumpStatus struct for web UI
           pumpStatus.valid      = true;
@@ -816,39 +1841,47 @@ void parseAndDisplayResponse(uint8_t* data, size_t length) {
           pumpStatus.hour       = hour;
           pumpStatus.minute     = minute;
           pumpStatus.lastUpdate = millis();
+          pumpStatus.sampledAt  = pumpStatus.lastUpdate;
+          adaptPolling(pumpStatus, moving || errCode != 0);
+          if (!ours) pumpStatus.lastQuery = millis();  // Someone else polled: ours can wait
           
-          Serial.println("  ┌─────────────────────────────────┐");
-          Serial.printf( "  │ Status: %-8s  Mode: %-8s │\n",
-                         runState == RUN_START ? "RUNNING" : "STOPPED",
-                         modeName(mode));
-          Serial.printf( "  │ Speed:  %-5d RPM               │\n", rpm);
-          Serial.printf( "  │ Power:  %-5d Watts             │\n", watts);
-          Serial.printf( "  │ Flow:   %-3d GPM                 │\n", gpm);
-          Serial.printf( "  │ Drive:  0x%02X                     │\n", drive);
-          Serial.printf( "  │ Error:  0x%02X %s│\n", errCode,
-                         errCode == 0 ? "(none)                 " : "(ERROR!)               ");
-          Serial.printf( "  │ Timer:  %d min                  │\n", timer);
-          Serial.printf( "  │ Clock:  %02d:%02d                    │\n", hour, minute);
-          Serial.println("  └─────────────────────────────────┘");
+          LOGD("BUS", "0x%02X %s  %s  %d RPM  %d W  %d GPM  drive 0x%02X  error 0x%02X%s  "
+               "timer %d min  clock %02d:%02d",
+               src, runState == RUN_START ? "RUNNING" : "STOPPED", modeName(mode),
+               rpm, watts, gpm, drive, errCode, errCode == 0 ? "" : " (ERROR!)",
+               timer, hour, minute);
         } else {
-          Serial.println("  >> Status response (short data)");
-          for (int i = 0; i < dataLen; i++) {
-            Serial.printf("  Byte %d: 0x%02X\n", i, respData[i]);
-          }
+          LOG_HEX(LOG_DEBUG, "BUS", "Status response (short data)", pkt.data(), dataLen);
         }
         break;
         
       default:
-        Serial.print("  >> Data: ");
-        for (int i = 0; i < dataLen; i++) {
-          Serial.printf("%02X ", respData[i]);
-        }
-        Serial.println();
+        LOG_HEX(LOG_DEBUG, "BUS", "Data", pkt.data(), dataLen);
         break;
     }
   }
 }
 
+// Speed / state command accepted: watch the pump closely while it reacts
+void commandAcked(PumpStatus& p) {
+  adaptPolling(p, true);
+  p.lastQuery = millis();
+}
+
+// =============================================
+// COMMAND NAME HELPER (for sniffed requests)
+// =============================================
+const char* cmdName(uint8_t cmd) {
+  switch (cmd) {
+    case CMD_WRITE_REG: return "register write";
+    case CMD_CTRL:      return "remote/local";
+    case CMD_MODE:      return "set mode";
+    case CMD_RUN:       return "run/stop";
+    case CMD_STATUS:    return "status";
+    default:            return "other";
+  }
+}
+
 // =============================================
 // MODE NAME HELPER
 // =============================================
@@ -869,17 +1902,6 @@ const char* modeName(uint8_t mode) {
   }
 }
 
-// =============================================
-// PRINT PACKET HEX
-// =============================================
-void printPacketHex(const char* prefix, uint8_t* data, size_t length) {
-  Serial.printf("%s [%d bytes]: ", prefix, length);
-  for (size_t i = 0; i < length; i++) {
-    Serial.printf("%02X ", data[i]);
-  }
-  Serial.println();
-}
-
 // =============================================
 // PRINT BANNER
 // =============================================
@@ -888,13 +1910,39 @@ void printBanner() {
   Serial.println("  FlexPool - Pentair Pump Controller");
   Serial.println("  WiFi + RS-485 Remote Control");
   Serial.println("==============================================");
-  Serial.printf( "  Controller: 0x%02X  Pump: 0x%02X\n",
-                 controllerAddr, pumpAddr);
+  Serial.printf( "  Controller: 0x%02X  Pump: 0x%02X (poll mask 0x%X)\n",
+                 controllerAddr, pumpAddr, PUMP_POLL_MASK);
   Serial.println("  RS-485: 9600 baud, 8N1");
   Serial.println("  Protocol: Exact nodejs-poolController");
+  Serial.printf( "  Build: %s -%s%s%s%s%s%s%s\n", PROFILE_NAME,
+                 FEATURE_BLE ? " ble" : "", FEATURE_HTTP ? " http" : "",
+                 FEATURE_WEBUI ? " webui" : "", FEATURE_HISTORY ? " history" : "",
+                 FEATURE_MQTT ? " mqtt" : "", FEATURE_CONSOLE ? " console" : "",
+                 FEATURE_HEX_LOG ? " hex" : "");
+  Serial.printf( "  Log: %s (up to %s)\n",
+                 Logger::levelName(logger.level()), Logger::levelName(LOG_LEVEL_MAX));
   Serial.println("==============================================\n");
 }
 
+#if FEATURE_CONSOLE
+// =============================================
+// PRINT PUMPS (registry, Serial Monitor only)
+// =============================================
+void printPumps() {
+  BusSnapshot snap = bus.snapshot();
+  Serial.println("\n  #  Addr  Status   RPM    Watts  Control");
+  for (int i = 0; i < PUMP_COUNT; i++) {
+    const PumpStatus& p = snap.pumps[i];
+    if (!p.present) continue;
+    Serial.printf("  %d  0x%02X  %-7s  %-5d  %-5d  %s%s\n",
+                  i + 1, pumpAddress(i),
+                  !p.valid ? "?" : p.running ? "RUNNING" : "STOPPED",
+                  p.rpm, p.watts,
+                  p.remote ? "REMOTE" : "LOCAL",
+                  pumpAddress(i) == pumpAddr ? "   <- selected" : "");
+  }
+}
+
 // =============================================
 // PRINT MENU (Serial Monitor only)
 // =============================================
@@ -912,24 +1960,69 @@ void printMenu() {
   Serial.println("  11 - FULL: Set RPM and run");
   Serial.println("  12 - FULL: Stop pump");
   Serial.println("  99 - RAW TEST (sends AA BB CC DD EE)");
+  Serial.println("  --- Pumps ---");
+  Serial.printf( "  pump N - Target pump N (1-4), now: pump %d\n", pumpIndex(pumpAddr) + 1);
+  Serial.println("  pumps  - List known pumps");
+  Serial.println("  scan   - Look for pumps at 0x60-0x63");
+  Serial.println("  energy - kWh and cost of the selected pump, per RPM band");
+  Serial.println("  metrics - Bus health counters and reply latency (as on /metrics)");
+  Serial.println("  capture [on|off|clear] - RS-485 capture to LittleFS (status without args)");
+  Serial.println("  replay [SPEED|stop] - Feed the capture back in (1 = wire speed, 0 = flat out)");
+  Serial.println("  --- Schedule ---");
+  Serial.println("  sched  - List rules (external programs, local time)");
+  Serial.println("  sched N PUMP DAYS HH:MM HH:MM PROG RPM - Set rule N (DAYS: 0-6, 0 = Sun, or *)");
+  Serial.println("  sched N on|off|clear");
+  Serial.printf( "  listen / listen off - Passive sniffer mode (now %s)\n",
+                 bus.listenOnly() ? "ON" : "off");
+  Serial.printf( "  log [error|warn|info|debug|trace] - What is logged (now %s)\n",
+                 Logger::levelName(logger.level()));
+  Serial.println("  help   - This menu");
   Serial.println("  --- WiFi ---");
+#if FEATURE_BLE
   Serial.println("  setup - Start Bluetooth WiFi setup");
+#endif
   Serial.println("  wifi  - Connect WiFi (if credentials saved)");
+  Serial.println("  wifi join SSID PASSWORD - Save WiFi credentials and restart");
+#if FEATURE_BLE
   Serial.println("  reset - Clear WiFi & restart Bluetooth setup");
+#else
+  Serial.println("  reset - Clear WiFi credentials & restart");
+#endif
+#if FEATURE_MQTT
+  Serial.println("  --- MQTT ---");
+  Serial.println("  mqtt   - Broker, site and topics in use");
+  Serial.println("  mqtt broker mqtt[s]://HOST[:PORT] - Broker (mqtts:// = TLS)");
+  Serial.println("  mqtt user NAME PASSWORD / mqtt user - - Login / anonymous");
+  Serial.println("  mqtt site SITE / mqtt pad LABEL - Topic site, summary label (\"-\" clears)");
+  Serial.println("  mqtt reset / mqtt apply - Build defaults / restart onto the saved settings");
+#endif
   Serial.println("========================================");
   
   if (wifiConnected && WiFi.status() == WL_CONNECTED) {
-    Serial.printf("  WiFi: http://flexpool.local or http://%s\n",
+#if FEATURE_HTTP
+    Serial.printf("  WiFi: http://%s.local or http://%s\n", MDNS_HOSTNAME,
                   WiFi.localIP().toString().c_str());
+#else
+    Serial.printf("  WiFi: %s\n", WiFi.localIP().toString().c_str());
+#endif
     Serial.printf("  Network: %s (%d dBm)\n",
                   BLESetup::getSavedSSID().c_str(), WiFi.RSSI());
+#if FEATURE_MQTT
     Serial.printf("  MQTT: %s  Device ID: %s\n",
                   mqtt.isConnected() ? "Connected" : "Disconnected",
                   mqtt.getDeviceId().c_str());
+#endif
   } else {
     Serial.println("  WiFi: Not connected");
   }
+#if FEATURE_MQTT
+  if (wifiConnected && (mqtt.queued() || mqtt.queuedFileBytes() || mqtt.queueDropped())) {
+    Serial.printf("  MQTT queue: %u in RAM, %u bytes in flash, %lu dropped\n", mqtt.queued(),
+                  (unsigned)mqtt.queuedFileBytes(), (unsigned long)mqtt.queueDropped());
+  }
+#endif
   
   Serial.println("========================================");
   Serial.print("Enter command: ");
 }
+#endif // FEATURE_CONSOLE
@@ -0,0 +1,279 @@
+/*
+ * =============================================
+ * Energy.h - kWh accounting per pump (NVS-backed)
+ * =============================================
+ *
+ * Every status reply carries the pump's power draw. Between two
+ * replies the energy used is the trapezoid under the two readings:
+ *
+ *   E += (watts_prev + watts_now) / 2 * (sampledAt_now - sampledAt_prev)
+ *
+ * Only status replies set sampledAt: a run or mode ack changes
+ * lastUpdate but carries no power reading.
+ *
+ * A gap longer than ENERGY_MAX_GAP_MS (pump not answering, bus
+ * unplugged) is not bridged: that stretch is counted as unknown
+ * rather than guessed, and integration restarts at the next reply.
+ *
+ * KEPT PER PUMP:
+ *   today, this week (Monday-Sunday), lifetime    kWh
+ *   per RPM band: kWh + hours spent in the band     (lifetime)
+ *
+ * The bands answer "what does 1500 vs 2750 RPM actually cost": power
+ * rises with roughly the cube of speed, so the same water moved
+ * slowly for longer is usually far cheaper.
+ *
+ * Day / week roll over on the local calendar once the clock is set
+ * (SNTP); before that everything accumulates into the current day.
+ *
+ * NVS WEAR:
+ *   Totals live in RAM. A pump's record (one blob) is written only
+ *   when it changed and ENERGY_SAVE_INTERVAL_MS has passed, or at a
+ *   day rollover - a handful of writes a day instead of one per reply.
+ *   Power loss costs at most one interval of accounting.
+ *
+ * USAGE (Controller.ino):
+ *   energy.begin();              setup()
+ *   energy.update(snap);         whenever the bus reports new data
+ *   energy.loop();               every loop (coalesced NVS saves)
+ */
+
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <time.h>
+#include "PumpStatus.h"
+#include "RS485Bus.h"
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define ENERGY_MAX_GAP_MS        (2 * STATUS_QUERY_INTERVAL)  // Longest interval integrated
+#define ENERGY_SAVE_INTERVAL_MS  (15UL * 60 * 1000)           // Min spacing of NVS writes
+#define ENERGY_BAND_RPM          250     // Width of one RPM band
+#define ENERGY_BANDS             15      // 0-249 (stopped), ..., 3500+
+#define ENERGY_PRICE_PER_KWH     0.15    // Tariff used for the cost figures
+#define ENERGY_CLOCK_MIN         1600000000L   // Clock counts as set past this
+#define ENERGY_PREFS_NAMESPACE   "energy"
+
+// =============================================
+// ONE PUMP'S TOTALS (the NVS blob - append fields, bump version)
+// =============================================
+// Energy in millijoules (W x ms): exact integer sums, and 64 bits
+// hold a 3 kW pump for ~3 million years.
+struct EnergyTotals {
+  uint8_t  version  = 1;
+  int32_t  day      = -1;          // Local days since 1970 of "today"
+  int32_t  week     = -1;          // Local weeks since 1970 (Monday start)
+  uint64_t todayMj  = 0;
+  uint64_t weekMj   = 0;
+  uint64_t lifeMj   = 0;
+  uint64_t bandMj[ENERGY_BANDS] = {0};
+  uint64_t bandMs[ENERGY_BANDS] = {0};
+};
+
+inline double mjToKwh(uint64_t mj) { return mj / 3.6e9; }
+
+// RPM band of a reading
+inline int energyBand(uint16_t rpm) {
+  int band = rpm / ENERGY_BAND_RPM;
+  return band < ENERGY_BANDS ? band : ENERGY_BANDS - 1;
+}
+
+// Local calendar day number (days since 1970-01-01), or -1 if the clock
+// isn't set. Day-from-civil, so DST / time zone come from localtime().
+inline int32_t energyLocalDay() {
+  time_t now = time(nullptr);
+  if (now < ENERGY_CLOCK_MIN) return -1;
+  struct tm tm;
+  localtime_r(&now, &tm);
+  int y = tm.tm_year + 1900;
+  int m = tm.tm_mon + 1;
+  y -= m <= 2;
+  int era = (y >= 0 ? y : y - 399) / 400;
+  int yoe = y - era * 400;
+  int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + tm.tm_mday - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+// 1970-01-01 was a Thursday: +3 makes weeks start on Monday
+inline int32_t energyWeekOf(int32_t day) { return (day + 3) / 7; }
+
+// =============================================
+// EnergyMeter CLASS
+// =============================================
+class EnergyMeter {
+private:
+  struct Last {
+    bool          have = false;
+    unsigned long at = 0;           // sampledAt of the previous reading
+    uint16_t      watts = 0;
+    uint16_t      rpm = 0;
+  };
+
+  EnergyTotals  _totals[PUMP_COUNT];
+  Last          _last[PUMP_COUNT];
+  bool          _dirty[PUMP_COUNT] = {false};
+  unsigned long _lastSave = 0;
+  unsigned long _lastRollCheck = 0;
+  portMUX_TYPE  _mux = portMUX_INITIALIZER_UNLOCKED;   // _totals vs. web readers
+
+  static void key(char* out, size_t size, int idx) { snprintf(out, size, "p%d", idx + 1); }
+
+  void save(int idx) {
+    EnergyTotals copy = totals(idx);
+    char k[4];
+    key(k, sizeof(k), idx);
+    Preferences prefs;
+    prefs.begin(ENERGY_PREFS_NAMESPACE, false);
+    prefs.putBytes(k, &copy, sizeof(copy));
+    prefs.end();
+    _dirty[idx] = false;
+  }
+
+  // Start a new day / week where the calendar says so
+  void rollOver(int idx, int32_t day) {
+    if (day < 0) return;
+    EnergyTotals& t = _totals[idx];
+    if (t.day == day) return;
+    bool saved = t.day >= 0;         // -1: first day with a clock, keep the counts
+    portENTER_CRITICAL(&_mux);
+    if (saved) t.todayMj = 0;
+    if (saved && t.week != energyWeekOf(day)) t.weekMj = 0;
+    t.day  = day;
+    t.week = energyWeekOf(day);
+    portEXIT_CRITICAL(&_mux);
+    if (t.lifeMj) save(idx);         // Pumps that never ran: nothing to keep
+  }
+
+public:
+  // Load saved totals (setup)
+  void begin() {
+    Preferences prefs;
+    prefs.begin(ENERGY_PREFS_NAMESPACE, true);
+    for (int i = 0; i < PUMP_COUNT; i++) {
+      char k[4];
+      key(k, sizeof(k), i);
+      EnergyTotals saved;
+      if (prefs.getBytesLength(k) == sizeof(saved) &&
+          prefs.getBytes(k, &saved, sizeof(saved)) == sizeof(saved) &&
+          saved.version == EnergyTotals().version) {
+        _totals[i] = saved;
+      }
+    }
+    prefs.end();
+  }
+
+  /*
+   * Integrate every pump that has a new reading since the last call
+   * (loop task, on bus updates).
+   */
+  void update(const BusSnapshot& snap) {
+    if (snap.replay) return;       // A capture's readings never reach the totals
+    for (int i = 0; i < PUMP_COUNT; i++) {
+      const PumpStatus& p = snap.pumps[i];
+      Last& last = _last[i];
+      if (!p.valid || (last.have && p.sampledAt == last.at)) continue;
+
+      unsigned long dt = p.sampledAt - last.at;
+      if (last.have && dt <= ENERGY_MAX_GAP_MS) {
+        uint64_t mj = (uint64_t)(last.watts + p.watts) * dt / 2;
+        int band = energyBand((last.rpm + p.rpm) / 2);
+        EnergyTotals& t = _totals[i];
+        portENTER_CRITICAL(&_mux);
+        t.todayMj += mj;
+        t.weekMj  += mj;
+        t.lifeMj  += mj;
+        t.bandMj[band]  += mj;
+        t.bandMs[band] += dt;
+        portEXIT_CRITICAL(&_mux);
+        _dirty[i] = true;
+      }
+      last.have  = true;
+      last.at    = p.sampledAt;
+      last.watts = p.watts;
+      last.rpm   = p.rpm;
+    }
+  }
+
+  // Calendar rollover + coalesced NVS writes (loop task)
+  void loop() {
+    unsigned long now = millis();
+    if (now - _lastRollCheck >= 10000) {
+      _lastRollCheck = now;
+      int32_t day = energyLocalDay();
+      for (int i = 0; i < PUMP_COUNT; i++) rollOver(i, day);
+    }
+    if (now - _lastSave >= ENERGY_SAVE_INTERVAL_MS) {
+      _lastSave = now;
+      for (int i = 0; i < PUMP_COUNT; i++) {
+        if (_dirty[i]) save(i);
+      }
+    }
+  }
+
+  // Consistent copy of one pump's totals (any task)
+  EnergyTotals totals(int idx) {
+    portENTER_CRITICAL(&_mux);
+    EnergyTotals t = _totals[idx];
+    portEXIT_CRITICAL(&_mux);
+    return t;
+  }
+
+  /*
+   * {"pump":1,"today":{"kwh":..,"cost":..},"week":{..},"lifetime":{..},
+   *  "pricePerKwh":0.15,"bands":[{"rpm":1500,"kwh":..,"hours":..,
+   *  "avgWatts":..,"cost":..},...]}   (bands never used are left out)
+   * out: anything with printf() - an AsyncResponseStream, Serial. With
+   * every band used this is well over 1 KB, so it is streamed, not
+   * built in a buffer.
+   */
+  template <typename Out>
+  void printJson(Out& out, int idx) {
+    EnergyTotals t = totals(idx);
+    out.printf(
+      "{\"pump\":%d,"
+      "\"today\":{\"kwh\":%.3f,\"cost\":%.2f},"
+      "\"week\":{\"kwh\":%.3f,\"cost\":%.2f},"
+      "\"lifetime\":{\"kwh\":%.3f,\"cost\":%.2f},"
+      "\"pricePerKwh\":%.3f,\"bands\":[",
+      idx + 1,
+      mjToKwh(t.todayMj), mjToKwh(t.todayMj) * ENERGY_PRICE_PER_KWH,
+      mjToKwh(t.weekMj),  mjToKwh(t.weekMj)  * ENERGY_PRICE_PER_KWH,
+      mjToKwh(t.lifeMj),  mjToKwh(t.lifeMj)  * ENERGY_PRICE_PER_KWH,
+      ENERGY_PRICE_PER_KWH);
+    bool first = true;
+    for (int b = 0; b < ENERGY_BANDS; b++) {
+      if (!t.bandMs[b]) continue;
+      double kwh = mjToKwh(t.bandMj[b]);
+      out.printf(
+        "%s{\"rpm\":%d,\"kwh\":%.3f,\"hours\":%.2f,\"avgWatts\":%lu,\"cost\":%.2f}",
+        first ? "" : ",", b * ENERGY_BAND_RPM, kwh, t.bandMs[b] / 3.6e6,
+        (unsigned long)(t.bandMj[b] / t.bandMs[b]), kwh * ENERGY_PRICE_PER_KWH);
+      first = false;
+    }
+    out.printf("]}");
+  }
+
+  // Serial Monitor table
+  void print(int idx) {
+    EnergyTotals t = totals(idx);
+    Serial.printf("\n  Pump %d energy   today %.3f kWh   week %.3f kWh   lifetime %.3f kWh\n",
+                  idx + 1, mjToKwh(t.todayMj), mjToKwh(t.weekMj), mjToKwh(t.lifeMj));
+    Serial.println("  RPM band    Hours     kWh      Avg W   Cost");
+    for (int b = 0; b < ENERGY_BANDS; b++) {
+      if (!t.bandMs[b]) continue;
+      double kwh = mjToKwh(t.bandMj[b]);
+      Serial.printf("  %4d-%-5d  %-8.2f  %-7.3f  %-6lu  %.2f\n",
+                    b * ENERGY_BAND_RPM, b == ENERGY_BANDS - 1 ? 9999 : (b + 1) * ENERGY_BAND_RPM - 1,
+                    t.bandMs[b] / 3.6e6, kwh,
+                    (unsigned long)(t.bandMj[b] / t.bandMs[b]),
+                    kwh * ENERGY_PRICE_PER_KWH);
+    }
+  }
+};
+
+#endif // ENERGY_H
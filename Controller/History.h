@@ -0,0 +1,403 @@
+/*
+ * =============================================
+ * History.h - Pump telemetry history (RAM rings + LittleFS)
+ * =============================================
+ *
+ * Once a second every recorded pump's reading is sampled from
+ * bus.snapshot() into three fixed-size rings, one per resolution:
+ *
+ *   tier  res      kept       samples
+ *   raw   1 s      10 min     600
+ *   min   1 min    24 h       1440     average of the raw samples
+ *   qtr   15 min   30 days    2880     average of the raw samples
+ *
+ * A sample is 10 bytes: time, rpm, watts, gpm, error. About 48 KB of
+ * RAM per recorded pump, all allocated at compile time.
+ *
+ * An average only covers seconds the pump actually answered; a bucket
+ * with no valid reading is left out, so gaps in the pump's history
+ * show up as gaps here too. "error" is the last non-zero code seen in
+ * the bucket.
+ *
+ * TIME:
+ *   Samples carry epoch seconds once the clock is set (SNTP), uptime
+ *   seconds before that. Only epoch-stamped samples are persisted.
+ *
+ * PERSISTENCE (HISTORY_PERSIST):
+ *   The min and qtr tiers are appended to LittleFS as they are made,
+ *   one file per pump and tier (/hist/p1-60.bin, /hist/p1-900.bin):
+ *   a 4-byte magic followed by HistorySample records, little-endian,
+ *   never rewritten in place. Once a file holds twice its ring's
+ *   worth, it is rewritten from the ring. At boot the newest records
+ *   are read back, so the 24 h / 30 day views survive a restart.
+ *
+ * HTTP:
+ *   GET /api/history?pump=N&from=T&to=T&res=1|60|900
+ *   {"pump":1,"res":60,"fields":["t","rpm","watts","gpm","error"],
+ *    "samples":[[1700000000,2000,410,38,0],...]}
+ *   Streamed a TCP window at a time straight out of the ring, never
+ *   assembled in RAM. Without res, the finest tier reaching back to
+ *   "from" is used.
+ *
+ * THREADING:
+ *   loop() (sampling, files) runs on the loop task, the HTTP stream
+ *   on the AsyncTCP task. Samples are copied in and out of the rings
+ *   under a spinlock, one at a time.
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <time.h>
+#include "PumpStatus.h"
+#include "RS485Bus.h"
+#include "Log.h"
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#ifndef HISTORY_PUMPS
+#define HISTORY_PUMPS       1        // Registry slots recorded: pump 1..N (~48 KB each)
+#endif
+#define HISTORY_RAW_LEN     600      // 1 s samples     -> 10 minutes
+#define HISTORY_MIN_LEN     1440     // 1 min averages  -> 24 hours
+#define HISTORY_QTR_LEN     2880     // 15 min averages -> 30 days
+#define HISTORY_PERSIST     1        // Keep the min / qtr tiers in LittleFS
+#define HISTORY_DIR         "/hist"
+#define HISTORY_EPOCH_MIN   1600000000UL   // Clock counts as set past this (Sept 2020)
+
+#if HISTORY_PUMPS < 1 || HISTORY_PUMPS > PUMP_COUNT
+#error "HISTORY_PUMPS must be 1-PUMP_COUNT"
+#endif
+
+#if HISTORY_PERSIST
+#include <LittleFS.h>
+#endif
+
+extern RS485Bus bus;
+
+// =============================================
+// ONE SAMPLE (also the on-flash record)
+// =============================================
+struct __attribute__((packed)) HistorySample {
+  uint32_t t;        // Epoch or uptime seconds (see TIME above)
+  uint16_t rpm;
+  uint16_t watts;
+  uint8_t  gpm;
+  uint8_t  err;      // 0 = none
+};
+static_assert(sizeof(HistorySample) == 10, "HistorySample is the file format");
+
+enum HistoryTier : uint8_t { HT_RAW, HT_MIN, HT_QTR, HT_COUNT };
+
+// Seconds per sample, per tier
+const uint16_t HISTORY_RES[HT_COUNT] = { 1, 60, 900 };
+
+#if HISTORY_PERSIST
+// First bytes of every history file (bump the digit if HistorySample changes)
+const uint8_t HISTORY_MAGIC[4] = { 'F', 'P', 'H', '1' };
+#endif
+
+// Seconds now: epoch once SNTP has set the clock, uptime until then
+inline uint32_t historyClock() {
+  time_t now = time(nullptr);
+  return now > (time_t)HISTORY_EPOCH_MIN ? (uint32_t)now : millis() / 1000;
+}
+
+// =============================================
+// RING (fixed storage, absolute sample numbers)
+// =============================================
+// Sample k lives in s[k % cap] and is still there while k >= first().
+// Readers keep k, not a slot, so an overwrite just skips them ahead.
+struct HistoryRing {
+  HistorySample*    s = nullptr;
+  uint32_t          cap = 0;
+  volatile uint32_t written = 0;
+
+  uint32_t first() const { return written > cap ? written - cap : 0; }
+  void push(const HistorySample& x) {
+    s[written % cap] = x;
+    written++;
+  }
+};
+
+// =============================================
+// BUCKET AVERAGE (one per averaged tier)
+// =============================================
+struct HistoryAverage {
+  uint32_t bucket = 0;     // t / res of the bucket being filled
+  uint32_t rpm = 0, watts = 0, gpm = 0;
+  uint16_t n = 0;
+  uint8_t  err = 0;
+
+  void add(const HistorySample& x) {
+    rpm += x.rpm;
+    watts += x.watts;
+    gpm += x.gpm;
+    if (x.err) err = x.err;
+    n++;
+  }
+  // The average, stamped with the bucket's start; resets for the next
+  HistorySample take(uint16_t res) {
+    HistorySample a;
+    a.t     = bucket * res;
+    a.rpm   = (rpm + n / 2) / n;
+    a.watts = (watts + n / 2) / n;
+    a.gpm   = (gpm + n / 2) / n;
+    a.err   = err;
+    *this = HistoryAverage();
+    return a;
+  }
+};
+
+// =============================================
+// History CLASS
+// =============================================
+class History {
+private:
+  HistorySample  _raw[HISTORY_PUMPS][HISTORY_RAW_LEN];
+  HistorySample  _min[HISTORY_PUMPS][HISTORY_MIN_LEN];
+  HistorySample  _qtr[HISTORY_PUMPS][HISTORY_QTR_LEN];
+  HistoryRing    _rings[HISTORY_PUMPS][HT_COUNT];
+  HistoryAverage _avg[HISTORY_PUMPS][HT_COUNT];    // [HT_RAW] unused
+  portMUX_TYPE   _mux = portMUX_INITIALIZER_UNLOCKED;
+  unsigned long  _lastSample = 0;
+  bool           _fs = false;                      // LittleFS mounted
+
+  void push(int idx, HistoryTier tier, const HistorySample& x) {
+    portENTER_CRITICAL(&_mux);
+    _rings[idx][tier].push(x);
+    portEXIT_CRITICAL(&_mux);
+  }
+
+  // Add one second's reading; closes the averages it completes
+  void record(int idx, const HistorySample& x) {
+    push(idx, HT_RAW, x);
+    for (int tier = HT_MIN; tier < HT_COUNT; tier++) {
+      HistoryAverage& avg = _avg[idx][tier];
+      uint32_t bucket = x.t / HISTORY_RES[tier];
+      if (avg.n && avg.bucket != bucket) {
+        HistorySample a = avg.take(HISTORY_RES[tier]);
+        push(idx, (HistoryTier)tier, a);
+        append(idx, (HistoryTier)tier, a);
+      }
+      avg.bucket = bucket;
+      avg.add(x);
+    }
+  }
+
+  // ---- LittleFS (loop task only) ----
+#if HISTORY_PERSIST
+  static void path(char* out, size_t size, int idx, HistoryTier tier) {
+    snprintf(out, size, HISTORY_DIR "/p%d-%u.bin", idx + 1, HISTORY_RES[tier]);
+  }
+
+  void append(int idx, HistoryTier tier, const HistorySample& x) {
+    if (!_fs || x.t < HISTORY_EPOCH_MIN) return;
+    char name[32];
+    path(name, sizeof(name), idx, tier);
+    File f = LittleFS.open(name, "a");
+    if (!f) return;
+    if (f.size() == 0) f.write(HISTORY_MAGIC, sizeof(HISTORY_MAGIC));
+    f.write((const uint8_t*)&x, sizeof(x));
+    size_t size = f.size();
+    f.close();
+    if (size >= sizeof(HISTORY_MAGIC) + 2 * _rings[idx][tier].cap * sizeof(HistorySample)) {
+      compact(idx, tier, name);
+    }
+  }
+
+  // Rewrite a grown file with what the ring still holds
+  void compact(int idx, HistoryTier tier, const char* name) {
+    char tmp[36];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", name);
+    File f = LittleFS.open(tmp, "w");
+    if (!f) return;
+    f.write(HISTORY_MAGIC, sizeof(HISTORY_MAGIC));
+    const HistoryRing& r = _rings[idx][tier];
+    for (uint32_t k = r.first(); k < r.written; k++) {
+      const HistorySample& x = r.s[k % r.cap];
+      if (x.t >= HISTORY_EPOCH_MIN) f.write((const uint8_t*)&x, sizeof(x));
+    }
+    f.close();
+    // Replaces name in one step: a power cut leaves the old file or the new one
+    LittleFS.rename(tmp, name);
+    LOGI("HIST", "Compacted %s", name);
+  }
+
+  // Newest ring's worth of records back into RAM (boot)
+  void load(int idx, HistoryTier tier) {
+    char name[32], tmp[36];
+    path(name, sizeof(name), idx, tier);
+    snprintf(tmp, sizeof(tmp), "%s.tmp", name);
+    if (LittleFS.exists(tmp)) LittleFS.remove(tmp);   // A compaction cut short; name is still whole
+    File f = LittleFS.open(name, "r");
+    if (!f) return;
+    uint8_t magic[sizeof(HISTORY_MAGIC)];
+    if (f.read(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, HISTORY_MAGIC, sizeof(HISTORY_MAGIC)) != 0) {
+      f.close();
+      Serial.printf("[HIST] %s: not a history file, removed\n", name);
+      LittleFS.remove(name);
+      return;
+    }
+    uint32_t records = (f.size() - sizeof(HISTORY_MAGIC)) / sizeof(HistorySample);
+    uint32_t skip = records > _rings[idx][tier].cap ? records - _rings[idx][tier].cap : 0;
+    f.seek(sizeof(HISTORY_MAGIC) + skip * sizeof(HistorySample));
+
+    HistorySample chunk[32];
+    size_t got;
+    uint32_t loaded = 0;
+    while ((got = f.read((uint8_t*)chunk, sizeof(chunk)) / sizeof(HistorySample)) > 0) {
+      for (size_t i = 0; i < got; i++) push(idx, tier, chunk[i]);
+      loaded += got;
+    }
+    f.close();
+    Serial.printf("[HIST] %s: %lu samples\n", name, (unsigned long)loaded);
+  }
+#else
+  void append(int, HistoryTier, const HistorySample&) {}
+#endif
+
+public:
+  History() {
+    for (int i = 0; i < HISTORY_PUMPS; i++) {
+      _rings[i][HT_RAW].s = _raw[i];  _rings[i][HT_RAW].cap = HISTORY_RAW_LEN;
+      _rings[i][HT_MIN].s = _min[i];  _rings[i][HT_MIN].cap = HISTORY_MIN_LEN;
+      _rings[i][HT_QTR].s = _qtr[i];  _rings[i][HT_QTR].cap = HISTORY_QTR_LEN;
+    }
+  }
+
+  // Mount LittleFS and reload the saved tiers (setup, before loop())
+  void begin() {
+#if HISTORY_PERSIST
+    _fs = LittleFS.begin(true);    // Formats an empty / corrupt partition
+    if (!_fs) {
+      Serial.println("[HIST] LittleFS mount failed - history is RAM only");
+      return;
+    }
+    LittleFS.mkdir(HISTORY_DIR);
+    for (int i = 0; i < HISTORY_PUMPS; i++) {
+      load(i, HT_MIN);
+      load(i, HT_QTR);
+    }
+#endif
+  }
+
+  // Sample every recorded pump once a second (loop task)
+  void loop() {
+    unsigned long now = millis();
+    if (now - _lastSample < 1000) return;
+    // Hold a steady 1 Hz, but don't replay seconds a long stall skipped
+    _lastSample = (now - _lastSample < 2000) ? _lastSample + 1000 : now;
+
+    BusSnapshot snap = bus.snapshot();
+    if (snap.replay) return;       // Replayed readings are not this pad's history
+    uint32_t t = historyClock();
+    for (int i = 0; i < HISTORY_PUMPS; i++) {
+      const PumpStatus& p = snap.pumps[i];
+      if (!p.valid) continue;
+      HistorySample x;
+      x.t     = t;
+      x.rpm   = p.rpm;
+      x.watts = p.watts;
+      x.gpm   = p.gpm;
+      x.err   = p.errCode;
+      record(i, x);
+    }
+  }
+
+  // Milliseconds until loop() takes the next sample
+  unsigned long msUntilDue() const {
+    unsigned long since = millis() - _lastSample;
+    return since >= 1000 ? 0 : 1000 - since;
+  }
+
+  // Is registry slot idx recorded?
+  bool records(int idx) const { return idx >= 0 && idx < HISTORY_PUMPS; }
+
+  // Tier for ?res= (seconds), or HT_COUNT if it isn't one of ours
+  static HistoryTier tierFor(uint32_t res) {
+    for (int tier = 0; tier < HT_COUNT; tier++) {
+      if (HISTORY_RES[tier] == res) return (HistoryTier)tier;
+    }
+    return HT_COUNT;
+  }
+
+  // Finest tier whose oldest sample is no newer than from, else the
+  // coarsest one holding anything
+  HistoryTier tierReaching(int idx, uint32_t from) {
+    HistoryTier best = HT_RAW;
+    for (int tier = HT_RAW; tier < HT_COUNT; tier++) {
+      HistorySample oldest;
+      if (!sampleAt(idx, (HistoryTier)tier, _rings[idx][tier].first(), oldest)) continue;
+      if (oldest.t <= from) return (HistoryTier)tier;
+      best = (HistoryTier)tier;
+    }
+    return best;
+  }
+
+  /*
+   * Copy sample k of a tier out (any task).
+   * False if k has not been written yet or was already overwritten.
+   */
+  bool sampleAt(int idx, HistoryTier tier, uint32_t k, HistorySample& out) {
+    const HistoryRing& r = _rings[idx][tier];
+    bool ok;
+    portENTER_CRITICAL(&_mux);
+    ok = k >= r.first() && k < r.written;
+    if (ok) out = r.s[k % r.cap];
+    portEXIT_CRITICAL(&_mux);
+    return ok;
+  }
+
+  /*
+   * Chunked JSON response for samples with from <= t <= to (AsyncTCP task).
+   * The filler keeps its own cursor and writes whole samples only, as
+   * many as fit in each buffer the server hands it.
+   */
+  AsyncWebServerResponse* stream(AsyncWebServerRequest* request, int idx,
+                                 uint32_t from, uint32_t to, HistoryTier tier) {
+    History* self = this;
+    uint32_t k = _rings[idx][tier].first();
+    uint8_t  part = 0;        // 0 header, 1 samples, 2 footer, 3 done
+    bool     first = true;
+
+    return request->beginChunkedResponse("application/json",
+      [self, idx, from, to, tier, k, part, first](uint8_t* buf, size_t max, size_t) mutable -> size_t {
+        const size_t ROOM = 48;   // Longest header / sample / footer, with margin
+        size_t len = 0;
+
+        if (part == 0) {
+          if (max < 96) return RESPONSE_TRY_AGAIN;
+          len += snprintf((char*)buf, max,
+                          "{\"pump\":%d,\"res\":%u,\"fields\":[\"t\",\"rpm\",\"watts\",\"gpm\",\"error\"],"
+                          "\"samples\":[", idx + 1, HISTORY_RES[tier]);
+          part = 1;
+        }
+        while (part == 1 && max - len >= ROOM) {
+          HistorySample x;
+          if (!self->sampleAt(idx, tier, k, x)) {
+            // Overwritten while we streamed: skip to the oldest still there
+            uint32_t oldest = self->_rings[idx][tier].first();
+            if (k < oldest) { k = oldest; continue; }
+            part = 2;       // Caught up with the writer
+            break;
+          }
+          k++;
+          if (x.t < from || x.t > to) continue;
+          len += snprintf((char*)buf + len, max - len, "%s[%lu,%u,%u,%u,%u]",
+                          first ? "" : ",", (unsigned long)x.t, x.rpm, x.watts, x.gpm, x.err);
+          first = false;
+        }
+        if (part == 2 && max - len >= ROOM) {
+          len += snprintf((char*)buf + len, max - len, "]}");
+          part = 3;
+        }
+        return len ? len : (part == 3 ? 0 : RESPONSE_TRY_AGAIN);
+      });
+  }
+};
+
+#endif // HISTORY_H
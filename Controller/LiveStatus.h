@@ -0,0 +1,97 @@
+/*
+ * =============================================
+ * LiveStatus.h - Push status to local browsers (Server-Sent Events)
+ * =============================================
+ *
+ * The Web UI opens  GET /events  once and gets status pushed to it
+ * instead of polling /api/status:
+ *
+ *   event: status   full status of the default pump, sent once on connect
+ *                   (same JSON as the MQTT status topic)
+ *   event: delta    {"pump":n, ...only the fields that changed...}
+ *                   sent when a pump's reading actually changes
+ *
+ * Nothing is formatted or sent while no browser is connected.
+ *
+ * USAGE (Controller.ino):
+ *   live.begin(server);           before server.begin()
+ *   live.publish(bus.snapshot()); whenever the bus reports new data
+ *
+ * REQUIRES: ESPAsyncWebServer (AsyncEventSource is part of it)
+ */
+
+#ifndef LIVE_STATUS_H
+#define LIVE_STATUS_H
+
+#include <ESPAsyncWebServer.h>
+#include "PumpStatus.h"
+#include "RS485Bus.h"
+#include "StatusFormat.h"
+#include "Log.h"
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define LIVE_RECONNECT_MS  3000    // Browser retry delay after a dropped stream
+
+// Status / delta formatters are shared with MQTT (StatusFormat.h)
+extern RS485Bus bus;               // Defined in Controller.ino
+extern uint8_t pumpAddr;           // Default pump, shown by the Web UI
+
+// =============================================
+// LiveStatus CLASS
+// =============================================
+class LiveStatus {
+private:
+  AsyncEventSource _events;
+  BusSnapshot      _sent;          // What connected browsers last saw
+  uint32_t         _nextId = 1;    // One sequence for snapshots and deltas
+  portMUX_TYPE     _mux = portMUX_INITIALIZER_UNLOCKED;   // Loop vs. AsyncTCP task
+
+  uint32_t nextId() {
+    portENTER_CRITICAL(&_mux);
+    uint32_t id = _nextId++;
+    portEXIT_CRITICAL(&_mux);
+    return id;
+  }
+
+public:
+  LiveStatus() : _events("/events") {}
+
+  // Register /events on the web server (call before server.begin())
+  void begin(AsyncWebServer& server) {
+    // Runs on the AsyncTCP task: builds its own snapshot; only the
+    // event ID is shared
+    _events.onConnect([this](AsyncEventSourceClient* client) {
+      BusSnapshot snap = bus.snapshot();
+      char json[384];
+      if (!formatStatus(json, sizeof(json), snap, pumpIndex(pumpAddr))) {
+        LOGW("LIVE", "Status too large for the /events snapshot, not sent");
+        return;       // The browser still gets the deltas
+      }
+      client->send(json, "status", nextId(), LIVE_RECONNECT_MS);
+    });
+    server.addHandler(&_events);
+  }
+
+  // Browsers currently listening
+  size_t clients() const { return _events.count(); }
+
+  /*
+   * Push what changed since the last call (loop task).
+   * With no browser connected this only records the new baseline.
+   */
+  void publish(const BusSnapshot& snap) {
+    if (_events.count() > 0) {
+      char json[256];
+      for (int i = 0; i < PUMP_COUNT; i++) {
+        if (formatDelta(json, sizeof(json), _sent, snap, i)) {
+          _events.send(json, "delta", nextId());
+        }
+      }
+    }
+    _sent = snap;
+  }
+};
+
+#endif // LIVE_STATUS_H
@@ -0,0 +1,284 @@
+/*
+ * =============================================
+ * Log.h - Leveled, rate-limited, non-blocking logging
+ * =============================================
+ *
+ * Serial.printf blocks the caller until the UART FIFO (or the USB CDC
+ * host) takes the bytes: at 115200 baud a hex dump plus its decode is
+ * ~10 ms, spent on the bus task between a reply and the next request.
+ * LOGx() only formats the line into a RAM ring (a few tens of µs) and
+ * returns; a low-priority task drains the ring to Serial and any sinks.
+ *
+ * LEVELS:
+ *   LOG_ERROR  something failed (always admitted)
+ *   LOG_WARN   recovered or suspicious (always admitted)
+ *   LOG_INFO   state changes: connects, commands, sequences finishing
+ *   LOG_DEBUG  per-transaction detail: decoded replies, sequence steps
+ *   LOG_TRACE  every frame in hex
+ *   Compile time: calls above LOG_LEVEL_MAX compile to nothing.
+ *   Run time:     logger.setLevel() ('log LEVEL' on the console).
+ *
+ * RATE LIMIT:
+ *   INFO and below share a token bucket (LOG_BURST, then LOG_RATE
+ *   lines/s); what it turns away is counted. Errors and warnings are
+ *   never rate-limited, only dropped if the ring itself is full.
+ *   Losses are reported as one "[LOG] ..." line once the ring drains.
+ *
+ * SINKS:
+ *   logger.addSink(fn, minLevel) - fn(level, line, len) gets every
+ *   line at minLevel or more severe, on the drain task, after Serial.
+ *   A sink must not log (it would feed itself).
+ *
+ * USAGE:
+ *   LOGI("BUS", "Queue full - \"%s\" dropped", name);
+ *   LOG_HEX(LOG_TRACE, "BUS", "TX", frame, len);
+ *   if (logger.enabled(LOG_DEBUG)) { ...expensive formatting... }
+ *   Lines get "[TAG] " in front and a newline after; don't add one.
+ *
+ * Before logger.begin() (and on the host bench) lines go straight to
+ * Serial, in the caller.
+ *
+ * THREADING: LOGx() from any task (not from an ISR).
+ *
+ * Identical copies live in Controller/ and Pump/.
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+#ifdef ARDUINO
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+#include "freertos/task.h"
+#endif
+
+// =============================================
+// LEVELS
+// =============================================
+#define LOG_NONE    0
+#define LOG_ERROR   1
+#define LOG_WARN    2
+#define LOG_INFO    3
+#define LOG_DEBUG   4
+#define LOG_TRACE   5
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#ifndef LOG_LEVEL_MAX
+#define LOG_LEVEL_MAX       LOG_TRACE   // Compiled in
+#endif
+#ifndef LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_DEFAULT   LOG_LEVEL_MAX   // Shown from boot
+#endif
+#define LOG_LINE_MAX        192     // Longer lines are cut
+#define LOG_RING_BYTES      4096    // ~50 typical lines waiting for Serial
+#define LOG_BURST           40      // INFO..TRACE lines back to back
+#define LOG_RATE            25      // Then this many per second
+#define LOG_MAX_SINKS       3
+#define LOG_TASK_STACK      3072
+#define LOG_TASK_PRIORITY   1       // Loop task's level: below the bus task (3)
+#define LOG_REPORT_MS       5000    // Loss report at most this often
+
+typedef void (*LogSinkFn)(uint8_t level, const char* line, size_t len);
+
+// =============================================
+// Logger CLASS
+// =============================================
+class Logger {
+private:
+  volatile uint8_t _level = LOG_LEVEL_DEFAULT > LOG_LEVEL_MAX ? LOG_LEVEL_MAX : LOG_LEVEL_DEFAULT;
+
+  struct Sink { LogSinkFn fn; uint8_t minLevel; };
+  Sink     _sinks[LOG_MAX_SINKS];
+  uint8_t  _sinkCount = 0;
+
+  // Token bucket for INFO and below
+  uint16_t      _tokens = LOG_BURST;
+  unsigned long _last = 0;
+
+  volatile uint32_t _dropped = 0;       // Ring full
+  volatile uint32_t _limited = 0;       // Rate limit
+  uint32_t      _reportedDropped = 0;
+  uint32_t      _reportedLimited = 0;
+  unsigned long _reportedAt = 0;
+
+#ifdef ARDUINO
+  RingbufHandle_t _ring = nullptr;
+  portMUX_TYPE    _mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+  // Rate limit: may this line go?
+  bool admit(uint8_t level) {
+    if (level <= LOG_WARN) return true;
+#ifdef ARDUINO
+    portENTER_CRITICAL(&_mux);
+    unsigned long now = millis();
+    unsigned long elapsed = now - _last;
+    if (elapsed >= LOG_BURST * 1000UL / LOG_RATE) {
+      _tokens = LOG_BURST;
+    } else {
+      uint32_t refill = elapsed * LOG_RATE / 1000;
+      _tokens = _tokens + refill > LOG_BURST ? LOG_BURST : _tokens + refill;
+      _last += refill * 1000 / LOG_RATE;
+    }
+    if (_tokens == LOG_BURST) _last = now;       // Full: don't bank idle time
+    bool ok = _tokens > 0;
+    if (ok) _tokens--;
+    else _limited++;
+    portEXIT_CRITICAL(&_mux);
+    return ok;
+#else
+    return true;                 // Host bench: virtual time, nothing to protect
+#endif
+  }
+
+  // item = level byte + text (no NUL)
+  void push(const char* item, size_t len) {
+#ifdef ARDUINO
+    if (_ring) {
+      if (xRingbufferSend(_ring, item, len, 0) != pdTRUE) _dropped++;
+      return;
+    }
+#endif
+    emit(item[0], item + 1, len - 1);
+  }
+
+  void emit(uint8_t level, const char* line, size_t len) {
+    Serial.printf("%.*s\n", (int)len, line);
+    for (uint8_t i = 0; i < _sinkCount; i++) {
+      if (level <= _sinks[i].minLevel) _sinks[i].fn(level, line, len);
+    }
+  }
+
+  // "[TAG] " into item (after the level byte); returns its length
+  static int header(char* item, uint8_t level, const char* tag) {
+    item[0] = level;
+    int n = snprintf(item + 1, LOG_LINE_MAX, "[%s] ", tag);
+    return n < 0 ? 0 : n >= LOG_LINE_MAX ? LOG_LINE_MAX - 1 : n;
+  }
+
+#ifdef ARDUINO
+  void reportLosses() {
+    uint32_t d = _dropped - _reportedDropped;
+    uint32_t l = _limited - _reportedLimited;
+    if (!d && !l) return;
+    if (millis() - _reportedAt < LOG_REPORT_MS) return;
+    _reportedDropped += d;
+    _reportedLimited += l;
+    _reportedAt = millis();
+    char line[80];
+    int n = snprintf(line, sizeof(line), "[LOG] %lu lines lost (%lu ring full, %lu rate-limited)",
+                     (unsigned long)(d + l), (unsigned long)d, (unsigned long)l);
+    emit(LOG_WARN, line, n);
+  }
+
+  static void drainTask(void* arg) {
+    Logger* self = static_cast<Logger*>(arg);
+    for (;;) {
+      size_t len = 0;
+      char* item = (char*)xRingbufferReceive(self->_ring, &len, pdMS_TO_TICKS(1000));
+      if (item) {
+        self->emit(item[0], item + 1, len - 1);
+        vRingbufferReturnItem(self->_ring, item);
+      }
+      self->reportLosses();
+    }
+  }
+#endif
+
+public:
+  // Start the ring and drain task (setup, after Serial.begin)
+  void begin() {
+#ifdef ARDUINO
+    if (_ring) return;
+    _ring = xRingbufferCreate(LOG_RING_BYTES, RINGBUF_TYPE_NOSPLIT);
+    if (!_ring) return;          // Stays synchronous
+    xTaskCreate(drainTask, "log", LOG_TASK_STACK, this, LOG_TASK_PRIORITY, nullptr);
+#endif
+  }
+
+  // Another destination; false if LOG_MAX_SINKS are taken (setup only)
+  bool addSink(LogSinkFn fn, uint8_t minLevel) {
+    if (_sinkCount >= LOG_MAX_SINKS) return false;
+    _sinks[_sinkCount++] = { fn, minLevel };
+    return true;
+  }
+
+  // ---- Level ----
+  bool    enabled(uint8_t level) const { return level <= _level; }
+  uint8_t level() const { return _level; }
+  void    setLevel(uint8_t level) { _level = level > LOG_LEVEL_MAX ? LOG_LEVEL_MAX : level; }
+
+  static const char* levelName(uint8_t level) {
+    static const char* const NAMES[] = { "none", "error", "warn", "info", "debug", "trace" };
+    return level <= LOG_TRACE ? NAMES[level] : "?";
+  }
+
+  // "warn" -> LOG_WARN; -1 if it isn't a level name
+  static int parseLevel(const char* s) {
+    for (uint8_t l = LOG_NONE; l <= LOG_TRACE; l++) {
+      if (strcasecmp(s, levelName(l)) == 0) return l;
+    }
+    return -1;
+  }
+
+  // ---- Writing (use the LOGx macros) ----
+  void write(uint8_t level, const char* tag, const char* fmt, ...)
+      __attribute__((format(printf, 4, 5))) {
+    if (!admit(level)) return;
+    char item[1 + LOG_LINE_MAX];
+    int n = header(item, level, tag);
+    char* text = item + 1 + n;
+    va_list args;
+    va_start(args, fmt);
+    int m = vsnprintf(text, LOG_LINE_MAX - n, fmt, args);
+    va_end(args);
+    if (m < 0) m = 0;
+    if (m >= LOG_LINE_MAX - n) m = LOG_LINE_MAX - n - 1;
+    int skip = 0;                              // Old-style "\n..." messages
+    while (skip < m && text[skip] == '\n') skip++;
+    if (skip) memmove(text, text + skip, m -= skip);
+    while (m && text[m - 1] == '\n') m--;
+    push(item, 1 + n + m);
+  }
+
+  // "[TAG] prefix [N bytes]: A5 00 ..."
+  void hex(uint8_t level, const char* tag, const char* prefix, const uint8_t* data, size_t len) {
+    if (!admit(level)) return;
+    char item[1 + LOG_LINE_MAX];
+    int n = header(item, level, tag);
+    int m = snprintf(item + 1 + n, LOG_LINE_MAX - n, "%s [%u bytes]:", prefix, (unsigned)len);
+    n = m < 0 ? n : n + m >= LOG_LINE_MAX ? LOG_LINE_MAX - 1 : n + m;
+    for (size_t i = 0; i < len && n + 3 < LOG_LINE_MAX; i++) {
+      n += snprintf(item + 1 + n, 4, " %02X", data[i]);
+    }
+    push(item, 1 + n);
+  }
+
+  // ---- Counters ----
+  uint32_t dropped() const { return _dropped; }
+  uint32_t limited() const { return _limited; }
+};
+
+// Defined in the sketch (.ino) / bench.cpp
+extern Logger logger;
+
+// =============================================
+// MACROS
+// =============================================
+#define LOG_AT(lvl, tag, ...) \
+  do { if ((lvl) <= LOG_LEVEL_MAX && logger.enabled(lvl)) logger.write((lvl), (tag), __VA_ARGS__); } while (0)
+
+#define LOGE(tag, ...)  LOG_AT(LOG_ERROR, tag, __VA_ARGS__)
+#define LOGW(tag, ...)  LOG_AT(LOG_WARN,  tag, __VA_ARGS__)
+#define LOGI(tag, ...)  LOG_AT(LOG_INFO,  tag, __VA_ARGS__)
+#define LOGD(tag, ...)  LOG_AT(LOG_DEBUG, tag, __VA_ARGS__)
+#define LOGT(tag, ...)  LOG_AT(LOG_TRACE, tag, __VA_ARGS__)
+
+#define LOG_HEX(lvl, tag, prefix, data, len) \
+  do { if ((lvl) <= LOG_LEVEL_MAX && logger.enabled(lvl)) logger.hex((lvl), (tag), (prefix), (data), (len)); } while (0)
+
+#endif // LOG_H
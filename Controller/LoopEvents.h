@@ -0,0 +1,173 @@
+/*
+ * =============================================
+ * LoopEvents.h - Event-driven loop() + power saving
+ * =============================================
+ *
+ * loop() used to spin flat out re-checking Serial, MQTT and the bus.
+ * Now it sleeps in one FreeRTOS event group until something happens:
+ *
+ *   LOOP_EV_BUS      bus task published a new snapshot  (onBusUpdated)
+ *   LOOP_EV_SERIAL   bytes on the USB Serial Monitor    (see SERIAL WAKE)
+ *   LOOP_EV_NET      MQTT socket readable               (select() watcher task)
+ *   LOOP_EV_WIFI     WiFi connected / lost              (WiFi.onEvent)
+ *
+ * or until its next timer is due (history sample, schedule check,
+ * MQTT keep-alive - at most LOOP_MAX_SLEEP_MS). Nothing is polled, so
+ * response time is unchanged while the CPU idles between events.
+ *
+ * Lwip sockets can't be put in an event group directly. A small task
+ * blocks in select() on the MQTT socket and sets LOOP_EV_NET, then
+ * waits until loop() has read the data before selecting again.
+ *
+ * SERIAL WAKE:
+ *   Every ESP32 board Arduino-ESP32 builds for, by what Serial is:
+ *   USB-UART bridge   HardwareSerial, Serial.onReceive()  (ESP32, and
+ *                     S2/S3/C3 boards with USB CDC On Boot disabled)
+ *   native USB        ARDUINO_USB_CDC_ON_BOOT; HWCDC (S3/C3/C6 USB
+ *                     Serial/JTAG, ARDUINO_USB_MODE) or USBCDC (S2/S3
+ *                     TinyUSB), woken by its RX event through onEvent()
+ *
+ * POWER:
+ *   WiFi modem sleep  radio dozes between AP beacons (always on here)
+ *   DFS               CPU drops to LOW_POWER_MIN_MHZ when every task is
+ *                     blocked (ESP-IDF built with CONFIG_PM_ENABLE)
+ *   light sleep       LOW_POWER_LIGHT_SLEEP, off by default: the chip
+ *                     wakes on the first RS-485 byte, so a pump reply
+ *                     can lose its preamble; for installs where the
+ *                     Controller is the only master
+ *
+ * The RS-485 UART is clocked from REF_TICK (RS485Uart.h), so DFS doesn't
+ * shift the baud rate.
+ */
+
+#ifndef LOOP_EVENTS_H
+#define LOOP_EVENTS_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/task.h"
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define LOOP_MAX_SLEEP_MS      1000   // Longest loop() sleep without an event
+#define LOW_POWER_MAX_MHZ      240
+#define LOW_POWER_MIN_MHZ      80     // DFS floor (APB stays at 80 MHz)
+#define LOW_POWER_LIGHT_SLEEP  0      // Automatic light sleep (see POWER)
+#define NET_WATCH_STACK        2048
+#define NET_WATCH_PRIORITY     1      // Same as loopTask
+
+// =============================================
+// EVENTS
+// =============================================
+#define LOOP_EV_BUS     (1 << 0)
+#define LOOP_EV_SERIAL  (1 << 1)
+#define LOOP_EV_NET     (1 << 2)
+#define LOOP_EV_WIFI    (1 << 3)
+#define LOOP_EV_ALL     (LOOP_EV_BUS | LOOP_EV_SERIAL | LOOP_EV_NET | LOOP_EV_WIFI)
+
+// =============================================
+// LoopEvents CLASS
+// =============================================
+class LoopEvents {
+private:
+  EventGroupHandle_t _group = nullptr;
+  TaskHandle_t       _watcher = nullptr;
+  volatile int       _netFd = -1;       // Socket the watcher selects on, -1 none
+
+  static LoopEvents* _instance;
+
+  // select() on the MQTT socket; one LOOP_EV_NET per batch of data
+  static void netWatchTask(void* arg) {
+    LoopEvents& self = *static_cast<LoopEvents*>(arg);
+    for (;;) {
+      int fd = self._netFd;
+      if (fd < 0) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOOP_MAX_SLEEP_MS));
+        continue;
+      }
+      fd_set readable;
+      FD_ZERO(&readable);
+      FD_SET(fd, &readable);
+      struct timeval tv = { 1, 0 };      // Re-check which socket to watch
+      int ready = select(fd + 1, &readable, nullptr, nullptr, &tv);
+      if (ready > 0) {
+        ulTaskNotifyTake(pdTRUE, 0);     // Drop acks from before this data
+        self.signal(LOOP_EV_NET);
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOOP_MAX_SLEEP_MS));   // Until loop() has read
+      } else if (ready < 0) {
+        vTaskDelay(pdMS_TO_TICKS(100));  // Socket closed under us: wait for the next one
+      }
+    }
+  }
+
+public:
+  LoopEvents() { _instance = this; }
+
+  // Event group, watcher task, wake sources, power management (setup)
+  void begin() {
+    _group = xEventGroupCreate();
+    xTaskCreate(netWatchTask, "netwatch", NET_WATCH_STACK, this, NET_WATCH_PRIORITY, &_watcher);
+
+    WiFi.setSleep(true);                 // Modem sleep (needed alongside BLE anyway)
+#if ARDUINO_USB_CDC_ON_BOOT && ARDUINO_USB_MODE
+    Serial.onEvent(ARDUINO_HW_CDC_RX_EVENT, [](void*, esp_event_base_t, int32_t, void*) {
+      _instance->signal(LOOP_EV_SERIAL);
+    });
+#elif ARDUINO_USB_CDC_ON_BOOT
+    Serial.onEvent(ARDUINO_USB_CDC_RX_EVENT, [](void*, esp_event_base_t, int32_t, void*) {
+      _instance->signal(LOOP_EV_SERIAL);
+    });
+#else
+    Serial.onReceive([]() { _instance->signal(LOOP_EV_SERIAL); });
+#endif
+    WiFi.onEvent([](arduino_event_id_t, arduino_event_info_t) { _instance->signal(LOOP_EV_WIFI); });
+
+#if CONFIG_PM_ENABLE
+    esp_pm_config_esp32_t pm = {};
+    pm.max_freq_mhz = LOW_POWER_MAX_MHZ;
+    pm.min_freq_mhz = LOW_POWER_MIN_MHZ;
+    pm.light_sleep_enable = LOW_POWER_LIGHT_SLEEP;
+    if (esp_pm_configure(&pm) == ESP_OK) {
+      Serial.printf("[PWR] DFS %d-%d MHz, light sleep %s\n", LOW_POWER_MIN_MHZ,
+                    LOW_POWER_MAX_MHZ, LOW_POWER_LIGHT_SLEEP ? "on" : "off");
+    } else {
+      Serial.println("[PWR] Power management not available in this build");
+    }
+#endif
+  }
+
+  // Wake loop() (any task)
+  void signal(EventBits_t bits) {
+    if (_group) xEventGroupSetBits(_group, bits);
+  }
+
+  /*
+   * Sleep until an event or maxMs (loop task).
+   * Returns the events that fired (0 = timer).
+   */
+  EventBits_t wait(uint32_t maxMs) {
+    if (!_group) return 0;
+    if (maxMs > LOOP_MAX_SLEEP_MS) maxMs = LOOP_MAX_SLEEP_MS;
+    return xEventGroupWaitBits(_group, LOOP_EV_ALL, pdTRUE, pdFALSE, pdMS_TO_TICKS(maxMs));
+  }
+
+  /*
+   * loop() has serviced the network: watch fd (-1 = none) for the next
+   * incoming data.
+   */
+  void watchSocket(int fd) {
+    _netFd = fd;
+    if (_watcher) xTaskNotifyGive(_watcher);
+  }
+};
+
+LoopEvents* LoopEvents::_instance = nullptr;
+
+#endif // LOOP_EVENTS_H
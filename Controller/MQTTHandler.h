@@ -3,8 +3,8 @@
  * MQTTHandler.h - Cloud MQTT for Remote Control
  * =============================================
  * 
- * Connects ESP32 to a free public MQTT broker so you can
- * control the pump from ANYWHERE in the world via a web page.
+ * Connects ESP32 to an MQTT broker (by default a free public one) so
+ * you can control the pump from ANYWHERE in the world via a web page.
  * 
  * HOW IT WORKS:
  *   ESP32 connects to MQTT broker over WiFi (TCP)
@@ -12,11 +12,68 @@
  *   Both publish/subscribe to the same "topics"
  *   Messages flow through the broker = remote control!
  * 
- * DEFAULT BROKER: broker.hivemq.com (free, no signup)
+ * BROKER: MqttConfig.h - mqtt:// or mqtts:// (TLS), optional username
+ * and password, saved in NVS; MQTT_DEFAULT_BROKER (Config.h) until
+ * then, broker.hivemq.com (free, no signup). Without a CA certificate
+ * a TLS connection is encrypted but the server is not verified.
  * 
- * TOPICS (using unique device ID from MAC address):
- *   flexpool/{deviceId}/cmd     ← commands TO the ESP32
- *   flexpool/{deviceId}/status  → status FROM the ESP32
+ * TOPICS ({base} = flexpool/{deviceId}, or flexpool/{site}/{deviceId}
+ * once a site is set; deviceId is the full MAC, StatusFormat.h):
+ *   {base}/cmd             ← commands TO the ESP32
+ *   {base}/status          → full status of the default pump (retained)
+ *   {base}/pump/{n}/status → full status of pump n (1-4), each one on the bus (retained)
+ *   {base}/pump/{n}/delta  → {"pump":n, ...only the fields that changed...}
+ *   .../status.cbor        → the same status CBOR-encoded, in place of .../status
+ *                            when MQTT_STATUS_CBOR is 1 (StatusFormat.h)
+ *   {base}/pump/{n}/energy → {"pump":n,"today":kWh,"week":kWh,"lifetime":kWh,"ts":..} (retained)
+ *   {base}/event           → {"event":"started|stopped|fault|fault_cleared","pump":n,...,"ts":..}
+ *                            and {"event":"boot","reason":r} once per boot
+ *   {base}/diagnostics     → bus health every MQTT_DIAG_INTERVAL (BusMetrics.h)
+ *   {base}/log             → {"level":"warn","msg":"[BUS] ..."} for log lines at
+ *                            LOG_MQTT_LEVEL or worse (Config.h, Log.h); live-only
+ *   {base}/lwt             → {"online":true|false} (retained, broker sends false)
+ * 
+ * FLEET SUMMARY: every MQTT_SUMMARY_INTERVAL, one compact rollup of
+ * the whole controller on flexpool/{site}/summary (no site:
+ * flexpool/{deviceId}/summary), live-only, not retained:
+ *   {"id":"24DCC3A1B2C3","site":"north","pad":"pad-3","up":86400,"rssi":-61,"ts":..,
+ *    "pumps":[[1,1,2000,850,0],[2,0,0,0,0]]}     pumps: [n, running, rpm, watts, error]
+ * A dashboard or collector watches every unit with one subscription
+ * to flexpool/+/summary, and only opens a device's own topics to drill
+ * in. Several collector instances can share that load with a shared
+ * subscription, $share/{group}/flexpool/+/summary: each summary then
+ * goes to one of them (a broker feature - HiveMQ, EMQX, Mosquitto 2 -
+ * nothing changes here). A unit that stops sending summaries for a
+ * few intervals is offline; its {base}/lwt says so too.
+ * 
+ * PUBLISHING is change-driven: a pump's topics are published after a
+ * reply moves it past the deadbands below (run state, mode, error and
+ * sequence progress always count), plus a full heartbeat every
+ * MQTT_HEARTBEAT_INTERVAL. A steady pump costs one message a minute.
+ * 
+ * OFFLINE: status, energy, deltas and events produced while the broker
+ * is unreachable are queued (OutboundQueue.h) and sent oldest-first
+ * once it is back, rate limited. Queued status / energy for a topic is
+ * replaced by the newer one; deltas and events are all kept, with a
+ * "ts" (Unix time, once the clock is set) since they arrive late.
+ * Diagnostics and heartbeats are live-only.
+ * 
+ * COMMANDS target the default pump, or pump n with "pump":n.
+ * One object, or an array of them run in order (schema: CommandParser.h)
+ *   {"cmd":"fullstart","rpm":2000,"pump":2}
+ *   [{"cmd":"rpm","pump":2,"rpm":1800},{"cmd":"stop","pump":1}]
+ * 
+ * CONNECTING never blocks loop(): PubSubClient's connect (DNS lookup,
+ * TCP connect, CONNECT / CONNACK) runs on a small helper task while
+ * loop() leaves the client alone, and loop() takes over again once it
+ * is done. Failed attempts back off exponentially with jitter
+ * (Backoff.h); WiFi coming back retries at once.
+ *
+ *   WAIT_WIFI --WiFi up--> CONNECTING --ok--> ONLINE
+ *       ^                    |   ^              |
+ *       |                 failed |              | connection lost
+ *       |                    v   | due          v
+ *       +----WiFi down---- BACKOFF <------------+
  * 
  * REQUIRES: PubSubClient library
  *   Arduino IDE → Sketch → Include Library → Manage Libraries
@@ -27,142 +84,221 @@
 #define MQTT_HANDLER_H
 
 #include <WiFi.h>
+#include <WiFiClientSecure.h>
 #include <PubSubClient.h>
+#include "Backoff.h"
+#include "Energy.h"
+#include "OutboundQueue.h"
 #include "PumpStatus.h"
+#include "RS485Bus.h"
+#include "StatusFormat.h"
+#include "CommandParser.h"
+#include "BusMetrics.h"
+#include "Log.h"
+#include "MqttConfig.h"
 
 // =============================================
-// MQTT BROKER SETTINGS
+// MQTT SETTINGS (broker, credentials, site: MqttConfig.h)
 // =============================================
-// HiveMQ public broker - free, no signup required
-// Good for testing. For production, use HiveMQ Cloud (free tier)
-#define MQTT_BROKER     "broker.hivemq.com"
-#define MQTT_PORT       1883           // TCP port (ESP32 uses this)
-#define MQTT_WS_PORT    8884           // WebSocket Secure port (browser uses this)
+// The public HiveMQ broker is good for testing. For a fleet, use a
+// broker of your own (HiveMQ Cloud, EMQX, Mosquitto) with TLS and a
+// login per site.
+
+// Change-driven status (see PUBLISHING above)
+#define MQTT_RPM_DEADBAND        10     // RPM change worth publishing
+#define MQTT_WATTS_DEADBAND      5      // Watts change worth publishing
+#define MQTT_HEARTBEAT_INTERVAL  60000  // Full status for every pump, changed or not
+#define MQTT_DIAG_INTERVAL       60000  // Bus health counters (0 = off)
+#define MQTT_ENERGY_INTERVAL     300000 // kWh totals per pump (queued while offline)
+#define MQTT_SUMMARY_INTERVAL    30000  // Fleet rollup on .../summary (0 = off)
+
+// Delivery. PubSubClient publishes at QoS 0 only; retain is what lets a
+// dashboard that connects later see the current state at once.
+#define MQTT_STATUS_RETAIN  true       // Full-state topics
+#define MQTT_DELTA_RETAIN   false      // Deltas only make sense live
+#define MQTT_CMD_QOS        1          // Command topic subscription
+
+// Status encoding: 0 = JSON on .../status, 1 = CBOR on .../status.cbor
+// instead (a fraction of the size; docs/index.html reads either). One,
+// not both: every status is retained and takes a queue slot offline.
+#define MQTT_STATUS_CBOR    0
 
-// How often to publish status (milliseconds)
-#define MQTT_STATUS_INTERVAL  3000     // Every 3 seconds
+// Reconnect (see CONNECTING above)
+#define MQTT_BACKOFF_MIN_MS      2000   // First retry after 1-2 s
+#define MQTT_BACKOFF_MAX_MS      120000 // Give up doubling at 1-2 min
+#define MQTT_CONNECT_TIMEOUT_S   5      // CONNACK wait (helper task)
+#define MQTT_CONNECT_STACK       4096
+#define MQTT_CONNECT_STACK_TLS   8192   // The TLS handshake runs on it too
+#define MQTT_CONNECT_PRIORITY    1
+#define MQTT_TLS_POLL_MS         50     // TLS: loop() polls (records can sit decrypted
+                                        // in mbedTLS, where select() can't see them)
 
-// Reconnect interval if disconnected
-#define MQTT_RECONNECT_INTERVAL  5000  // Every 5 seconds
+// Log lines for .../log, waiting for loop() (LOG_MQTT_LEVEL, Config.h)
+#ifndef LOG_MQTT_LEVEL
+#define LOG_MQTT_LEVEL           LOG_WARN
+#endif
+#define MQTT_LOG_RING            1024   // Bytes; dropped when full
+#define MQTT_LOG_PER_LOOP        4      // Published per loop() at most
 
 // =============================================
 // FORWARD DECLARATIONS
 // (these functions are defined in Controller.ino)
 // =============================================
-void sendRemoteControl();
-void sendLocalControl();
-void sendRunPump(bool start);
-void sendStatusQuery();
-void sendSetRPM(uint16_t rpm);
-void runFullSpeedSequence(uint16_t rpm);
-void runFullStopSequence();
+void sendRemoteControl(uint8_t addr);
+void sendLocalControl(uint8_t addr);
+void sendRunPump(uint8_t addr, bool start);
+void sendStatusQuery(uint8_t addr);
+void sendSetRPM(uint8_t addr, uint16_t rpm);
+void runFullSpeedSequence(uint8_t addr, uint16_t rpm);
+void runFullStopSequence(uint8_t addr);
+void onMqttConnectDone();   // Helper task finished an attempt: wake loop()
 
-// External pump status (defined in Controller.ino)
-extern PumpStatus pumpStatus;
-extern bool remoteControlActive;
+// RS-485 bus (defined in Controller.ino) - status is read via bus.snapshot()
+extern RS485Bus bus;
+extern uint8_t pumpAddr;   // Default command target
+extern PeakTracker loopPeak;   // loop() iteration time, for .../diagnostics
+extern EnergyMeter energy;     // kWh totals, for .../energy
 
 // =============================================
 // MQTTHandler CLASS
 // =============================================
 class MQTTHandler {
 private:
-  WiFiClient    _wifiClient;
-  PubSubClient  _mqtt;
+  WiFiClient       _wifiClient;
+  WiFiClientSecure _tlsClient;
+  PubSubClient     _mqtt;
+  MqttConfig       _cfg;                 // Broker, login, site (loaded in begin)
   
   String _deviceId;
+  String _topicBase;
+  String _topicSummary;
   String _topicCmd;
   String _topicStatus;
   String _topicLWT;
+  String _topicDiag;
   
-  unsigned long _lastStatusPublish = 0;
-  unsigned long _lastReconnectAttempt = 0;
+  unsigned long _lastHeartbeat = 0;
+  unsigned long _lastDiag = 0;
+  unsigned long _lastEnergy = 0;
+  unsigned long _lastSummary = 0;
+  BusSnapshot   _published;            // What the broker last got, per pump
+  BusSnapshot   _eventBase;            // Run / fault state behind the last events
+  uint8_t       _publishedDefault = 0; // pumpAddr behind the last status topic
   bool _enabled = true;
+  volatile bool _online = false;   // Last connected() seen by loop()
   
-  // Generate unique device ID from MAC address (last 6 chars)
+  // Connect state machine (loop task; see CONNECTING above)
+  enum State : uint8_t { WAIT_WIFI, BACKOFF, CONNECTING, ONLINE };
+  State         _state = WAIT_WIFI;
+  Backoff       _retry{MQTT_BACKOFF_MIN_MS, MQTT_BACKOFF_MAX_MS};
+  TaskHandle_t  _connectTask = nullptr;
+  volatile bool _attemptDone = false;     // Set by the helper task
+  volatile bool _attemptOk = false;
+  unsigned long _attemptStart = 0;
+  
+  // Store-and-forward (OFFLINE above)
+  OutboundQueue _queue;
+  SendRate      _rate;
+  OutboundMsg   _out;                  // Scratch for the flush (keeps it off the stack)
+  
+  // Log lines from the drain task (logSink), published by loop()
+  RingbufHandle_t _logRing = nullptr;
+  String          _topicLog;
+  static MQTTHandler*& logTarget() { static MQTTHandler* t = nullptr; return t; }
+  
+  // Unique device ID from the MAC address (StatusFormat.h), and the topics
   void generateDeviceId() {
-    uint8_t mac[6];
-    WiFi.macAddress(mac);
-    char id[7];
-    snprintf(id, sizeof(id), "%02X%02X%02X", mac[3], mac[4], mac[5]);
-    _deviceId = String(id);
+    _deviceId = String(deviceId());
     
-    // Build topic names
-    _topicCmd    = "flexpool/" + _deviceId + "/cmd";
-    _topicStatus = "flexpool/" + _deviceId + "/status";
-    _topicLWT    = "flexpool/" + _deviceId + "/lwt";
+    // Build topic names (TOPICS above)
+    _topicBase    = _cfg.topicBase(deviceId());
+    _topicSummary = _cfg.topicSummary(deviceId());
+    _topicCmd    = _topicBase + "/cmd";
+    _topicStatus = _topicBase + "/status";
+    _topicLWT    = _topicBase + "/lwt";
+    _topicDiag   = _topicBase + "/diagnostics";
+    _topicLog    = _topicBase + "/log";
+  }
+  
+  // TCP or TLS client for the configured broker
+  void setupClient() {
+    if (_cfg.tls) {
+      if (_cfg.ca.length()) {
+        _tlsClient.setCACert(_cfg.ca.c_str());
+      } else if (MQTT_DEFAULT_CA[0]) {
+        _tlsClient.setCACert(MQTT_DEFAULT_CA);
+      } else {
+        _tlsClient.setInsecure();
+        LOGW("MQTT", "No CA certificate: TLS without verifying the broker");
+      }
+      _mqtt.setClient(_tlsClient);
+    } else {
+      _mqtt.setClient(_wifiClient);
+    }
+    _mqtt.setServer(_cfg.host.c_str(), _cfg.port);   // Keeps the pointer: _cfg lives on
   }
   
-  // Parse incoming command JSON and execute it
-  // Format: {"cmd":"fullstart","rpm":2000}
+  // Parse an incoming command (or batch, see CommandParser.h) and run it
   void handleCommand(const char* payload, unsigned int length) {
-    String msg = String(payload).substring(0, length);
+    LOGI("MQTT", "Received command: %.*s", (int)length, payload);
     
-    Serial.printf("[MQTT] Received command: %s\n", msg.c_str());
+    ParsedCommand cmds[CMD_MAX_BATCH];
+    CommandParser parser;
+    int count = parser.parse(payload, length, cmds, CMD_MAX_BATCH);
+    if (count < 0) {
+      LOGW("MQTT", "Rejected: %s", parser.error());
+      return;
+    }
     
-    // Simple JSON parsing (no library needed for our simple format)
-    if (msg.indexOf("\"fullstart\"") >= 0) {
-      int rpm = extractInt(msg, "rpm");
-      if (rpm >= 450 && rpm <= 3450) {
-        Serial.printf("[MQTT] → Full start at %d RPM\n", rpm);
-        runFullSpeedSequence(rpm);
+    // Check every entry before running any of them
+    const CommandSpec* specs[CMD_MAX_BATCH];
+    for (int i = 0; i < count; i++) {
+      specs[i] = findCommand(cmds[i].name);
+      if (!specs[i]) {
+        LOGW("MQTT", "Rejected: unknown command \"%s\"", cmds[i].name);
+        return;
       }
-    }
-    else if (msg.indexOf("\"fullstop\"") >= 0) {
-      Serial.println("[MQTT] → Full stop");
-      runFullStopSequence();
-    }
-    else if (msg.indexOf("\"start\"") >= 0) {
-      Serial.println("[MQTT] → Start pump");
-      sendRunPump(true);
-    }
-    else if (msg.indexOf("\"stop\"") >= 0) {
-      Serial.println("[MQTT] → Stop pump");
-      sendRunPump(false);
-    }
-    else if (msg.indexOf("\"rpm\"") >= 0) {
-      int rpm = extractInt(msg, "value");
-      if (rpm >= 450 && rpm <= 3450) {
-        Serial.printf("[MQTT] → Set RPM to %d\n", rpm);
-        sendSetRPM(rpm);
+      if (specs[i]->needsRpm && (!cmds[i].hasRpm || cmds[i].rpm < 450 || cmds[i].rpm > 3450)) {
+        LOGW("MQTT", "Rejected: \"%s\" needs rpm 450-3450", cmds[i].name);
+        return;
       }
     }
-    else if (msg.indexOf("\"remote\"") >= 0) {
-      Serial.println("[MQTT] → Set remote control");
-      sendRemoteControl();
-    }
-    else if (msg.indexOf("\"local\"") >= 0) {
-      Serial.println("[MQTT] → Set local control");
-      sendLocalControl();
-    }
-    else if (msg.indexOf("\"query\"") >= 0) {
-      Serial.println("[MQTT] → Query status");
-      sendStatusQuery();
-    }
-    else {
-      Serial.printf("[MQTT] Unknown command: %s\n", msg.c_str());
-    }
     
-    // Publish updated status after command
-    delay(500);
-    publishStatus();
+    for (int i = 0; i < count; i++) {
+      uint8_t addr = cmds[i].pump ? pumpAddress(cmds[i].pump - 1) : pumpAddr;
+      if (specs[i]->needsRpm) {
+        LOGI("MQTT", "→ %s pump 0x%02X at %ld RPM", specs[i]->name, addr, (long)cmds[i].rpm);
+      } else {
+        LOGI("MQTT", "→ %s pump 0x%02X", specs[i]->name, addr);
+      }
+      specs[i]->run(addr, cmds[i].rpm);
+    }
+    // Status goes out once the pump's reply has been parsed
+    // (Controller.ino's loop calls publishStatus() on every bus update)
   }
   
-  // Extract integer value from simple JSON: "key":1234
-  int extractInt(const String& json, const char* key) {
-    String search = String("\"") + key + "\"";
-    int idx = json.indexOf(search);
-    if (idx < 0) return 0;
-    
-    // Find the colon after the key
-    idx = json.indexOf(':', idx);
-    if (idx < 0) return 0;
-    
-    // Skip whitespace
-    idx++;
-    while (idx < (int)json.length() && json[idx] == ' ') idx++;
-    
-    // Parse the number
-    return json.substring(idx).toInt();
+  // ---- Command table ----
+  struct CommandSpec {
+    const char* name;
+    bool        needsRpm;
+    void      (*run)(uint8_t addr, int32_t rpm);
+  };
+  
+  static const CommandSpec* findCommand(const char* name) {
+    static const CommandSpec COMMANDS[] = {
+      { "fullstart", true,  [](uint8_t a, int32_t rpm) { runFullSpeedSequence(a, rpm); } },
+      { "fullstop",  false, [](uint8_t a, int32_t)     { runFullStopSequence(a); } },
+      { "start",     false, [](uint8_t a, int32_t)     { sendRunPump(a, true); } },
+      { "stop",      false, [](uint8_t a, int32_t)     { sendRunPump(a, false); } },
+      { "rpm",       true,  [](uint8_t a, int32_t rpm) { sendSetRPM(a, rpm); } },
+      { "remote",    false, [](uint8_t a, int32_t)     { sendRemoteControl(a); } },
+      { "local",     false, [](uint8_t a, int32_t)     { sendLocalControl(a); } },
+      { "query",     false, [](uint8_t a, int32_t)     { sendStatusQuery(a); } },
+    };
+    for (const CommandSpec& c : COMMANDS) {
+      if (strcmp(c.name, name) == 0) return &c;
+    }
+    return nullptr;
   }
 
 public:
@@ -172,14 +308,24 @@ public:
   const String& getDeviceId() const { return _deviceId; }
   const String& getTopicCmd() const { return _topicCmd; }
   const String& getTopicStatus() const { return _topicStatus; }
-  bool isConnected() { return _mqtt.connected(); }
+  const String& getTopicBase() const { return _topicBase; }
+  const MqttConfig& config() const { return _cfg; }
+  // Cached by loop(), so the web server task can read it without
+  // touching the MQTT client
+  bool isConnected() const { return _online; }
+
+  // Socket to wake loop() on (LoopEvents), -1 while offline or over
+  // TLS (polled instead, msUntilDue)
+  int socketFd() { return _online && !_cfg.tls ? _wifiClient.fd() : -1; }
   
   // Initialize MQTT
   void begin() {
+    _cfg.load();
     generateDeviceId();
     
-    _mqtt.setServer(MQTT_BROKER, MQTT_PORT);
+    setupClient();
     _mqtt.setBufferSize(512);
+    _mqtt.setSocketTimeout(MQTT_CONNECT_TIMEOUT_S);
     
     // Set callback for incoming messages
     _mqtt.setCallback([this](char* topic, byte* payload, unsigned int length) {
@@ -188,111 +334,460 @@ public:
     
     Serial.println("\n[MQTT] ================================");
     Serial.printf( "[MQTT] Device ID: %s\n", _deviceId.c_str());
-    Serial.printf( "[MQTT] Broker:    %s:%d\n", MQTT_BROKER, MQTT_PORT);
+    Serial.printf( "[MQTT] Broker:    %s%s\n", _cfg.broker().c_str(),
+                   _cfg.user.length() ? (" as " + _cfg.user).c_str() : "");
     Serial.printf( "[MQTT] Commands:  %s\n", _topicCmd.c_str());
     Serial.printf( "[MQTT] Status:    %s\n", _topicStatus.c_str());
+#if MQTT_SUMMARY_INTERVAL
+    Serial.printf( "[MQTT] Summary:   %s\n", _topicSummary.c_str());
+#endif
     Serial.println("[MQTT] ================================");
     Serial.println();
     Serial.println("════════════════════════════════════════════════");
     Serial.println("  BOOKMARK THIS URL FOR REMOTE CONTROL:");
-    Serial.printf( "  https://taejoonest.github.io/FlexPool?id=%s\n", _deviceId.c_str());
+    Serial.printf( "  https://taejoonest.github.io/FlexPool?id=%s%s%s\n", _deviceId.c_str(),
+                   _cfg.site.length() ? "&site=" : "", _cfg.site.c_str());
     Serial.println("════════════════════════════════════════════════");
     Serial.println();
     
-    connect();
+    // Backlog left in flash by the last boot, and a note of this one
+    _queue.begin();
+    char json[64];
+    int n = snprintf(json, sizeof(json), "{\"event\":\"boot\",\"reason\":%d}", (int)esp_reset_reason());
+    event(json, n);
+    _lastEnergy = millis();
+    _lastSummary = millis() - MQTT_SUMMARY_INTERVAL / 2;   // First one soon after connecting
+    
+#if LOG_MQTT_LEVEL
+    _logRing = xRingbufferCreate(MQTT_LOG_RING, RINGBUF_TYPE_NOSPLIT);
+    logTarget() = this;
+#endif
+    
+    // Connects as soon as loop() sees WiFi
+    xTaskCreatePinnedToCore(connectTaskFn, "mqttconn",
+                            _cfg.tls ? MQTT_CONNECT_STACK_TLS : MQTT_CONNECT_STACK, this,
+                            MQTT_CONNECT_PRIORITY, &_connectTask, 0);
+  }
+  
+  /*
+   * Log.h sink (drain task): keep the line for loop() to publish.
+   * Registered in setup(); lines before begin() and while the ring is
+   * full are dropped. Must not log.
+   */
+  static void logSink(uint8_t level, const char* line, size_t len) {
+    MQTTHandler* self = logTarget();
+    if (!self || !self->_logRing) return;
+    char item[1 + LOG_LINE_MAX];
+    if (len > LOG_LINE_MAX) len = LOG_LINE_MAX;
+    item[0] = level;
+    memcpy(item + 1, line, len);
+    xRingbufferSend(self->_logRing, item, 1 + len, 0);
+  }
+  
+  // Loop work pending: the backlog drains in steps, and a TLS link is
+  // polled (loop task)
+  unsigned long msUntilDue() const {
+    if (_state != ONLINE) return UINT32_MAX;
+    if (_cfg.tls) return MQTT_TLS_POLL_MS;
+    return !_queue.empty() ? 1000 / OUTQ_RATE : UINT32_MAX;
+  }
+  
+  // Queue depth for the Serial status
+  uint8_t  queued() const { return _queue.queued(); }
+  size_t   queuedFileBytes() const { return _queue.fileBytes(); }
+  uint32_t queueDropped() const { return _queue.dropped(); }
+  
+  // WiFi events, forwarded by loop() (loop task)
+  void onWiFiUp() {
+    if (_state == BACKOFF) _retry.now();     // Don't sit out a long backoff
+  }
+  void onWiFiDown() {
+    if (_state != ONLINE) return;            // Dead link: don't wait for keep-alive
+    if (_cfg.tls) _tlsClient.stop();
+    else _wifiClient.stop();
+  }
+  
+private:
+  // ---- Store-and-forward ----
+  String topicFor(uint8_t kind, uint8_t pump) const {
+    const String& base = _topicBase;
+    String pumpBase = base + "/pump/" + String(pump + 1);
+    switch (kind) {
+      case OUT_STATUS:      return pump == OUT_DEFAULT_PUMP ? _topicStatus : pumpBase + "/status";
+      case OUT_STATUS_CBOR: return (pump == OUT_DEFAULT_PUMP ? _topicStatus : pumpBase + "/status") + ".cbor";
+      case OUT_ENERGY:      return pumpBase + "/energy";
+      case OUT_DELTA:       return pumpBase + "/delta";
+      default:              return base + "/event";
+    }
+  }
+  
+  bool publishRaw(uint8_t kind, uint8_t pump, const uint8_t* data, size_t len) {
+    bool retain = kind == OUT_DELTA ? MQTT_DELTA_RETAIN
+                : kind == OUT_EVENT ? false
+                : kind == OUT_ENERGY ? true : MQTT_STATUS_RETAIN;
+    return _mqtt.publish(topicFor(kind, pump).c_str(), data, len, retain);
+  }
+  
+  // Unix time for late messages, 0 before SNTP
+  static long unixTime() {
+    time_t now = time(nullptr);
+    return now >= ENERGY_CLOCK_MIN ? (long)now : 0;
+  }
+  
+  /*
+   * Publish now if the broker is there, nothing is queued ahead and
+   * the rate allows; otherwise queue it. A queued delta gets a "ts".
+   */
+  void send(uint8_t kind, uint8_t pump, const void* data, size_t len) {
+    if (_state == ONLINE && _queue.empty() && _rate.take() &&
+        publishRaw(kind, pump, (const uint8_t*)data, len)) {
+      return;
+    }
+    long ts = unixTime();
+    if (kind == OUT_DELTA && ts && len > 1 && len + 20 < OUTQ_PAYLOAD) {
+      char stamped[OUTQ_PAYLOAD];
+      memcpy(stamped, data, len - 1);                  // Up to the closing brace
+      len = len - 1 + snprintf(stamped + len - 1, sizeof(stamped) - len + 1, ",\"ts\":%ld}", ts);
+      _queue.push(kind, pump, stamped, len);
+      return;
+    }
+    _queue.push(kind, pump, data, len);
+  }
+  
+  // Backlog out, oldest first, as fast as the rate allows (loop task, online)
+  void flushQueue() {
+    while (_queue.peek(_out) && _rate.take()) {
+      if (!publishRaw(_out.kind, _out.pump, _out.data, _out.len) && !_mqtt.connected()) break;
+      _queue.pop();              // Sent, or can never be (too big for the client buffer)
+    }
+  }
+  
+  // ---- Events: run / fault transitions ----
+  void event(const char* json, size_t len) {
+    send(OUT_EVENT, 0, json, len);
+  }
+  
+  void detectEvents(const BusSnapshot& snap) {
+    char json[128];
+    long ts = unixTime();
+    for (int i = 0; i < PUMP_COUNT; i++) {
+      const PumpStatus& a = _eventBase.pumps[i];
+      const PumpStatus& b = snap.pumps[i];
+      if (!b.valid) continue;
+      if (a.valid && b.running != a.running) {
+        int n = snprintf(json, sizeof(json), "{\"event\":\"%s\",\"pump\":%d,\"rpm\":%d,\"ts\":%ld}",
+                         b.running ? "started" : "stopped", i + 1, b.rpm, ts);
+        event(json, n);
+      }
+      if (b.errCode != a.errCode) {
+        int n = snprintf(json, sizeof(json), "{\"event\":\"%s\",\"pump\":%d,\"error\":%d,\"ts\":%ld}",
+                         b.errCode ? "fault" : "fault_cleared", i + 1,
+                         b.errCode ? b.errCode : a.errCode, ts);
+        event(json, n);
+      }
+      _eventBase.pumps[i] = b;
+    }
+  }
+  
+  // kWh totals of every pump on the bus (queued while offline)
+  void publishEnergy() {
+    BusSnapshot snap = bus.snapshot();
+    if (snap.replay) {
+      _lastEnergy = millis();
+      return;
+    }
+    char json[160];
+    for (int i = 0; i < PUMP_COUNT; i++) {
+      if (!snap.pumps[i].present) continue;
+      EnergyTotals t = energy.totals(i);
+      int n = snprintf(json, sizeof(json),
+                       "{\"pump\":%d,\"today\":%.3f,\"week\":%.3f,\"lifetime\":%.3f,\"ts\":%ld}",
+                       i + 1, mjToKwh(t.todayMj), mjToKwh(t.weekMj), mjToKwh(t.lifeMj), unixTime());
+      send(OUT_ENERGY, i, json, n);
+    }
+    _lastEnergy = millis();
+  }
+  
+  // Helper task: one blocking PubSubClient connect per notification.
+  // loop() doesn't touch the client while _state is CONNECTING.
+  static void connectTaskFn(void* arg) {
+    MQTTHandler& self = *static_cast<MQTTHandler*>(arg);
+    for (;;) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      String clientId = "flexpool-" + self._deviceId;
+      // Last Will and Testament (published if ESP32 disconnects unexpectedly)
+      const MqttConfig& cfg = self._cfg;
+      self._attemptOk = self._mqtt.connect(
+        clientId.c_str(),
+        cfg.user.length() ? cfg.user.c_str() : NULL,   // anonymous without a user
+        cfg.user.length() ? cfg.pass.c_str() : NULL,
+        self._topicLWT.c_str(), 1, true,     // LWT: topic, QoS 1, retain
+        "{\"online\":false}"                 // LWT message
+      );
+      self._attemptDone = true;
+      onMqttConnectDone();
+    }
+  }
+  
+  void startAttempt() {
+    LOGI("MQTT", "Connecting to %s:%u%s (in the background)...", _cfg.host.c_str(),
+         _cfg.port, _cfg.tls ? " over TLS" : "");
+    _attemptDone = false;
+    _attemptStart = millis();
+    _state = CONNECTING;
+    xTaskNotifyGive(_connectTask);
   }
   
-  // Connect to MQTT broker
-  bool connect() {
-    if (_mqtt.connected()) return true;
+  // Attempt finished (loop task): subscribe and publish, or back off
+  void finishAttempt() {
+    if (!_attemptOk) {
+      _retry.fail();
+      LOGW("MQTT", "Connect failed (rc=%d) after %lu ms, retry %u in %lu s",
+           _mqtt.state(), millis() - _attemptStart, _retry.failures(),
+           (_retry.msUntilDue() + 500) / 1000);
+      _state = BACKOFF;
+      return;
+    }
+    LOGI("MQTT", "Connected in %lu ms", millis() - _attemptStart);
+    _retry.reset();
+    _state = ONLINE;
     
-    String clientId = "flexpool-" + _deviceId;
+    // Publish online status
+    _mqtt.publish(_topicLWT.c_str(), "{\"online\":true}", true);
     
-    Serial.printf("[MQTT] Connecting to %s...", MQTT_BROKER);
+    // Subscribe to command topic
+    _mqtt.subscribe(_topicCmd.c_str(), MQTT_CMD_QOS);
+    LOGI("MQTT", "Subscribed to: %s", _topicCmd.c_str());
     
-    // Set Last Will and Testament (published if ESP32 disconnects unexpectedly)
-    bool connected = _mqtt.connect(
-      clientId.c_str(),
-      NULL, NULL,                          // no username/password for public broker
-      _topicLWT.c_str(), 1, true,          // LWT: topic, QoS 1, retain
-      "{\"online\":false}"                 // LWT message
-    );
+    // Backlog first, then the current state behind it
+    if (!_queue.empty()) {
+      LOGI("MQTT", "Sending %u queued message(s) + %u bytes from flash",
+           _queue.queued(), (unsigned)_queue.fileBytes());
+    }
     
-    if (connected) {
-      Serial.println(" Connected!");
-      
-      // Publish online status
-      _mqtt.publish(_topicLWT.c_str(), "{\"online\":true}", true);
-      
-      // Subscribe to command topic
-      _mqtt.subscribe(_topicCmd.c_str());
-      Serial.printf("[MQTT] Subscribed to: %s\n", _topicCmd.c_str());
-      
-      // Publish initial status
-      publishStatus();
-      
-      return true;
-    } else {
-      Serial.printf(" Failed (rc=%d)\n", _mqtt.state());
-      return false;
+    // Publish initial status (refreshes the retained topics)
+    publishStatus(true);
+  }
+  
+  // Advance the connect state machine (loop task)
+  void runStateMachine() {
+    bool wifi = WiFi.status() == WL_CONNECTED;
+    switch (_state) {
+      case WAIT_WIFI:
+        if (wifi) startAttempt();
+        break;
+      case BACKOFF:
+        if (!wifi) _state = WAIT_WIFI;
+        else if (_retry.due()) startAttempt();
+        break;
+      case CONNECTING:
+        if (_attemptDone) finishAttempt();
+        break;
+      case ONLINE:
+        if (!_mqtt.connected()) {
+          LOGW("MQTT", "Connection lost (rc=%d)", _mqtt.state());
+          _retry.fail();
+          _state = wifi ? BACKOFF : WAIT_WIFI;
+        }
+        break;
     }
   }
+
+public:
+  // Full status of pump idx on its topic (".cbor" with MQTT_STATUS_CBOR), retained.
+  // topicPump: idx, or OUT_DEFAULT_PUMP for .../status
+  void publishFull(uint8_t topicPump, const BusSnapshot& snap, int idx) {
+#if MQTT_STATUS_CBOR
+    uint8_t cbor[STATUS_CBOR_MAX];
+    size_t len = formatStatusCbor(cbor, sizeof(cbor), snap, idx);
+    if (len) send(OUT_STATUS_CBOR, topicPump, cbor, len);
+#else
+    char json[OUTQ_PAYLOAD];
+    size_t n = formatStatus(json, sizeof(json), snap, idx);
+    if (n) send(OUT_STATUS, topicPump, json, n);
+#endif
+  }
   
-  // Publish current pump status
-  void publishStatus() {
-    if (!_mqtt.connected()) return;
+  // Worth a publish? Deadbands on rpm/watts, anything else counts
+  bool changed(const BusSnapshot& snap, int idx) const {
+    const PumpStatus& a = _published.pumps[idx];
+    const PumpStatus& b = snap.pumps[idx];
+    return b.present != a.present || b.valid != a.valid ||
+           b.running != a.running || b.remote != a.remote ||
+           b.mode != a.mode || b.errCode != a.errCode || b.gpm != a.gpm ||
+           abs((int)b.rpm - (int)a.rpm) > MQTT_RPM_DEADBAND ||
+           abs((int)b.watts - (int)a.watts) > MQTT_WATTS_DEADBAND ||
+           seqStepFor(snap, idx) != seqStepFor(_published, idx) ||
+           strcmp(seqNameFor(snap, idx), seqNameFor(_published, idx)) != 0;
+  }
+  
+  /*
+   * Publish every pump that changed since the broker last heard
+   * (full retained status + delta), or every pump when forced.
+   * Call after each bus update; cheap when nothing moved. Offline,
+   * the messages are queued (OFFLINE above).
+   */
+  void publishStatus(bool force = false) {
+    if (!_connectTask) return;               // begin() not called yet
     
-    char json[384];
-    snprintf(json, sizeof(json),
-      "{"
-      "\"running\":%s,"
-      "\"rpm\":%d,"
-      "\"watts\":%d,"
-      "\"gpm\":%d,"
-      "\"mode\":%d,"
-      "\"error\":%d,"
-      "\"remote\":%s,"
-      "\"valid\":%s,"
-      "\"deviceId\":\"%s\","
-      "\"uptime\":%lu,"
-      "\"rssi\":%d"
-      "}",
-      pumpStatus.running ? "true" : "false",
-      pumpStatus.rpm,
-      pumpStatus.watts,
-      pumpStatus.gpm,
-      pumpStatus.mode,
-      pumpStatus.errCode,
-      remoteControlActive ? "true" : "false",
-      pumpStatus.valid ? "true" : "false",
-      _deviceId.c_str(),
-      millis() / 1000,
-      WiFi.RSSI()
-    );
+    BusSnapshot snap = bus.snapshot();
+    if (snap.replay) {                       // A capture, not the pad: nothing for the fleet
+      if (force) _lastHeartbeat = millis();
+      return;
+    }
+    char delta[256];
+    bool sent[PUMP_COUNT] = {};
+    detectEvents(snap);
     
-    _mqtt.publish(_topicStatus.c_str(), json);
+    for (int i = 0; i < PUMP_COUNT; i++) {
+      if (!snap.pumps[i].present && !_published.pumps[i].present) continue;
+      if (!force && !changed(snap, i)) continue;
+      
+      publishFull(i, snap, i);
+      if (formatDelta(delta, sizeof(delta), _published, snap, i)) {
+        send(OUT_DELTA, i, delta, strlen(delta));
+      }
+      sent[i] = true;
+    }
+    
+    // Default pump, on its own topic (also when the default changes)
+    int def = pumpIndex(pumpAddr);
+    if (force || pumpAddr != _publishedDefault || changed(snap, def)) {
+      publishFull(OUT_DEFAULT_PUMP, snap, def);
+      _publishedDefault = pumpAddr;
+      sent[def] = true;
+    }
+    
+    // New baseline. Sequence changes always publish, so the
+    // sequence fields can move forward for every pump at once.
+    for (int i = 0; i < PUMP_COUNT; i++) {
+      if (sent[i]) _published.pumps[i] = snap.pumps[i];
+    }
+    _published.sequence = snap.sequence;
+    _published.seqPump  = snap.seqPump;
+    _published.seqStep  = snap.seqStep;
+    _published.seqSteps = snap.seqSteps;
+    if (force) _lastHeartbeat = millis();
+  }
+  
+  // Waiting log lines on .../log, a few per loop() (live-only, never
+  // queued: a log line that went through the backlog would be stale)
+  void publishLog() {
+    char json[2 * LOG_LINE_MAX + 32];
+    for (int i = 0; i < MQTT_LOG_PER_LOOP && _mqtt.connected(); i++) {
+      size_t len = 0;
+      char* item = (char*)xRingbufferReceive(_logRing, &len, 0);
+      if (!item) break;
+      int n = snprintf(json, sizeof(json), "{\"level\":\"%s\",\"msg\":\"", Logger::levelName(item[0]));
+      for (size_t k = 1; k < len && n < (int)sizeof(json) - 8; k++) {
+        char c = item[k];
+        if (c == '"' || c == '\\') {
+          json[n++] = '\\';
+          json[n++] = c;
+        } else if ((uint8_t)c < 0x20) {
+          n += snprintf(json + n, 7, "\\u%04x", c);
+        } else {
+          json[n++] = c;
+        }
+      }
+      vRingbufferReturnItem(_logRing, item);
+      n += snprintf(json + n, sizeof(json) - n, "\"}");
+      _mqtt.publish(_topicLog.c_str(), (const uint8_t*)json, n, false);
+    }
+  }
+  
+  /*
+   * Fleet rollup on the summary topic (FLEET SUMMARY above): every pump
+   * on the bus as [n, running, rpm, watts, error]. Live-only - a
+   * late rollup would show an old state as current.
+   */
+  void publishSummary() {
+    if (_state != ONLINE || !_mqtt.connected()) return;
+    BusSnapshot snap = bus.snapshot();
+    if (snap.replay) {
+      _lastSummary = millis();
+      return;
+    }
+    char json[320];
+    int n = snprintf(json, sizeof(json),
+                     "{\"id\":\"%s\",\"site\":\"%s\",\"pad\":\"%s\",\"up\":%lu,\"rssi\":%d,"
+                     "\"ts\":%ld,\"pumps\":[",
+                     _deviceId.c_str(), _cfg.site.c_str(), _cfg.pad.c_str(),
+                     millis() / 1000, WiFi.RSSI(), unixTime());
+    bool first = true;
+    for (int i = 0; i < PUMP_COUNT && n < (int)sizeof(json); i++) {
+      const PumpStatus& p = snap.pumps[i];
+      if (!p.present) continue;
+      n += snprintf(json + n, sizeof(json) - n, "%s[%d,%d,%d,%d,%d]", first ? "" : ",",
+                    i + 1, p.valid && p.running, p.valid ? p.rpm : 0,
+                    p.valid ? p.watts : 0, p.errCode);
+      first = false;
+    }
+    if (n < (int)sizeof(json)) n += snprintf(json + n, sizeof(json) - n, "]}");
+    if (n < (int)sizeof(json)) {
+      _mqtt.publish(_topicSummary.c_str(), (const uint8_t*)json, n, false);
+    }
+    _lastSummary = millis();
+  }
+  
+  // Bus health counters on .../diagnostics (not retained: a stale
+  // reading would look like a live one)
+  void publishDiagnostics() {
+    if (_state != ONLINE || !_mqtt.connected()) return;
+    char json[448];
+    if (formatDiagnostics(json, sizeof(json), bus.metrics(), loopPeak.peak())) {
+      _mqtt.publish(_topicDiag.c_str(), json, false);
+    }
+    _lastDiag = millis();
   }
   
   // Call this in loop()
   void loop() {
-    if (!_enabled) return;
+    if (!_enabled || !_connectTask) return;
     
     // Handle MQTT messages
-    if (_mqtt.connected()) {
+    if (_state == ONLINE) {
       _mqtt.loop();
     }
     
-    // Reconnect if disconnected
-    if (!_mqtt.connected() && millis() - _lastReconnectAttempt > MQTT_RECONNECT_INTERVAL) {
-      _lastReconnectAttempt = millis();
-      connect();
+    // (Re)connect, without waiting on the network
+    runStateMachine();
+    
+    // Energy goes out (or into the queue) online or not
+    if (millis() - _lastEnergy > MQTT_ENERGY_INTERVAL) {
+      publishEnergy();
+    }
+    
+    if (_state != ONLINE) {
+      _online = false;
+      return;
     }
     
-    // Periodically publish status
-    if (_mqtt.connected() && millis() - _lastStatusPublish > MQTT_STATUS_INTERVAL) {
-      publishStatus();
-      _lastStatusPublish = millis();
+    // Backlog, rate limited
+    flushQueue();
+    
+#if LOG_MQTT_LEVEL
+    publishLog();
+#endif
+    
+    // Slow heartbeat: full status even when nothing changed
+    if (_mqtt.connected() && millis() - _lastHeartbeat > MQTT_HEARTBEAT_INTERVAL) {
+      publishStatus(true);
+    }
+    
+#if MQTT_DIAG_INTERVAL
+    if (_mqtt.connected() && millis() - _lastDiag > MQTT_DIAG_INTERVAL) {
+      publishDiagnostics();
     }
+#endif
+    
+#if MQTT_SUMMARY_INTERVAL
+    if (_mqtt.connected() && millis() - _lastSummary > MQTT_SUMMARY_INTERVAL) {
+      publishSummary();
+    }
+#endif
+    
+    _online = _mqtt.connected();
   }
 };
 
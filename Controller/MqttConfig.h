@@ -0,0 +1,196 @@
+/*
+ * =============================================
+ * MqttConfig.h - Broker, credentials and topic layout, kept in NVS
+ * =============================================
+ *
+ * What MQTTHandler connects to and where its topics live. Read once at
+ * boot (MqttConfig::load); a change is saved here and used from the
+ * next boot on, like the WiFi credentials.
+ *
+ * SETTINGS (NVS namespace MQTT_PREFS_NAMESPACE):
+ *   broker   mqtt://host[:port] (TCP, default port 1883) or
+ *            mqtts://host[:port] (TLS, default 8883); a bare host[:port]
+ *            is mqtt://
+ *   user     username, "" = anonymous (pass only goes with a user)
+ *   pass
+ *   site     first topic level below flexpool/, "" = none
+ *   pad      free label for this controller, carried in the summary
+ *   ca       PEM root certificate for mqtts://, "" = MQTT_DEFAULT_CA
+ *   Anything not saved falls back to the MQTT_DEFAULT_* values
+ *   (Config.h). Kept apart from the WiFi credentials so 'reset' (new
+ *   network) doesn't also lose the fleet settings; 'mqtt reset' does.
+ *
+ * TOPIC LAYOUT (id = deviceId(), the full 12-digit MAC):
+ *   no site   flexpool/{id}/...            summary: flexpool/{id}/summary
+ *   site      flexpool/{site}/{id}/...     summary: flexpool/{site}/summary
+ *   Either way every summary matches flexpool/+/summary.
+ *
+ * SET FROM: the console ('mqtt ...'), POST /api/mqtt, and the BLE
+ * setup write (optional "broker", "site", "pad", "user", "mqttPass").
+ *
+ * THREADING: load() in setup; save() from whichever task handles the
+ * request (NVS is thread-safe), never on the bus task.
+ */
+
+#ifndef MQTT_CONFIG_H
+#define MQTT_CONFIG_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "Config.h"
+
+// =============================================
+// CONFIGURATION (defaults: Config.h)
+// =============================================
+#define MQTT_PREFS_NAMESPACE  "mqtt"
+#define MQTT_PORT_TCP         1883
+#define MQTT_PORT_TLS         8883
+#define MQTT_LABEL_MAX        24      // site and pad
+#define MQTT_CA_MAX           3072    // PEM bytes (one root, not a bundle)
+
+// =============================================
+// MqttConfig
+// =============================================
+struct MqttConfig {
+  String   host;
+  uint16_t port = MQTT_PORT_TCP;
+  bool     tls = false;
+  String   user;
+  String   pass;
+  String   site;
+  String   pad;
+  String   ca;
+
+  /*
+   * "mqtts://host:8883" -> host, port, tls. False (nothing changed)
+   * for another scheme, an empty host or a bad port.
+   */
+  bool setBroker(const String& url) {
+    String rest = url;
+    bool secure = false;
+    if (rest.startsWith("mqtts://")) {
+      secure = true;
+      rest = rest.substring(8);
+    } else if (rest.startsWith("mqtt://")) {
+      rest = rest.substring(7);
+    } else if (rest.indexOf("://") >= 0) {
+      return false;
+    }
+    if (rest.endsWith("/")) rest.remove(rest.length() - 1);
+    int colon = rest.lastIndexOf(':');
+    long p = secure ? MQTT_PORT_TLS : MQTT_PORT_TCP;
+    if (colon >= 0) {
+      p = rest.substring(colon + 1).toInt();
+      rest = rest.substring(0, colon);
+    }
+    if (rest.length() == 0 || rest.indexOf('/') >= 0 || p < 1 || p > 65535) return false;
+    host = rest;
+    port = p;
+    tls = secure;
+    return true;
+  }
+
+  // The broker as it was given: "mqtts://host:8883"
+  String broker() const {
+    return String(tls ? "mqtts://" : "mqtt://") + host + ":" + String(port);
+  }
+
+  /*
+   * Usable as a site (one topic level) or pad label: 1-MQTT_LABEL_MAX
+   * of A-Z a-z 0-9 - _ . ("" is also fine: none). Keeps MQTT
+   * wildcards, '/' and anything needing JSON escapes out.
+   */
+  static bool validLabel(const String& s) {
+    if (s.length() > MQTT_LABEL_MAX) return false;
+    for (size_t i = 0; i < s.length(); i++) {
+      char c = s[i];
+      if (!isalnum((unsigned char)c) && c != '-' && c != '_' && c != '.') return false;
+    }
+    return true;
+  }
+
+  /*
+   * One setting by name ("broker", "user", "pass", "site", "pad"), as
+   * the console, REST and BLE give it. "" clears user (and pass), site
+   * and pad. False if the name or the value isn't usable.
+   */
+  bool set(const String& key, const String& value) {
+    if (key == "broker") return setBroker(value);
+    if (key == "user") {
+      user = value;
+      if (!value.length()) pass = "";
+      return true;
+    }
+    if (key == "pass") {
+      pass = value;
+      return true;
+    }
+    if (key == "site" || key == "pad") {
+      if (!validLabel(value)) return false;
+      (key == "site" ? site : pad) = value;
+      return true;
+    }
+    return false;
+  }
+
+  // ---- Topics ----
+  String topicBase(const char* id) const {
+    return site.length() ? "flexpool/" + site + "/" + id : String("flexpool/") + id;
+  }
+  String topicSummary(const char* id) const {
+    return "flexpool/" + (site.length() ? site : String(id)) + "/summary";
+  }
+
+  // ---- NVS ----
+  // Saved values over the build defaults
+  void load() {
+    setBroker(MQTT_DEFAULT_BROKER);
+    user = MQTT_DEFAULT_USER;
+    pass = MQTT_DEFAULT_PASS;
+    site = MQTT_DEFAULT_SITE;
+    pad  = "";
+    ca   = "";
+
+    Preferences prefs;
+    if (!prefs.begin(MQTT_PREFS_NAMESPACE, true)) return;    // Nothing saved yet
+    String url = prefs.getString("broker", "");
+    if (url.length() && !setBroker(url)) {
+      Serial.printf("[MQTT] Saved broker \"%s\" is not usable, using %s\n",
+                    url.c_str(), MQTT_DEFAULT_BROKER);
+    }
+    if (prefs.isKey("user")) {
+      user = prefs.getString("user", "");
+      pass = prefs.getString("pass", "");
+    }
+    if (prefs.isKey("site")) site = prefs.getString("site", "");
+    pad = prefs.getString("pad", "");
+    ca  = prefs.getString("ca", "");
+    prefs.end();
+
+    if (!validLabel(site)) site = "";
+    if (!validLabel(pad))  pad = "";
+  }
+
+  // Everything, as it is now
+  void save() const {
+    Preferences prefs;
+    prefs.begin(MQTT_PREFS_NAMESPACE, false);
+    prefs.putString("broker", broker());
+    prefs.putString("user", user);
+    prefs.putString("pass", pass);
+    prefs.putString("site", site);
+    prefs.putString("pad", pad);
+    prefs.putString("ca", ca);
+    prefs.end();
+  }
+
+  // Back to the build defaults
+  static void clear() {
+    Preferences prefs;
+    prefs.begin(MQTT_PREFS_NAMESPACE, false);
+    prefs.clear();
+    prefs.end();
+  }
+};
+
+#endif // MQTT_CONFIG_H
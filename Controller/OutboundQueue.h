@@ -0,0 +1,263 @@
+/*
+ * =============================================
+ * OutboundQueue.h - Store-and-forward for MQTT publishes
+ * =============================================
+ *
+ * Every publish goes through here (MQTTHandler::send). While the
+ * broker is reachable and nothing is waiting, it goes straight out;
+ * otherwise it waits its turn, and is sent oldest-first once the
+ * connection is back.
+ *
+ * TWO KINDS OF MESSAGE:
+ *   state      retained "current value" topics (status, energy): a
+ *              newer one supersedes the queued one for the same topic,
+ *              which is dropped and the new one goes to the back
+ *   timeline   deltas and events: every one is kept, in order, so the
+ *              cloud side sees the whole outage afterwards
+ *
+ * STORAGE:
+ *   A RAM ring of OUTQ_LEN fixed slots. When it is full the oldest
+ *   entry moves to a LittleFS file (OUTQ_FLASH), up to OUTQ_FILE_MAX,
+ *   and only then are entries dropped (counted). The file outlives a
+ *   reboot: the backlog still goes out after the next connect. File
+ *   entries are always older than RAM ones and are sent first.
+ *
+ * RATE:
+ *   SendRate is a token bucket: a burst of OUTQ_BURST, then OUTQ_RATE
+ *   per second. Live traffic (a full heartbeat is ~14 messages) fits
+ *   in the burst; a backlog drains at OUTQ_RATE so a reconnect doesn't
+ *   hammer the broker.
+ *
+ * THREADING: loop task only.
+ */
+
+#ifndef OUTBOUND_QUEUE_H
+#define OUTBOUND_QUEUE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "Config.h"
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#ifndef OUTQ_LEN
+#define OUTQ_LEN        24              // RAM slots (~9 KB; PROFILE_BRIDGE: 64)
+#endif
+static_assert(OUTQ_LEN <= 255, "ring indices are uint8_t");
+#define OUTQ_PAYLOAD    384             // Largest payload (full JSON status)
+#define OUTQ_FLASH      1               // Spill to LittleFS when RAM is full
+#define OUTQ_FILE       "/mqttq.bin"
+#define OUTQ_FILE_MAX   (64 * 1024)
+#define OUTQ_BURST      16              // Messages sent back to back
+#define OUTQ_RATE       10              // Then this many per second
+
+// What a message is; the topic is built from this (+ pump) when it is sent
+enum OutKind : uint8_t {
+  OUT_NONE = 0,          // Superseded (a tombstone in the ring)
+  OUT_STATUS,            // .../pump/{n}/status, or .../status for OUT_DEFAULT_PUMP
+  OUT_STATUS_CBOR,       // the same + ".cbor"
+  OUT_ENERGY,            // .../pump/{n}/energy
+  OUT_DELTA,             // .../pump/{n}/delta
+  OUT_EVENT,             // .../event
+};
+#define OUT_DEFAULT_PUMP  0xFF
+
+// State topics: only the newest one matters
+inline bool outSupersedes(uint8_t kind) {
+  return kind == OUT_STATUS || kind == OUT_STATUS_CBOR || kind == OUT_ENERGY;
+}
+
+struct OutboundMsg {
+  uint8_t  kind;
+  uint8_t  pump;          // Registry slot, or OUT_DEFAULT_PUMP
+  uint16_t len;
+  uint8_t  data[OUTQ_PAYLOAD];
+};
+
+// =============================================
+// SendRate: token bucket
+// =============================================
+class SendRate {
+private:
+  uint16_t      _tokens = OUTQ_BURST;
+  unsigned long _last = 0;
+
+public:
+  // One message may go now?
+  bool take() {
+    unsigned long now = millis();
+    unsigned long elapsed = now - _last;
+    if (elapsed >= OUTQ_BURST * 1000UL / OUTQ_RATE) {
+      _tokens = OUTQ_BURST;
+    } else {
+      uint32_t refill = elapsed * OUTQ_RATE / 1000;
+      _tokens = _tokens + refill > OUTQ_BURST ? OUTQ_BURST : _tokens + refill;
+      _last += refill * 1000 / OUTQ_RATE;
+    }
+    if (_tokens == OUTQ_BURST) _last = now;       // Full: don't bank idle time
+    if (!_tokens) return false;
+    _tokens--;
+    return true;
+  }
+};
+
+// =============================================
+// OutboundQueue CLASS
+// =============================================
+class OutboundQueue {
+private:
+  OutboundMsg _ring[OUTQ_LEN];
+  uint8_t     _head = 0;          // Oldest
+  uint8_t     _count = 0;         // Slots in use, tombstones included
+  bool        _fs = false;
+  size_t      _fileRead = 0;      // Next file entry
+  size_t      _fileNext = 0;      // The one after, once peeked
+  size_t      _fileSize = 0;
+  bool        _peekedFile = false;
+  uint32_t    _dropped = 0;
+  uint32_t    _spilled = 0;
+
+  OutboundMsg& at(int i) { return _ring[(_head + i) % OUTQ_LEN]; }
+
+  // Oldest RAM entry to the file (or dropped); frees one slot
+  void spillOldest() {
+    OutboundMsg& m = at(0);
+    if (m.kind != OUT_NONE) {
+#if OUTQ_FLASH
+      size_t need = 4 + m.len;
+      File f;
+      if (_fs && _fileSize + need <= OUTQ_FILE_MAX && (f = LittleFS.open(OUTQ_FILE, "a"))) {
+        uint8_t h[4] = { m.kind, m.pump, (uint8_t)m.len, (uint8_t)(m.len >> 8) };
+        f.write(h, sizeof(h));
+        f.write(m.data, m.len);
+        f.close();
+        _fileSize += need;
+        _spilled++;
+      } else {
+        _dropped++;
+      }
+#else
+      _dropped++;
+#endif
+    }
+    _head = (_head + 1) % OUTQ_LEN;
+    _count--;
+  }
+
+  // Close the gaps superseded entries left (order kept)
+  void compact() {
+    int kept = 0;
+    for (int i = 0; i < _count; i++) {
+      if (at(i).kind == OUT_NONE) continue;
+      if (kept != i) at(kept) = at(i);
+      kept++;
+    }
+    _count = kept;
+  }
+
+  // Drop tombstones at the front
+  void trim() {
+    while (_count && at(0).kind == OUT_NONE) {
+      _head = (_head + 1) % OUTQ_LEN;
+      _count--;
+    }
+  }
+
+  // Next file entry into m; false (and the file goes) once it is all sent
+  bool peekFile(OutboundMsg& m) {
+    if (!_fileSize) return false;
+    File f = LittleFS.open(OUTQ_FILE, "r");
+    uint8_t h[4];
+    bool ok = f && f.seek(_fileRead) && f.read(h, sizeof(h)) == sizeof(h);
+    if (ok) {
+      m.kind = h[0];
+      m.pump = h[1];
+      m.len  = h[2] | h[3] << 8;
+      ok = m.len <= OUTQ_PAYLOAD && f.read(m.data, m.len) == m.len;
+    }
+    if (f) f.close();
+    if (!ok) {                    // Done, or a torn write at the end
+      LittleFS.remove(OUTQ_FILE);
+      _fileRead = _fileSize = 0;
+      return false;
+    }
+    _fileNext = _fileRead + sizeof(h) + m.len;
+    return true;
+  }
+
+public:
+  // Pick up a backlog left by the last boot (setup, LittleFS mounted by History)
+  void begin() {
+    _fs = LittleFS.begin(true);
+    if (!_fs || !LittleFS.exists(OUTQ_FILE)) return;
+    File f = LittleFS.open(OUTQ_FILE, "r");
+    _fileSize = f ? f.size() : 0;
+    if (f) f.close();
+    if (_fileSize) {
+      Serial.printf("[MQTT] %u bytes of queued messages from before the reboot\n",
+                    (unsigned)_fileSize);
+    }
+  }
+
+  // Queue a message (the newest); a state message replaces its
+  // queued predecessor. False if it is too big to queue.
+  bool push(uint8_t kind, uint8_t pump, const void* data, size_t len) {
+    if (len > OUTQ_PAYLOAD) return false;
+    if (outSupersedes(kind)) {
+      for (int i = 0; i < _count; i++) {
+        OutboundMsg& m = at(i);
+        if (m.kind == kind && m.pump == pump) m.kind = OUT_NONE;
+      }
+      trim();
+    }
+    if (_count == OUTQ_LEN) compact();
+    if (_count == OUTQ_LEN) spillOldest();
+    OutboundMsg& m = at(_count++);
+    m.kind = kind;
+    m.pump = pump;
+    m.len = len;
+    memcpy(m.data, data, len);
+    return true;
+  }
+
+  bool empty() const { return !_fileSize && !_count; }
+
+  /*
+   * Oldest message, copied into m. Call pop() once it has gone out,
+   * or leave it at the front to retry.
+   */
+  bool peek(OutboundMsg& m) {
+    _peekedFile = peekFile(m);
+    if (_peekedFile) return true;
+    trim();
+    if (!_count) return false;
+    m = at(0);
+    return true;
+  }
+
+  // The message peek() just returned has been sent
+  void pop() {
+    if (_peekedFile) {
+      _peekedFile = false;
+      _fileRead = _fileNext;
+      if (_fileRead >= _fileSize) {
+        LittleFS.remove(OUTQ_FILE);
+        _fileRead = _fileSize = 0;
+      }
+      return;
+    }
+    trim();
+    if (!_count) return;
+    _head = (_head + 1) % OUTQ_LEN;
+    _count--;
+  }
+
+  // ---- Counters ----
+  uint8_t  queued() const { return _count; }     // RAM (tombstones included)
+  size_t   fileBytes() const { return _fileSize - _fileRead; }
+  uint32_t dropped() const { return _dropped; }
+  uint32_t spilled() const { return _spilled; }
+};
+
+#endif // OUTBOUND_QUEUE_H
@@ -24,7 +24,13 @@
 #ifndef PENTAIR_PROTOCOL_H
 #define PENTAIR_PROTOCOL_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stdint.h>   // Host builds (tools/bench): nothing here needs the core
+#include <stddef.h>
+#include <string.h>
+#endif
 
 // =============================================
 // PREAMBLE
@@ -48,6 +54,9 @@ const uint8_t PENTAIR_PREAMBLE[] = {0xFF, 0x00, 0xFF, 0xA5};
 // Minimum packet size: preamble(4) + ver(1) + dst(1) + src(1) + cmd(1) + len(1) + checksum(2) = 11
 #define PENTAIR_MIN_PKT_LEN  11
 
+// Maximum packet size: the LEN byte can describe up to 255 data bytes
+#define PENTAIR_MAX_PKT_LEN  (PENTAIR_MIN_PKT_LEN + 255)
+
 // Version byte (always 0x00 in observed traffic)
 #define PENTAIR_VERSION  0x00
 
@@ -240,44 +249,346 @@ inline size_t pentairPacketLength(const uint8_t* packetStart) {
   return 4 + 1 + 1 + 1 + 1 + 1 + packetStart[PKT_IDX_LEN] + 2;
 }
 
-/*
- * Build a Pentair packet.
- * Fills in preamble, version, addresses, command, data, and checksum.
- * Returns total packet length.
- * 
- * Buffer must be large enough: 11 + dataLen bytes minimum.
- */
-inline size_t pentairBuildPacket(uint8_t* buffer, uint8_t dst, uint8_t src,
-                                 uint8_t cmd, const uint8_t* data, uint8_t dataLen) {
-  size_t idx = 0;
-  
-  // Preamble
-  buffer[idx++] = 0xFF;
-  buffer[idx++] = 0x00;
-  buffer[idx++] = 0xFF;
-  buffer[idx++] = 0xA5;
-  
-  // Header
-  buffer[idx++] = PENTAIR_VERSION;  // Version byte
-  buffer[idx++] = dst;              // Destination
-  buffer[idx++] = src;              // Source
-  buffer[idx++] = cmd;              // Command/CFI
-  buffer[idx++] = dataLen;          // Data length
-  
-  // Data
-  for (uint8_t i = 0; i < dataLen; i++) {
-    buffer[idx++] = data[i];
+// =============================================
+// FRAME WRITER (build in place, no temporary arrays)
+// =============================================
+// Writes straight into the caller's buffer and adds up the checksum
+// as bytes go in, so there is no second pass and no copy:
+//
+//   uint8_t frame[24];
+//   size_t len = PentairFrameWriter(frame, sizeof(frame))
+//                  .begin(ADDR_PUMP_1, ADDR_REMOTE_CONTROLLER, CMD_WRITE_REG)
+//                  .u16(REG_SET_RPM).u16(rpm)
+//                  .finish();            // 0 if the buffer was too small
+
+class PentairFrameWriter {
+public:
+  PentairFrameWriter(uint8_t* buffer, size_t capacity)
+    : _buf(buffer), _cap(capacity) {}
+
+  // Preamble + header; data length is filled in by finish()
+  PentairFrameWriter& begin(uint8_t dst, uint8_t src, uint8_t cmd) {
+    _len = 0;
+    _ok = (_cap >= PENTAIR_MIN_PKT_LEN);
+    if (!_ok) return *this;
+
+    _buf[_len++] = 0xFF;
+    _buf[_len++] = 0x00;
+    _buf[_len++] = 0xFF;
+    _buf[_len++] = 0xA5;
+    _buf[_len++] = PENTAIR_VERSION;
+    _buf[_len++] = dst;
+    _buf[_len++] = src;
+    _buf[_len++] = cmd;
+    _buf[_len++] = 0;               // LEN, patched in finish()
+    _sum = 0xA5 + PENTAIR_VERSION + dst + src + cmd;
+    return *this;
   }
-  
-  // Checksum (from A5 through end of data)
-  uint16_t checksum = 0;
-  for (size_t i = PKT_IDX_LEAD; i < idx; i++) {
-    checksum += buffer[i];
+
+  // Append one data byte
+  PentairFrameWriter& u8(uint8_t b) {
+    // Leave room for the 2 checksum bytes; LEN is one byte
+    if (!_ok || _len + 3 > _cap || _len - PKT_IDX_DATA >= 255) {
+      _ok = false;
+      return *this;
+    }
+    _buf[_len++] = b;
+    _sum += b;
+    return *this;
   }
-  buffer[idx++] = (checksum >> 8) & 0xFF;  // Checksum high byte
-  buffer[idx++] = checksum & 0xFF;         // Checksum low byte
-  
-  return idx;
+
+  // Append a 16-bit value, high byte first (register numbers, RPM, watts)
+  PentairFrameWriter& u16(uint16_t v) { return u8(v >> 8).u8(v & 0xFF); }
+
+  // Append raw data bytes
+  PentairFrameWriter& bytes(const uint8_t* data, size_t n) {
+    for (size_t i = 0; i < n; i++) u8(data[i]);
+    return *this;
+  }
+
+  // Patch LEN, append the checksum. Returns frame length, or 0 on overflow.
+  size_t finish() {
+    if (!_ok) return 0;
+    uint8_t dataLen = _len - PKT_IDX_DATA;
+    _buf[PKT_IDX_LEN] = dataLen;
+    uint16_t sum = _sum + dataLen;
+    _buf[_len++] = sum >> 8;        // Checksum high byte
+    _buf[_len++] = sum & 0xFF;      // Checksum low byte
+    _ok = false;                    // One frame per begin()
+    return _len;
+  }
+
+private:
+  uint8_t* _buf;
+  size_t   _cap;
+  size_t   _len = 0;
+  uint16_t _sum = 0;
+  bool     _ok  = false;
+};
+
+// =============================================
+// FIXED FRAMES (built at compile time)
+// =============================================
+// Frames that never change for a given pair of addresses (status
+// query, remote/local, run/stop) can be built by the compiler,
+// checksum included:
+//
+//   constexpr PentairFixedFrame q = pentairFixedFrame(ADDR_PUMP_1, ADDR_REMOTE_CONTROLLER, CMD_STATUS);
+//   transmit(q.bytes, q.len);
+
+struct PentairFixedFrame {
+  uint8_t bytes[PENTAIR_MIN_PKT_LEN + 1];   // Header + at most 1 data byte
+  uint8_t len;
+};
+
+constexpr uint16_t pentairHeaderSum(uint8_t dst, uint8_t src, uint8_t cmd, uint8_t len) {
+  return 0xA5 + PENTAIR_VERSION + dst + src + cmd + len;
+}
+
+// No data (e.g. CMD_STATUS query)
+constexpr PentairFixedFrame pentairFixedFrame(uint8_t dst, uint8_t src, uint8_t cmd) {
+  return PentairFixedFrame{
+    { 0xFF, 0x00, 0xFF, 0xA5, PENTAIR_VERSION, dst, src, cmd, 0,
+      (uint8_t)(pentairHeaderSum(dst, src, cmd, 0) >> 8),
+      (uint8_t)(pentairHeaderSum(dst, src, cmd, 0) & 0xFF), 0 },
+    PENTAIR_MIN_PKT_LEN };
+}
+
+// One data byte (e.g. CMD_CTRL remote/local, CMD_RUN start/stop)
+constexpr PentairFixedFrame pentairFixedFrame(uint8_t dst, uint8_t src, uint8_t cmd, uint8_t d0) {
+  return PentairFixedFrame{
+    { 0xFF, 0x00, 0xFF, 0xA5, PENTAIR_VERSION, dst, src, cmd, 1, d0,
+      (uint8_t)((pentairHeaderSum(dst, src, cmd, 1) + d0) >> 8),
+      (uint8_t)((pentairHeaderSum(dst, src, cmd, 1) + d0) & 0xFF) },
+    PENTAIR_MIN_PKT_LEN + 1 };
 }
 
+// =============================================
+// FRAME VIEW (read a received frame in place)
+// =============================================
+// Non-owning accessor over a buffer holding one frame that starts
+// at the preamble (what PentairParser produces). Every accessor is
+// bounds-checked: out-of-range data reads return 0 instead of
+// running off the end of the buffer.
+//
+//   PentairFrameView f(frame, len);
+//   if (f.valid() && f.cmd() == CMD_STATUS && f.has(STAT_DATA_LEN))
+//     rpm = f.u16(STAT_RPM_HI);
+
+class PentairFrameView {
+public:
+  PentairFrameView(const uint8_t* frame, size_t length)
+    : _p(frame), _n(length) {}
+
+  // Long enough for its LEN byte, and the checksum matches
+  bool complete() const {
+    return _n >= PENTAIR_MIN_PKT_LEN && pentairPacketLength(_p) <= _n;
+  }
+  bool valid() const {
+    return complete() && pentairVerifyChecksum(_p, pentairPacketLength(_p));
+  }
+
+  // ---- Header ----
+  uint8_t version() const { return at(PKT_IDX_VER); }
+  uint8_t dst() const     { return at(PKT_IDX_DST); }
+  uint8_t src() const     { return at(PKT_IDX_SRC); }
+  uint8_t cmd() const     { return at(PKT_IDX_CMD); }
+
+  // Data bytes actually present (LEN, clipped to the buffer)
+  uint8_t dataLen() const {
+    if (_n < PENTAIR_MIN_PKT_LEN) return 0;
+    size_t room = _n - PENTAIR_MIN_PKT_LEN;
+    return (at(PKT_IDX_LEN) <= room) ? at(PKT_IDX_LEN) : room;
+  }
+  bool has(size_t n) const { return dataLen() >= n; }
+
+  // ---- Data (i = offset into the data field) ----
+  const uint8_t* data() const { return _p + PKT_IDX_DATA; }
+  uint8_t u8(size_t i) const { return (i < dataLen()) ? _p[PKT_IDX_DATA + i] : 0; }
+  uint16_t u16(size_t i) const { return ((uint16_t)u8(i) << 8) | u8(i + 1); }
+
+  // ---- Whole frame ----
+  const uint8_t* bytes() const { return _p; }
+  size_t size() const { return _n; }
+
+private:
+  const uint8_t* _p;
+  size_t _n;
+
+  uint8_t at(size_t i) const { return (i < _n) ? _p[i] : 0; }
+};
+
+// =============================================
+// STREAMING FRAME PARSER
+// =============================================
+// Fed one byte at a time as bytes come off the UART:
+//   preamble (FF 00 FF A5) -> header (VER DST SRC CMD LEN)
+//   -> LEN data bytes -> checksum (HI LO)
+// A frame is reported the moment its last checksum byte arrives,
+// so there is no need to wait a fixed time for "the rest" of a packet.
+// Back-to-back frames are split correctly, and garbage between
+// frames is skipped while hunting for the next preamble.
+//
+// The completed frame is stored with the standard 4-byte preamble,
+// so all PKT_IDX_* constants and helpers above apply to it.
+
+class PentairParser {
+public:
+  enum Result : uint8_t {
+    PENDING,             // Byte consumed, no complete frame yet
+    FRAME_OK,            // Frame complete, checksum verified
+    FRAME_BAD_CHECKSUM   // Frame complete, checksum mismatch (dropped)
+  };
+
+  PentairParser() { reset(); }
+
+  // Discard any partially received frame and hunt for a new preamble
+  void reset() {
+    _state = WAIT_FF1;
+    _len = 0;
+    _hunted = 0;
+  }
+
+  // True while in the middle of a frame (after the 0xA5 lead byte)
+  bool inFrame() const { return _state >= HEADER; }
+
+  /*
+   * Feed one received byte.
+   * On FRAME_OK the frame is available through frame()/length()
+   * until the next frame's lead byte (0xA5) arrives.
+   */
+  Result feed(uint8_t b) {
+    if (_state < HEADER) _hunted++;
+    switch (_state) {
+      // ---- Preamble: FF 00 FF A5 ----
+      case WAIT_FF1:
+        if (b == 0xFF) _state = WAIT_00;
+        break;
+
+      case WAIT_00:
+        if (b == 0x00)      _state = WAIT_FF2;
+        else if (b != 0xFF) _state = WAIT_FF1;   // Repeated FF is fine
+        break;
+
+      case WAIT_FF2:
+        _state = (b == 0xFF) ? WAIT_LEAD : WAIT_FF1;
+        break;
+
+      case WAIT_LEAD:
+        if (b == 0xA5) {
+          _buf[0] = 0xFF;
+          _buf[1] = 0x00;
+          _buf[2] = 0xFF;
+          _buf[3] = 0xA5;
+          _len = PENTAIR_PREAMBLE_LEN;
+          _sum = 0xA5;
+          _state = HEADER;
+          if (_hunted > PENTAIR_PREAMBLE_LEN) {   // Noise or a lost frame before this one
+            _resyncs++;
+            _skipped += _hunted - PENTAIR_PREAMBLE_LEN;
+          }
+          _hunted = 0;
+        } else {
+          // FF 00 FF FF... or FF 00 FF 00...: the last FF (and 00)
+          // may be the start of the real preamble
+          _state = (b == 0xFF) ? WAIT_00 : (b == 0x00 ? WAIT_FF2 : WAIT_FF1);
+        }
+        break;
+
+      // ---- Header: VER DST SRC CMD LEN ----
+      case HEADER:
+        _buf[_len++] = b;
+        _sum += b;
+        if (_len == PKT_IDX_DATA) {
+          _state = (_buf[PKT_IDX_LEN] > 0) ? PAYLOAD : CHECKSUM_HI;
+        }
+        break;
+
+      // ---- Data: LEN bytes ----
+      case PAYLOAD:
+        _buf[_len++] = b;
+        _sum += b;
+        if (_len == (size_t)PKT_IDX_DATA + _buf[PKT_IDX_LEN]) {
+          _state = CHECKSUM_HI;
+        }
+        break;
+
+      // ---- Checksum: HI LO ----
+      case CHECKSUM_HI:
+        _buf[_len++] = b;
+        _state = CHECKSUM_LO;
+        break;
+
+      case CHECKSUM_LO: {
+        _buf[_len++] = b;
+        _state = WAIT_FF1;
+        uint16_t received = ((uint16_t)_buf[_len - 2] << 8) | b;
+        return (received == _sum) ? FRAME_OK : FRAME_BAD_CHECKSUM;
+      }
+    }
+    return PENDING;
+  }
+
+  // Last completed frame (preamble through checksum)
+  const uint8_t* frame() const { return _buf; }
+  size_t length() const { return _len; }
+
+  // ---- Counters ----
+  // Preambles found only after skipping bytes, and the bytes skipped
+  uint32_t resyncs() const { return _resyncs; }
+  uint32_t skippedBytes() const { return _skipped; }
+
+private:
+  enum State : uint8_t {
+    WAIT_FF1, WAIT_00, WAIT_FF2, WAIT_LEAD,   // Hunting for preamble
+    HEADER, PAYLOAD, CHECKSUM_HI, CHECKSUM_LO // Inside a frame
+  };
+
+  uint8_t  _buf[PENTAIR_MAX_PKT_LEN];
+  size_t   _len;
+  uint16_t _sum;
+  State    _state;
+  uint32_t _hunted;                // Bytes seen since the last frame / reset()
+  uint32_t _resyncs = 0;
+  uint32_t _skipped = 0;
+};
+
+// =============================================
+// RX RING BUFFER
+// =============================================
+// Fixed-size byte FIFO between the UART driver and the parser.
+// The driver copies straight into the free space (writeBegin/
+// writeCommit), the parser pops bytes out. N must be a power of two.
+// Single producer / single consumer on the same task.
+
+template <size_t N>
+class ByteRing {
+  static_assert((N & (N - 1)) == 0, "ByteRing size must be a power of two");
+
+public:
+  size_t available() const { return _head - _tail; }
+  size_t space() const { return N - available(); }
+  void clear() { _head = _tail = 0; }
+
+  // Contiguous free region for a direct write; len = usable bytes
+  uint8_t* writeBegin(size_t& len) {
+    size_t idx = _head & (N - 1);
+    size_t free = space();
+    len = (N - idx < free) ? (N - idx) : free;
+    return &_buf[idx];
+  }
+  void writeCommit(size_t n) { _head += n; }
+
+  // Next byte, or -1 if empty
+  int pop() {
+    if (_head == _tail) return -1;
+    return _buf[_tail++ & (N - 1)];
+  }
+
+private:
+  uint8_t _buf[N];
+  size_t  _head = 0;   // Total bytes written (wraps)
+  size_t  _tail = 0;   // Total bytes read (wraps)
+};
+
 #endif // PENTAIR_PROTOCOL_H
@@ -5,16 +5,25 @@
  * 
  * Shared between Controller.ino and MQTTHandler.h
  * so both can access the pump's current state.
+ *
+ * PUMP REGISTRY:
+ *   One PumpStatus per IntelliFlo address on the bus,
+ *   indexed by pumpIndex(addr): 0x60 -> 0 ... 0x63 -> 3.
  */
 
 #ifndef PUMP_STATUS_H
 #define PUMP_STATUS_H
 
 #include <Arduino.h>
+#include "PentairProtocol.h"
+
+#define PUMP_COUNT  4   // ADDR_PUMP_1 .. ADDR_PUMP_4
 
 // Last known pump status (from CMD_STATUS responses)
 struct PumpStatus {
+  bool     present  = false;  // Seen on the bus (or configured)
   bool     valid    = false;  // Have we received at least one status?
+  bool     remote   = false;  // Under our remote control
   bool     running  = false;
   uint16_t rpm      = 0;
   uint16_t watts    = 0;
@@ -26,6 +35,18 @@ struct PumpStatus {
   uint8_t  hour     = 0;
   uint8_t  minute   = 0;
   unsigned long lastUpdate = 0;
+  unsigned long sampledAt  = 0;  // Last CMD_STATUS reply (acks don't measure power)
+  unsigned long lastQuery  = 0;  // Last status poll we sent (bus task)
+  uint16_t pollMs   = 0;        // Current adaptive poll interval (0 = poll now)
 };
 
+// Registry index for a pump address, or -1 if not a pump
+inline int pumpIndex(uint8_t addr) {
+  if (addr < ADDR_PUMP_1 || addr >= ADDR_PUMP_1 + PUMP_COUNT) return -1;
+  return addr - ADDR_PUMP_1;
+}
+
+// Address of registry slot i (0-based)
+inline uint8_t pumpAddress(int i) { return ADDR_PUMP_1 + i; }
+
 #endif // PUMP_STATUS_H
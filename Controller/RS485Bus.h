@@ -0,0 +1,573 @@
+/*
+ * =============================================
+ * RS485Bus.h - Dedicated RS-485 bus task
+ * =============================================
+ *
+ * All pump I/O runs in its own FreeRTOS task, pinned to the core
+ * WiFi/LwIP don't use (APP_CPU, core 1) at a priority above the
+ * Arduino loop task. The HTTP server, MQTT client, WiFi reconnects
+ * and the Serial menu can block as long as they like without making
+ * us miss a pump reply.
+ *
+ * HOW IT WORKS:
+ *   loop task / web / MQTT               RS-485 bus task
+ *   ----------------------               ---------------
+ *   bus.submit(sequence)  --queue-->     runs sequence, TX/RX frames,
+ *                                        parses replies into pumps[]
+ *   bus.snapshot()        <--mutex---    publishes a copy after each change
+ *
+ * Up to BUS_MAX_SEQUENCES sequences run side by side (e.g. a status
+ * query while a full start sits in its 1 s wait). Their frames go
+ * through one TransactionTable, which keeps per-pump order, matches
+ * replies and retries lost ones.
+ *
+ * The task sleeps in a queue set on { UART events, request queue }
+ * until bytes arrive, a request is submitted, or the running
+ * sequence's next deadline - no fixed-rate polling.
+ *
+ * SHARED BUS:
+ *   Every frame on the wire is decoded, not just replies to us, so a
+ *   pump polled by an IntelliCenter (0x10) stays current for free.
+ *   We only transmit in idle gaps: never mid-frame, and not while
+ *   another master is waiting for a pump's reply. Listen-only mode
+ *   turns transmitting off entirely: running and queued requests are
+ *   dropped when it goes on, and nothing new is accepted.
+ *
+ * METRICS:
+ *   bus.metrics() - frame/byte counts, errors, reply latency,
+ *   utilisation (see BusMetrics.h), safe from any task.
+ *
+ * CAPTURE / REPLAY (Capture.h):
+ *   Every frame sent or received is handed to captureFrame(). A
+ *   replayed capture comes back in through bus.replay(): its received
+ *   frames are fed through a parser of their own and then reach the
+ *   registry and counters like frames off the wire, but never the
+ *   transaction table or other-master tracking.
+ *   Between setReplaying(true) and (false) the registry is the
+ *   replay's: the live one is put aside and restored afterwards, live
+ *   frames meanwhile are counted and left out of it, and snapshots
+ *   carry replay = true so nothing persistent or bound for the cloud
+ *   (energy, history, MQTT) takes them as real.
+ *
+ * OWNERSHIP:
+ *   The pump registry pumps[] (Controller.ino) is written only by
+ *   the bus task. Everything else reads bus.snapshot().
+ */
+
+#ifndef RS485_BUS_H
+#define RS485_BUS_H
+
+#include <Arduino.h>
+#include "PentairProtocol.h"
+#include "RS485Uart.h"
+#include "PumpStatus.h"
+#include "Transactions.h"
+#include "CommandSequencer.h"
+#include "BusMetrics.h"
+#include "CaptureFormat.h"
+#include "Log.h"
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define BUS_TASK_CORE       1      // APP_CPU - WiFi/LwIP live on core 0
+#define BUS_TASK_PRIORITY   3      // Above loopTask (1): bus work preempts HTTP/MQTT
+#define BUS_TASK_STACK      6144   // Bytes (holds two CommandSequence copies)
+#define BUS_QUEUE_LEN       4      // Outbound sequences waiting for the bus
+#define BUS_REPLAY_QUEUE_LEN 8     // Replayed frames waiting for the bus task
+#define BUS_MAX_SEQUENCES   3      // Sequences running at the same time
+#define BUS_IDLE_POLL_MS    100    // Max sleep when idle (onBusIdle timer resolution)
+#define BUS_FOREIGN_REPLY_WINDOW_MS  100    // Hold off after another master's request
+#define BUS_FOREIGN_TIMEOUT_MS       60000  // Forget that master after this much silence
+
+// =============================================
+// FORWARD DECLARATIONS
+// (these functions are defined in Controller.ino and run on the bus task)
+// =============================================
+void handleBusFrame(const uint8_t* frame, size_t len);  // Parse + log a received frame
+void onBusIdle();                                       // Nothing queued or running
+void onBusUpdated();                                    // New snapshot published
+void captureFrame(uint8_t flags, const uint8_t* frame, size_t len);   // Capture.h ring
+
+// Bus-task-owned pump registry (defined in Controller.ino)
+extern PumpStatus pumps[PUMP_COUNT];
+extern const uint8_t controllerAddr;   // Replies to this address are ours
+
+// =============================================
+// SNAPSHOT (copied out for other tasks)
+// =============================================
+struct BusSnapshot {
+  PumpStatus  pumps[PUMP_COUNT];
+  const char* sequence = "none";   // Name of the sequence in progress
+  uint8_t     seqPump  = 0;        // Its target address, 0 when idle
+  uint8_t     seqStep  = 0;        // 1-based, 0 when idle
+  uint8_t     seqSteps = 0;
+  uint8_t     foreignMaster = 0;   // Another controller polling pumps, 0 = none seen
+  bool        listenOnly    = false;
+  bool        replay        = false;   // pumps[] is a capture being replayed, not live
+};
+
+// =============================================
+// RS485Bus CLASS
+// =============================================
+class RS485Bus {
+private:
+  static RS485Bus* _instance;      // For the static transmit callback
+
+  uart_port_t      _port;
+  RS485Uart        _uart;
+  TransactionTable _txns;
+  CommandSequencer _lanes[BUS_MAX_SEQUENCES];
+
+  // Each running sequence holds at most one transaction
+  static_assert(BUS_MAX_SEQUENCES <= TXN_MAX_INFLIGHT, "transaction table too small");
+
+  QueueHandle_t    _queue = nullptr;     // Requests from other tasks
+  QueueHandle_t    _replayQueue = nullptr;   // CaptureRecords from a replay
+  QueueSetHandle_t _queueSet = nullptr;  // { UART events, _queue, _replayQueue }
+  TaskHandle_t     _task = nullptr;
+
+  // Requests taken off _queue but not started yet (bus task only)
+  CommandSequence  _pending[BUS_QUEUE_LEN];
+  uint8_t          _pendingHead = 0;
+  uint8_t          _pendingCount = 0;
+  CommandSequence  _incoming;            // Scratch when the backlog is full
+
+  uint8_t          _foreignMaster = 0;   // Last other master heard (bus task only)
+  unsigned long    _foreignSeenAt = 0;
+  volatile bool    _listenOnly = false;
+  bool             _silenced = false;    // Work dropped for listen-only (bus task only)
+  PentairParser    _replayParser;        // Replayed bytes never touch the UART's
+  volatile bool    _replaying = false;   // Asked for by Capture (any task)
+  bool             _inReplay = false;    // Registry swapped out (bus task only)
+  uint32_t         _liveSkipped = 0;     // Live frames kept out of the replay's registry
+  PumpStatus       _liveRegistry[PUMP_COUNT];   // pumps[] while a replay has it
+
+  portMUX_TYPE     _mux = portMUX_INITIALIZER_UNLOCKED;
+  BusSnapshot      _snapshot;
+  volatile uint32_t _updates = 0;  // Bumped on every snapshot change
+
+  // Metrics (written by the bus task only, see BusMetrics.h)
+  uint32_t         _baud = 9600;
+  volatile uint32_t _framesTx = 0;
+  volatile uint32_t _framesRx = 0;
+  volatile uint32_t _badFrames = 0;
+  volatile uint16_t _utilPermille = 0;
+  uint32_t         _utilBytes = 0;        // Line bytes at the window start
+  unsigned long    _utilFrom = 0;
+  PeakTracker      _iterPeak;
+
+  // ---- RS-485 SEND (bus task only) ----
+  static void transmit(const uint8_t* data, size_t length) {
+    _instance->sendFrame(data, length);
+  }
+
+  void sendFrame(const uint8_t* data, size_t length) {
+    LOG_HEX(LOG_TRACE, "BUS", "TX", data, length);
+
+    // No RX flush: the parser resyncs on its own, and a flush would drop
+    // a frame (another master's, a late reply) still arriving
+    _uart.write(data, length);
+    _framesTx++;
+    captureFrame(CAPTURE_TX, data, length);
+  }
+
+  // ---- RS-485 RECEIVE (bus task only) ----
+  // Returns true if at least one frame was handled
+  bool pollReceive() {
+    bool handled = false;
+    PentairParser::Result r;
+    while ((r = _uart.poll()) != PentairParser::PENDING) {
+      captureFrame(r == PentairParser::FRAME_OK ? 0 : CAPTURE_BAD, _uart.frame(), _uart.frameLength());
+      if (handleReceived(r, _uart.frame(), _uart.frameLength(), false)) handled = true;
+    }
+    return handled;
+  }
+
+  // One complete frame, off the line or out of a replay (replay = true).
+  // The registry takes only the replay's frames while one runs; only
+  // live frames reach the transaction table and master tracking.
+  // Returns true if the registry was updated.
+  bool handleReceived(PentairParser::Result r, const uint8_t* frame, size_t len, bool replay) {
+    if (r == PentairParser::FRAME_OK) {
+      _framesRx++;
+      bool shown = (replay == _inReplay);
+      if (shown) handleBusFrame(frame, len);
+      else _liveSkipped++;
+      if (!replay) trackFrame(frame[PKT_IDX_SRC], frame[PKT_IDX_DST], frame[PKT_IDX_CMD]);
+      return shown;
+    }
+    LOG_HEX(LOG_TRACE, "BUS", "RX", frame, len);
+    LOGW("BUS", "Bad checksum from 0x%02X - frame dropped", frame[PKT_IDX_SRC]);
+    _badFrames++;
+    if (!replay) _txns.onBadFrame(frame[PKT_IDX_SRC]);
+    return false;
+  }
+
+  // Next replayed record. Our own frames are only shown; received
+  // ones go through _replayParser as if they had just arrived.
+  // Records still queued when the replay ended are taken and dropped.
+  bool replayRecord() {
+    CaptureRecord rec;
+    if (xQueueReceive(_replayQueue, &rec, 0) != pdTRUE) return false;
+    if (!_inReplay) return false;
+    if (rec.flags & CAPTURE_TX) {
+      LOG_HEX(LOG_TRACE, "BUS", "TX (replay)", rec.data, rec.len);
+      return false;
+    }
+    bool handled = false;
+    for (uint8_t i = 0; i < rec.len; i++) {
+      PentairParser::Result r = _replayParser.feed(rec.data[i]);
+      if (r != PentairParser::PENDING &&
+          handleReceived(r, _replayParser.frame(), _replayParser.length(), true)) {
+        handled = true;
+      }
+    }
+    _replayParser.reset();    // A cut-off record never completes
+    return handled;
+  }
+
+  // A replay starts / ends: it gets the registry to itself, and the
+  // live one comes back untouched. Records still queued past the end
+  // are dropped by replayRecord(), so none lands in the restored registry.
+  bool syncReplay() {
+    if (_replaying == _inReplay) return false;
+    _inReplay = _replaying;
+    if (_inReplay) {
+      memcpy(_liveRegistry, pumps, sizeof(_liveRegistry));
+      _liveSkipped = 0;
+    } else {
+      _replayParser.reset();
+      memcpy(pumps, _liveRegistry, sizeof(_liveRegistry));
+      if (_liveSkipped) {
+        LOGI("BUS", "Replay over - %lu live frame(s) kept out of it", (unsigned long)_liveSkipped);
+      }
+    }
+    return true;
+  }
+
+  // Route a valid frame to the transaction table and keep track of
+  // other masters on the bus
+  void trackFrame(uint8_t src, uint8_t dst, uint8_t cmd) {
+    if (dst == controllerAddr) {
+      _txns.onFrame(src, cmd);
+      return;
+    }
+    _txns.noteLineActivity();
+
+    if (pumpIndex(dst) >= 0 && pumpIndex(src) < 0) {
+      // Someone else asked a pump something: leave room for its answer
+      if (src != _foreignMaster) {
+        LOGW("BUS", "Another master on the bus: 0x%02X", src);
+      }
+      _foreignMaster = src;
+      _foreignSeenAt = millis();
+      _txns.holdOff(BUS_FOREIGN_REPLY_WINDOW_MS);
+    } else if (pumpIndex(src) >= 0) {
+      _txns.holdOff(0);   // The pump answered them: gap is open again
+    }
+  }
+
+  // Take one request off the queue. A preempting one (full start/stop)
+  // starts right away; anything else waits its turn in _pending.
+  void receiveRequest() {
+    // Receive straight into the next backlog slot, or scratch if it is full
+    bool full = (_pendingCount >= BUS_QUEUE_LEN);
+    CommandSequence& slot = full ? _incoming
+                                 : _pending[(_pendingHead + _pendingCount) % BUS_QUEUE_LEN];
+    if (xQueueReceive(_queue, &slot, 0) != pdTRUE) return;
+
+    if (_listenOnly) {
+      LOGW("BUS", "Listen-only mode - \"%s\" not sent", slot.name);   // Queued just before
+    } else if (slot.preempt) {
+      runPreempting(slot);
+    } else if (!full) {
+      _pendingCount++;
+    } else {
+      LOGW("BUS", "Backlog full - \"%s\" dropped", slot.name);
+    }
+  }
+
+  // Full start/stop takes over its pump: that pump's other work is
+  // abandoned, running or waiting in the backlog (a queued keep-alive
+  // would re-select the program it just turned off), other pumps carry on
+  void runPreempting(const CommandSequence& seq) {
+    CommandSequencer* free = nullptr;
+    for (CommandSequencer& lane : _lanes) {
+      if (lane.busy() && lane.addr() == seq.addr) lane.abort();
+      if (!lane.busy() && !free) free = &lane;
+    }
+    uint8_t kept = 0;
+    for (uint8_t n = 0; n < _pendingCount; n++) {
+      const CommandSequence& queued = _pending[(_pendingHead + n) % BUS_QUEUE_LEN];
+      if (queued.addr == seq.addr) continue;
+      if (kept != n) _pending[(_pendingHead + kept) % BUS_QUEUE_LEN] = queued;
+      kept++;
+    }
+    if (kept != _pendingCount) {
+      LOGI("BUS", "\"%s\" - %d queued request(s) for 0x%02X dropped",
+           seq.name, _pendingCount - kept, seq.addr);
+    }
+    _pendingCount = kept;
+    if (free) {
+      free->run(seq);
+      return;
+    }
+
+    // Every lane is busy with other pumps: go to the head of the backlog
+    if (_pendingCount == BUS_QUEUE_LEN) {
+      LOGW("BUS", "Backlog full - \"%s\" dropped",
+           _pending[(_pendingHead + _pendingCount - 1) % BUS_QUEUE_LEN].name);
+      _pendingCount--;
+    }
+    _pendingHead = (_pendingHead + BUS_QUEUE_LEN - 1) % BUS_QUEUE_LEN;
+    _pending[_pendingHead] = seq;
+    _pendingCount++;
+  }
+
+  // Start waiting requests on any free lane (oldest first)
+  void startPending() {
+    for (CommandSequencer& lane : _lanes) {
+      if (_pendingCount == 0) return;
+      if (lane.busy()) continue;
+      lane.run(_pending[_pendingHead]);
+      _pendingHead = (_pendingHead + 1) % BUS_QUEUE_LEN;
+      _pendingCount--;
+    }
+  }
+
+  // Listen-only just went on: abandon what is running and queued, so
+  // no step or retry of it goes out. A frame already on the wire keeps
+  // the line until its reply is due (TransactionTable::cancel).
+  // Requests still in _queue come through the queue set as usual and
+  // are dropped by receiveRequest().
+  void dropAllWork() {
+    for (CommandSequencer& lane : _lanes) lane.abort();
+    if (_pendingCount) {
+      LOGI("BUS", "Listen-only - %d queued request(s) dropped", _pendingCount);
+    }
+    _pendingCount = 0;
+  }
+
+  bool anyLaneBusy() const {
+    for (const CommandSequencer& lane : _lanes) {
+      if (lane.busy()) return true;
+    }
+    return false;
+  }
+
+  // Lane shown in status: a multi-step sequence wins over one-shot commands
+  const CommandSequencer& reportedLane() const {
+    const CommandSequencer* shown = &_lanes[0];
+    for (const CommandSequencer& lane : _lanes) {
+      if (lane.stepCount() > shown->stepCount()) shown = &lane;
+    }
+    return *shown;
+  }
+
+  void runLanes() {
+    for (CommandSequencer& lane : _lanes) lane.loop();
+  }
+
+  uint8_t foreignMaster() const {
+    if (!_foreignMaster || millis() - _foreignSeenAt > BUS_FOREIGN_TIMEOUT_MS) return 0;
+    return _foreignMaster;
+  }
+
+  uint32_t msUntilDue() const {
+    uint32_t due = _txns.msUntilDue();
+    for (const CommandSequencer& lane : _lanes) {
+      uint32_t d = lane.msUntilDue();
+      if (d < due) due = d;
+    }
+    return due;
+  }
+
+  // Share of the window the line carried bytes, once a window
+  void sampleUtilisation() {
+    unsigned long now = millis();
+    unsigned long elapsed = now - _utilFrom;
+    if (elapsed < METRICS_UTIL_WINDOW_MS) return;
+    uint32_t bytes = _uart.rxBytes() + _uart.txBytes();
+    uint32_t busyMs = (uint64_t)(bytes - _utilBytes) * 10 * 1000 / _baud;
+    _utilPermille = (busyMs >= elapsed) ? 1000 : busyMs * 1000 / elapsed;
+    _utilBytes = bytes;
+    _utilFrom = now;
+  }
+
+  // Copy bus-owned state out for other tasks
+  void publishSnapshot() {
+    portENTER_CRITICAL(&_mux);
+    memcpy(_snapshot.pumps, pumps, sizeof(_snapshot.pumps));
+    _snapshot.foreignMaster = foreignMaster();
+    _snapshot.listenOnly = _listenOnly;
+    _snapshot.replay = _inReplay;
+    const CommandSequencer& shown = reportedLane();
+    _snapshot.sequence = shown.name();
+    _snapshot.seqPump  = shown.addr();
+    _snapshot.seqStep  = shown.step();
+    _snapshot.seqSteps = shown.stepCount();
+    _updates++;
+    portEXIT_CRITICAL(&_mux);
+    onBusUpdated();
+  }
+
+  static void taskEntry(void* arg) {
+    static_cast<RS485Bus*>(arg)->run();
+  }
+
+  void run() {
+    const char* lastName = nullptr;
+    uint8_t lastStep = 0;
+
+    for (;;) {
+      // Sleep until UART data, a new request, or the next sequence/transaction deadline
+      uint32_t waitMs = msUntilDue();
+      if (waitMs > BUS_IDLE_POLL_MS) waitMs = BUS_IDLE_POLL_MS;
+
+      QueueSetMemberHandle_t ready = xQueueSelectFromSet(_queueSet, pdMS_TO_TICKS(waitMs));
+      uint32_t woke = micros();
+      bool changed = syncReplay();
+      if (ready == _uart.eventQueue()) {
+        uart_event_t event;
+        if (xQueueReceive(_uart.eventQueue(), &event, 0) == pdTRUE) {
+          _uart.handleEvent(event);
+          _txns.noteLineActivity();
+        }
+      } else if (ready == _queue) {
+        receiveRequest();
+      } else if (ready == _replayQueue) {
+        changed = replayRecord();
+      }
+
+      if (pollReceive()) changed = true;
+      if (_listenOnly != _silenced) {
+        _silenced = _listenOnly;
+        if (_silenced) dropAllWork();
+      }
+      runLanes();
+      startPending();
+      runLanes();          // Queue the first frame of newly started sequences
+      // Timeouts, retries, and whatever may go out now (nothing while listen-only)
+      _txns.loop(!_listenOnly && !_uart.receiving());
+
+      if (!anyLaneBusy() && _pendingCount == 0) {
+        onBusIdle();       // Anything it submits wakes the next select
+      }
+
+      const CommandSequencer& shown = reportedLane();
+      if (shown.name() != lastName || shown.step() != lastStep) {
+        lastName = shown.name();
+        lastStep = shown.step();
+        changed = true;
+      }
+      if (changed) publishSnapshot();
+
+      sampleUtilisation();
+      _iterPeak.record(micros() - woke);
+    }
+  }
+
+public:
+  RS485Bus(uart_port_t port) : _port(port) { _instance = this; }
+
+  // Open the UART and start the bus task
+  void begin(uint32_t baud, int8_t rxPin, int8_t txPin, uint8_t dePin) {
+    // RS-485 UART (Pentair: 9600 baud, 8N1) + direction pin
+    if (!_uart.begin(_port, baud, rxPin, txPin, dePin)) return;
+    _baud = baud;
+
+    _txns.begin(transmit);
+    for (CommandSequencer& lane : _lanes) lane.begin(_txns);
+    _queue = xQueueCreate(BUS_QUEUE_LEN, sizeof(CommandSequence));
+    _replayQueue = xQueueCreate(BUS_REPLAY_QUEUE_LEN, sizeof(CaptureRecord));
+
+    // Wake the bus task on UART traffic, a new request or a replayed frame
+    _queueSet = xQueueCreateSet(RS485_EVENT_QUEUE_LEN + BUS_QUEUE_LEN + BUS_REPLAY_QUEUE_LEN);
+    xQueueAddToSet(_uart.eventQueue(), _queueSet);
+    xQueueAddToSet(_queue, _queueSet);
+    xQueueAddToSet(_replayQueue, _queueSet);
+    publishSnapshot();
+
+    xTaskCreatePinnedToCore(taskEntry, "rs485", BUS_TASK_STACK, this,
+                            BUS_TASK_PRIORITY, &_task, BUS_TASK_CORE);
+  }
+
+  /*
+   * Queue a sequence for the bus (safe from any task).
+   * Returns false if the queue stayed full for waitMs.
+   */
+  bool submit(const CommandSequence& seq, uint32_t waitMs = 50) {
+    if (!_queue) return false;
+    if (_listenOnly) {
+      LOGW("BUS", "Listen-only mode - \"%s\" not sent", seq.name);
+      return false;
+    }
+    // Never block the bus task on its own queue
+    TickType_t wait = (xTaskGetCurrentTaskHandle() == _task) ? 0 : pdMS_TO_TICKS(waitMs);
+    if (xQueueSend(_queue, &seq, wait) != pdTRUE) {
+      LOGW("BUS", "Queue full - \"%s\" dropped", seq.name);
+      return false;
+    }
+    return true;
+  }
+
+  /*
+   * Hand one captured frame to the bus task as if it were on the line
+   * (safe from any task). False if the replay queue is full: try again.
+   */
+  bool replay(const CaptureRecord& rec) {
+    return _replayQueue && xQueueSend(_replayQueue, &rec, 0) == pdTRUE;
+  }
+
+  // Consistent copy of the latest bus state (safe from any task)
+  BusSnapshot snapshot() {
+    portENTER_CRITICAL(&_mux);
+    BusSnapshot s = _snapshot;
+    portEXIT_CRITICAL(&_mux);
+    return s;
+  }
+
+  // Counters, latency and utilisation, gathered (safe from any task)
+  BusMetrics metrics() const {
+    BusMetrics m;
+    m.framesTx       = _framesTx;
+    m.framesRx       = _framesRx;
+    m.bytesTx        = _uart.txBytes();
+    m.bytesRx        = _uart.rxBytes();
+    m.checksumErrors = _badFrames;
+    m.resyncs        = _uart.resyncs();
+    m.skippedBytes   = _uart.skippedBytes();
+    m.overruns       = _uart.overruns();
+    m.truncated      = _uart.truncatedFrames();
+    m.timeouts       = _txns.timeouts();
+    m.retries        = _txns.retries();
+    m.failures       = _txns.failures();
+    m.latency        = _txns.latency();
+    m.baud           = _baud;
+    m.utilPermille   = _utilPermille;
+    m.busIterPeakUs  = _iterPeak.peak();
+    return m;
+  }
+
+  // Passive mode: decode everything, transmit nothing (safe from any task)
+  void setListenOnly(bool on) {
+    _listenOnly = on;
+    LOGI("BUS", "Listen-only mode %s", on ? "ON - we will not transmit" : "OFF");
+  }
+  bool listenOnly() const { return _listenOnly; }
+
+  // Capture replay on / off (safe from any task; see CAPTURE / REPLAY).
+  // Turn it on before the first bus.replay().
+  void setReplaying(bool on) { _replaying = on; }
+
+  // Changes whenever the snapshot does (poll to detect new data)
+  uint32_t updateCount() const { return _updates; }
+
+  // Bus task only: is a sequence running right now?
+  bool busy() const { return anyLaneBusy(); }
+};
+
+RS485Bus* RS485Bus::_instance = nullptr;
+
+#endif // RS485_BUS_H
@@ -0,0 +1,411 @@
+/*
+ * =============================================
+ * Schedule.h - On-device pump schedule (external programs)
+ * =============================================
+ *
+ * Time-of-day rules run the pumps' external programs from here, so a
+ * pump keeps its schedule through broker, cloud or WiFi outages. Once
+ * the clock has been set by SNTP the ESP32 keeps time by itself.
+ *
+ * RULE:  pump, days, start-end (local time), program slot 1-4, RPM
+ *   "Pump 1, Mon-Fri, 08:00-18:00, program 2 at 2000 RPM"
+ *   end < start runs past midnight (22:00-02:00); the days are those
+ *   the rule starts on. The first enabled rule covering a pump wins.
+ *
+ * WHAT GOES ON THE BUS:
+ *   rule starts      remote, program N RPM, select program N, run
+ *   while it runs    remote + select program N, every EXT_PROG_KEEPALIVE_MS
+ *   rule ends        program off, stop, local
+ *
+ * The pump drops an external program that isn't re-selected within
+ * EXT_PROG_REPEAT_INTERVAL (30 s). The keep-alive is sent from the bus
+ * task's idle hook, at half that, so one lost frame (after retries)
+ * still leaves the pump running; nothing on the loop task or the
+ * network can delay it.
+ *
+ * MANUAL OVERRIDE:
+ *   A full start / full stop (Serial, Web, MQTT) on a scheduled pump
+ *   cancels its program until the next rule change for that pump. The
+ *   "program off" write is the first step of that start / stop
+ *   sequence, so nothing on the bus can get between the two.
+ *
+ * Rules are kept in NVS, and so is the rule each pump is running: after
+ * a reboot resume() restarts that program straight away, without
+ * waiting for WiFi and SNTP. Once the clock is set the rules take over
+ * again as usual.
+ *
+ * USAGE (Controller.ino):
+ *   schedule.begin();          setup()
+ *   schedule.resume(idx);      once pump idx answers after boot
+ *   scheduleStartClock();      once WiFi is up (SNTP + time zone)
+ *   schedule.loop();           every loop (rule changes)
+ *   schedule.keepAlive();      onBusIdle() (bus task)
+ *   schedule.cancel(addr);     building a manual full start / stop
+ */
+
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <time.h>
+#include "PentairProtocol.h"
+#include "PumpStatus.h"
+#include "Log.h"
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define SCHEDULE_MAX_RULES      8
+#define SCHEDULE_TZ             "UTC0"          // POSIX TZ, e.g. "PST8PDT,M3.2.0,M11.1.0"
+#define SCHEDULE_NTP_SERVER_1   "pool.ntp.org"
+#define SCHEDULE_NTP_SERVER_2   "time.nist.gov"
+#define SCHEDULE_CLOCK_MIN      1600000000L     // Clock counts as set past this
+#define SCHEDULE_EVAL_INTERVAL  1000            // How often rules are checked (ms)
+#define EXT_PROG_KEEPALIVE_MS   (EXT_PROG_REPEAT_INTERVAL / 2)
+#define SCHEDULE_PREFS_NAMESPACE "sched"
+#define SCHEDULE_PREFS_KEY       "rules"
+#define SCHEDULE_PREFS_APPLIED   "applied"
+
+// =============================================
+// FORWARD DECLARATIONS
+// (these functions are defined in Controller.ino)
+// =============================================
+void runExtProgramSequence(uint8_t addr, uint8_t program, uint16_t rpm);
+void runExtProgramStopSequence(uint8_t addr);
+void sendExtProgramKeepAlive(uint8_t addr, uint8_t program);
+
+// =============================================
+// ONE RULE (the NVS record - append fields only)
+// =============================================
+struct ScheduleRule {
+  bool     enabled = false;
+  uint8_t  pump    = 1;        // 1-4
+  uint8_t  days    = 0x7F;     // bit 0 = Sunday ... bit 6 = Saturday
+  uint16_t start   = 0;        // Minutes after local midnight
+  uint16_t end     = 0;        // Exclusive; end < start runs past midnight
+  uint8_t  program = 1;        // External program slot 1-4
+  uint16_t rpm     = 0;
+
+  bool covers(const struct tm& tm) const {
+    int m = tm.tm_hour * 60 + tm.tm_min;
+    int today = tm.tm_wday;
+    int yesterday = (today + 6) % 7;
+    if (start < end) return (days >> today & 1) && m >= start && m < end;
+    return ((days >> today & 1) && m >= start) ||
+           ((days >> yesterday & 1) && m < end);
+  }
+};
+
+// Why a rule can't be saved, or nullptr if it's fine
+inline const char* scheduleRuleError(const ScheduleRule& r) {
+  if (r.pump < 1 || r.pump > PUMP_COUNT) return "pump must be 1-4";
+  if (!r.days || r.days > 0x7F)          return "days must be digits 0-6 (0 = Sunday) or *";
+  if (r.start >= 24 * 60 || r.end >= 24 * 60 || r.start == r.end) return "start / end must be different HH:MM times";
+  if (r.program < 1 || r.program > 4)    return "program must be 1-4";
+  if (r.rpm < 450 || r.rpm > 3450)       return "rpm must be 450-3450";
+  return nullptr;
+}
+
+// "HH:MM" -> minutes after midnight, or -1
+inline int scheduleParseTime(const char* s) {
+  int h, m;
+  char extra;
+  if (sscanf(s, "%d:%d%c", &h, &m, &extra) != 2) return -1;
+  if (h < 0 || h > 23 || m < 0 || m > 59) return -1;
+  return h * 60 + m;
+}
+
+// Day digits "12345" (0 = Sunday) or "*" -> bit mask, or -1
+inline int scheduleParseDays(const char* s) {
+  if (strcmp(s, "*") == 0) return 0x7F;
+  int mask = 0;
+  for (; *s; s++) {
+    if (*s < '0' || *s > '6') return -1;
+    mask |= 1 << (*s - '0');
+  }
+  return mask ? mask : -1;
+}
+
+// Start SNTP and the local time zone (after WiFi connects)
+inline void scheduleStartClock() {
+  configTzTime(SCHEDULE_TZ, SCHEDULE_NTP_SERVER_1, SCHEDULE_NTP_SERVER_2);
+  LOGI("SCHED", "SNTP started (%s, TZ %s)", SCHEDULE_NTP_SERVER_1, SCHEDULE_TZ);
+}
+
+// =============================================
+// Schedule CLASS
+// =============================================
+class Schedule {
+private:
+  ScheduleRule  _rules[SCHEDULE_MAX_RULES];
+  int8_t        _applied[PUMP_COUNT];     // Rule running per pump, -1 none (loop task)
+  int8_t        _cancelled[PUMP_COUNT];   // Rule overridden by hand, -1 none (loop task)
+  int8_t        _saved[PUMP_COUNT];       // _applied as last written to NVS
+  unsigned long _lastEval = 0;
+  bool          _clockSeen = false;
+
+  // Shared with the bus task (keep-alive) and web / MQTT (edits, overrides)
+  portMUX_TYPE  _mux = portMUX_INITIALIZER_UNLOCKED;
+  uint8_t       _keepProgram[PUMP_COUNT] = {0};   // 0 = nothing to keep alive
+  unsigned long _keepAt[PUMP_COUNT] = {0};        // Last program (re)select
+  uint8_t       _cancelMask = 0;                  // Pumps overridden by hand (bit = slot)
+  uint8_t       _editMask = 0;                    // Rules changed since loop() (bit = rule)
+
+  void setKeep(int idx, uint8_t program) {
+    portENTER_CRITICAL(&_mux);
+    _keepProgram[idx] = program;
+    _keepAt[idx] = millis();
+    portEXIT_CRITICAL(&_mux);
+  }
+
+  // First enabled rule for registry slot idx covering tm, or -1
+  static int ruleFor(const ScheduleRule* rules, int idx, const struct tm& tm) {
+    for (int r = 0; r < SCHEDULE_MAX_RULES; r++) {
+      if (rules[r].enabled && rules[r].pump == idx + 1 && rules[r].covers(tm)) return r;
+    }
+    return -1;
+  }
+
+  void apply(const ScheduleRule* rules, int idx, int rule) {
+    uint8_t addr = pumpAddress(idx);
+    if (rule < 0) {
+      LOGI("SCHED", "Pump %d: schedule ended", idx + 1);
+      setKeep(idx, 0);
+      runExtProgramStopSequence(addr);
+    } else {
+      const ScheduleRule& r = rules[rule];
+      LOGI("SCHED", "Pump %d: rule %d -> program %d at %d RPM",
+           idx + 1, rule + 1, r.program, r.rpm);
+      runExtProgramSequence(addr, r.program, r.rpm);
+      setKeep(idx, r.program);
+    }
+    _applied[idx] = rule;
+  }
+
+  // Rule per pump, for resume() after a reboot; only when it changed
+  void saveApplied() {
+    int8_t applied[PUMP_COUNT];
+    for (int i = 0; i < PUMP_COUNT; i++) applied[i] = _applied[i] < 0 ? -1 : _applied[i];
+    if (!memcmp(applied, _saved, sizeof(applied))) return;
+    memcpy(_saved, applied, sizeof(applied));
+    Preferences prefs;
+    prefs.begin(SCHEDULE_PREFS_NAMESPACE, false);
+    prefs.putBytes(SCHEDULE_PREFS_APPLIED, applied, sizeof(applied));
+    prefs.end();
+  }
+
+  void save(const ScheduleRule* rules) {
+    Preferences prefs;
+    prefs.begin(SCHEDULE_PREFS_NAMESPACE, false);
+    prefs.putBytes(SCHEDULE_PREFS_KEY, rules, sizeof(_rules));
+    prefs.end();
+  }
+
+public:
+  Schedule() {
+    for (int i = 0; i < PUMP_COUNT; i++) _applied[i] = _cancelled[i] = _saved[i] = -1;
+  }
+
+  // Load saved rules, and what was running before the reboot (setup)
+  void begin() {
+    Preferences prefs;
+    prefs.begin(SCHEDULE_PREFS_NAMESPACE, true);
+    if (prefs.getBytesLength(SCHEDULE_PREFS_KEY) == sizeof(_rules)) {
+      prefs.getBytes(SCHEDULE_PREFS_KEY, _rules, sizeof(_rules));
+    }
+    if (prefs.getBytesLength(SCHEDULE_PREFS_APPLIED) == sizeof(_saved)) {
+      prefs.getBytes(SCHEDULE_PREFS_APPLIED, _saved, sizeof(_saved));
+    }
+    prefs.end();
+  }
+
+  // Was pump idx running a rule that still applies to it? (loop task)
+  bool resumable(int idx) const {
+    int r = _saved[idx];
+    return r >= 0 && r < SCHEDULE_MAX_RULES && _applied[idx] == -1 &&
+           _rules[r].enabled && _rules[r].pump == idx + 1;
+  }
+
+  /*
+   * Restart the program pump idx was running before the reboot
+   * (loop task, once the pump answers). The clock may not be set yet;
+   * when it is, loop() moves on to whichever rule covers the time.
+   */
+  void resume(int idx) {
+    if (!resumable(idx)) return;
+    ScheduleRule rules[SCHEDULE_MAX_RULES];
+    portENTER_CRITICAL(&_mux);
+    memcpy(rules, _rules, sizeof(rules));
+    portEXIT_CRITICAL(&_mux);
+    LOGI("SCHED", "Pump %d: resuming after reboot", idx + 1);
+    apply(rules, idx, _saved[idx]);
+  }
+
+  // Follow rule changes (loop task). Nothing runs until the clock is set.
+  void loop() {
+    if (millis() - _lastEval < SCHEDULE_EVAL_INTERVAL) return;
+    _lastEval = millis();
+
+    time_t now = time(nullptr);
+    if (now < SCHEDULE_CLOCK_MIN) return;
+    if (!_clockSeen) {
+      _clockSeen = true;
+      LOGI("SCHED", "Clock set - schedule running");
+    }
+    struct tm tm;
+    localtime_r(&now, &tm);
+
+    // Rules and requests from other tasks, taken in one go
+    ScheduleRule rules[SCHEDULE_MAX_RULES];
+    portENTER_CRITICAL(&_mux);
+    memcpy(rules, _rules, sizeof(rules));
+    uint8_t cancels = _cancelMask, edits = _editMask;
+    _cancelMask = _editMask = 0;
+    portEXIT_CRITICAL(&_mux);
+
+    for (int i = 0; i < PUMP_COUNT; i++) {
+      if (cancels >> i & 1) {
+        _cancelled[i] = _applied[i];
+        _applied[i] = -1;
+      }
+      if (_applied[i] >= 0 && (edits >> _applied[i] & 1)) _applied[i] = -2;   // Re-apply
+      if (_cancelled[i] >= 0 && (edits >> _cancelled[i] & 1)) _cancelled[i] = -1;
+
+      int want = ruleFor(rules, i, tm);
+      if (_cancelled[i] >= 0) {
+        if (want == _cancelled[i]) continue;
+        _cancelled[i] = -1;          // Next rule change: back on schedule
+      }
+      if (want != _applied[i]) apply(rules, i, want);
+    }
+    saveApplied();
+  }
+
+  /*
+   * Re-select any program that is due (bus task, from onBusIdle()).
+   * Queues at most one keep-alive; returns true if it did.
+   */
+  bool keepAlive() {
+    for (int i = 0; i < PUMP_COUNT; i++) {
+      portENTER_CRITICAL(&_mux);
+      uint8_t program = _keepProgram[i];
+      bool due = program && millis() - _keepAt[i] >= EXT_PROG_KEEPALIVE_MS;
+      if (due) _keepAt[i] = millis();
+      portEXIT_CRITICAL(&_mux);
+      if (due) {
+        sendExtProgramKeepAlive(pumpAddress(i), program);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Some pump is running a scheduled program (any task)
+  bool programRunning() {
+    bool running = false;
+    portENTER_CRITICAL(&_mux);
+    for (int i = 0; i < PUMP_COUNT; i++) running |= _keepProgram[i] != 0;
+    portEXIT_CRITICAL(&_mux);
+    return running;
+  }
+
+  /*
+   * Manual command for addr: drop its program until the next rule change
+   * (any task). Returns true if a program was running: the caller's
+   * sequence must then deselect it (EPRG_OFF) as its first step.
+   */
+  bool cancel(uint8_t addr) {
+    int idx = pumpIndex(addr);
+    if (idx < 0) return false;
+    portENTER_CRITICAL(&_mux);
+    bool running = _keepProgram[idx] != 0;
+    _keepProgram[idx] = 0;
+    if (running) _cancelMask |= 1 << idx;
+    portEXIT_CRITICAL(&_mux);
+    if (running) LOGI("SCHED", "Pump %d: schedule overridden by hand", idx + 1);
+    return running;
+  }
+
+  // Copy of one rule (any task)
+  ScheduleRule rule(int slot) {
+    portENTER_CRITICAL(&_mux);
+    ScheduleRule r = _rules[slot];
+    portEXIT_CRITICAL(&_mux);
+    return r;
+  }
+
+  // Replace a rule and save (any task); a pump running it picks up the
+  // change on the next loop()
+  void setRule(int slot, const ScheduleRule& r) {
+    ScheduleRule rules[SCHEDULE_MAX_RULES];
+    portENTER_CRITICAL(&_mux);
+    _rules[slot] = r;
+    _editMask |= 1 << slot;
+    memcpy(rules, _rules, sizeof(rules));
+    portEXIT_CRITICAL(&_mux);
+    save(rules);
+  }
+
+  /*
+   * {"clockSet":true,"time":"14:05","rules":[{"slot":1,"enabled":true,
+   *  "pump":1,"days":"12345","start":"08:00","end":"18:00","program":2,
+   *  "rpm":2000,"active":true},...]}   (empty slots are left out)
+   * Returns the length, or 0 if it didn't fit.
+   */
+  size_t formatJson(char* json, size_t size) {
+    ScheduleRule rules[SCHEDULE_MAX_RULES];
+    portENTER_CRITICAL(&_mux);
+    memcpy(rules, _rules, sizeof(rules));
+    portEXIT_CRITICAL(&_mux);
+    time_t now = time(nullptr);
+    struct tm tm;
+    localtime_r(&now, &tm);
+    int n = snprintf(json, size, "{\"clockSet\":%s,\"time\":\"%02d:%02d\",\"rules\":[",
+                     now >= SCHEDULE_CLOCK_MIN ? "true" : "false", tm.tm_hour, tm.tm_min);
+    bool first = true;
+    for (int s = 0; s < SCHEDULE_MAX_RULES && n < (int)size; s++) {
+      const ScheduleRule& r = rules[s];
+      if (!r.enabled && r.rpm == 0) continue;
+      char days[8];
+      int d = 0;
+      for (int b = 0; b < 7; b++) if (r.days >> b & 1) days[d++] = '0' + b;
+      days[d] = '\0';
+      n += snprintf(json + n, size - n,
+        "%s{\"slot\":%d,\"enabled\":%s,\"pump\":%d,\"days\":\"%s\","
+        "\"start\":\"%02d:%02d\",\"end\":\"%02d:%02d\",\"program\":%d,\"rpm\":%d,\"active\":%s}",
+        first ? "" : ",", s + 1, r.enabled ? "true" : "false", r.pump, days,
+        r.start / 60, r.start % 60, r.end / 60, r.end % 60, r.program, r.rpm,
+        _applied[r.pump - 1] == s ? "true" : "false");
+      first = false;
+    }
+    if (n < (int)size) n += snprintf(json + n, size - n, "]}");
+    return n < (int)size ? n : 0;
+  }
+
+  // Serial Monitor table (loop task)
+  void print() const {
+    time_t now = time(nullptr);
+    if (now < SCHEDULE_CLOCK_MIN) {
+      Serial.println("\n  Schedule (clock not set yet - nothing runs until SNTP syncs)");
+    } else {
+      struct tm tm;
+      localtime_r(&now, &tm);
+      Serial.printf("\n  Schedule (local time %02d:%02d, TZ %s)\n", tm.tm_hour, tm.tm_min, SCHEDULE_TZ);
+    }
+    Serial.println("  #  On   Pump  Days     Start  End    Prog  RPM");
+    for (int s = 0; s < SCHEDULE_MAX_RULES; s++) {
+      const ScheduleRule& r = _rules[s];
+      if (!r.enabled && r.rpm == 0) continue;
+      char days[8];
+      for (int b = 0; b < 7; b++) days[b] = (r.days >> b & 1) ? "SMTWTFS"[b] : '-';
+      days[7] = '\0';
+      Serial.printf("  %d  %-3s  %d     %s  %02d:%02d  %02d:%02d  %d     %d%s\n",
+                    s + 1, r.enabled ? "on" : "off", r.pump, days,
+                    r.start / 60, r.start % 60, r.end / 60, r.end % 60,
+                    r.program, r.rpm, _applied[r.pump - 1] == s ? "   <- running" : "");
+    }
+  }
+};
+
+#endif // SCHEDULE_H
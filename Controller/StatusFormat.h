@@ -0,0 +1,294 @@
+/*
+ * =============================================
+ * StatusFormat.h - One pump status encoder, JSON or CBOR
+ * =============================================
+ *
+ * The status fields are listed once, in writeStatus(). The writer it
+ * is given decides the wire format:
+ *
+ *   JsonWriter  {"pump":1,"running":true,"rpm":2000,...}    (~200 bytes)
+ *   CborWriter  { 1: 1, 2: true, 3: 2000, ... }  RFC 8949   (~55 bytes)
+ *
+ * CBOR uses the small integer keys from StatusKey instead of names.
+ * Numbers and booleans also go out as 1-3 binary bytes rather than
+ * text. Decoders map the keys back with the same table (see
+ * docs/index.html, decodeStatusCbor()).
+ *
+ * Neither writer truncates: if the buffer is too small, finish()
+ * returns 0 and nothing should be sent.
+ *
+ * USED BY:
+ *   MQTT   .../status       JSON   or .../status.cbor   CBOR (MQTT_STATUS_CBOR)
+ *   HTTP   GET /api/status: the JSON record plus controller fields
+ *          (writeStatusFields), or just the CBOR one with
+ *          "Accept: application/cbor"
+ *          /events (status and deltas, LiveStatus.h)
+ * They live here rather than in MQTTHandler so builds without MQTT
+ * (Config.h) serve the same records.
+ */
+
+#ifndef STATUS_FORMAT_H
+#define STATUS_FORMAT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "PumpStatus.h"
+#include "RS485Bus.h"
+
+#define STATUS_CBOR_MAX  96   // Largest CBOR status (worst case ~71 bytes)
+
+// =============================================
+// FIELD KEYS (CBOR map keys - append only, never renumber)
+// =============================================
+enum StatusKey : uint8_t {
+  SK_PUMP = 1,     // 1-4
+  SK_RUNNING,      // bool
+  SK_RPM,
+  SK_WATTS,
+  SK_GPM,
+  SK_MODE,         // MODE_* value
+  SK_ERROR,        // 0 = none
+  SK_REMOTE,       // bool
+  SK_VALID,        // bool - at least one status reply seen
+  SK_DEVICE_ID,    // text
+  SK_UPTIME,       // seconds
+  SK_RSSI,         // dBm (negative)
+  SK_SEQUENCE,     // text, "none" when idle
+  SK_SEQ_STEP,
+  SK_SEQ_STEPS,
+  SK_COUNT
+};
+
+// JSON names, indexed by StatusKey
+const char* const STATUS_KEY_NAMES[SK_COUNT] = {
+  "", "pump", "running", "rpm", "watts", "gpm", "mode", "error", "remote",
+  "valid", "deviceId", "uptime", "rssi", "sequence", "seqStep", "seqSteps"
+};
+
+// =============================================
+// DEVICE ID (MQTT topics, /api/status, BLE setup reply)
+// =============================================
+// The whole station MAC, e.g. "24DCC3A1B2C3": unique across a fleet
+// (the last 3 bytes alone are not). Read once WiFi is up.
+inline const char* deviceId() {
+  static char id[13] = "";
+  if (!id[0]) {
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    snprintf(id, sizeof(id), "%02X%02X%02X%02X%02X%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  }
+  return id;
+}
+
+// =============================================
+// SEQUENCE FIELDS (reported only on the pump the sequence runs for)
+// =============================================
+inline const char* seqNameFor(const BusSnapshot& snap, int idx) {
+  return snap.seqPump == pumpAddress(idx) ? snap.sequence : "none";
+}
+inline uint8_t seqStepFor(const BusSnapshot& snap, int idx) {
+  return snap.seqPump == pumpAddress(idx) ? snap.seqStep : 0;
+}
+inline uint8_t seqStepsFor(const BusSnapshot& snap, int idx) {
+  return snap.seqPump == pumpAddress(idx) ? snap.seqSteps : 0;
+}
+
+// =============================================
+// JsonWriter
+// =============================================
+class JsonWriter {
+private:
+  char*  _buf;
+  size_t _cap;
+  size_t _len = 0;
+  bool   _ok = true;
+  bool   _first = true;
+
+  void raw(const char* s) {
+    size_t n = strlen(s);
+    if (_len + n >= _cap) { _ok = false; return; }
+    memcpy(_buf + _len, s, n);
+    _len += n;
+  }
+  void key(const char* name) {
+    raw(_first ? "\"" : ",\"");
+    raw(name);
+    raw("\":");
+    _first = false;
+  }
+  // "v", with '"' and '\\' escaped and control characters dropped
+  void quoted(const char* v) {
+    raw("\"");
+    for (; *v; v++) {
+      if ((unsigned char)*v < 0x20) continue;
+      char c[3] = { '\\', *v, '\0' };
+      raw(*v == '"' || *v == '\\' ? c : c + 1);
+    }
+    raw("\"");
+  }
+
+public:
+  JsonWriter(char* buffer, size_t capacity) : _buf(buffer), _cap(capacity) {}
+
+  void beginMap(uint8_t) { raw(_first ? "{" : ",{"); _first = true; }
+  void endMap()          { raw("}"); _first = false; }
+
+  void num(StatusKey k, int32_t v)        { num(STATUS_KEY_NAMES[k], v); }
+  void flag(StatusKey k, bool v)          { flag(STATUS_KEY_NAMES[k], v); }
+  void text(StatusKey k, const char* v)   { text(STATUS_KEY_NAMES[k], v); }
+
+  // Fields outside the shared record (/api/status extras); JSON only
+  void num(const char* k, int32_t v) {
+    char s[12];
+    snprintf(s, sizeof(s), "%ld", (long)v);
+    key(k);
+    raw(s);
+  }
+  void flag(const char* k, bool v)        { key(k); raw(v ? "true" : "false"); }
+  void text(const char* k, const char* v) { key(k); quoted(v); }
+  void beginArray(const char* k)          { key(k); raw("["); _first = true; }
+  void endArray()                         { raw("]"); _first = false; }
+
+  // Length (NUL-terminated), or 0 if it didn't fit
+  size_t finish() {
+    if (!_ok) return 0;
+    _buf[_len] = '\0';
+    return _len;
+  }
+};
+
+// =============================================
+// CborWriter (the subset of RFC 8949 we need)
+// =============================================
+class CborWriter {
+private:
+  uint8_t* _buf;
+  size_t   _cap;
+  size_t   _len = 0;
+  bool     _ok = true;
+
+  void put(uint8_t b) {
+    if (_len >= _cap) { _ok = false; return; }
+    _buf[_len++] = b;
+  }
+  // Major type + argument, shortest encoding
+  void head(uint8_t major, uint32_t v) {
+    major <<= 5;
+    if (v < 24) {
+      put(major | v);
+    } else if (v <= 0xFF) {
+      put(major | 24); put(v);
+    } else if (v <= 0xFFFF) {
+      put(major | 25); put(v >> 8); put(v);
+    } else {
+      put(major | 26); put(v >> 24); put(v >> 16); put(v >> 8); put(v);
+    }
+  }
+
+public:
+  CborWriter(uint8_t* buffer, size_t capacity) : _buf(buffer), _cap(capacity) {}
+
+  void beginMap(uint8_t pairs) { head(5, pairs); }
+  void endMap() {}                                 // Definite length: nothing to close
+
+  void num(StatusKey k, int32_t v) {
+    head(0, k);
+    if (v >= 0) head(0, (uint32_t)v);
+    else        head(1, (uint32_t)(-1 - v));       // Negative: -1 - n
+  }
+  void flag(StatusKey k, bool v) { head(0, k); put(v ? 0xF5 : 0xF4); }
+  void text(StatusKey k, const char* v) {
+    size_t n = strlen(v);
+    head(0, k);
+    head(3, n);
+    for (size_t i = 0; i < n; i++) put(v[i]);
+  }
+
+  // Length, or 0 if it didn't fit
+  size_t finish() { return _ok ? _len : 0; }
+};
+
+// =============================================
+// THE STATUS RECORD
+// =============================================
+// The SK_COUNT - 1 fields of registry slot idx, inside an open map
+template <class Writer>
+void writeStatusFields(Writer& w, const BusSnapshot& snap, int idx, const char* deviceId) {
+  const PumpStatus& p = snap.pumps[idx];
+
+  w.num (SK_PUMP,      idx + 1);
+  w.flag(SK_RUNNING,   p.running);
+  w.num (SK_RPM,       p.rpm);
+  w.num (SK_WATTS,     p.watts);
+  w.num (SK_GPM,       p.gpm);
+  w.num (SK_MODE,      p.mode);
+  w.num (SK_ERROR,     p.errCode);
+  w.flag(SK_REMOTE,    p.remote);
+  w.flag(SK_VALID,     p.valid);
+  w.text(SK_DEVICE_ID, deviceId);
+  w.num (SK_UPTIME,    millis() / 1000);
+  w.num (SK_RSSI,      WiFi.RSSI());
+  w.text(SK_SEQUENCE,  seqNameFor(snap, idx));
+  w.num (SK_SEQ_STEP,  seqStepFor(snap, idx));
+  w.num (SK_SEQ_STEPS, seqStepsFor(snap, idx));
+}
+
+// Status of registry slot idx, in whichever format w writes.
+template <class Writer>
+size_t writeStatus(Writer& w, const BusSnapshot& snap, int idx, const char* deviceId) {
+  w.beginMap(SK_COUNT - 1);
+  writeStatusFields(w, snap, idx, deviceId);
+  w.endMap();
+  return w.finish();
+}
+
+// Status of registry slot idx as JSON / CBOR. Returns 0 if it didn't fit.
+inline size_t formatStatus(char* json, size_t size, const BusSnapshot& snap, int idx) {
+  JsonWriter w(json, size);
+  return writeStatus(w, snap, idx, deviceId());
+}
+inline size_t formatStatusCbor(uint8_t* buf, size_t size, const BusSnapshot& snap, int idx) {
+  CborWriter w(buf, size);
+  return writeStatus(w, snap, idx, deviceId());
+}
+
+// =============================================
+// DELTAS (JSON only)
+// =============================================
+/*
+ * Delta JSON for pump idx: {"pump":n} plus every field that differs
+ * between two snapshots. Returns false if nothing did.
+ * (MQTT .../delta, and the local /events stream, see LiveStatus.h)
+ */
+inline bool formatDelta(char* json, size_t size, const BusSnapshot& before,
+                        const BusSnapshot& now, int idx) {
+  const PumpStatus& a = before.pumps[idx];
+  const PumpStatus& b = now.pumps[idx];
+  int n = snprintf(json, size, "{\"pump\":%d", idx + 1);
+  int header = n;
+  
+#define DELTA_FIELD(cond, fmt, ...) \
+  if ((cond) && n < (int)size) n += snprintf(json + n, size - n, fmt, __VA_ARGS__)
+  
+  DELTA_FIELD(b.present != a.present, ",\"present\":%s", b.present ? "true" : "false");
+  DELTA_FIELD(b.valid   != a.valid,   ",\"valid\":%s",   b.valid ? "true" : "false");
+  DELTA_FIELD(b.running != a.running, ",\"running\":%s", b.running ? "true" : "false");
+  DELTA_FIELD(b.rpm     != a.rpm,     ",\"rpm\":%d",     b.rpm);
+  DELTA_FIELD(b.watts   != a.watts,   ",\"watts\":%d",   b.watts);
+  DELTA_FIELD(b.gpm     != a.gpm,     ",\"gpm\":%d",     b.gpm);
+  DELTA_FIELD(b.mode    != a.mode,    ",\"mode\":%d",    b.mode);
+  DELTA_FIELD(b.errCode != a.errCode, ",\"error\":%d",   b.errCode);
+  DELTA_FIELD(b.remote  != a.remote,  ",\"remote\":%s",  b.remote ? "true" : "false");
+  DELTA_FIELD(seqStepFor(now, idx) != seqStepFor(before, idx) ||
+              strcmp(seqNameFor(now, idx), seqNameFor(before, idx)) != 0,
+              ",\"sequence\":\"%s\",\"seqStep\":%d,\"seqSteps\":%d",
+              seqNameFor(now, idx), seqStepFor(now, idx), seqStepsFor(now, idx));
+#undef DELTA_FIELD
+  
+  if (n == header || n + 2 > (int)size) return false;
+  snprintf(json + n, size - n, "}");
+  return true;
+}
+
+#endif // STATUS_FORMAT_H
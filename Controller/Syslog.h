@@ -0,0 +1,73 @@
+/*
+ * =============================================
+ * Syslog.h - Log lines to a syslog server over UDP
+ * =============================================
+ *
+ * A Log.h sink: every line at LOG_SYSLOG_LEVEL or worse goes to
+ * LOG_SYSLOG_HOST as one RFC 5424 datagram, so a pad of controllers
+ * can be watched from one rsyslog / Graylog / Loki box without a USB
+ * cable on each. Nothing is sent while WiFi is down (lines are not
+ * kept for later; Serial still has them).
+ *
+ *   <134>1 - flexpool-24DCC3A1B2C3 flexpool - - - [BUS] Queue full - "poll" dropped
+ *
+ * Facility LOG_SYSLOG_FACILITY (default 16, local0); severity from the
+ * level: error 3, warn 4, info 6, debug and trace 7.
+ *
+ * USAGE (setup):
+ *   if (LOG_SYSLOG_HOST[0]) logger.addSink(Syslog::sink, LOG_SYSLOG_LEVEL);
+ *
+ * THREADING: the sink runs on the log drain task only.
+ */
+
+#ifndef SYSLOG_H
+#define SYSLOG_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include "Config.h"
+#include "Log.h"
+#include "StatusFormat.h"
+
+// =============================================
+// CONFIGURATION (host, port and level: Config.h)
+// =============================================
+#define LOG_SYSLOG_FACILITY   16       // local0
+#define SYSLOG_RESOLVE_MS     60000    // Retry a failed DNS lookup after this
+
+class Syslog {
+private:
+  static WiFiUDP& udp() { static WiFiUDP u; return u; }
+
+  // LOG_SYSLOG_HOST, looked up once (again every SYSLOG_RESOLVE_MS while that fails)
+  static bool resolve(IPAddress& ip) {
+    static IPAddress cached;
+    static bool resolved = false;
+    static unsigned long failedAt = 0;
+    if (!resolved && (!failedAt || millis() - failedAt >= SYSLOG_RESOLVE_MS)) {
+      resolved = WiFi.hostByName(LOG_SYSLOG_HOST, cached);
+      failedAt = resolved ? 0 : millis() | 1;
+    }
+    ip = cached;
+    return resolved;
+  }
+
+public:
+  static void sink(uint8_t level, const char* line, size_t len) {
+    static const uint8_t SEVERITY[] = { 7, 3, 4, 6, 7, 7 };   // none..trace
+    IPAddress ip;
+    if (!WiFi.isConnected() || !resolve(ip)) return;
+    char head[64];
+    int n = snprintf(head, sizeof(head), "<%u>1 - flexpool-%s flexpool - - - ",
+                     LOG_SYSLOG_FACILITY * 8 + SEVERITY[level <= LOG_TRACE ? level : LOG_TRACE],
+                     deviceId());
+    WiFiUDP& u = udp();
+    if (!u.beginPacket(ip, LOG_SYSLOG_PORT)) return;
+    u.write((const uint8_t*)head, n);
+    u.write((const uint8_t*)line, len);
+    u.endPacket();
+  }
+};
+
+#endif // SYSLOG_H
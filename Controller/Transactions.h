@@ -0,0 +1,317 @@
+/*
+ * =============================================
+ * Transactions.h - RS-485 request/response tracking
+ * =============================================
+ *
+ * Every frame we send to a pump is a transaction: it is tagged with
+ * the reply it expects (pump address + CFI) and kept in a small table
+ * until that reply arrives, it runs out of retries, or its owner
+ * cancels it.
+ *
+ *   start() --> QUEUED --(bus free)--> IN_FLIGHT --(reply)--> done(ok)
+ *                  ^                       |
+ *                  +------ BACKOFF <-------+ timeout / bad checksum
+ *                                          (retries left, else done(fail))
+ *
+ * RULES:
+ *   - One request in flight on the bus: a pump starts its answer
+ *     within a few ms, and any other frame we sent meanwhile would
+ *     collide with it (tools/bench shows how badly). The next request
+ *     goes out once the reply is in (or timed out) and the line has
+ *     been quiet for TXN_TURNAROUND_MS.
+ *   - Oldest request first; requests to the same pump go out in order.
+ *   - Nothing goes out while a frame is being received, or during a
+ *     holdOff() window (another master waiting for a pump's reply).
+ *   - Replies complete their request whenever they arrive, so
+ *     completions can come back in a different order than starts.
+ *   - A request cancelled after its frame went out still holds the
+ *     line (ORPHANED) until its reply arrives or its attempt times out:
+ *     the pump answers regardless, and a new frame would collide.
+ *
+ * Owned and driven by the RS-485 bus task:
+ *   table.loop(lineQuiet);        every bus task iteration
+ *   table.msUntilDue();           how long the bus task may sleep
+ *   table.onFrame(src, cmd);      for every valid frame addressed to us
+ *   table.noteLineActivity();     for any other traffic
+ *   table.onBadFrame(src);        for every frame with a bad checksum
+ */
+
+#ifndef TRANSACTIONS_H
+#define TRANSACTIONS_H
+
+#include <Arduino.h>
+#include "PentairProtocol.h"
+#include "BusMetrics.h"
+#include "Log.h"
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define TXN_MAX_INFLIGHT        4      // Table size (queued + in flight)
+#define TXN_MAX_FRAME_LEN       24     // Largest frame we send (set RPM = 15)
+#define TXN_ATTEMPT_TIMEOUT_MS  300    // Wait for a reply, per attempt
+#define TXN_MAX_RETRIES         3      // Extra attempts after the first
+#define TXN_BACKOFF_MS          50     // First retry delay, doubled each retry
+#define TXN_TURNAROUND_MS       3      // Quiet line needed before we transmit
+
+// Called when a transaction ends; ok = the expected reply arrived
+typedef void (*TransactionDoneFn)(void* ctx, bool ok);
+
+// Puts one frame on the wire
+typedef void (*TransmitFn)(const uint8_t* frame, size_t len);
+
+// =============================================
+// TransactionTable CLASS
+// =============================================
+class TransactionTable {
+private:
+  enum State : uint8_t { FREE, QUEUED, IN_FLIGHT, BACKOFF, ORPHANED };
+
+  struct Transaction {
+    State    state = FREE;
+    uint8_t  frame[TXN_MAX_FRAME_LEN];
+    uint8_t  frameLen;
+    uint8_t  addr;                 // Pump we expect the reply from
+    uint8_t  cfi;                  // Reply CFI that completes it
+    uint16_t timeoutMs;            // Per attempt; 0 = no reply expected
+    uint8_t  retriesLeft;
+    uint8_t  attempt;              // 0 = first try
+    uint32_t order;                // Start order, keeps same-pump FIFO
+    unsigned long since;           // Sent at / backoff started at
+    TransactionDoneFn done;
+    void*    ctx;
+  };
+
+  Transaction   _slots[TXN_MAX_INFLIGHT];
+  TransmitFn    _transmit = nullptr;
+  uint32_t      _nextOrder = 0;
+  unsigned long _lineBusyAt = 0;   // Last TX end or RX frame
+  unsigned long _holdFrom = 0;     // holdOff() window start...
+  uint32_t      _holdMs = 0;       // ...and length
+
+  uint32_t _retries = 0;
+  uint32_t _failures = 0;
+  uint32_t _timeouts = 0;
+  LatencyHistogram _latency;       // Sent -> completing reply
+
+  void complete(Transaction& t, bool ok) {
+    TransactionDoneFn done = t.done;
+    void* ctx = t.ctx;
+    t.state = FREE;
+    if (!ok) _failures++;
+    if (done) done(ctx, ok);
+  }
+
+  // Timed out or answered with garbage: try again later, or give up
+  void retryOrFail(Transaction& t, const char* why) {
+    if (t.retriesLeft == 0) {
+      complete(t, false);
+      return;
+    }
+    t.retriesLeft--;
+    t.attempt++;
+    _retries++;
+    t.state = BACKOFF;
+    t.since = millis();
+    LOGD("TXN", "%s from 0x%02X (CFI 0x%02X) - retry %d in %u ms",
+         why, t.addr, t.cfi, t.attempt, backoffMs(t));
+  }
+
+  // Sent, its reply still due (cancelled or not)
+  static bool awaitingReply(const Transaction& t) {
+    return t.state == IN_FLIGHT || t.state == ORPHANED;
+  }
+
+  static uint32_t backoffMs(const Transaction& t) {
+    return (uint32_t)TXN_BACKOFF_MS << (t.attempt - 1);
+  }
+
+  // A reply is due on the line, or an older request to the same pump goes first
+  bool blocked(const Transaction& t) const {
+    for (const Transaction& o : _slots) {
+      if (&o == &t || o.state == FREE) continue;
+      if (awaitingReply(o)) return true;
+      if (o.addr == t.addr && (int32_t)(o.order - t.order) < 0) return true;
+    }
+    return false;
+  }
+
+  // Ready to (re)send: queued, or backoff expired
+  bool ready(const Transaction& t, unsigned long now) const {
+    if (t.state == QUEUED) return true;
+    return t.state == BACKOFF && now - t.since >= backoffMs(t);
+  }
+
+  // Milliseconds until we may put a frame on the line
+  uint32_t lineFreeIn(unsigned long now) const {
+    uint32_t quiet = now - _lineBusyAt;
+    uint32_t wait = (quiet >= TXN_TURNAROUND_MS) ? 0 : TXN_TURNAROUND_MS - quiet;
+    uint32_t held = now - _holdFrom;
+    if (held < _holdMs && _holdMs - held > wait) wait = _holdMs - held;
+    return wait;
+  }
+
+  // Oldest transaction that may go out now, or nullptr
+  Transaction* nextToSend(unsigned long now) {
+    Transaction* best = nullptr;
+    for (Transaction& t : _slots) {
+      if (!ready(t, now) || blocked(t)) continue;
+      if (!best || (int32_t)(t.order - best->order) < 0) best = &t;
+    }
+    return best;
+  }
+
+  void send(Transaction& t) {
+    _transmit(t.frame, t.frameLen);
+    _lineBusyAt = millis();
+    t.since = _lineBusyAt;
+
+    if (t.timeoutMs == 0) {
+      complete(t, true);   // Fire and forget
+    } else {
+      t.state = IN_FLIGHT;
+    }
+  }
+
+public:
+  void begin(TransmitFn transmit) { _transmit = transmit; }
+
+  /*
+   * Queue a frame and the reply that completes it.
+   * done(ctx, ok) is called exactly once, unless cancel(ctx) comes first.
+   * Returns false if the frame is too long or the table is full.
+   */
+  bool start(const uint8_t* frame, size_t len, uint8_t expectCmd, uint16_t timeoutMs,
+             TransactionDoneFn done, void* ctx, uint8_t retries = TXN_MAX_RETRIES) {
+    if (len > TXN_MAX_FRAME_LEN) return false;
+
+    for (Transaction& t : _slots) {
+      if (t.state != FREE) continue;
+      memcpy(t.frame, frame, len);
+      t.frameLen    = len;
+      t.addr        = (len > PKT_IDX_DST) ? frame[PKT_IDX_DST] : 0;
+      t.cfi         = expectCmd;
+      t.timeoutMs   = timeoutMs;
+      t.retriesLeft = retries;
+      t.attempt     = 0;
+      t.order       = _nextOrder++;
+      t.done        = done;
+      t.ctx         = ctx;
+      t.state       = QUEUED;
+      return true;
+    }
+    return false;
+  }
+
+  // Drop every transaction started with ctx (no callbacks). One already
+  // on the wire is orphaned: it keeps the line until the reply is due.
+  void cancel(void* ctx) {
+    for (Transaction& t : _slots) {
+      if (t.state == FREE || t.ctx != ctx) continue;
+      t.state = (t.state == IN_FLIGHT) ? ORPHANED : FREE;
+      t.done  = nullptr;
+      t.ctx   = nullptr;
+    }
+  }
+
+  // Bus traffic we are not part of: restart the quiet-gap timer
+  void noteLineActivity() { _lineBusyAt = millis(); }
+
+  // Don't transmit for ms (e.g. another master awaits a reply); 0 = release
+  void holdOff(uint32_t ms) {
+    _holdFrom = millis();
+    _holdMs = ms;
+  }
+
+  // Valid frame addressed to us: complete the request it answers (if any)
+  void onFrame(uint8_t src, uint8_t cmd) {
+    _lineBusyAt = millis();
+    for (Transaction& t : _slots) {
+      if (awaitingReply(t) && t.addr == src && t.cfi == cmd) {
+        _latency.record(_lineBusyAt - t.since);
+        complete(t, true);
+        return;
+      }
+    }
+  }
+
+  // Corrupted frame: if it looks like our pump's reply, resend now
+  // rather than sitting out the whole timeout
+  void onBadFrame(uint8_t src) {
+    _lineBusyAt = millis();
+    for (Transaction& t : _slots) {
+      if (t.state == ORPHANED && t.addr == src) {
+        t.state = FREE;            // Its (garbled) reply is over
+        return;
+      }
+      if (t.state == IN_FLIGHT && t.addr == src) {
+        retryOrFail(t, "Bad checksum");
+        return;
+      }
+    }
+  }
+
+  // Call this every bus task iteration.
+  // lineQuiet = false while bytes of a frame are still arriving.
+  void loop(bool lineQuiet) {
+    unsigned long now = millis();
+
+    for (Transaction& t : _slots) {
+      if (t.state == ORPHANED && now - t.since >= t.timeoutMs) {
+        t.state = FREE;
+      } else if (t.state == IN_FLIGHT && now - t.since >= t.timeoutMs) {
+        _timeouts++;
+        retryOrFail(t, "No reply");
+      }
+    }
+
+    // Half duplex: one frame at a time, only in an idle gap
+    while (lineQuiet && lineFreeIn(millis()) == 0) {
+      Transaction* t = nextToSend(millis());
+      if (!t) break;
+      send(*t);
+    }
+  }
+
+  // Milliseconds until loop() has something to do (UINT32_MAX when idle)
+  uint32_t msUntilDue() const {
+    unsigned long now = millis();
+    uint32_t due = UINT32_MAX;
+    for (const Transaction& t : _slots) {
+      uint32_t left;
+      if (!awaitingReply(t) && blocked(t)) continue;   // Woken when the one ahead finishes
+      switch (t.state) {
+        case QUEUED:
+          left = lineFreeIn(now);
+          break;
+        case IN_FLIGHT:
+        case ORPHANED:
+        case BACKOFF: {
+          uint32_t wait = awaitingReply(t) ? t.timeoutMs : backoffMs(t);
+          uint32_t elapsed = now - t.since;
+          left = (elapsed >= wait) ? 0 : wait - elapsed;
+          if (t.state == BACKOFF && lineFreeIn(now) > left) left = lineFreeIn(now);
+          break;
+        }
+        default:
+          continue;
+      }
+      if (left < due) due = left;
+    }
+    return due;
+  }
+
+  // ---- Status ----
+  bool active() const {
+    for (const Transaction& t : _slots) {
+      if (t.state != FREE) return true;
+    }
+    return false;
+  }
+  uint32_t retries() const { return _retries; }
+  uint32_t failures() const { return _failures; }
+  uint32_t timeouts() const { return _timeouts; }
+  const LatencyHistogram& latency() const { return _latency; }
+};
+
+#endif // TRANSACTIONS_H
@@ -2,693 +2,472 @@
  * =============================================
  * WebUI.h - Web Interface for FlexPool Controller
  * =============================================
- * 
+ *
+ * GENERATED by tools/webui_embed.py from webui/index.html - do not edit.
+ *
  * Mobile-friendly HTML control panel.
  * Uses MQTT over WebSocket so it works from ANYWHERE:
  *   - On your home WiFi (local)
  *   - On cellular data (remote)
  *   - From another country (cloud)
- * 
+ *
  * MAIN INTERFACE:
  *   Speed 1 - Speed 4 buttons (each sends full start sequence)
  *   Custom RPM slider
  *   Stop button
  *   Status display
- * 
- * The ESP32 serves this page at http://flexpool.local
- * The page connects to the MQTT broker via WebSocket
- * Commands and status flow through MQTT
+ *
+ * The ESP32 serves this page at http://flexpool.local, gzip'd
+ * (27109 bytes -> 6937 bytes). The page asks /api/status for the
+ * device ID, then connects to the MQTT broker via WebSocket.
+ * Commands and status flow through MQTT.
  */
 
 #ifndef WEBUI_H
 #define WEBUI_H
 
-const char WEBUI_HTML[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html lang="en">
-<head>
-  <meta charset="UTF-8">
-  <meta name="viewport" content="width=device-width, initial-scale=1.0">
-  <title>FlexPool Controller</title>
-  <script src="https://unpkg.com/mqtt/dist/mqtt.min.js"></script>
-  <style>
-    * { margin: 0; padding: 0; box-sizing: border-box; }
-    body {
-      font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', Roboto, sans-serif;
-      background: #0f172a;
-      color: #e2e8f0;
-      min-height: 100vh;
-      padding: 16px;
-    }
-    h1 {
-      text-align: center;
-      font-size: 1.5rem;
-      padding: 16px 0 4px;
-      color: #38bdf8;
-      letter-spacing: 1px;
-    }
-    h1 span { color: #94a3b8; font-weight: 300; font-size: 0.9rem; display: block; }
-
-    /* Connection banner */
-    .conn-bar {
-      display: flex; justify-content: center; align-items: center; gap: 8px;
-      padding: 8px; margin-bottom: 12px; border-radius: 10px;
-      font-size: 0.8rem; text-align: center;
-    }
-    .conn-bar.connected { background: #052e16; color: #4ade80; }
-    .conn-bar.connecting { background: #422006; color: #fbbf24; }
-    .conn-bar.disconnected { background: #450a0a; color: #f87171; }
-    .conn-dot { width: 8px; height: 8px; border-radius: 50%; }
-    .conn-bar.connected .conn-dot { background: #22c55e; box-shadow: 0 0 6px #22c55e; }
-    .conn-bar.connecting .conn-dot { background: #f59e0b; box-shadow: 0 0 6px #f59e0b; }
-    .conn-bar.disconnected .conn-dot { background: #ef4444; box-shadow: 0 0 6px #ef4444; }
-
-    /* Device ID input (for remote access) */
-    .device-section {
-      background: #1e293b; border-radius: 12px; padding: 14px;
-      margin-bottom: 12px; border: 1px solid #334155;
-      display: none;
-    }
-    .device-section.show { display: block; }
-    .device-section label { font-size: 0.8rem; color: #94a3b8; }
-    .device-row { display: flex; gap: 8px; margin-top: 6px; }
-    .device-row input {
-      flex: 1; padding: 10px; border-radius: 8px; border: 1px solid #475569;
-      background: #0f172a; color: #e2e8f0; font-size: 1rem;
-      font-family: 'Courier New', monospace; letter-spacing: 2px; text-transform: uppercase;
-    }
-    .device-row button {
-      padding: 10px 16px; border-radius: 8px; border: none;
-      background: #2563eb; color: white; font-weight: 600; cursor: pointer;
-    }
-
-    /* Status card */
-    .status-card {
-      background: #1e293b; border-radius: 16px; padding: 20px;
-      margin-bottom: 16px; border: 1px solid #334155;
-    }
-    .status-header {
-      display: flex; justify-content: space-between; align-items: center;
-      margin-bottom: 16px;
-    }
-    .status-dot {
-      width: 12px; height: 12px; border-radius: 50%;
-      display: inline-block; margin-right: 8px;
-    }
-    .dot-running { background: #22c55e; box-shadow: 0 0 8px #22c55e; }
-    .dot-stopped { background: #ef4444; box-shadow: 0 0 8px #ef4444; }
-    .dot-unknown { background: #f59e0b; box-shadow: 0 0 8px #f59e0b; }
-    .status-label { font-size: 1.1rem; font-weight: 600; }
-    .status-grid {
-      display: grid; grid-template-columns: repeat(2, 1fr); gap: 12px;
-    }
-    .stat-item {
-      background: #0f172a; border-radius: 10px; padding: 12px; text-align: center;
-    }
-    .stat-value { font-size: 1.6rem; font-weight: 700; color: #38bdf8; }
-    .stat-label {
-      font-size: 0.75rem; color: #94a3b8;
-      text-transform: uppercase; letter-spacing: 1px; margin-top: 2px;
-    }
-
-    .section-title {
-      font-size: 0.8rem; color: #64748b;
-      text-transform: uppercase; letter-spacing: 2px; margin: 20px 0 10px;
-    }
-
-    /* ======== SPEED BUTTONS (primary interface) ======== */
-    .speed-section {
-      background: #1e293b; border-radius: 16px; padding: 20px;
-      margin-bottom: 16px; border: 1px solid #334155;
-    }
-    .speed-grid {
-      display: grid; grid-template-columns: repeat(2, 1fr); gap: 12px;
-    }
-    .speed-btn {
-      border: none; border-radius: 14px; padding: 20px 8px;
-      cursor: pointer; transition: all 0.15s; color: white;
-      text-align: center; position: relative; overflow: hidden;
-    }
-    .speed-btn:active { transform: scale(0.96); }
-    .speed-btn.active { box-shadow: 0 0 0 3px #38bdf8, 0 0 20px rgba(56,189,248,0.3); }
-    .speed-name {
-      font-size: 1.2rem; font-weight: 700; display: block;
-    }
-    .speed-rpm {
-      font-size: 0.85rem; opacity: 0.85; margin-top: 4px; display: block;
-    }
-    .speed-watts {
-      font-size: 0.7rem; opacity: 0.6; margin-top: 2px; display: block;
-    }
-    .speed-1 { background: linear-gradient(135deg, #0891b2, #06b6d4); }
-    .speed-2 { background: linear-gradient(135deg, #2563eb, #3b82f6); }
-    .speed-3 { background: linear-gradient(135deg, #7c3aed, #8b5cf6); }
-    .speed-4 { background: linear-gradient(135deg, #c2410c, #ea580c); }
-
-    /* STOP button */
-    .stop-section { margin-bottom: 16px; }
-    .btn-bigstop {
-      width: 100%; border: none; border-radius: 14px; padding: 18px;
-      font-size: 1.15rem; font-weight: 700; cursor: pointer;
-      background: linear-gradient(135deg, #dc2626, #b91c1c);
-      color: white; transition: all 0.15s; letter-spacing: 1px;
-    }
-    .btn-bigstop:active { transform: scale(0.97); }
-
-    /* RPM custom slider */
-    .rpm-section {
-      background: #1e293b; border-radius: 16px; padding: 20px;
-      margin-bottom: 16px; border: 1px solid #334155;
-    }
-    .rpm-display {
-      text-align: center; font-size: 2.5rem; font-weight: 700;
-      color: #38bdf8; margin: 8px 0;
-    }
-    .rpm-display span { font-size: 1rem; color: #94a3b8; }
-    input[type="range"] {
-      width: 100%; height: 8px; -webkit-appearance: none;
-      background: #334155; border-radius: 4px; outline: none; margin: 12px 0;
-    }
-    input[type="range"]::-webkit-slider-thumb {
-      -webkit-appearance: none; width: 28px; height: 28px;
-      border-radius: 50%; background: #38bdf8; cursor: pointer;
-    }
-    .rpm-presets {
-      display: grid; grid-template-columns: repeat(4, 1fr); gap: 8px; margin-top: 10px;
-    }
-    .rpm-preset {
-      border: 1px solid #475569; background: transparent; color: #e2e8f0;
-      border-radius: 8px; padding: 8px 4px; font-size: 0.8rem; cursor: pointer;
-    }
-    .rpm-preset:active { background: #334155; }
-    .btn-setcustom {
-      width: 100%; margin-top: 12px; border: none; border-radius: 12px;
-      padding: 14px; font-size: 1rem; font-weight: 600; cursor: pointer;
-      background: linear-gradient(135deg, #16a34a, #0891b2); color: white;
-    }
-    .btn-setcustom:active { transform: scale(0.97); }
-
-    /* Buttons */
-    .btn-row { display: grid; grid-template-columns: repeat(2, 1fr); gap: 10px; margin-bottom: 10px; }
-    .btn {
-      border: none; border-radius: 12px; padding: 14px 8px; font-size: 0.95rem;
-      font-weight: 600; cursor: pointer; transition: all 0.15s; color: white; text-align: center;
-    }
-    .btn:active { transform: scale(0.96); }
-    .btn-start  { background: #16a34a; }
-    .btn-stop   { background: #dc2626; }
-    .btn-remote { background: #2563eb; }
-    .btn-local  { background: #7c3aed; }
-    .btn-query  { background: #0891b2; }
-    .btn:disabled { opacity: 0.4; cursor: not-allowed; }
-
-    /* Collapsible advanced section */
-    .advanced-toggle {
-      width: 100%; background: #1e293b; border: 1px solid #334155;
-      border-radius: 12px; padding: 12px; color: #64748b;
-      font-size: 0.85rem; cursor: pointer; text-align: center;
-      margin-bottom: 12px;
-    }
-    .advanced-toggle:active { background: #334155; }
-    .advanced-panel { display: none; }
-    .advanced-panel.show { display: block; }
-
-    /* Settings section */
-    .settings-section {
-      background: #1e293b; border-radius: 16px; padding: 20px;
-      margin-bottom: 16px; border: 1px solid #334155;
-    }
-    .setting-row {
-      display: flex; align-items: center; justify-content: space-between;
-      padding: 10px 0; border-bottom: 1px solid #334155;
-    }
-    .setting-row:last-child { border-bottom: none; }
-    .setting-label { font-size: 0.9rem; color: #94a3b8; }
-    .setting-input {
-      width: 90px; padding: 8px; border-radius: 8px; border: 1px solid #475569;
-      background: #0f172a; color: #38bdf8; font-size: 1rem;
-      text-align: center; font-weight: 600;
-    }
-    .btn-save-settings {
-      width: 100%; margin-top: 12px; border: none; border-radius: 12px;
-      padding: 12px; font-size: 0.9rem; font-weight: 600; cursor: pointer;
-      background: #475569; color: white;
-    }
-
-    /* Log */
-    .log-section {
-      background: #1e293b; border-radius: 16px; padding: 16px;
-      margin-top: 16px; border: 1px solid #334155;
-    }
-    .log-box {
-      background: #0f172a; border-radius: 8px; padding: 10px;
-      max-height: 200px; overflow-y: auto;
-      font-family: 'Courier New', monospace; font-size: 0.75rem;
-      color: #94a3b8; line-height: 1.5;
-    }
-    .log-entry { border-bottom: 1px solid #1e293b; padding: 2px 0; }
-    .log-ok { color: #22c55e; }
-    .log-err { color: #ef4444; }
-
-    .toast {
-      position: fixed; bottom: 20px; left: 50%; transform: translateX(-50%);
-      background: #334155; color: #e2e8f0; padding: 12px 24px;
-      border-radius: 12px; font-size: 0.9rem; opacity: 0;
-      transition: opacity 0.3s; pointer-events: none; z-index: 100;
-    }
-    .toast.show { opacity: 1; }
-    .info-bar {
-      text-align: center; color: #475569; font-size: 0.7rem; margin-top: 12px; line-height: 1.6;
-    }
-  </style>
-</head>
-<body>
-  <h1>FlexPool <span>Pentair Pump Controller</span></h1>
-
-  <!-- MQTT CONNECTION STATUS -->
-  <div class="conn-bar disconnected" id="connBar">
-    <div class="conn-dot"></div>
-    <span id="connLabel">Connecting to cloud...</span>
-  </div>
-
-  <!-- DEVICE ID (shown when opened remotely without an embedded ID) -->
-  <div class="device-section" id="deviceSection">
-    <label>Enter your Device ID to connect remotely:</label>
-    <div class="device-row">
-      <input type="text" id="deviceInput" placeholder="e.g. A1B2C3" maxlength="6">
-      <button onclick="manualConnect()">Connect</button>
-    </div>
-  </div>
-
-  <!-- STATUS CARD -->
-  <div class="status-card">
-    <div class="status-header">
-      <div>
-        <span class="status-dot dot-unknown" id="statusDot"></span>
-        <span class="status-label" id="statusLabel">Waiting for data...</span>
-      </div>
-      <button class="btn btn-query" style="padding:8px 16px; font-size:0.8rem;" onclick="sendCmd('query')">Refresh</button>
-    </div>
-    <div class="status-grid">
-      <div class="stat-item">
-        <div class="stat-value" id="rpmVal">--</div>
-        <div class="stat-label">RPM</div>
-      </div>
-      <div class="stat-item">
-        <div class="stat-value" id="wattsVal">--</div>
-        <div class="stat-label">Watts</div>
-      </div>
-      <div class="stat-item">
-        <div class="stat-value" id="gpmVal">--</div>
-        <div class="stat-label">GPM</div>
-      </div>
-      <div class="stat-item">
-        <div class="stat-value" id="modeVal">--</div>
-        <div class="stat-label">Mode</div>
-      </div>
-    </div>
-  </div>
-
-  <!-- ======== SPEED BUTTONS (PRIMARY INTERFACE) ======== -->
-  <div class="speed-section">
-    <div class="section-title" style="margin-top:0">Select Speed</div>
-    <div class="speed-grid">
-      <button class="speed-btn speed-1" id="speedBtn1" onclick="setSpeed(1)">
-        <span class="speed-name">Speed 1</span>
-        <span class="speed-rpm" id="speedLabel1">750 RPM</span>
-      </button>
-      <button class="speed-btn speed-2" id="speedBtn2" onclick="setSpeed(2)">
-        <span class="speed-name">Speed 2</span>
-        <span class="speed-rpm" id="speedLabel2">1500 RPM</span>
-      </button>
-      <button class="speed-btn speed-3" id="speedBtn3" onclick="setSpeed(3)">
-        <span class="speed-name">Speed 3</span>
-        <span class="speed-rpm" id="speedLabel3">2350 RPM</span>
-      </button>
-      <button class="speed-btn speed-4" id="speedBtn4" onclick="setSpeed(4)">
-        <span class="speed-name">Speed 4</span>
-        <span class="speed-rpm" id="speedLabel4">3110 RPM</span>
-      </button>
-    </div>
-  </div>
-
-  <!-- STOP BUTTON -->
-  <div class="stop-section">
-    <button class="btn-bigstop" onclick="sendCmd('fullstop')">STOP PUMP</button>
-  </div>
-
-  <!-- CUSTOM RPM -->
-  <div class="rpm-section">
-    <div class="section-title" style="margin-top:0">Custom RPM</div>
-    <div class="rpm-display"><span id="rpmTarget">1000</span> <span>RPM</span></div>
-    <input type="range" id="rpmSlider" min="450" max="3450" step="50" value="1000"
-           oninput="document.getElementById('rpmTarget').textContent=this.value">
-    <div class="rpm-presets">
-      <button class="rpm-preset" onclick="setSlider(600)">600</button>
-      <button class="rpm-preset" onclick="setSlider(1100)">1100</button>
-      <button class="rpm-preset" onclick="setSlider(2000)">2000</button>
-      <button class="rpm-preset" onclick="setSlider(3000)">3000</button>
-    </div>
-    <button class="btn-setcustom" onclick="fullStartCustom()">Start at Custom RPM</button>
-  </div>
-
-  <!-- ADVANCED COMMANDS (collapsible) -->
-  <button class="advanced-toggle" onclick="toggleAdvanced()">
-    ▼ Advanced / Manual Commands
-  </button>
-  <div class="advanced-panel" id="advancedPanel">
-
-    <!-- Speed Settings (configurable RPM for each speed) -->
-    <div class="settings-section">
-      <div class="section-title" style="margin-top:0">Speed Settings (RPM)</div>
-      <div class="setting-row">
-        <span class="setting-label">Speed 1</span>
-        <input type="number" class="setting-input" id="cfg1" min="450" max="3450" step="50" value="750">
-      </div>
-      <div class="setting-row">
-        <span class="setting-label">Speed 2</span>
-        <input type="number" class="setting-input" id="cfg2" min="450" max="3450" step="50" value="1500">
-      </div>
-      <div class="setting-row">
-        <span class="setting-label">Speed 3</span>
-        <input type="number" class="setting-input" id="cfg3" min="450" max="3450" step="50" value="2350">
-      </div>
-      <div class="setting-row">
-        <span class="setting-label">Speed 4</span>
-        <input type="number" class="setting-input" id="cfg4" min="450" max="3450" step="50" value="3110">
-      </div>
-      <button class="btn-save-settings" onclick="saveSettings()">Save Speed Settings</button>
-    </div>
-
-    <!-- Manual Commands -->
-    <div class="section-title">Manual Commands</div>
-    <div class="btn-row">
-      <button class="btn btn-start"  onclick="sendCmd('start')">Start Motor</button>
-      <button class="btn btn-stop"   onclick="sendCmd('stop')">Stop Motor</button>
-    </div>
-    <div class="btn-row">
-      <button class="btn btn-remote" onclick="sendCmd('remote')">Remote Control</button>
-      <button class="btn btn-local"  onclick="sendCmd('local')">Local Control</button>
-    </div>
-    <div class="btn-row">
-      <button class="btn btn-query" onclick="sendCmd('query')">Query Status</button>
-      <button class="btn" style="background:#475569" onclick="setRPMOnly()">Set RPM Only</button>
-    </div>
-  </div>
-
-  <!-- LOG -->
-  <div class="log-section">
-    <div class="section-title" style="margin-top:0">Activity Log</div>
-    <div class="log-box" id="logBox"></div>
-  </div>
-
-  <div class="info-bar" id="infoBar"></div>
-  <div class="toast" id="toast"></div>
-
-  <script>
-    // =============================================
-    // SPEED PRESETS (RPM values for Speed 1-4)
-    // Saved in browser localStorage so they persist
-    // =============================================
-    const DEFAULT_SPEEDS = [750, 1500, 2350, 3110];
-    let speeds = [...DEFAULT_SPEEDS];
-    let activeSpeed = 0;  // 0 = none, 1-4 = active speed
-
-    // Load saved speeds from localStorage
-    function loadSettings() {
-      const saved = localStorage.getItem('flexpool_speeds');
-      if (saved) {
-        try {
-          const arr = JSON.parse(saved);
-          if (arr.length === 4) speeds = arr;
-        } catch(e) {}
-      }
-      // Update UI
-      for (let i = 1; i <= 4; i++) {
-        document.getElementById('speedLabel' + i).textContent = speeds[i-1] + ' RPM';
-        document.getElementById('cfg' + i).value = speeds[i-1];
-      }
-    }
-
-    function saveSettings() {
-      for (let i = 1; i <= 4; i++) {
-        const val = parseInt(document.getElementById('cfg' + i).value);
-        if (val >= 450 && val <= 3450) speeds[i-1] = val;
-      }
-      localStorage.setItem('flexpool_speeds', JSON.stringify(speeds));
-      loadSettings();
-      showToast('Speed settings saved!');
-      addLog('Speed settings saved: ' + speeds.join(', ') + ' RPM', true);
-    }
-
-    // =============================================
-    // MQTT CONFIGURATION
-    // =============================================
-    const MQTT_BROKER = 'wss://broker.hivemq.com:8884/mqtt';
-
-    // Device ID: injected by ESP32 when served locally, or entered manually
-    let DEVICE_ID = '%%DEVICE_ID%%';
-    let mqttClient = null;
-    let topicCmd = '';
-    let topicStatus = '';
-
-    // =============================================
-    // INITIALIZATION
-    // =============================================
-    window.addEventListener('load', () => {
-      loadSettings();
-
-      // Check if device ID was injected by ESP32 (local access)
-      if (DEVICE_ID && DEVICE_ID !== '%%' + 'DEVICE_ID' + '%%') {
-        addLog('Device ID: ' + DEVICE_ID, null);
-        connectMQTT(DEVICE_ID);
-      } else {
-        // No device ID — check localStorage
-        const saved = localStorage.getItem('flexpool_device_id');
-        if (saved) {
-          DEVICE_ID = saved;
-          addLog('Using saved Device ID: ' + DEVICE_ID, null);
-          connectMQTT(DEVICE_ID);
-        } else {
-          document.getElementById('deviceSection').classList.add('show');
-          setConnStatus('disconnected', 'Enter Device ID to connect');
-        }
-      }
-    });
-
-    function manualConnect() {
-      const id = document.getElementById('deviceInput').value.trim().toUpperCase();
-      if (id.length < 4) {
-        showToast('Enter a valid Device ID (shown in Serial Monitor)');
-        return;
-      }
-      DEVICE_ID = id;
-      localStorage.setItem('flexpool_device_id', id);
-      document.getElementById('deviceSection').classList.remove('show');
-      connectMQTT(id);
-    }
-
-    // =============================================
-    // MQTT CONNECTION
-    // =============================================
-    function connectMQTT(deviceId) {
-      topicCmd    = 'flexpool/' + deviceId + '/cmd';
-      topicStatus = 'flexpool/' + deviceId + '/status';
-      const topicLWT = 'flexpool/' + deviceId + '/lwt';
-
-      setConnStatus('connecting', 'Connecting to cloud...');
-      addLog('Connecting to MQTT broker...', null);
-
-      const clientId = 'flexpool-web-' + Math.random().toString(16).substr(2, 6);
-
-      mqttClient = mqtt.connect(MQTT_BROKER, {
-        clientId: clientId,
-        clean: true,
-        connectTimeout: 10000,
-        reconnectPeriod: 3000,
-      });
-
-      mqttClient.on('connect', () => {
-        setConnStatus('connected', 'Connected — Device: ' + deviceId);
-        addLog('Connected to MQTT broker', true);
-        mqttClient.subscribe(topicStatus);
-        mqttClient.subscribe(topicLWT);
-        addLog('Listening for pump status...', null);
-      });
-
-      mqttClient.on('message', (topic, message) => {
-        try {
-          const data = JSON.parse(message.toString());
-          if (topic === topicStatus) {
-            updateStatus(data);
-          } else if (topic === topicLWT) {
-            if (data.online === false) {
-              setConnStatus('disconnected', 'ESP32 is offline');
-              addLog('ESP32 went offline', false);
-            }
-          }
-        } catch (e) {
-          addLog('Bad message: ' + message.toString(), false);
-        }
-      });
-
-      mqttClient.on('error', (err) => {
-        setConnStatus('disconnected', 'Connection error');
-        addLog('MQTT error: ' + err.message, false);
-      });
-
-      mqttClient.on('close', () => {
-        setConnStatus('connecting', 'Reconnecting...');
-      });
-
-      mqttClient.on('reconnect', () => {
-        setConnStatus('connecting', 'Reconnecting...');
-      });
-    }
-
-    // =============================================
-    // SEND COMMANDS VIA MQTT
-    // =============================================
-    function sendCmd(cmd, extra) {
-      if (!mqttClient || !mqttClient.connected) {
-        showToast('Not connected');
-        addLog('Cannot send — not connected', false);
-        return;
-      }
-
-      let payload = { cmd: cmd };
-      if (extra) Object.assign(payload, extra);
-
-      const msg = JSON.stringify(payload);
-      mqttClient.publish(topicCmd, msg);
-      addLog('Sent: ' + msg, true);
-      showToast('Command sent: ' + cmd);
-    }
-
-    // =============================================
-    // SPEED 1-4 BUTTONS
-    // =============================================
-    function setSpeed(num) {
-      const rpm = speeds[num - 1];
-      activeSpeed = num;
-      highlightSpeed(num);
-      sendCmd('fullstart', { rpm: rpm });
-      addLog('Speed ' + num + ' selected → ' + rpm + ' RPM', true);
-    }
-
-    function highlightSpeed(num) {
-      for (let i = 1; i <= 4; i++) {
-        document.getElementById('speedBtn' + i).classList.remove('active');
-      }
-      if (num > 0) {
-        document.getElementById('speedBtn' + num).classList.add('active');
-      }
-    }
-
-    // =============================================
-    // CUSTOM RPM
-    // =============================================
-    function fullStartCustom() {
-      const rpm = parseInt(document.getElementById('rpmSlider').value);
-      activeSpeed = 0;
-      highlightSpeed(0);
-      sendCmd('fullstart', { rpm: rpm });
-    }
-
-    function setRPMOnly() {
-      const rpm = parseInt(document.getElementById('rpmSlider').value);
-      sendCmd('rpm', { value: rpm });
-    }
-
-    // =============================================
-    // UPDATE STATUS DISPLAY
-    // =============================================
-    function updateStatus(s) {
-      const dot = document.getElementById('statusDot');
-      const label = document.getElementById('statusLabel');
-
-      if (s.running) {
-        dot.className = 'status-dot dot-running';
-        label.textContent = 'Running';
-      } else {
-        dot.className = 'status-dot dot-stopped';
-        label.textContent = 'Stopped';
-        activeSpeed = 0;
-        highlightSpeed(0);
-      }
-
-      document.getElementById('rpmVal').textContent = s.rpm >= 0 ? s.rpm : '--';
-      document.getElementById('wattsVal').textContent = s.watts >= 0 ? s.watts : '--';
-      document.getElementById('gpmVal').textContent = s.gpm >= 0 ? s.gpm : '--';
-
-      const modes = ['Filter','Manual','Speed 1','Speed 2','Speed 3','Speed 4'];
-      document.getElementById('modeVal').textContent = modes[s.mode] || 'Mode ' + s.mode;
-
-      // Auto-detect which speed button matches current RPM
-      if (s.running && s.rpm > 0) {
-        let matched = 0;
-        for (let i = 0; i < 4; i++) {
-          if (Math.abs(s.rpm - speeds[i]) < 30) { matched = i + 1; break; }
-        }
-        if (matched > 0 && activeSpeed !== matched) {
-          activeSpeed = matched;
-          highlightSpeed(matched);
-        }
-      }
-
-      // Update info bar
-      const info = document.getElementById('infoBar');
-      info.textContent = 'Device: ' + (s.deviceId || DEVICE_ID) +
-        ' | RSSI: ' + (s.rssi || '?') + ' dBm' +
-        ' | Uptime: ' + formatUptime(s.uptime || 0);
-    }
-
-    function formatUptime(sec) {
-      if (sec < 60) return sec + 's';
-      if (sec < 3600) return Math.floor(sec/60) + 'm';
-      return Math.floor(sec/3600) + 'h ' + Math.floor((sec%3600)/60) + 'm';
-    }
-
-    // =============================================
-    // UI HELPERS
-    // =============================================
-    function setSlider(v) {
-      document.getElementById('rpmSlider').value = v;
-      document.getElementById('rpmTarget').textContent = v;
-    }
-
-    function toggleAdvanced() {
-      const panel = document.getElementById('advancedPanel');
-      const btn = panel.previousElementSibling;
-      panel.classList.toggle('show');
-      btn.textContent = panel.classList.contains('show')
-        ? '▲ Advanced / Manual Commands'
-        : '▼ Advanced / Manual Commands';
-    }
-
-    function setConnStatus(state, text) {
-      const bar = document.getElementById('connBar');
-      bar.className = 'conn-bar ' + state;
-      document.getElementById('connLabel').textContent = text;
-    }
-
-    function showToast(msg) {
-      const t = document.getElementById('toast');
-      t.textContent = msg;
-      t.classList.add('show');
-      setTimeout(() => t.classList.remove('show'), 2000);
-    }
-
-    function addLog(msg, ok) {
-      const box = document.getElementById('logBox');
-      const cls = ok === true ? 'log-ok' : (ok === false ? 'log-err' : '');
-      const time = new Date().toLocaleTimeString();
-      box.innerHTML = '<div class="log-entry ' + cls + '">[' + time + '] ' + msg + '</div>' + box.innerHTML;
-      if (box.children.length > 50) box.removeChild(box.lastChild);
-    }
-  </script>
-</body>
-</html>
-)rawliteral";
+#include <Arduino.h>
+
+// Changes whenever the page does (quoted, as sent in the ETag header)
+#define WEBUI_ETAG  "\"c1e4cac1bbb53669\""
+
+const size_t WEBUI_HTML_GZ_LEN = 6937;
+
+const uint8_t WEBUI_HTML_GZ[] PROGMEM = {
+  0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xCD, 0x3D, 0xDB, 0x72, 0xE3, 0xB8,
+  0x95, 0xEF, 0xFD, 0x15, 0x18, 0x6D, 0x25, 0x92, 0x32, 0xBA, 0x4B, 0x76, 0xBB, 0x2D, 0xDB, 0x53,
+  0xBE, 0xF5, 0x44, 0xBB, 0xBE, 0xC5, 0x72, 0x4F, 0x36, 0x3B, 0xD5, 0x35, 0x45, 0x91, 0x90, 0xC4,
+  0x31, 0x45, 0x6A, 0x48, 0xAA, 0xDD, 0x4E, 0xC7, 0x55, 0xFB, 0xB4, 0x1F, 0xB0, 0xB5, 0x95, 0x0F,
+  0xD9, 0xE7, 0xFD, 0x9A, 0x7C, 0xC9, 0x9E, 0x03, 0x80, 0x20, 0x00, 0x82, 0x92, 0x6C, 0x77, 0x57,
+  0xA5, 0x53, 0x15, 0x53, 0xB8, 0x1C, 0xE0, 0x1C, 0x9C, 0xFB, 0x01, 0x39, 0x07, 0xDF, 0x9D, 0x5D,
+  0x9F, 0xDE, 0xFD, 0xE5, 0xE6, 0x9C, 0xCC, 0xD3, 0x45, 0x70, 0xF4, 0xE6, 0x00, 0xFF, 0x90, 0xC0,
+  0x09, 0x67, 0x87, 0x15, 0x1A, 0x56, 0xB0, 0x81, 0x3A, 0xDE, 0xD1, 0x1B, 0x42, 0x0E, 0x16, 0x34,
+  0x75, 0x88, 0x3B, 0x77, 0xE2, 0x84, 0xA6, 0x87, 0x95, 0x0F, 0x77, 0xEF, 0x9B, 0x7B, 0x95, 0xBC,
+  0x23, 0x74, 0x16, 0xF4, 0xB0, 0xF2, 0xC9, 0xA7, 0x0F, 0xCB, 0x28, 0x4E, 0x2B, 0xC4, 0x8D, 0xC2,
+  0x94, 0x86, 0x30, 0xF0, 0xC1, 0xF7, 0xD2, 0xF9, 0xA1, 0x47, 0x3F, 0xF9, 0x2E, 0x6D, 0xB2, 0x1F,
+  0x0D, 0xE2, 0x87, 0x7E, 0xEA, 0x3B, 0x41, 0x33, 0x71, 0x9D, 0x80, 0x1E, 0x76, 0x5B, 0x1D, 0x0E,
+  0x28, 0xF5, 0xD3, 0x80, 0x1E, 0xBD, 0x0F, 0xE8, 0xE7, 0x9B, 0x28, 0x0A, 0xC8, 0x29, 0x80, 0x88,
+  0xA3, 0x20, 0xA0, 0xF1, 0x41, 0x9B, 0x77, 0xE1, 0xA0, 0xC4, 0x8D, 0xFD, 0x65, 0x4A, 0x92, 0xD8,
+  0x3D, 0xAC, 0xCC, 0xD3, 0x74, 0x99, 0xEC, 0xB7, 0xDB, 0xAB, 0x70, 0x79, 0x3F, 0x6B, 0xB9, 0xD1,
+  0xA2, 0xBD, 0xF8, 0x2D, 0x4D, 0xDB, 0x9E, 0x9F, 0xA4, 0xEC, 0xA9, 0xB5, 0xF0, 0xC3, 0xD6, 0xAF,
+  0x49, 0xE5, 0xE8, 0xA0, 0xCD, 0xA7, 0x71, 0x08, 0xE9, 0x23, 0x87, 0x45, 0xC8, 0x1F, 0xC8, 0x17,
+  0xB2, 0x70, 0xE2, 0x99, 0x1F, 0xEE, 0x93, 0xCE, 0x90, 0x2C, 0x1D, 0xCF, 0xF3, 0xC3, 0x19, 0x7B,
+  0x9E, 0x44, 0x9F, 0x9B, 0x89, 0xFF, 0x57, 0xF6, 0x73, 0x12, 0xC5, 0x1E, 0x8D, 0x9B, 0xD0, 0x34,
+  0x24, 0x4F, 0x6C, 0xE2, 0x24, 0xF2, 0x1E, 0xC9, 0x17, 0xF6, 0x48, 0xC8, 0x14, 0x36, 0xDA, 0x9C,
+  0x3A, 0x0B, 0x3F, 0x78, 0xDC, 0x27, 0x4D, 0x67, 0xB9, 0x0C, 0x68, 0x33, 0x79, 0x4C, 0x52, 0xBA,
+  0x68, 0x90, 0x93, 0xC0, 0x0F, 0xEF, 0x2F, 0x1D, 0x77, 0xCC, 0x7E, 0xBF, 0x87, 0x91, 0x0D, 0x52,
+  0x1D, 0xD3, 0x59, 0x44, 0xC9, 0x87, 0x51, 0xB5, 0x41, 0x6E, 0xA3, 0x49, 0x94, 0x46, 0x0D, 0x92,
+  0x38, 0x61, 0xD2, 0x4C, 0x68, 0xEC, 0x4F, 0x87, 0x02, 0xEA, 0xC4, 0x71, 0xEF, 0x67, 0x71, 0xB4,
+  0x0A, 0xBD, 0x7D, 0xF2, 0x2F, 0x9D, 0x69, 0xF7, 0x6D, 0xCF, 0xC9, 0xBA, 0xDC, 0x28, 0x88, 0x62,
+  0x68, 0xA5, 0x3D, 0xBA, 0x37, 0xED, 0x64, 0xAD, 0x80, 0x6C, 0x73, 0x4E, 0xFD, 0xD9, 0x3C, 0xDD,
+  0x27, 0xDD, 0x4E, 0xE7, 0xD3, 0x3C, 0xEB, 0x90, 0x68, 0x75, 0x77, 0x97, 0x9F, 0x79, 0x23, 0xC7,
+  0x62, 0xDE, 0x95, 0x38, 0xA4, 0xF4, 0x73, 0xDA, 0x74, 0x02, 0x7F, 0x06, 0x94, 0x70, 0xE1, 0xE0,
+  0x68, 0x3C, 0x54, 0xB1, 0x03, 0x4A, 0x50, 0x98, 0xDF, 0xDA, 0x89, 0xE9, 0xC2, 0x0A, 0x96, 0x74,
+  0xC8, 0x20, 0x03, 0x9E, 0x6F, 0xB0, 0xBF, 0x37, 0xF1, 0xA6, 0x7B, 0x59, 0x6B, 0x40, 0x53, 0x80,
+  0xDB, 0x4C, 0x96, 0x8E, 0xCB, 0xE7, 0x15, 0x76, 0x03, 0x5D, 0x21, 0x1C, 0x49, 0x36, 0xFD, 0xDD,
+  0xC0, 0xE9, 0x4F, 0xF6, 0x86, 0x7C, 0x0B, 0x0F, 0x02, 0xB5, 0x7E, 0xA7, 0x33, 0x54, 0x37, 0xD5,
+  0x69, 0xBD, 0xC3, 0x4D, 0x11, 0x38, 0xF5, 0x65, 0xE0, 0xC0, 0x09, 0x4C, 0x82, 0xC8, 0xBD, 0xC7,
+  0x83, 0x62, 0x50, 0xDB, 0x7F, 0x40, 0x46, 0x0A, 0xA9, 0x9B, 0xFA, 0x51, 0x08, 0x44, 0x85, 0xC7,
+  0x98, 0xFC, 0xA1, 0xCD, 0xFA, 0x80, 0x65, 0xC2, 0xB0, 0x39, 0x71, 0x62, 0x49, 0x06, 0x09, 0x64,
+  0x0A, 0x5C, 0x38, 0x24, 0xBF, 0xAE, 0x92, 0xD4, 0x9F, 0x3E, 0x36, 0x05, 0x37, 0x4B, 0xD2, 0x10,
+  0x46, 0xA9, 0xA6, 0x0F, 0x47, 0x9A, 0xE4, 0x8D, 0x33, 0x67, 0xB9, 0x4F, 0xF6, 0x72, 0x2A, 0x48,
+  0x02, 0x61, 0x9B, 0xE0, 0x33, 0x60, 0xA2, 0x34, 0x8D, 0x16, 0x80, 0x7C, 0x0F, 0x1B, 0x05, 0x67,
+  0xC5, 0x8E, 0xE7, 0xAF, 0x12, 0x3C, 0xB6, 0x7C, 0xB6, 0x86, 0xE2, 0x1E, 0x43, 0xB1, 0xEC, 0x90,
+  0x9E, 0x74, 0x6C, 0xD8, 0x03, 0x20, 0x4C, 0x3D, 0xA0, 0xA5, 0xCE, 0x46, 0x3B, 0x3D, 0xDA, 0xDD,
+  0x1D, 0x4A, 0x02, 0x0F, 0x1C, 0x8F, 0xEE, 0x75, 0x86, 0x65, 0x00, 0x60, 0xF3, 0x26, 0x84, 0x41,
+  0xAF, 0xD7, 0xE9, 0x28, 0x10, 0xA6, 0x93, 0xC9, 0xB4, 0x37, 0x28, 0x42, 0x00, 0x42, 0x96, 0xEE,
+  0x62, 0xB0, 0xD3, 0x71, 0x3A, 0x8E, 0x02, 0x63, 0xEF, 0x6D, 0xF7, 0x6D, 0x57, 0x87, 0xE1, 0x45,
+  0x29, 0x4C, 0x63, 0xFA, 0x42, 0xD0, 0x2F, 0x63, 0xED, 0x3D, 0x0B, 0xDD, 0x76, 0x3A, 0xBF, 0x1B,
+  0xAE, 0xA1, 0x82, 0x0A, 0x52, 0xDB, 0x49, 0xAF, 0xE7, 0xEE, 0xEC, 0x50, 0x21, 0xEC, 0x73, 0xC7,
+  0x8B, 0x1E, 0x80, 0xD8, 0xF0, 0x3F, 0x64, 0x68, 0xD9, 0xB9, 0x86, 0x38, 0xA5, 0x80, 0xA7, 0x3B,
+  0xEF, 0x68, 0x67, 0x52, 0x02, 0x38, 0xEB, 0x5C, 0x4B, 0xB3, 0x52, 0xD0, 0x74, 0x3A, 0x80, 0x7F,
+  0x25, 0xA0, 0xB3, 0xCE, 0x9C, 0xF9, 0xCF, 0x98, 0xE6, 0x25, 0xA3, 0x33, 0xD0, 0xBA, 0xCB, 0x55,
+  0x4A, 0x6A, 0xD3, 0x28, 0x26, 0xC0, 0x4D, 0x51, 0x4A, 0x89, 0xE3, 0xBA, 0x34, 0x49, 0xEA, 0x52,
+  0x1C, 0x84, 0x96, 0x4E, 0x84, 0xB0, 0x7C, 0xB1, 0x69, 0xA2, 0x2E, 0xED, 0xBD, 0xEB, 0x4F, 0x8A,
+  0x9C, 0xCB, 0xD8, 0x39, 0x57, 0x09, 0x8A, 0x32, 0x58, 0xC3, 0xF8, 0x4C, 0x07, 0x90, 0x24, 0x0A,
+  0x7C, 0x0F, 0x94, 0x45, 0x7F, 0xD0, 0xDD, 0xD9, 0x19, 0x9A, 0x92, 0x18, 0x46, 0x21, 0xD5, 0xD8,
+  0x5C, 0xDF, 0x65, 0x2B, 0x99, 0x47, 0x0F, 0x40, 0xA3, 0xA2, 0xF8, 0xDB, 0x50, 0x0A, 0x9C, 0x09,
+  0x0D, 0x60, 0xB4, 0x45, 0xB8, 0x4C, 0xA5, 0xA3, 0x03, 0x88, 0xF5, 0x45, 0xB8, 0x7A, 0x90, 0x02,
+  0x9F, 0xE1, 0x98, 0x46, 0xD0, 0x80, 0x4A, 0xD6, 0x32, 0x9B, 0x93, 0x5F, 0xDA, 0x0C, 0x00, 0x00,
+  0xD8, 0xAB, 0x24, 0xEB, 0x58, 0x18, 0x7B, 0xAF, 0x84, 0x56, 0x83, 0xB7, 0x3B, 0x3B, 0xBB, 0xEF,
+  0xD6, 0x99, 0x0A, 0xD3, 0x48, 0x68, 0x7A, 0x5C, 0xD1, 0xE2, 0x9A, 0xF1, 0xAA, 0x9E, 0x46, 0xAB,
+  0xD8, 0x07, 0x05, 0x79, 0x45, 0x1F, 0xC0, 0x38, 0x2D, 0xA2, 0x30, 0x42, 0x6D, 0x0D, 0x42, 0x60,
+  0xEA, 0x6E, 0x76, 0x88, 0x4C, 0x1F, 0xA5, 0x31, 0x98, 0x2E, 0x60, 0x2A, 0x38, 0xDA, 0xD5, 0x72,
+  0x49, 0x63, 0xD7, 0x49, 0xAC, 0xE7, 0x85, 0x34, 0x98, 0xAC, 0x80, 0x07, 0x72, 0xC6, 0xD2, 0x70,
+  0xE7, 0xD6, 0x69, 0x2D, 0x01, 0x72, 0x56, 0x30, 0x70, 0xEE, 0xED, 0xEC, 0xF6, 0xE9, 0x44, 0xE2,
+  0xFC, 0x30, 0x07, 0xCD, 0x6C, 0x98, 0x8D, 0x5D, 0x34, 0x1B, 0xEE, 0x2A, 0x4E, 0x70, 0xC0, 0x32,
+  0xF2, 0x55, 0xED, 0x99, 0xC9, 0xCA, 0x38, 0x75, 0xD2, 0x55, 0x42, 0x5C, 0x27, 0xF6, 0xA4, 0x4C,
+  0x24, 0xAC, 0xAD, 0xC9, 0xDA, 0x9E, 0x25, 0x10, 0xBB, 0x9A, 0x40, 0xF4, 0x3A, 0xE5, 0x02, 0xB1,
+  0xBB, 0x85, 0x40, 0x3C, 0x69, 0xBB, 0x41, 0xA7, 0x8C, 0x6E, 0x6F, 0xB5, 0xD8, 0x19, 0x36, 0x27,
+  0x34, 0x7D, 0xA0, 0x34, 0xB4, 0x1B, 0xAF, 0x35, 0x5B, 0xB3, 0xAC, 0xCF, 0xD4, 0x92, 0x98, 0x22,
+  0x74, 0x34, 0x17, 0x6B, 0xE9, 0x7F, 0xF4, 0x4A, 0xB4, 0xB4, 0xB9, 0x63, 0x3F, 0x04, 0x07, 0x09,
+  0xF6, 0xC6, 0x85, 0x56, 0x2C, 0x1F, 0xE7, 0x9A, 0x5E, 0x63, 0xA4, 0x28, 0x6D, 0xC6, 0xAB, 0x30,
+  0xB4, 0x98, 0xA5, 0x32, 0x45, 0xBE, 0x67, 0x51, 0xE4, 0x08, 0x26, 0x01, 0x49, 0x5D, 0x16, 0x2D,
+  0x53, 0x99, 0x6E, 0xDD, 0xD3, 0x75, 0xAB, 0x04, 0xB3, 0x0A, 0xEF, 0xC3, 0xE8, 0x21, 0xDC, 0x56,
+  0xFB, 0xEF, 0x59, 0xB4, 0xBF, 0xA0, 0xA8, 0x45, 0x31, 0x75, 0x5B, 0x4C, 0x4E, 0x2D, 0x6C, 0xAC,
+  0x4F, 0x9D, 0xC5, 0xBE, 0x57, 0x64, 0x05, 0x6C, 0x1D, 0xB2, 0xFF, 0x6F, 0xC2, 0x41, 0x43, 0x5B,
+  0x4A, 0x81, 0x21, 0x82, 0xD5, 0x22, 0x84, 0x93, 0x88, 0xE9, 0x92, 0x3A, 0x69, 0xAD, 0xD7, 0x20,
+  0xDD, 0x69, 0x5C, 0x17, 0x8A, 0x8C, 0x9D, 0x99, 0x79, 0xD8, 0x8C, 0x4D, 0xEC, 0x8C, 0x9F, 0x29,
+  0x1A, 0x9B, 0x0F, 0xA3, 0x88, 0x76, 0xAE, 0x29, 0xCA, 0x3D, 0x17, 0xB6, 0xD2, 0x27, 0x27, 0x58,
+  0x51, 0x93, 0x04, 0xBB, 0x45, 0x12, 0xBC, 0x65, 0x92, 0xAC, 0x7B, 0x98, 0x1A, 0x20, 0x41, 0x4B,
+  0x9B, 0x1F, 0xF5, 0x76, 0xC7, 0xA6, 0xEB, 0x55, 0x1F, 0xD8, 0xAA, 0xCE, 0xAC, 0xAE, 0xAB, 0xA6,
+  0xF4, 0x15, 0xDA, 0x89, 0x9D, 0x70, 0x8B, 0xD3, 0x64, 0x91, 0x8B, 0x7D, 0x33, 0xBA, 0xDD, 0xD9,
+  0x1D, 0xBC, 0x1D, 0xEC, 0x4D, 0x5E, 0xB0, 0x97, 0x5E, 0xBE, 0x17, 0xAE, 0x67, 0x80, 0xD3, 0x72,
+  0x47, 0x32, 0xD7, 0x6E, 0x87, 0xE2, 0x1F, 0x19, 0xDF, 0x9C, 0x9F, 0x9F, 0x91, 0x93, 0x0F, 0x77,
+  0x77, 0xD7, 0x57, 0x63, 0x52, 0x5B, 0xC6, 0x3E, 0xCC, 0x7E, 0x24, 0x4C, 0x25, 0x4E, 0x41, 0x53,
+  0xD4, 0xF3, 0xA1, 0x52, 0x0B, 0x2E, 0x29, 0xF5, 0x5E, 0xE6, 0x18, 0x7C, 0x1B, 0x3D, 0xC8, 0xF6,
+  0xF3, 0xED, 0x38, 0x9F, 0x81, 0x9F, 0xA4, 0x0A, 0xAA, 0xAA, 0x09, 0x2A, 0xE0, 0x38, 0x28, 0xE0,
+  0xA8, 0xC6, 0x01, 0xA6, 0xD5, 0x21, 0xEC, 0x5C, 0x7D, 0x24, 0xE5, 0x3E, 0x28, 0xE3, 0x00, 0x58,
+  0xA1, 0xBB, 0x93, 0x18, 0xD6, 0xAB, 0x3C, 0x2E, 0x03, 0x38, 0xD9, 0xE4, 0x98, 0x02, 0x76, 0xFE,
+  0x27, 0xD8, 0x51, 0xF4, 0x09, 0xCE, 0x2E, 0x40, 0x45, 0x33, 0xF7, 0x3D, 0x0F, 0xB4, 0xBC, 0x15,
+  0x9D, 0x7D, 0xC7, 0xC5, 0xE1, 0x20, 0x64, 0x0A, 0x6B, 0xB1, 0x28, 0xBC, 0x06, 0x61, 0xD4, 0x6E,
+  0x7D, 0x58, 0x98, 0xD1, 0x92, 0x33, 0x4C, 0x65, 0xD6, 0x21, 0x7D, 0x54, 0x67, 0x5C, 0x00, 0x1B,
+  0xAC, 0x81, 0x21, 0x1E, 0xCF, 0x26, 0x4E, 0x6D, 0x67, 0xB7, 0xD1, 0xDD, 0x7B, 0xD7, 0xE8, 0x0D,
+  0xF6, 0x1A, 0x9D, 0x56, 0xDF, 0x84, 0x8B, 0xC9, 0x02, 0x9B, 0x48, 0x74, 0x5B, 0xBD, 0x12, 0x71,
+  0x37, 0xBC, 0xBB, 0x22, 0x72, 0xF1, 0x72, 0x51, 0x22, 0x64, 0x5C, 0xE2, 0x23, 0x94, 0x96, 0xF4,
+  0x91, 0xB7, 0xE8, 0xA2, 0xCB, 0x0E, 0x6F, 0xE3, 0x02, 0x0F, 0x4E, 0x9A, 0x26, 0x25, 0x4A, 0xC5,
+  0x5C, 0x61, 0xB7, 0xA8, 0x1B, 0x36, 0x2F, 0xD0, 0x35, 0xAC, 0x08, 0xDA, 0x45, 0x27, 0x06, 0x1E,
+  0x07, 0x26, 0x83, 0x83, 0xAF, 0x75, 0xFB, 0x3B, 0x1E, 0x9D, 0x35, 0x40, 0xEF, 0xEE, 0xBD, 0xEB,
+  0x4E, 0x7A, 0xF8, 0xB0, 0x3B, 0xD9, 0xF5, 0x06, 0x26, 0x71, 0x7B, 0xDB, 0xC2, 0xE1, 0x4E, 0x13,
+  0x3C, 0x80, 0x0A, 0xEC, 0x4D, 0x0B, 0x87, 0xDF, 0xDF, 0x16, 0xCE, 0x5B, 0xB7, 0xEF, 0x50, 0x0F,
+  0x1E, 0xF6, 0x26, 0x3B, 0x6E, 0x11, 0xCE, 0x60, 0x5B, 0x38, 0x6E, 0x6F, 0xD0, 0xED, 0xB8, 0xF0,
+  0x40, 0x9D, 0x9D, 0xBD, 0x8E, 0x5B, 0x57, 0xA3, 0x98, 0xF1, 0xDD, 0xF5, 0x4D, 0xE6, 0x3D, 0xE6,
+  0x9E, 0x59, 0xB4, 0xCC, 0x55, 0x92, 0x5D, 0x9B, 0x88, 0x9D, 0x00, 0x23, 0x37, 0x27, 0xFE, 0x0C,
+  0x67, 0x14, 0xFC, 0x96, 0x0E, 0xC6, 0x8E, 0xCF, 0x11, 0xEF, 0xEE, 0x9E, 0x35, 0x48, 0x07, 0x73,
+  0xBD, 0x53, 0x66, 0xAC, 0x6C, 0x6E, 0x27, 0xD9, 0x8E, 0x2A, 0x9E, 0xDB, 0xDB, 0xED, 0xED, 0xC2,
+  0xC3, 0xE4, 0x5D, 0xD7, 0xED, 0x02, 0x55, 0xF4, 0x14, 0x8B, 0x70, 0x75, 0x4B, 0x34, 0xCA, 0x86,
+  0x8C, 0x8B, 0x4A, 0x97, 0xF5, 0xAA, 0xE1, 0xAD, 0x76, 0x1A, 0xB7, 0x37, 0x97, 0x80, 0x13, 0xCC,
+  0x5A, 0x90, 0x04, 0x34, 0xB4, 0x92, 0x50, 0x01, 0x31, 0xFC, 0x27, 0xB2, 0x12, 0xB8, 0x1B, 0x21,
+  0x77, 0xEB, 0x12, 0x5D, 0xEA, 0x29, 0xF6, 0x5A, 0x25, 0x87, 0x68, 0xCF, 0x6C, 0x49, 0xBB, 0x8B,
+  0xAE, 0x5D, 0xA7, 0x74, 0x71, 0x91, 0xD7, 0x32, 0x43, 0xB0, 0x92, 0x98, 0x93, 0x45, 0x8A, 0x3F,
+  0xA7, 0x8F, 0x4B, 0x7A, 0x58, 0x81, 0xB3, 0x98, 0xD1, 0xCA, 0x47, 0x3B, 0xD7, 0x6A, 0x29, 0x11,
+  0xD8, 0xED, 0xE4, 0xDE, 0x4F, 0x31, 0xFF, 0x08, 0x9C, 0xE4, 0x84, 0x2E, 0x5D, 0x13, 0x30, 0x09,
+  0x62, 0x99, 0xC7, 0xC0, 0x18, 0x3D, 0x5A, 0xA5, 0xC8, 0x8D, 0x99, 0x30, 0x64, 0x18, 0xA2, 0x91,
+  0xD4, 0x51, 0xB4, 0xEC, 0x73, 0x7F, 0x3F, 0xDB, 0x06, 0x67, 0x8C, 0x66, 0x3A, 0x5F, 0x2D, 0x26,
+  0x72, 0xF7, 0xA5, 0x7B, 0xCC, 0xF0, 0xEA, 0x69, 0xA9, 0x9E, 0x9E, 0x22, 0x69, 0xB6, 0x8C, 0x8F,
+  0x8E, 0x92, 0x38, 0x91, 0x92, 0x18, 0x4F, 0x9E, 0xC9, 0x32, 0xA6, 0x09, 0x55, 0x54, 0xF9, 0xB3,
+  0xFC, 0x86, 0x81, 0xE6, 0x37, 0x14, 0x42, 0x7F, 0xD5, 0xED, 0x32, 0x16, 0x2C, 0x78, 0x12, 0xC5,
+  0x68, 0x5E, 0xC3, 0x87, 0x49, 0xE1, 0xD2, 0x89, 0x81, 0x45, 0x87, 0x25, 0x09, 0x5F, 0x5B, 0xA8,
+  0xAC, 0xE6, 0x1C, 0xF9, 0x71, 0xDA, 0x5C, 0xCE, 0xAD, 0x48, 0x94, 0x6B, 0x04, 0x2B, 0xEB, 0x28,
+  0x2A, 0x04, 0x06, 0x0B, 0x75, 0x60, 0x65, 0x53, 0x8D, 0x42, 0xBD, 0x42, 0x40, 0x6F, 0x4D, 0x25,
+  0x15, 0x32, 0x04, 0x26, 0x2E, 0x65, 0xB1, 0xD1, 0x6B, 0x74, 0x6D, 0x77, 0xD7, 0xE9, 0x0F, 0x1C,
+  0x69, 0x62, 0xEB, 0x36, 0x97, 0xCC, 0x86, 0xF6, 0x73, 0x74, 0xE7, 0x09, 0x33, 0x62, 0x89, 0xD4,
+  0x98, 0x08, 0xC8, 0x48, 0x2E, 0xBD, 0xC0, 0x81, 0xED, 0xD8, 0x32, 0xCC, 0x1D, 0xDD, 0x02, 0x6E,
+  0xE9, 0xCB, 0x16, 0x13, 0x79, 0x9C, 0xB3, 0xF4, 0x94, 0xFB, 0x8E, 0x99, 0x42, 0x5A, 0x7B, 0x08,
+  0x5B, 0x79, 0xBC, 0x9B, 0x82, 0xC4, 0xE7, 0xF8, 0xAF, 0xEC, 0x78, 0x52, 0x27, 0x4E, 0x89, 0xC9,
+  0xBE, 0xFC, 0x8C, 0x8D, 0x81, 0xE0, 0x16, 0x14, 0x06, 0x72, 0xC3, 0xAB, 0x0D, 0x14, 0x69, 0xD3,
+  0x2F, 0xF6, 0xE4, 0x93, 0x32, 0x10, 0x5C, 0x3C, 0x27, 0x28, 0x40, 0xE4, 0x8E, 0x92, 0x36, 0xF0,
+  0xB7, 0x15, 0x85, 0xC8, 0xAB, 0x90, 0xA6, 0x67, 0xEC, 0xA7, 0x0E, 0xDC, 0x07, 0xE6, 0x70, 0x26,
+  0x01, 0xCB, 0x58, 0x28, 0x8E, 0xE6, 0x20, 0x27, 0x75, 0x18, 0x21, 0xED, 0x20, 0x02, 0xE0, 0x2B,
+  0xE4, 0xB5, 0x8F, 0x20, 0x70, 0x96, 0x89, 0x0F, 0x73, 0x89, 0xE3, 0x7D, 0x42, 0x95, 0xEB, 0x91,
+  0xCC, 0x42, 0x67, 0x3C, 0x98, 0x75, 0x80, 0x88, 0xCE, 0x66, 0x4A, 0xB4, 0xAA, 0xBB, 0x48, 0xE5,
+  0x66, 0x7C, 0x4D, 0x1A, 0x77, 0x03, 0x77, 0xB1, 0x9F, 0xF6, 0x08, 0xD8, 0xE6, 0xC5, 0x17, 0xF9,
+  0xAA, 0xB4, 0x6C, 0x65, 0xCB, 0x3A, 0xAB, 0xDC, 0x64, 0xE0, 0xBC, 0x9D, 0xB2, 0x93, 0x93, 0xC0,
+  0x9E, 0xB3, 0x74, 0x8D, 0x9E, 0xA5, 0xB6, 0x0F, 0x2B, 0xCF, 0x50, 0x4B, 0xEF, 0x16, 0xDC, 0x34,
+  0xA0, 0x47, 0x52, 0x38, 0x98, 0x44, 0x74, 0xFC, 0x33, 0x45, 0xDE, 0x7C, 0x4B, 0x5C, 0x67, 0xD9,
+  0xF3, 0x8F, 0xD6, 0xE2, 0xD8, 0x86, 0xA4, 0xA4, 0x35, 0x23, 0xDC, 0x19, 0xE6, 0xA5, 0x57, 0xB1,
+  0xD3, 0x6D, 0xF7, 0xB6, 0x1F, 0x38, 0x49, 0xDA, 0x74, 0xE7, 0x7E, 0xC0, 0x92, 0x7C, 0x3A, 0x14,
+  0xED, 0xB0, 0xB2, 0x49, 0xD6, 0xD2, 0xC0, 0xBB, 0x75, 0xA5, 0x81, 0x6C, 0xA6, 0x9E, 0xD9, 0x17,
+  0x42, 0xF3, 0xAE, 0x63, 0x9A, 0xE3, 0x6F, 0x91, 0xDC, 0xCF, 0x9C, 0x9E, 0x92, 0xE4, 0x7E, 0xA9,
+  0xB3, 0xAB, 0x6A, 0xEB, 0x82, 0x59, 0x73, 0x3E, 0x61, 0xC1, 0x44, 0xB0, 0xE4, 0xB7, 0xB3, 0xE8,
+  0xBD, 0xA2, 0x55, 0x79, 0xB9, 0x4D, 0x97, 0x3E, 0x94, 0xCD, 0x62, 0x67, 0x72, 0x76, 0x11, 0xCD,
+  0xA4, 0x68, 0x05, 0xD1, 0xEC, 0x6B, 0x48, 0x55, 0x9E, 0x21, 0x27, 0x3A, 0x55, 0x9E, 0x21, 0x52,
+  0xB8, 0x95, 0x49, 0xF4, 0xF9, 0x59, 0x59, 0x56, 0xDD, 0xD9, 0xEB, 0x6A, 0xB2, 0xFD, 0x59, 0x5E,
+  0x03, 0xE8, 0x75, 0x18, 0x17, 0x66, 0xC9, 0xA1, 0x26, 0x88, 0xA8, 0xB3, 0x4A, 0xA3, 0x67, 0xD6,
+  0x7E, 0x2C, 0x19, 0x54, 0x23, 0x1A, 0xCA, 0x04, 0x83, 0xE5, 0xF2, 0x65, 0x0D, 0xA0, 0x55, 0x44,
+  0x13, 0x78, 0x10, 0xEC, 0xDD, 0x97, 0x35, 0x62, 0x9D, 0x91, 0x3D, 0xD7, 0x5B, 0x5C, 0x11, 0x28,
+  0x40, 0xA2, 0x7B, 0xE5, 0x8E, 0x80, 0x91, 0xDC, 0x67, 0x8B, 0xC4, 0xB1, 0x32, 0xC0, 0x28, 0x89,
+  0xB6, 0xD2, 0x08, 0x34, 0x43, 0x5E, 0x82, 0x92, 0xB9, 0xB4, 0xA9, 0xFF, 0x19, 0x4D, 0x67, 0xB6,
+  0x25, 0xA6, 0x2E, 0x21, 0x80, 0x9E, 0xA6, 0x22, 0xD8, 0x50, 0x3C, 0x0E, 0xF6, 0x88, 0x6E, 0xD9,
+  0xBF, 0xD7, 0x9A, 0xD0, 0x57, 0x5F, 0x1B, 0x62, 0x99, 0x75, 0x38, 0x4D, 0x00, 0x48, 0x6F, 0x50,
+  0x1A, 0xE2, 0x94, 0x0A, 0x48, 0xEE, 0x00, 0x48, 0x39, 0x57, 0xDC, 0x2B, 0xD1, 0x0B, 0xA3, 0xFB,
+  0xC9, 0x30, 0x13, 0x99, 0x26, 0xFD, 0x04, 0xA4, 0x4F, 0x32, 0xF9, 0xFC, 0x2B, 0xE8, 0x2C, 0x8F,
+  0x15, 0x20, 0x0D, 0xF9, 0x67, 0xC4, 0xC9, 0x0C, 0x96, 0x5C, 0x27, 0xAF, 0xCD, 0xFB, 0xE1, 0x34,
+  0xD2, 0x2E, 0x4C, 0xD8, 0x34, 0x8C, 0xBC, 0x5D, 0x20, 0x44, 0xD2, 0x92, 0x2C, 0x2B, 0x2A, 0x10,
+  0x83, 0x75, 0x76, 0xF3, 0x6D, 0x1D, 0xB4, 0xC5, 0x8D, 0x9D, 0x83, 0x36, 0xBF, 0x8C, 0x74, 0x80,
+  0xB7, 0x6F, 0xD8, 0x55, 0x9E, 0x79, 0x37, 0xBF, 0x2E, 0x74, 0x80, 0x41, 0xF6, 0xD1, 0x0D, 0xEC,
+  0xC1, 0xF1, 0x63, 0x72, 0xB3, 0x5A, 0x2C, 0xB5, 0x1B, 0x44, 0xAC, 0x17, 0x20, 0x74, 0x8F, 0x90,
+  0x0F, 0x0E, 0xBE, 0x6B, 0x36, 0xC9, 0xE5, 0x9F, 0xEE, 0xEE, 0xC8, 0xE9, 0xF5, 0xD5, 0xD5, 0xF9,
+  0xE9, 0xDD, 0xE8, 0xFA, 0x8A, 0x8C, 0xEF, 0x8E, 0xEF, 0x3E, 0x8C, 0x49, 0xB3, 0xC9, 0x60, 0x7B,
+  0xFE, 0x27, 0xE2, 0x82, 0x15, 0x49, 0x0E, 0x2B, 0xF2, 0x9A, 0x88, 0x5A, 0xA1, 0xAF, 0x10, 0xDF,
+  0xE3, 0x5D, 0x27, 0x4E, 0x5C, 0xE1, 0xF7, 0x89, 0x0A, 0x93, 0xBC, 0x28, 0xC5, 0xDB, 0x47, 0xD0,
+  0x2C, 0x06, 0xB0, 0x4C, 0x40, 0x36, 0xF1, 0x02, 0x4D, 0x4E, 0xE5, 0xE8, 0x34, 0xBF, 0x50, 0x90,
+  0x46, 0x30, 0x3D, 0x5A, 0x79, 0xAD, 0x56, 0x4B, 0x6C, 0x99, 0x11, 0x80, 0xCD, 0xCF, 0xB6, 0x7D,
+  0x76, 0xFE, 0xD3, 0xE8, 0xF4, 0x1C, 0x2B, 0xFA, 0x35, 0x3C, 0xA8, 0x10, 0x74, 0x1D, 0x0D, 0xE1,
+  0xB0, 0x68, 0x08, 0xAE, 0x1D, 0x77, 0x51, 0x83, 0x47, 0xD0, 0xD7, 0xE9, 0x1C, 0x22, 0x79, 0x02,
+  0xCB, 0xD1, 0xC5, 0x84, 0x7A, 0x1E, 0x74, 0x8E, 0xCE, 0xEA, 0x16, 0xEC, 0xF4, 0x12, 0x39, 0x47,
+  0x8B, 0xB7, 0x8D, 0x45, 0x93, 0xD8, 0x3B, 0xB3, 0x90, 0x47, 0xE7, 0x78, 0xC8, 0xE4, 0x11, 0x94,
+  0x85, 0x72, 0xB7, 0x00, 0xF7, 0xCD, 0xB1, 0x90, 0x3B, 0xD8, 0x3F, 0x68, 0xF3, 0x09, 0x05, 0xCA,
+  0xE4, 0x05, 0x61, 0x01, 0x19, 0xBA, 0xB9, 0x0D, 0xE5, 0xB9, 0x04, 0xE4, 0x29, 0x75, 0x1B, 0x23,
+  0xEC, 0xAB, 0x10, 0x70, 0x31, 0x5C, 0x3A, 0x8F, 0x02, 0x90, 0x91, 0xC3, 0x0A, 0x6D, 0xCD, 0x5A,
+  0x20, 0x3C, 0x67, 0xA7, 0xA7, 0xFD, 0xE3, 0xEE, 0x49, 0xEF, 0xB4, 0x4F, 0xA2, 0x18, 0x98, 0x3B,
+  0x4E, 0xE7, 0x6D, 0xB5, 0xB5, 0x82, 0xEA, 0x30, 0xA0, 0xE1, 0x2C, 0x9D, 0x1F, 0x56, 0x06, 0x9D,
+  0x7C, 0x3D, 0x91, 0x4B, 0x8C, 0x42, 0x37, 0xF0, 0xDD, 0xFB, 0xC3, 0xCA, 0xC2, 0x09, 0x57, 0x4E,
+  0x20, 0x4E, 0xA2, 0x56, 0x97, 0x87, 0x72, 0xD0, 0xE6, 0x23, 0x05, 0x16, 0xD9, 0x49, 0x1A, 0x47,
+  0x22, 0x38, 0xE7, 0xF4, 0xF8, 0xF6, 0xCC, 0x42, 0x60, 0xA5, 0x84, 0x6C, 0xE1, 0x13, 0xAD, 0xA4,
+  0x9B, 0x6F, 0x50, 0xB2, 0x4C, 0xCE, 0x36, 0xFA, 0x04, 0xAC, 0xC1, 0x2A, 0x35, 0x48, 0x4E, 0x30,
+  0xDE, 0x77, 0xC6, 0xB9, 0x2E, 0xE3, 0x9F, 0x72, 0x18, 0xEC, 0x80, 0xD4, 0x99, 0x82, 0x23, 0xFF,
+  0xEC, 0xF8, 0x8C, 0x1D, 0xF1, 0xAE, 0x88, 0xE7, 0xA4, 0x8E, 0xC6, 0x8E, 0x1A, 0x21, 0x54, 0x62,
+  0x0A, 0xD8, 0x18, 0x6A, 0xCA, 0xD8, 0xA6, 0x42, 0x98, 0xF0, 0x1E, 0x56, 0x32, 0xB5, 0xB7, 0x27,
+  0x2B, 0xFD, 0xB9, 0x5A, 0x10, 0x79, 0x89, 0x4A, 0x7E, 0x1C, 0x09, 0x0D, 0xBD, 0xD3, 0x85, 0x57,
+  0xAB, 0x32, 0x20, 0x55, 0x38, 0x8F, 0x5B, 0x3A, 0x8D, 0x69, 0x32, 0x2F, 0x39, 0x0F, 0x2B, 0x49,
+  0x31, 0x82, 0xD6, 0x08, 0xAA, 0xF6, 0x33, 0xFF, 0xB4, 0xA2, 0x90, 0xC7, 0xEC, 0x67, 0xE5, 0x48,
+  0x4E, 0x9B, 0x78, 0xB9, 0xF8, 0xC9, 0x01, 0xB2, 0x34, 0x9B, 0x1A, 0xDE, 0x96, 0x49, 0x9C, 0xA0,
+  0x47, 0xB7, 0x37, 0x97, 0x3A, 0x85, 0xB4, 0x1F, 0xAF, 0xD8, 0x09, 0xAB, 0x42, 0x3C, 0x6F, 0x2F,
+  0x7F, 0xC6, 0x29, 0xDF, 0x66, 0x37, 0xB3, 0xE7, 0xD2, 0xE5, 0xC7, 0x6F, 0x45, 0x97, 0x45, 0xE4,
+  0xD1, 0xE7, 0x6D, 0xE5, 0x12, 0x66, 0x94, 0xED, 0xA5, 0x4C, 0xCC, 0xCB, 0x2A, 0xA8, 0x37, 0xB7,
+  0xA3, 0xCB, 0xE3, 0xDB, 0xBF, 0x90, 0xD1, 0xD5, 0xDD, 0xF9, 0xED, 0xFB, 0xE3, 0xD3, 0x73, 0xA5,
+  0x82, 0x6A, 0x51, 0x07, 0x6A, 0x2D, 0xD5, 0xA6, 0x10, 0xD4, 0xCA, 0xB1, 0x94, 0x1F, 0xC5, 0x62,
+  0x82, 0x1A, 0x1B, 0xD3, 0x00, 0x75, 0xED, 0x18, 0x41, 0x95, 0x09, 0x81, 0x2C, 0x91, 0x56, 0x4A,
+  0x04, 0x35, 0xAF, 0x72, 0x8A, 0x0A, 0x94, 0xD0, 0x04, 0xF8, 0xE3, 0x24, 0x0D, 0xBB, 0x9A, 0x3C,
+  0xA6, 0x6C, 0xAD, 0x5A, 0xB7, 0x5E, 0x29, 0x53, 0x29, 0xB2, 0xB4, 0x07, 0xDB, 0xC3, 0x67, 0xD2,
+  0x5D, 0xAF, 0x82, 0xB2, 0xBA, 0x9D, 0xB2, 0x2A, 0x53, 0x3F, 0xDD, 0xCA, 0xD1, 0xDB, 0x9D, 0x0E,
+  0x61, 0x32, 0xA4, 0xEB, 0x1C, 0x55, 0xF4, 0x37, 0x62, 0xD3, 0xD3, 0xB1, 0xE9, 0xD9, 0xB0, 0xE9,
+  0x3D, 0x03, 0x9B, 0xDE, 0xCB, 0xB0, 0xE9, 0x55, 0x8E, 0xBA, 0x3B, 0x9D, 0xD7, 0xA3, 0xD3, 0xD7,
+  0xD1, 0xE9, 0xDB, 0xD0, 0xE9, 0x3F, 0x03, 0x9D, 0xFE, 0xCB, 0xD0, 0xE9, 0x57, 0x8E, 0x7A, 0xFD,
+  0xAF, 0x70, 0x3A, 0x03, 0x1D, 0x9D, 0x81, 0x0D, 0x9D, 0xC1, 0x33, 0xD0, 0x19, 0xBC, 0x0C, 0x9D,
+  0x41, 0xE5, 0xA8, 0xDF, 0xED, 0x6E, 0x44, 0xA7, 0xDC, 0xEE, 0x5F, 0xDF, 0x08, 0x35, 0x60, 0xB5,
+  0xFB, 0x79, 0x81, 0x32, 0x93, 0xF3, 0x82, 0xA9, 0xCC, 0xEA, 0x6F, 0x36, 0xE3, 0x37, 0x5D, 0x05,
+  0x01, 0xF6, 0xA1, 0xFD, 0x63, 0x4B, 0xDD, 0x7C, 0xB8, 0xBC, 0x51, 0x77, 0x66, 0x6C, 0xE7, 0xF4,
+  0x03, 0x8C, 0xBA, 0x64, 0xE5, 0xB9, 0xE2, 0x6E, 0x94, 0xD2, 0xDC, 0x0B, 0x95, 0xCE, 0x29, 0xCF,
+  0xF1, 0xEB, 0xC6, 0xCD, 0x5C, 0x42, 0xE4, 0x82, 0xC0, 0xFF, 0x90, 0xAE, 0x2E, 0x34, 0xDF, 0x01,
+  0x20, 0x0A, 0x4E, 0x09, 0xC4, 0x1B, 0x1D, 0x41, 0x68, 0xE1, 0xB0, 0xE7, 0x94, 0x57, 0x81, 0xAA,
+  0xEE, 0x20, 0x2F, 0x2D, 0x65, 0x90, 0xC6, 0xAC, 0xAE, 0x54, 0xC1, 0xDB, 0xEE, 0xE0, 0xD1, 0xED,
+  0x74, 0x98, 0x87, 0x77, 0x58, 0xE9, 0xB3, 0xC7, 0x24, 0xA5, 0xCB, 0xC3, 0x0A, 0x3E, 0x31, 0xDB,
+  0x70, 0x58, 0xC1, 0xF5, 0x2A, 0x92, 0x27, 0xE0, 0x5F, 0x14, 0x32, 0xD0, 0xE0, 0x5A, 0x46, 0xEE,
+  0x6A, 0x01, 0xC1, 0x42, 0x0B, 0xF6, 0x75, 0x1E, 0x50, 0x7C, 0x3C, 0x79, 0x1C, 0x01, 0xD1, 0xE5,
+  0x6E, 0xAB, 0xF5, 0x16, 0x7A, 0xA2, 0xA7, 0xE2, 0x4D, 0x86, 0x74, 0xEE, 0x27, 0x2D, 0x6E, 0x72,
+  0xEC, 0x98, 0x8B, 0xC2, 0x52, 0x99, 0xB6, 0xCD, 0x87, 0x18, 0xBC, 0xCE, 0x10, 0xAA, 0xED, 0x76,
+  0x3A, 0x70, 0xCA, 0xBB, 0x48, 0x9E, 0xB5, 0x82, 0xB4, 0x01, 0x0C, 0x30, 0x33, 0xC2, 0xC1, 0x3F,
+  0xAF, 0x03, 0xD4, 0xEB, 0x30, 0x40, 0xBD, 0xCE, 0x6B, 0x01, 0xF5, 0x39, 0xA0, 0x7E, 0x01, 0x90,
+  0x7A, 0xDE, 0x45, 0xB1, 0x90, 0xC5, 0x15, 0x05, 0x28, 0xCA, 0xC3, 0x18, 0xB3, 0xFA, 0x9C, 0x13,
+  0xD1, 0x4D, 0x67, 0x3F, 0x89, 0x93, 0x12, 0x95, 0x39, 0x4B, 0x05, 0xE4, 0xF8, 0xEC, 0xA7, 0xE3,
+  0xAB, 0x53, 0x30, 0xDD, 0xA7, 0xD7, 0x97, 0x97, 0xC7, 0x57, 0x67, 0x60, 0xBB, 0xDD, 0x3C, 0x41,
+  0x2E, 0x83, 0x23, 0x7D, 0x37, 0x46, 0xA6, 0x58, 0xD9, 0x0F, 0x6F, 0x38, 0x16, 0xFD, 0xB5, 0x4C,
+  0x5D, 0xFD, 0xE3, 0xEF, 0xFF, 0x47, 0xB2, 0x46, 0xD2, 0x26, 0x97, 0x2C, 0xB4, 0x80, 0x60, 0x74,
+  0x01, 0x41, 0x86, 0x97, 0xBC, 0xD1, 0x95, 0x8B, 0xCA, 0x45, 0x7A, 0xDE, 0x98, 0xB3, 0x7C, 0xD6,
+  0x76, 0xC3, 0x9A, 0x8E, 0x78, 0x12, 0x83, 0x2B, 0x1F, 0xA6, 0xF8, 0x64, 0xEE, 0x18, 0x30, 0x09,
+  0xA7, 0xFE, 0x6C, 0x15, 0x63, 0x9D, 0x80, 0xE9, 0x00, 0xF4, 0xDE, 0xA9, 0xE3, 0xCE, 0xB9, 0xCA,
+  0xCD, 0xB0, 0x33, 0xE5, 0x5E, 0xCF, 0x30, 0xDB, 0xFD, 0xE5, 0x6D, 0x3C, 0x12, 0x63, 0x37, 0xB0,
+  0x81, 0x7A, 0xB9, 0x7B, 0x97, 0x27, 0x6A, 0x4B, 0x55, 0xBC, 0x9A, 0x96, 0x2D, 0xF7, 0x28, 0x54,
+  0x45, 0x11, 0xAE, 0x20, 0xD0, 0x05, 0xD5, 0x60, 0x40, 0xF0, 0x79, 0xF8, 0xC8, 0x82, 0xEE, 0xE9,
+  0xAC, 0xBB, 0xAD, 0xEA, 0x00, 0x1F, 0xA4, 0xB2, 0xD9, 0x4F, 0x7D, 0x21, 0x22, 0xBD, 0xD7, 0x23,
+  0xD2, 0xDB, 0x5A, 0x07, 0x82, 0xFB, 0xF1, 0xED, 0x30, 0xE9, 0xBF, 0x1E, 0x93, 0xFE, 0xB6, 0x98,
+  0xA0, 0xE7, 0xF1, 0xED, 0x30, 0x19, 0xBC, 0x1E, 0x93, 0xC1, 0xB6, 0x98, 0xA0, 0xD3, 0x51, 0xD9,
+  0x32, 0x98, 0xD6, 0x13, 0xF2, 0xAA, 0x8E, 0x85, 0xF6, 0x4C, 0xE0, 0x98, 0x2E, 0x84, 0xDF, 0x86,
+  0x56, 0xB0, 0x6A, 0xDC, 0x5C, 0x85, 0x18, 0xAA, 0xA9, 0x44, 0x43, 0xA8, 0xC2, 0x7F, 0x64, 0x4C,
+  0x29, 0xF1, 0x04, 0x44, 0x55, 0xBB, 0xB2, 0x21, 0x45, 0xC0, 0x4A, 0xB4, 0x15, 0x62, 0x71, 0x7D,
+  0x58, 0x4F, 0x55, 0x2A, 0xF8, 0xCB, 0x28, 0x8D, 0xE2, 0x0D, 0x76, 0x28, 0x07, 0x8A, 0xDE, 0x94,
+  0x1D, 0xA8, 0xF0, 0xA5, 0xB0, 0xE0, 0x6B, 0x01, 0xF9, 0x3A, 0x64, 0x78, 0xE2, 0xCB, 0xE6, 0xC7,
+  0xF1, 0x1E, 0x9E, 0xC5, 0x60, 0x15, 0x64, 0x91, 0x98, 0xDC, 0x12, 0x21, 0x56, 0x4D, 0xB6, 0x52,
+  0x89, 0xF5, 0x20, 0xDC, 0x0B, 0x56, 0x70, 0xB6, 0x82, 0x7D, 0x1D, 0x52, 0x22, 0x89, 0xB3, 0x26,
+  0x31, 0xF3, 0x27, 0x56, 0xC2, 0xE6, 0xAF, 0x4E, 0x6C, 0x46, 0x48, 0x5A, 0x0F, 0x25, 0x57, 0x2E,
+  0x12, 0xC5, 0xBA, 0xF7, 0x00, 0xF6, 0xE3, 0x3A, 0x0C, 0x1E, 0x19, 0x5F, 0xD3, 0x94, 0xD9, 0x33,
+  0xFC, 0xBD, 0x9D, 0x5F, 0x7E, 0x71, 0xFD, 0xA3, 0xC5, 0x03, 0x56, 0x4A, 0x3E, 0x2F, 0xF4, 0x80,
+  0x8F, 0xB1, 0x48, 0x8C, 0xC9, 0xF5, 0x8B, 0x68, 0x56, 0x42, 0x57, 0x51, 0xCC, 0xE1, 0x2A, 0x01,
+  0x7E, 0x9C, 0xC0, 0xF3, 0x91, 0x6D, 0x9F, 0xCA, 0x9C, 0x2C, 0xAB, 0xCE, 0x27, 0xE1, 0x2F, 0x96,
+  0x52, 0xCE, 0x67, 0x29, 0x63, 0x59, 0x86, 0x9E, 0x0F, 0xE4, 0x8F, 0x47, 0x0A, 0xCC, 0xFC, 0x2D,
+  0x57, 0x42, 0xDA, 0x6D, 0x99, 0x84, 0xD8, 0xEA, 0x5F, 0x36, 0x89, 0xE7, 0x36, 0x6E, 0x6E, 0xCF,
+  0xC7, 0xE7, 0x77, 0x63, 0x66, 0xC7, 0xB9, 0xD2, 0x4A, 0x98, 0x3F, 0x21, 0xEC, 0x70, 0x73, 0x50,
+  0x97, 0xE3, 0x41, 0xEB, 0x78, 0xC4, 0x07, 0x76, 0x01, 0x76, 0x4A, 0x68, 0x4C, 0x18, 0x53, 0x82,
+  0x88, 0xC5, 0xCE, 0x8C, 0x92, 0x24, 0x22, 0xE9, 0x9C, 0x3E, 0x92, 0x25, 0x8D, 0x13, 0x3F, 0x49,
+  0x5F, 0xBE, 0x33, 0xF0, 0x6E, 0x92, 0x94, 0x9C, 0x9D, 0xBF, 0x3F, 0xFE, 0x70, 0x71, 0xF7, 0x0B,
+  0xDB, 0xE4, 0x98, 0x1C, 0x92, 0x9F, 0xC1, 0x4C, 0x37, 0x08, 0x9A, 0xB8, 0x06, 0x41, 0xF3, 0xD0,
+  0x20, 0xA8, 0x5A, 0x3F, 0xF2, 0xEA, 0x41, 0x00, 0x8C, 0xC3, 0x7C, 0x9F, 0x04, 0x47, 0xB6, 0x5A,
+  0x2D, 0x7D, 0xBA, 0x32, 0x8A, 0x57, 0xFF, 0x39, 0x72, 0x87, 0x58, 0x6E, 0xC2, 0x4D, 0x76, 0xE0,
+  0x11, 0xEB, 0x25, 0x0D, 0xC4, 0x17, 0x9E, 0xC5, 0x15, 0x01, 0x06, 0xF1, 0x4D, 0x86, 0xC9, 0x45,
+  0xE4, 0x78, 0x24, 0x61, 0x34, 0x10, 0x4B, 0x4D, 0x63, 0xF0, 0x43, 0x55, 0x22, 0xB0, 0xA1, 0xD3,
+  0x55, 0x28, 0x5E, 0x41, 0x83, 0x09, 0xB9, 0xD6, 0x96, 0x85, 0x14, 0x8E, 0x1F, 0x07, 0x74, 0xA8,
+  0x4D, 0xC7, 0x08, 0x65, 0x94, 0xD2, 0x05, 0xC4, 0x83, 0x01, 0xFD, 0xBC, 0x8C, 0xA2, 0xE0, 0x17,
+  0xBE, 0x52, 0x55, 0x16, 0x9E, 0xFC, 0x29, 0xA9, 0xB1, 0xA9, 0x39, 0x3C, 0x2C, 0x0A, 0x3D, 0x2A,
+  0xBF, 0xB2, 0x15, 0x9C, 0x38, 0x06, 0xF8, 0xFF, 0x3A, 0xBE, 0xBE, 0x6A, 0x2D, 0xF1, 0x5D, 0x6E,
+  0x31, 0x6F, 0xA8, 0x0C, 0x44, 0x68, 0x30, 0xAC, 0xC5, 0xF3, 0xE6, 0x78, 0x56, 0x64, 0x50, 0xCF,
+  0x09, 0x09, 0x5D, 0xF9, 0xE8, 0x27, 0xE2, 0x3A, 0xA9, 0x3B, 0xAF, 0x81, 0xF3, 0xFC, 0xE5, 0x49,
+  0xB4, 0x66, 0x7F, 0x81, 0x3A, 0x1F, 0x96, 0x9E, 0x93, 0xE2, 0xAB, 0xCE, 0xB2, 0xE2, 0x18, 0x93,
+  0x1A, 0x12, 0xDC, 0x07, 0x40, 0xDD, 0x21, 0xFC, 0x39, 0x00, 0xE0, 0xF0, 0xF7, 0xFB, 0xEF, 0xD5,
+  0xAD, 0x97, 0x06, 0x67, 0x79, 0xE4, 0x5E, 0x25, 0xDF, 0x13, 0x5F, 0x8B, 0xD0, 0x00, 0x22, 0xDF,
+  0xE3, 0xCF, 0x7E, 0xB3, 0xFB, 0x11, 0xBA, 0xAB, 0xA8, 0x35, 0xAA, 0xC3, 0xCD, 0x50, 0xC1, 0x72,
+  0x0B, 0x70, 0xFC, 0x1D, 0x14, 0x0D, 0xD0, 0x50, 0xC3, 0x4A, 0x54, 0x11, 0xE5, 0x69, 0xEA, 0x36,
+  0x58, 0xB9, 0x1F, 0xBE, 0x15, 0x9E, 0xFC, 0x48, 0x60, 0x51, 0x18, 0xC5, 0x4E, 0x63, 0x14, 0xA6,
+  0xB5, 0x6D, 0xB7, 0xA9, 0x9C, 0x19, 0x9E, 0x18, 0x42, 0x39, 0x82, 0x45, 0x76, 0x3A, 0xE4, 0xF7,
+  0xBF, 0x67, 0x30, 0x61, 0x49, 0x74, 0x3F, 0xEA, 0x1A, 0x59, 0x0E, 0xB1, 0x6B, 0x68, 0x9C, 0x94,
+  0xC6, 0x6E, 0x49, 0x19, 0xBB, 0x35, 0x38, 0xDB, 0x24, 0x69, 0x0C, 0xD8, 0xFA, 0xD3, 0xC7, 0x1A,
+  0x6F, 0xAF, 0xCB, 0x8D, 0xE8, 0xAC, 0x9D, 0xB5, 0x62, 0x91, 0xEA, 0x0E, 0x55, 0x55, 0xAD, 0xCA,
+  0x05, 0x4C, 0xDE, 0x2D, 0x60, 0xAC, 0xF7, 0x5D, 0xCE, 0xC6, 0x8E, 0xE7, 0x81, 0x62, 0xB5, 0x0F,
+  0xDB, 0x27, 0x88, 0x3B, 0x5F, 0xB1, 0xF5, 0x6B, 0xE4, 0x87, 0x35, 0xD8, 0x4F, 0xB5, 0x2E, 0x8F,
+  0xB9, 0x01, 0xFC, 0x2E, 0x69, 0xF2, 0xF4, 0xE6, 0x55, 0x2A, 0x30, 0x2B, 0x0C, 0xBE, 0x1F, 0xFD,
+  0xF8, 0xE1, 0xF6, 0x18, 0x6B, 0x83, 0xAF, 0xD5, 0x5B, 0x08, 0xF1, 0x97, 0x93, 0xDB, 0xEB, 0x7F,
+  0x3B, 0xBF, 0x85, 0x13, 0xA8, 0x3E, 0x24, 0xF8, 0xD9, 0x02, 0x50, 0x98, 0xF7, 0x34, 0x6E, 0xCD,
+  0x41, 0xA9, 0x2C, 0x7E, 0xC3, 0xCF, 0x17, 0xEC, 0xEF, 0xED, 0xED, 0x0D, 0xD8, 0x97, 0x0B, 0x80,
+  0x6B, 0xB3, 0x25, 0x65, 0x91, 0x6D, 0x9F, 0x38, 0xC9, 0x3D, 0xD0, 0x85, 0xE9, 0x17, 0x50, 0xAA,
+  0xE4, 0x7C, 0x7C, 0xD3, 0xEF, 0xF1, 0xEA, 0x1F, 0xE8, 0x5D, 0x54, 0x1C, 0xEC, 0x1C, 0x83, 0xC7,
+  0x06, 0x16, 0xC3, 0x58, 0x31, 0x16, 0xDA, 0x78, 0x65, 0x2B, 0x78, 0xCC, 0xE0, 0xD5, 0x2A, 0xE3,
+  0xD1, 0xDD, 0x79, 0x7B, 0x74, 0x56, 0x61, 0x5C, 0xEA, 0x90, 0x55, 0xE8, 0xA7, 0xAC, 0x5C, 0x08,
+  0xCF, 0x89, 0x9F, 0xD2, 0x7A, 0x8B, 0xDC, 0x45, 0x4B, 0xDF, 0x4D, 0xF6, 0xC9, 0xDD, 0xF5, 0xCD,
+  0xE8, 0xF4, 0x97, 0x93, 0xE3, 0xF1, 0x79, 0xDB, 0x5D, 0x78, 0x0D, 0xD2, 0xE6, 0x95, 0x15, 0xD0,
+  0xA4, 0x52, 0x73, 0xF2, 0x6A, 0xE4, 0x2F, 0xA3, 0x33, 0xC4, 0xAB, 0x9A, 0x6B, 0xD4, 0x7C, 0xAA,
+  0xD1, 0x81, 0xE8, 0x9D, 0x06, 0x3E, 0x17, 0xD8, 0x10, 0x22, 0xFA, 0xBC, 0x2B, 0xC5, 0x65, 0xC1,
+  0xBB, 0x30, 0x66, 0xB0, 0x66, 0xF1, 0x6E, 0x26, 0xEF, 0xC9, 0x95, 0x2F, 0xBA, 0x3D, 0xFC, 0x35,
+  0xE6, 0x7D, 0xC2, 0x37, 0x47, 0x96, 0xAB, 0x64, 0x0E, 0x78, 0x4F, 0x1E, 0x15, 0x22, 0x81, 0xA4,
+  0xB6, 0x79, 0x09, 0x9C, 0xD4, 0xD8, 0xE9, 0x8A, 0xB1, 0xFE, 0x2C, 0x8C, 0x18, 0x91, 0xA8, 0x13,
+  0x3E, 0xCC, 0xFD, 0x80, 0xD6, 0xE5, 0xAA, 0x01, 0x1A, 0x84, 0x68, 0x15, 0xBB, 0xB4, 0xB0, 0x4F,
+  0xD6, 0x95, 0xED, 0x87, 0x77, 0xBD, 0x8A, 0xDF, 0x46, 0x57, 0xA3, 0xBB, 0xD1, 0xF1, 0xC5, 0xE8,
+  0x3F, 0x5E, 0xC9, 0x6B, 0x0F, 0x7E, 0xE8, 0x45, 0x0F, 0x2D, 0x10, 0xA3, 0x73, 0xC4, 0xF5, 0x02,
+  0x0C, 0x2E, 0x0D, 0x69, 0x8C, 0x7E, 0xA2, 0xE3, 0x81, 0x84, 0x38, 0xC9, 0x63, 0xE8, 0x12, 0x50,
+  0x53, 0x87, 0x47, 0x52, 0x09, 0x99, 0x32, 0x9B, 0xEB, 0xEE, 0x31, 0xE7, 0x29, 0x8D, 0x8E, 0xB5,
+  0x40, 0xA1, 0x78, 0x7D, 0x9F, 0x00, 0xE7, 0x60, 0xF5, 0x11, 0x08, 0x09, 0x94, 0xC5, 0x5A, 0xB4,
+  0x97, 0x71, 0xAB, 0x80, 0xA3, 0xB2, 0x87, 0xF3, 0xE0, 0xC0, 0xF8, 0x29, 0x05, 0x7B, 0xC1, 0x99,
+  0x1A, 0x94, 0x9A, 0x66, 0xC2, 0xE4, 0x60, 0x55, 0x47, 0x66, 0x4A, 0x41, 0x91, 0x03, 0xD4, 0x04,
+  0x72, 0x6C, 0x83, 0x9D, 0x80, 0xA2, 0x0C, 0x45, 0x21, 0xFA, 0x02, 0x0E, 0xA9, 0x56, 0x6C, 0xC6,
+  0xD3, 0x57, 0x16, 0x92, 0x9A, 0x90, 0xD0, 0x20, 0xA1, 0xCA, 0xB2, 0x40, 0x80, 0xAB, 0x28, 0x47,
+  0x87, 0xFC, 0xE3, 0x3F, 0xFF, 0x87, 0xB8, 0x73, 0xEA, 0xDE, 0x17, 0x4D, 0xFB, 0xB3, 0xCD, 0x37,
+  0x87, 0xFA, 0x8B, 0xEF, 0x55, 0x0D, 0x1D, 0x5E, 0xB0, 0xE1, 0x3A, 0x01, 0x59, 0xB7, 0x6A, 0xA9,
+  0x33, 0xDA, 0x7C, 0x48, 0xB0, 0x5A, 0xCB, 0x57, 0xDF, 0x9A, 0x4E, 0x9B, 0x48, 0x62, 0x21, 0xCA,
+  0x1A, 0x1B, 0xAA, 0xDD, 0x18, 0xA8, 0xD6, 0x5B, 0xCC, 0x5D, 0x45, 0x0E, 0x44, 0x76, 0x04, 0xC3,
+  0x0D, 0x46, 0xA0, 0xAA, 0x2D, 0x0E, 0xEA, 0x1D, 0x6B, 0xEC, 0x5C, 0x8E, 0x60, 0xBE, 0x72, 0xB5,
+  0x02, 0x35, 0x3B, 0xBF, 0x66, 0x60, 0xBB, 0x61, 0xA0, 0x82, 0xD1, 0x5D, 0x8E, 0xA7, 0x7A, 0x2E,
+  0x88, 0x3F, 0x9E, 0xDF, 0x91, 0xB6, 0xB3, 0xF4, 0x85, 0xCA, 0x42, 0x0D, 0x80, 0x6C, 0xBC, 0x84,
+  0x13, 0xA9, 0x72, 0x56, 0x9D, 0x47, 0x49, 0x3A, 0x04, 0x75, 0x82, 0x94, 0x4F, 0xE7, 0x0E, 0xD8,
+  0xEA, 0x24, 0xAC, 0xB2, 0x0B, 0x13, 0x8C, 0xD7, 0x19, 0x20, 0x2E, 0x31, 0xD2, 0xDA, 0x1B, 0xBC,
+  0x2B, 0x29, 0x83, 0x67, 0x87, 0x67, 0xCE, 0x3E, 0x48, 0xB0, 0x8C, 0x21, 0xB2, 0x74, 0xA3, 0x80,
+  0x7C, 0x07, 0x8E, 0x53, 0x15, 0xBF, 0x51, 0xB3, 0x0F, 0x76, 0x2A, 0xA6, 0xE9, 0x2A, 0x0E, 0xA5,
+  0x5E, 0x33, 0xDD, 0x33, 0xCE, 0x3F, 0x31, 0x4D, 0x74, 0x39, 0xA9, 0x55, 0x15, 0x1C, 0x80, 0x2C,
+  0x5F, 0xC0, 0xDD, 0x02, 0x2E, 0x84, 0xA3, 0x0D, 0x23, 0x0C, 0x74, 0x63, 0x5A, 0x65, 0x58, 0xAB,
+  0x4C, 0xF4, 0x1D, 0x40, 0x69, 0x45, 0xF7, 0x96, 0x25, 0x25, 0x9B, 0xCA, 0x45, 0x70, 0xE8, 0xAF,
+  0x49, 0x14, 0xAA, 0x82, 0xA2, 0x69, 0xEE, 0xA4, 0xC5, 0xB4, 0xEF, 0x89, 0x03, 0x7C, 0xF0, 0xB7,
+  0xBF, 0x69, 0xB0, 0x04, 0xF8, 0x44, 0xBC, 0xE0, 0x3F, 0xF2, 0xF4, 0x01, 0xC2, 0x33, 0x24, 0xCC,
+  0x35, 0x34, 0x27, 0x29, 0xC3, 0x0C, 0x83, 0xCD, 0xB4, 0x4E, 0xDC, 0x1C, 0xA3, 0x7D, 0x38, 0x17,
+  0x97, 0x96, 0xC0, 0x07, 0x27, 0x98, 0xFB, 0x25, 0xF9, 0x59, 0x0A, 0x5E, 0x68, 0xE0, 0xA1, 0xE2,
+  0x35, 0x8E, 0xE0, 0x11, 0xBF, 0x4D, 0x14, 0xCE, 0x68, 0xA2, 0xFB, 0x67, 0x9A, 0x32, 0xD0, 0xCE,
+  0xEB, 0x3B, 0xA1, 0x2D, 0xD9, 0x22, 0x5C, 0xD1, 0x67, 0x24, 0x93, 0xFE, 0x8C, 0x66, 0x02, 0xE8,
+  0x03, 0x51, 0xC6, 0xC2, 0xC9, 0x70, 0x83, 0x52, 0xCD, 0x95, 0x66, 0x3E, 0xDE, 0xA2, 0x83, 0xE5,
+  0x19, 0x22, 0x41, 0x14, 0x05, 0x4C, 0x74, 0x73, 0xA2, 0x78, 0xE6, 0xB4, 0x85, 0x77, 0x2F, 0x94,
+  0x93, 0x59, 0x31, 0x6F, 0x5A, 0x48, 0x4C, 0x3E, 0x2B, 0x57, 0x62, 0x5B, 0x6E, 0xC5, 0xA3, 0x41,
+  0xEA, 0xD8, 0x76, 0xC2, 0xD9, 0xC3, 0xDB, 0xB0, 0x0D, 0x46, 0x3D, 0x65, 0xD3, 0x70, 0xEC, 0x5E,
+  0x6B, 0x89, 0x17, 0xAE, 0x90, 0xE3, 0xF3, 0x0E, 0xD6, 0x66, 0xD2, 0x94, 0x90, 0xEB, 0xC9, 0xAF,
+  0x70, 0x22, 0x2D, 0x50, 0x0F, 0x60, 0x7D, 0x15, 0x34, 0x1A, 0xC4, 0x7B, 0x19, 0xAE, 0xC0, 0x35,
+  0x77, 0x20, 0xDA, 0x59, 0xFC, 0x19, 0x53, 0x71, 0xE8, 0x09, 0xDA, 0x2E, 0x30, 0x4C, 0x34, 0x98,
+  0x0E, 0xC1, 0xB7, 0x61, 0xF7, 0x47, 0x48, 0x76, 0x0E, 0xE0, 0xFC, 0xE0, 0x6D, 0xF9, 0xA4, 0x48,
+  0x2F, 0xE0, 0xB6, 0x38, 0x8E, 0x30, 0x4A, 0x12, 0x96, 0xD2, 0x62, 0xEF, 0xC9, 0x93, 0xE9, 0x68,
+  0x56, 0xD0, 0xA1, 0x6A, 0x1E, 0x91, 0x4C, 0xC9, 0xB7, 0x51, 0xE3, 0xE6, 0xAE, 0x96, 0xDA, 0x23,
+  0x1A, 0x49, 0x0D, 0x15, 0x12, 0x7A, 0x5C, 0xE4, 0x9E, 0xD2, 0x25, 0xB7, 0xA1, 0xF8, 0x8A, 0x77,
+  0x5D, 0x67, 0x61, 0x29, 0x80, 0xEF, 0xA3, 0xB8, 0xE6, 0x7B, 0x85, 0x90, 0x11, 0x14, 0x2D, 0x04,
+  0x69, 0xC4, 0xF7, 0x5A, 0x78, 0xE7, 0x79, 0x84, 0x17, 0xFB, 0xAE, 0xA7, 0xC0, 0x9E, 0xB9, 0x9E,
+  0xCC, 0x24, 0x95, 0x8D, 0x3C, 0x80, 0xB8, 0xF6, 0x07, 0x22, 0x8D, 0x51, 0x9B, 0x85, 0x14, 0x1E,
+  0x88, 0xF9, 0x07, 0x7C, 0xC5, 0xFC, 0x14, 0xD6, 0xA9, 0xD5, 0xD5, 0x8A, 0x99, 0xFA, 0x6F, 0xBF,
+  0x38, 0x2F, 0x59, 0x4D, 0x78, 0x40, 0x50, 0x83, 0xD8, 0x9B, 0xAD, 0xC0, 0x7C, 0xF2, 0x62, 0x37,
+  0x5F, 0xFD, 0x7B, 0xD2, 0xAD, 0xEB, 0x6B, 0x0D, 0xAD, 0x71, 0x95, 0x71, 0x1F, 0xCB, 0xC0, 0xD9,
+  0x47, 0x16, 0xDD, 0x60, 0x8A, 0xD8, 0xAD, 0xB1, 0xAA, 0x88, 0x95, 0x5A, 0xB0, 0x87, 0x85, 0xEE,
+  0x6C, 0x20, 0xBD, 0x78, 0x80, 0x7B, 0x80, 0xE1, 0x6D, 0x2E, 0x04, 0x4A, 0xBC, 0xC2, 0x8D, 0x90,
+  0x83, 0x21, 0x93, 0xAF, 0x58, 0xD6, 0xEC, 0xE2, 0x9D, 0x1F, 0xA2, 0xBA, 0xF2, 0xC1, 0x21, 0xBA,
+  0x8C, 0xC0, 0x89, 0x8E, 0xE2, 0xBA, 0x6A, 0x9B, 0x74, 0xBE, 0x7F, 0xB2, 0x38, 0x44, 0xBE, 0x37,
+  0xDC, 0x2E, 0x00, 0xCB, 0x1D, 0x86, 0x06, 0x4C, 0x92, 0x6B, 0xBC, 0xC0, 0x18, 0x63, 0x2A, 0x12,
+  0x54, 0xA1, 0x61, 0x8F, 0x55, 0x47, 0x40, 0xC2, 0xFF, 0x4A, 0x41, 0x94, 0xB8, 0x5D, 0xF9, 0x72,
+  0x58, 0xA6, 0x2E, 0x67, 0xBB, 0xCC, 0x6C, 0x8E, 0xC9, 0x19, 0x13, 0x34, 0x54, 0x87, 0xAA, 0x0D,
+  0x03, 0xED, 0xA4, 0x49, 0x90, 0x9C, 0x29, 0x0D, 0x71, 0x16, 0x75, 0xC0, 0xBF, 0x43, 0x0E, 0x00,
+  0x19, 0x18, 0x02, 0x9E, 0xAA, 0x36, 0x44, 0x6A, 0x00, 0x39, 0x44, 0xA8, 0x92, 0xA1, 0xB6, 0x03,
+  0x36, 0xF6, 0xE2, 0xCF, 0x77, 0xEA, 0xC0, 0xE0, 0x41, 0x46, 0x74, 0x05, 0xC7, 0x27, 0xFF, 0x9C,
+  0x14, 0xBA, 0x3D, 0xF6, 0xBB, 0xA0, 0xC5, 0x10, 0x59, 0x1F, 0xC7, 0x68, 0x2D, 0xC2, 0x49, 0x18,
+  0x2D, 0x5D, 0x3D, 0x6D, 0x63, 0x2E, 0x0B, 0xBA, 0x46, 0x2C, 0xBA, 0xCA, 0x38, 0x0B, 0x5F, 0xC8,
+  0x6C, 0xA2, 0xA8, 0x5E, 0x3A, 0xE9, 0xBC, 0x15, 0x3B, 0x60, 0x11, 0x41, 0x4C, 0x40, 0x40, 0xC7,
+  0x5C, 0x68, 0xBB, 0xBB, 0x75, 0x21, 0xC2, 0xF8, 0xC6, 0xD9, 0x6E, 0x0E, 0x52, 0x8B, 0xE2, 0xD8,
+  0xB7, 0xF6, 0x04, 0x1E, 0x35, 0x25, 0xD4, 0x6D, 0xA8, 0xA6, 0x45, 0xAC, 0xBE, 0x2F, 0x9F, 0x1A,
+  0x4A, 0x1F, 0x84, 0x5F, 0xFB, 0x2C, 0x80, 0x6F, 0x98, 0xFE, 0xFA, 0x9D, 0xBF, 0xA0, 0xD1, 0x8A,
+  0x7F, 0xD2, 0xAE, 0xD3, 0x69, 0x28, 0xD2, 0x25, 0x06, 0xDC, 0x80, 0x04, 0x46, 0x1E, 0xFB, 0x2E,
+  0x9C, 0xEC, 0x7E, 0xB2, 0x6D, 0x14, 0x14, 0xBB, 0xA4, 0x36, 0x1A, 0x3F, 0xC3, 0xF6, 0xD9, 0x8F,
+  0x85, 0x3B, 0xA3, 0xA7, 0xF2, 0xB3, 0x5C, 0x18, 0x06, 0x70, 0x3D, 0xC0, 0xDD, 0xEB, 0x02, 0x37,
+  0x15, 0x8E, 0x08, 0x26, 0xE9, 0x27, 0xA4, 0xA7, 0x2A, 0x8C, 0x3D, 0x22, 0xB1, 0xDD, 0xD8, 0x9F,
+  0xD0, 0x9A, 0xC2, 0x73, 0x5B, 0x0D, 0x05, 0x96, 0xB3, 0x6C, 0x82, 0x1B, 0xFD, 0xEC, 0x2E, 0x27,
+  0x33, 0xD2, 0x32, 0x86, 0xAF, 0x1A, 0x21, 0x41, 0x39, 0xD5, 0x16, 0x10, 0xED, 0xA1, 0xE3, 0x0C,
+  0x54, 0x63, 0x6B, 0x35, 0x88, 0x68, 0x31, 0x68, 0x68, 0x4F, 0x39, 0xA2, 0xFB, 0xA0, 0xBB, 0x14,
+  0x62, 0x76, 0xCE, 0x67, 0xF5, 0x42, 0x02, 0x92, 0xAD, 0xC3, 0x72, 0x8F, 0x2A, 0x21, 0x34, 0xE8,
+  0x05, 0x4F, 0xA4, 0xAE, 0x7B, 0x0D, 0x86, 0xDB, 0x22, 0xE3, 0x19, 0x0B, 0x78, 0x24, 0x9E, 0x05,
+  0x36, 0xBB, 0xFB, 0x1A, 0xB1, 0x4F, 0x14, 0xB1, 0xB1, 0x53, 0x07, 0xE6, 0x9B, 0x03, 0x37, 0x87,
+  0x32, 0x2C, 0x74, 0xF6, 0xC1, 0x6F, 0x9D, 0x4E, 0x11, 0x94, 0x1E, 0x07, 0xA9, 0xA7, 0x25, 0x32,
+  0x3A, 0x28, 0x55, 0xD9, 0xD8, 0x86, 0x58, 0x54, 0x9F, 0xF2, 0xF4, 0xC6, 0xF6, 0x6C, 0x77, 0xB9,
+  0x73, 0xF0, 0x27, 0x8E, 0x97, 0x1D, 0x1C, 0xE7, 0xDE, 0xE2, 0x39, 0x14, 0x97, 0x7B, 0xDA, 0xC8,
+  0x1D, 0xCC, 0x5D, 0x62, 0xEE, 0x64, 0x1C, 0xAF, 0x17, 0x2A, 0x93, 0x32, 0xCA, 0x97, 0x19, 0x39,
+  0x10, 0x0B, 0x07, 0x33, 0xC9, 0x61, 0xBD, 0x7C, 0xCF, 0xF0, 0xD8, 0x12, 0xFB, 0x36, 0x37, 0xBB,
+  0x46, 0xEC, 0x83, 0x28, 0xA1, 0x5B, 0x0B, 0xBD, 0xD0, 0xC5, 0xB7, 0x34, 0xFF, 0xAD, 0x29, 0xE1,
+  0xF2, 0x75, 0xA4, 0x56, 0xFA, 0xAA, 0x6B, 0x7D, 0x05, 0x6B, 0x3C, 0x3E, 0xBF, 0x52, 0x6E, 0xBD,
+  0xFC, 0x34, 0x3A, 0x66, 0x1A, 0xE9, 0x2B, 0x18, 0xE5, 0xAC, 0x20, 0xC8, 0xF2, 0x83, 0xF4, 0x73,
+  0x1A, 0x3B, 0x46, 0x98, 0xA5, 0x58, 0x0A, 0x30, 0xC5, 0xCA, 0xCF, 0xFC, 0x03, 0x8D, 0x25, 0xDE,
+  0xD7, 0x55, 0x94, 0x92, 0x9C, 0x5D, 0x6C, 0x1A, 0xD6, 0x09, 0x43, 0x18, 0x83, 0x5B, 0x60, 0x8A,
+  0x39, 0xD4, 0x26, 0x14, 0x59, 0xD9, 0xF4, 0xC8, 0xF2, 0xEF, 0x92, 0x92, 0xA5, 0xF3, 0x88, 0x99,
+  0x30, 0x50, 0x53, 0x10, 0x62, 0x2F, 0xD0, 0x4A, 0x81, 0x43, 0xF0, 0xA4, 0xFA, 0x8B, 0x02, 0x37,
+  0x3D, 0x7A, 0x11, 0xD3, 0x32, 0xCC, 0x0D, 0x8B, 0xBB, 0x48, 0x66, 0x99, 0xDE, 0xCB, 0x93, 0xE6,
+  0x62, 0x8A, 0xDC, 0x96, 0x42, 0x90, 0xE5, 0x6A, 0x12, 0xF8, 0xC9, 0xBC, 0x96, 0x79, 0x24, 0x0D,
+  0x84, 0x50, 0xCC, 0x8E, 0xB3, 0xD7, 0x27, 0x99, 0xF8, 0x26, 0x33, 0xC3, 0x96, 0x28, 0xD4, 0x13,
+  0x15, 0x7A, 0xA4, 0x8E, 0x18, 0x0E, 0x28, 0x7D, 0x25, 0x66, 0x62, 0x25, 0x42, 0x2C, 0x8A, 0x89,
+  0x2B, 0xD0, 0x5F, 0x85, 0x8F, 0xC4, 0xAD, 0xCF, 0x70, 0xB5, 0x30, 0x9D, 0x3A, 0xFC, 0xB8, 0x8F,
+  0xAC, 0xC9, 0x40, 0x3F, 0x69, 0x92, 0xBC, 0x2E, 0xA3, 0x97, 0xEE, 0xA0, 0x37, 0xEB, 0x98, 0xFB,
+  0xB3, 0x79, 0x80, 0xEF, 0x13, 0xE5, 0x70, 0x25, 0x99, 0xF4, 0x1B, 0x96, 0x78, 0xD5, 0x00, 0x73,
+  0x2B, 0xB0, 0xCE, 0x3E, 0x5B, 0xEC, 0xA9, 0xA4, 0x24, 0x81, 0x54, 0xC4, 0xF5, 0xB1, 0xE8, 0x90,
+  0xB0, 0x2B, 0xD8, 0xE8, 0x12, 0xFC, 0xD7, 0x7F, 0xB3, 0x0E, 0x9C, 0xB8, 0xAE, 0x1A, 0x21, 0x51,
+  0xB5, 0x6C, 0xEC, 0xB9, 0x85, 0xA3, 0xF5, 0x05, 0xB2, 0x93, 0x34, 0x14, 0x85, 0xA2, 0xA2, 0xE3,
+  0xCF, 0xC9, 0xA5, 0xE8, 0x17, 0x85, 0xC5, 0x11, 0xB5, 0x23, 0xD2, 0x79, 0xF6, 0x42, 0x88, 0x81,
+  0x99, 0xF0, 0xB3, 0xAF, 0xF3, 0x4A, 0xC6, 0xCB, 0x2F, 0xB8, 0x7E, 0x05, 0x8E, 0x2B, 0xDC, 0x26,
+  0xB4, 0x72, 0xDD, 0xE6, 0xB2, 0x9C, 0xBC, 0x94, 0x5A, 0x35, 0x0B, 0x73, 0x66, 0x55, 0xD9, 0xCE,
+  0x98, 0x9D, 0x67, 0xB3, 0x65, 0xA1, 0x08, 0xA9, 0x5C, 0x97, 0xF8, 0xEA, 0x48, 0xE4, 0xB7, 0x58,
+  0x96, 0x0B, 0xB6, 0x1D, 0xD6, 0x6D, 0xDD, 0xD0, 0x4B, 0x8F, 0xF5, 0xC3, 0xCD, 0xD9, 0xF1, 0xDD,
+  0x79, 0xF6, 0x16, 0xD5, 0xD9, 0x68, 0x7C, 0x73, 0x71, 0xFC, 0x97, 0xAF, 0x70, 0xC2, 0x9A, 0x37,
+  0x98, 0x98, 0xA4, 0xC1, 0x17, 0xA8, 0xD6, 0x64, 0x11, 0xE4, 0xAB, 0x54, 0x5A, 0x98, 0x0C, 0xF3,
+  0xF8, 0x8B, 0xE2, 0x1B, 0x67, 0xF2, 0x2A, 0x75, 0x6E, 0x12, 0x58, 0x7E, 0xBF, 0x25, 0xBE, 0x5F,
+  0xA9, 0x8B, 0x58, 0xCA, 0x85, 0xE7, 0x0A, 0x3F, 0x8B, 0x76, 0x98, 0x65, 0xA8, 0xE4, 0x0B, 0x5E,
+  0x62, 0x8A, 0x92, 0x79, 0x65, 0x3B, 0x30, 0x4A, 0xDF, 0xD5, 0x5B, 0x63, 0x58, 0x21, 0x79, 0xBF,
+  0x69, 0x1D, 0xF1, 0x4D, 0xCC, 0x4D, 0xEB, 0x8C, 0x0B, 0xC3, 0x4A, 0xD8, 0x7C, 0x0D, 0xA3, 0x3F,
+  0x29, 0xA9, 0xBB, 0xF7, 0x22, 0xB1, 0x1B, 0xA7, 0x6D, 0xF6, 0x21, 0x8E, 0x84, 0xFE, 0xB6, 0xA2,
+  0xA1, 0x4B, 0x31, 0xBB, 0xB2, 0x8C, 0xA3, 0x59, 0x0C, 0xBE, 0x1E, 0xA9, 0x01, 0x11, 0x64, 0x0E,
+  0x5F, 0xF8, 0xD3, 0xFC, 0x47, 0x7E, 0x8F, 0xA8, 0xAE, 0x11, 0x1A, 0xC0, 0x8C, 0x53, 0xCC, 0xAA,
+  0x19, 0x0A, 0xAD, 0x88, 0xD3, 0xF7, 0x80, 0x14, 0xA9, 0xB1, 0xEA, 0x72, 0x4B, 0x2E, 0x8E, 0x8A,
+  0x5C, 0x36, 0x21, 0x20, 0x99, 0xD4, 0x52, 0x40, 0x43, 0x53, 0xBD, 0x5A, 0xC0, 0x69, 0x9D, 0x8C,
+  0xFD, 0x84, 0xD7, 0xB5, 0xCC, 0x4B, 0x0B, 0xF8, 0xCD, 0x1D, 0x2C, 0xDD, 0x63, 0x5E, 0x8E, 0xFF,
+  0x00, 0x7B, 0xDD, 0x6C, 0x56, 0x37, 0xA6, 0x79, 0xB2, 0xB7, 0xC1, 0x2C, 0x20, 0xF9, 0xE7, 0xEA,
+  0x24, 0x50, 0xFE, 0x73, 0x4B, 0xB0, 0xB3, 0xB2, 0x7D, 0xCE, 0xD4, 0x7D, 0xCE, 0x94, 0x7D, 0xEA,
+  0x5E, 0x4F, 0xE4, 0xB1, 0x32, 0xC6, 0xCF, 0xD5, 0xF7, 0x7E, 0x90, 0x62, 0xBC, 0x5B, 0xE5, 0x97,
+  0x06, 0xE1, 0x41, 0x5C, 0x1F, 0x92, 0x4F, 0x3D, 0xF9, 0xD4, 0x97, 0x4F, 0x83, 0xEA, 0xC7, 0x8D,
+  0x5B, 0x14, 0xEF, 0x7B, 0x15, 0xF6, 0xC8, 0xD6, 0xFE, 0x39, 0x69, 0xE1, 0xDF, 0x8F, 0xAC, 0x1E,
+  0x81, 0xEF, 0x79, 0x89, 0x93, 0xC4, 0x46, 0x35, 0x69, 0x7C, 0xBC, 0x4A, 0xA3, 0xA6, 0x47, 0x53,
+  0x7C, 0x93, 0xEA, 0x61, 0xEE, 0x67, 0x17, 0xA5, 0xB3, 0xEF, 0xCC, 0x2D, 0x30, 0x96, 0x02, 0x4C,
+  0xDC, 0x55, 0x8C, 0x5F, 0x61, 0x92, 0x56, 0xC7, 0x10, 0x65, 0xBC, 0x6D, 0x21, 0x8E, 0xD0, 0xE0,
+  0x34, 0x2C, 0x76, 0x33, 0x18, 0x86, 0x58, 0x68, 0x36, 0xBE, 0xC3, 0x6C, 0xBC, 0xC5, 0xC4, 0xF3,
+  0x65, 0x58, 0x5E, 0xC6, 0x99, 0x24, 0x35, 0xBE, 0x44, 0x53, 0xDE, 0xE5, 0xF8, 0x58, 0x87, 0x59,
+  0x7D, 0x5C, 0x50, 0x59, 0xC4, 0xC7, 0xFC, 0xEA, 0x90, 0x4C, 0x62, 0xEA, 0xC8, 0x4F, 0x60, 0xEB,
+  0x21, 0x22, 0xC2, 0xCC, 0xC6, 0xC3, 0x7E, 0x71, 0xF3, 0xAA, 0xF8, 0x62, 0x02, 0x5F, 0x74, 0x1B,
+  0x21, 0xA4, 0x26, 0xE3, 0x62, 0x88, 0x1A, 0x93, 0x1A, 0xB2, 0x9E, 0x01, 0xB1, 0x95, 0xEA, 0x0A,
+  0xD7, 0x83, 0xF0, 0xC6, 0x1B, 0x08, 0x72, 0xAC, 0xE7, 0x78, 0xB1, 0x71, 0x8D, 0x96, 0x15, 0xD7,
+  0xE4, 0x94, 0x4B, 0x50, 0xD0, 0x60, 0x2A, 0x2B, 0x35, 0x55, 0x53, 0xD3, 0x2B, 0x55, 0x4A, 0xB1,
+  0xF9, 0x7B, 0xB9, 0xC9, 0x2A, 0xF9, 0x1B, 0xB9, 0x1D, 0x8F, 0x47, 0x72, 0x46, 0x0C, 0x7E, 0x3E,
+  0xE3, 0xA3, 0x1F, 0xC4, 0x5D, 0x13, 0xEF, 0x64, 0x51, 0x35, 0x26, 0x7C, 0x58, 0xA6, 0xFE, 0x42,
+  0x2C, 0x82, 0x1F, 0x08, 0x70, 0x52, 0xDE, 0x02, 0xD3, 0x57, 0xEC, 0x01, 0x01, 0x74, 0x4A, 0x6C,
+  0xB7, 0x3E, 0x81, 0xBA, 0x7A, 0xF4, 0x04, 0x0D, 0x70, 0xCC, 0xBB, 0x1D, 0x59, 0xCC, 0xC3, 0x06,
+  0xD8, 0x46, 0x9E, 0x74, 0xCC, 0x47, 0xF5, 0xF1, 0x15, 0x92, 0x6C, 0x1C, 0xE3, 0x9B, 0x69, 0x10,
+  0x45, 0x31, 0xF6, 0xB6, 0x11, 0x02, 0x4C, 0x5B, 0x54, 0x8D, 0x92, 0x80, 0x31, 0x8C, 0x83, 0x80,
+  0x81, 0x73, 0x22, 0x93, 0x82, 0xBC, 0x17, 0xBB, 0x7F, 0xC7, 0xBA, 0x4D, 0x58, 0xAF, 0xB5, 0xFD,
+  0x23, 0xF2, 0xC7, 0xF3, 0x8B, 0x9B, 0xF3, 0xDB, 0xAF, 0x15, 0x44, 0xF0, 0xB7, 0x4E, 0x3E, 0xE5,
+  0x74, 0xDC, 0xDE, 0xE7, 0xC1, 0xCB, 0x51, 0xC3, 0x2D, 0x66, 0xD9, 0xDE, 0x0F, 0xCA, 0xE7, 0x9A,
+  0x27, 0x6C, 0xBE, 0x25, 0x62, 0xB8, 0x21, 0xFC, 0x53, 0x42, 0x6B, 0x18, 0x5D, 0x7B, 0x03, 0xC4,
+  0x74, 0x46, 0xF0, 0x9E, 0xEE, 0x21, 0x87, 0xD1, 0x5A, 0xC6, 0xC0, 0xDE, 0xD1, 0x2A, 0x11, 0xB3,
+  0xC7, 0x3E, 0x44, 0x93, 0xE1, 0x2C, 0xFF, 0xF0, 0x0A, 0x8E, 0xC9, 0xBD, 0x74, 0xBE, 0x2D, 0xB3,
+  0x12, 0x80, 0x9F, 0x7C, 0xD5, 0xB1, 0x32, 0xE7, 0xE1, 0x07, 0x7C, 0x1C, 0x3F, 0x4C, 0xB2, 0x99,
+  0x52, 0x14, 0x7E, 0x20, 0xD5, 0x7F, 0xFC, 0xFD, 0x7F, 0xD7, 0xBC, 0xF9, 0x52, 0x7D, 0xA3, 0xD4,
+  0x91, 0xD6, 0xBF, 0x24, 0x53, 0x2D, 0x75, 0x74, 0x95, 0x14, 0x0A, 0xFA, 0x2F, 0xB4, 0xC1, 0x3E,
+  0x41, 0x51, 0x2C, 0x03, 0xC4, 0xEB, 0x48, 0x2A, 0xBE, 0xDA, 0xA0, 0xA0, 0x8D, 0xFF, 0x5D, 0x07,
+  0xD5, 0x37, 0x92, 0x9F, 0x7C, 0x60, 0xA6, 0x03, 0x17, 0xDA, 0xC8, 0x18, 0xF2, 0x8B, 0x0E, 0x05,
+  0xC6, 0xC0, 0x5F, 0x25, 0x08, 0xC9, 0x78, 0x1D, 0x23, 0x7D, 0x03, 0x89, 0xB5, 0xEE, 0x29, 0xBB,
+  0xFC, 0x9B, 0x23, 0x90, 0x9A, 0x86, 0x30, 0x99, 0xE5, 0x5D, 0x6B, 0xEF, 0x62, 0x00, 0x4D, 0x45,
+  0x8E, 0xBD, 0xC6, 0x33, 0x56, 0x69, 0x69, 0xB9, 0xA8, 0x41, 0xD8, 0x5B, 0x61, 0x76, 0x54, 0x44,
+  0xA4, 0xCC, 0x72, 0x12, 0x78, 0xFB, 0xC0, 0x38, 0x90, 0xE8, 0xF3, 0x3A, 0x6C, 0xF8, 0x45, 0x69,
+  0x93, 0xB9, 0xDD, 0x00, 0xFD, 0x88, 0xE8, 0x9E, 0xE7, 0x69, 0x21, 0xA0, 0x46, 0x1E, 0xE3, 0x5F,
+  0x80, 0xA9, 0x02, 0x0F, 0xD5, 0x44, 0x0F, 0x4B, 0xF3, 0x64, 0x5D, 0x34, 0x8E, 0xB1, 0xAF, 0x6A,
+  0xC2, 0x62, 0x7A, 0x98, 0x57, 0xF1, 0xCF, 0xE0, 0x34, 0x59, 0x91, 0x83, 0x5D, 0x1F, 0xA3, 0x88,
+  0x7D, 0x96, 0xFE, 0xCC, 0x3F, 0xC5, 0xF2, 0xB9, 0xE5, 0xE3, 0x7F, 0x2A, 0xE6, 0x8F, 0x77, 0x97,
+  0x17, 0xC8, 0x0F, 0xE6, 0x15, 0x6F, 0xFE, 0x21, 0x1B, 0x96, 0x55, 0x09, 0x98, 0x23, 0x58, 0x39,
+  0xFA, 0x19, 0x7F, 0xB1, 0x65, 0xE0, 0xE7, 0xC7, 0x2C, 0x41, 0x83, 0x3F, 0xF8, 0x0D, 0x6D, 0x6C,
+  0xD0, 0xE0, 0xAA, 0x2A, 0x1C, 0x3B, 0xD8, 0xD7, 0xAA, 0xC0, 0xD5, 0xC8, 0xEA, 0x92, 0x47, 0x04,
+  0x2F, 0x6F, 0x62, 0x0F, 0x3F, 0x86, 0x53, 0xEC, 0x67, 0x23, 0xB1, 0xD0, 0xCB, 0x7E, 0xD5, 0xB5,
+  0xCF, 0xA4, 0x88, 0xDB, 0xDF, 0x07, 0x6D, 0xFE, 0x81, 0x94, 0x83, 0x36, 0xFF, 0x8F, 0x3A, 0xFD,
+  0x3F, 0xA1, 0x55, 0x12, 0xB3, 0xE5, 0x69, 0x00, 0x00,
+};
 
 #endif // WEBUI_H
@@ -0,0 +1,742 @@
+/*
+ * =============================================
+ * PumpSimulator.h - Simulated IntelliFlo VS (transport-free)
+ * =============================================
+ *
+ * The pump's side of the protocol and its "physics", without a UART:
+ * valid frames come in through onFrame(), replies go out through the
+ * transmit callback, and time only moves when step(now) says so.
+ *
+ * Pump.ino wires it to the RS-485 port on the simulator ESP32;
+ * tools/bench runs several of them on a virtual bus on the host to
+ * load-test the Controller's transport (see tools/bench/bench.cpp).
+ *
+ * BEHAVIOR:
+ *   - Only answers frames addressed to its own address
+ *   - Remote/Local control (0x04), Mode (0x05), Run/Stop (0x06),
+ *     Status (0x07, full 15-byte reply), Register write (0x01)
+ *   - Mode changes are refused unless in remote control
+ *   - RPM ramps toward the target: +100 per step up, -150 down
+ *     (one step per SIM_STEP_MS). Power follows the affinity law
+ *     (watts ~ RPM^3, plus the drive's own draw), flow is ~ RPM
+ *   - driveState: ready, ramping while the speed changes, fault while
+ *     an error code is set. A faulted drive coasts to a stop and
+ *     ignores run commands until the error is cleared
+ *   - A selected external program sets the speed: direct RPM writes
+ *     are acked but ignored until it is deselected (EPRG_OFF). One not
+ *     re-selected within EXT_PROG_REPEAT_INTERVAL lapses and the
+ *     pump stops
+ *
+ * Replies go out setTurnaround() ms after the request (the drive's own
+ * response time, 0 by default), plus any injected delay.
+ *
+ * FAULTS (SimFaults, all off in the "clean" profile):
+ *   delay / jitter    extra turnaround: delay + 0..jitter ms
+ *   drop              % of replies never sent
+ *   truncate          % of replies cut off after a random byte
+ *   corrupt           % of replies with a bad checksum
+ *   garbage           % of replies preceded by 1..N noise bytes
+ *   broadcast         about every N ms, a status broadcast from another
+ *                     master (0x10 -> 0x0F) - traffic not for anyone
+ *
+ * SCRIPTING: command() takes one line, the same from the simulator's
+ * USB console, its /sim.txt at boot (Pump.ino) or a bench -f file:
+ *   profile clean|real|noisy|lossy|hostile
+ *   delay MS   jitter MS   drop %   truncate %   corrupt %
+ *   garbage % [MAX]   broadcast MS   error CODE (0 clears)   seed N
+ *   turnaround MS                     (not part of a profile)
+ *   faults                            settings + what was injected
+ *
+ * USAGE:
+ *   PumpSimulator pump;
+ *   pump.begin(ADDR_PUMP_1, transmit, ctx);     // transmit(ctx, frame, len)
+ *   pump.onFrame(frame, len, millis());         // every valid frame heard
+ *   pump.step(millis());                        // as often as msUntilStep() asks
+ *
+ * Debug output goes through Log.h as "[SIM 60] ..." (debug: decoded
+ * commands, trace: frames in hex); setVerbose(false) silences it.
+ */
+
+#ifndef PUMP_SIMULATOR_H
+#define PUMP_SIMULATOR_H
+
+#include <Arduino.h>
+#include "PentairProtocol.h"
+#include "Log.h"
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define SIM_STEP_MS          200    // Speed ramp step
+#define SIM_RAMP_UP_RPM      100    // Per step
+#define SIM_RAMP_DOWN_RPM    150    // Per step (decel is faster)
+#define SIM_CLOCK_STEP_MS    60000  // Simulated pump clock: one minute
+#define SIM_MAX_RPM          3450
+#define SIM_MAX_WATTS        2000   // Shaft power at SIM_MAX_RPM
+#define SIM_DRIVE_WATTS      15     // Electronics + losses, whenever the motor turns
+#define SIM_MAX_GPM          70     // Flow at SIM_MAX_RPM (depends on the plumbing)
+#define SIM_PENDING_MAX      4      // Delayed replies waiting to go out
+#define SIM_GARBAGE_MAX      16     // Noise bytes before one reply
+
+// Drive states besides DRIVE_READY. Picked for the simulator: real
+// drives report more, and their values aren't documented.
+#define SIM_DRIVE_RAMPING    0x01
+#define SIM_DRIVE_FAULT      0x04
+
+// Puts one reply frame on the bus
+typedef void (*SimTransmitFn)(void* ctx, const uint8_t* frame, size_t len);
+
+// =============================================
+// PUMP STATE (simulated IntelliFlo VS)
+// =============================================
+struct PumpState {
+  uint8_t  myAddress    = ADDR_PUMP_1;      // 0x60 - Our address
+  uint8_t  controlMode  = CTRL_LOCAL;        // Local or Remote
+  uint8_t  runState     = RUN_STOP;          // Running or stopped
+  uint8_t  mode         = MODE_FILTER;       // Current mode
+  uint8_t  driveState   = DRIVE_READY;       // Drive status
+  uint16_t currentRPM   = 0;                 // Actual current RPM
+  uint16_t targetRPM    = 0;                 // Target RPM
+  uint16_t powerWatts   = 0;                 // Power consumption
+  uint8_t  flowGPM      = 0;                 // Flow rate
+  uint8_t  ppcLevel     = 0;                 // PPC/chlorinator
+  uint8_t  errorCode    = 0x00;              // Error code (0 = no error)
+  uint8_t  timerMin     = 0;                 // Timer remaining
+  uint8_t  clockHour    = 0;                 // Clock hour
+  uint8_t  clockMin     = 0;                 // Clock minute
+
+  // External program RPM settings
+  uint16_t extProgRPM[5] = {0, 1000, 2000, 2500, 3450};  // Index 0 unused
+
+  // External program selection
+  uint16_t extProgSelect = EPRG_OFF;         // Which ext program is selected
+
+  // Speed presets (built-in)
+  uint16_t speedPreset[5] = {0, 750, 1500, 2350, 3110};   // Index 0 unused
+};
+
+// =============================================
+// FAULT INJECTION (see FAULTS above)
+// =============================================
+struct SimFaults {
+  uint16_t delayMs;
+  uint16_t jitterMs;
+  uint8_t  dropPct;
+  uint8_t  truncatePct;
+  uint8_t  corruptPct;
+  uint8_t  garbagePct;
+  uint8_t  garbageMax;          // Noise bytes, at most
+  uint16_t broadcastMs;         // 0 = off
+};
+
+struct SimProfile {
+  const char* name;
+  SimFaults   faults;
+};
+
+//                                           delay jitter drop trunc corrupt garbage max bcast
+const SimProfile SIM_PROFILES[] = {
+  { "clean",   SimFaults{  0,    0,   0,   0,   0,   0,  8,     0 } },
+  { "real",    SimFaults{  5,   10,   1,   0,   0,   2,  4,     0 } },   // A healthy install
+  { "noisy",   SimFaults{  5,   10,   2,   3,   5,  20, 12,  2000 } },   // Long run, no termination
+  { "lossy",   SimFaults{ 10,  150,  15,   5,   2,   5,  8,     0 } },   // Slow, flaky drive
+  { "hostile", SimFaults{ 20,  400,  20,  10,  10,  30, 16,   500 } },   // Everything at once
+};
+
+// What was actually injected
+struct SimFaultCounts {
+  uint32_t dropped = 0;
+  uint32_t truncated = 0;
+  uint32_t corrupted = 0;
+  uint32_t garbage = 0;         // Replies with noise in front
+  uint32_t broadcasts = 0;
+  uint32_t overflow = 0;        // Replies lost: too many delayed ones waiting
+};
+
+// =============================================
+// MODE NAME HELPER
+// =============================================
+inline const char* modeName(uint8_t mode) {
+  switch (mode) {
+    case MODE_FILTER:     return "Filter";
+    case MODE_MANUAL:     return "Manual";
+    case MODE_SPEED_1:    return "Speed 1";
+    case MODE_SPEED_2:    return "Speed 2";
+    case MODE_SPEED_3:    return "Speed 3";
+    case MODE_SPEED_4:    return "Speed 4";
+    case MODE_FEATURE_1:  return "Feature1";
+    case MODE_EXT_PROG_1: return "ExtPrg1";
+    case MODE_EXT_PROG_2: return "ExtPrg2";
+    case MODE_EXT_PROG_3: return "ExtPrg3";
+    case MODE_EXT_PROG_4: return "ExtPrg4";
+    default:              return "Unknown";
+  }
+}
+
+// =============================================
+// PumpSimulator CLASS
+// =============================================
+class PumpSimulator {
+private:
+  PumpState     _s;
+  SimTransmitFn _transmit = nullptr;
+  void*         _ctx = nullptr;
+  bool          _verbose = true;
+  char          _tag[8] = "SIM";        // "SIM 60": log tag with our address
+  unsigned long _lastStep = 0;
+  unsigned long _lastClock = 0;
+  unsigned long _nextBroadcast = 0;
+  unsigned long _extProgAt = 0;    // Last external program select
+  unsigned long _now = 0;          // Time of the frame being answered
+  uint16_t      _turnaroundMs = 0;
+  uint32_t      _replies = 0;
+  uint8_t       _tx[48];
+
+  SimFaults      _faults = SIM_PROFILES[0].faults;
+  SimFaultCounts _counts;
+  uint32_t       _rng = 1;
+
+  // A reply held back by delay / jitter, noise included
+  struct Pending {
+    bool          used = false;
+    unsigned long due;
+    uint8_t       len;
+    uint8_t       buf[SIM_GARBAGE_MAX + sizeof(_tx)];
+  };
+  Pending _pending[SIM_PENDING_MAX];
+
+  // Decode detail at LOG_DEBUG, unless silenced
+  template <typename... Args>
+  void log(const char* fmt, Args... args) {
+    if (_verbose) LOGD(_tag, fmt, args...);
+  }
+
+  // xorshift32: cheap, and repeatable for a given seed
+  uint32_t rand32() {
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    return _rng;
+  }
+  bool chance(uint8_t pct) { return pct && rand32() % 100 < pct; }
+
+  void send(const uint8_t* data, size_t len) {
+    if (_verbose) LOG_HEX(LOG_TRACE, _tag, "TX", data, len);
+    if (_transmit) _transmit(_ctx, data, len);
+  }
+
+  // Answer the frame being handled: faults applied, now or after the turnaround
+  void reply(size_t len) {
+    if (!len) return;
+    _replies++;
+    if (chance(_faults.dropPct)) {
+      _counts.dropped++;
+      log("[FAULT] reply dropped");
+      return;
+    }
+
+    Pending* p = nullptr;
+    for (Pending& slot : _pending) {
+      if (!slot.used) { p = &slot; break; }
+    }
+    if (!p) {
+      _counts.overflow++;
+      return;
+    }
+
+    size_t n = 0;
+    if (chance(_faults.garbagePct)) {
+      int noise = 1 + rand32() % (_faults.garbageMax ? _faults.garbageMax : 1);
+      if (noise > SIM_GARBAGE_MAX) noise = SIM_GARBAGE_MAX;
+      while (n < (size_t)noise) p->buf[n++] = rand32();
+      _counts.garbage++;
+      log("[FAULT] %d noise bytes first", noise);
+    }
+    memcpy(p->buf + n, _tx, len);
+    if (chance(_faults.corruptPct)) {
+      p->buf[n + len - 1] ^= 1 + rand32() % 255;
+      _counts.corrupted++;
+      log("[FAULT] checksum corrupted");
+    }
+    if (chance(_faults.truncatePct)) {
+      len = PENTAIR_PREAMBLE_LEN + 1 + rand32() % (len - PENTAIR_PREAMBLE_LEN - 1);
+      _counts.truncated++;
+      log("[FAULT] reply cut to %d bytes", (int)len);
+    }
+    p->len  = n + len;
+    p->due  = _now + _turnaroundMs + _faults.delayMs + (_faults.jitterMs ? rand32() % (_faults.jitterMs + 1) : 0);
+    p->used = true;
+    if (p->due == _now) sendDue(_now);
+  }
+
+  // Send every held reply whose turnaround is over, oldest first
+  void sendDue(unsigned long now) {
+    for (;;) {
+      Pending* next = nullptr;
+      for (Pending& p : _pending) {
+        if (p.used && (long)(now - p.due) >= 0 && (!next || (long)(p.due - next->due) < 0)) next = &p;
+      }
+      if (!next) return;
+      next->used = false;
+      send(next->buf, next->len);
+    }
+  }
+
+  // Another master's status broadcast (payload length as EasyTouch sends)
+  void broadcast() {
+    PentairFrameWriter w(_tx, sizeof(_tx));
+    w.begin(ADDR_BROADCAST, ADDR_MAIN_CONTROLLER_1, 0x02);
+    for (int i = 0; i < 29; i++) w.u8(i == 0 ? _s.clockHour : i == 1 ? _s.clockMin : 0);
+    _counts.broadcasts++;
+    send(_tx, w.finish());
+  }
+
+  // Drive state from run state, ramp and error
+  void updateDrive() {
+    if (_s.errorCode)                        _s.driveState = SIM_DRIVE_FAULT;
+    else if (_s.currentRPM != _s.targetRPM)  _s.driveState = SIM_DRIVE_RAMPING;
+    else                                     _s.driveState = DRIVE_READY;
+  }
+
+  // Trip (code != 0): motor coasts down and stays off; 0 clears the fault
+  void setError(uint8_t code) {
+    _s.errorCode = code;
+    if (code) {
+      _s.runState = RUN_STOP;
+      _s.targetRPM = 0;
+    }
+    updateDrive();
+    Serial.printf("[SIM] 0x%02X error %d%s\n", _s.myAddress, code, code ? " - drive tripped" : " (cleared)");
+  }
+
+  PentairFrameWriter answer(uint8_t dst, uint8_t cmd) {
+    PentairFrameWriter w(_tx, sizeof(_tx));
+    w.begin(dst, _s.myAddress, cmd);
+    return w;
+  }
+
+  // ---- Remote/Local Control (CMD 0x04) ----
+  void handleCtrl(uint8_t src, const PentairFrameView& cmd) {
+    if (!cmd.has(1)) return;
+
+    uint8_t oldMode = _s.controlMode;
+    _s.controlMode = cmd.u8(0);
+
+    log("CMD 0x04 CTRL: %s -> %s",
+        oldMode == CTRL_REMOTE ? "REMOTE" : "LOCAL",
+        _s.controlMode == CTRL_REMOTE ? "REMOTE" : "LOCAL");
+
+    // Send confirmation: echo back the control mode
+    reply(answer(src, CMD_CTRL).u8(_s.controlMode).finish());
+  }
+
+  // ---- Set Mode (CMD 0x05) ----
+  void handleMode(uint8_t src, const PentairFrameView& cmd) {
+    if (!cmd.has(1)) return;
+
+    // Only accept if in remote control mode
+    if (_s.controlMode != CTRL_REMOTE) {
+      log("REJECTED: Not in remote control mode");
+      return;
+    }
+
+    uint8_t oldMode = _s.mode;
+    _s.mode = cmd.u8(0);
+
+    log("CMD 0x05 MODE: %s -> %s", modeName(oldMode), modeName(_s.mode));
+
+    // Update target RPM based on mode
+    updateTargetFromMode();
+
+    // Send confirmation: echo back the mode
+    reply(answer(src, CMD_MODE).u8(_s.mode).finish());
+  }
+
+  // ---- Run/Stop (CMD 0x06) ----
+  void handleRun(uint8_t src, const PentairFrameView& cmd) {
+    if (!cmd.has(1)) return;
+
+    uint8_t oldState = _s.runState;
+    _s.runState = cmd.u8(0);
+    if (_s.errorCode && _s.runState == RUN_START) {
+      _s.runState = RUN_STOP;   // Drive in fault: the answer says so
+      log("REJECTED: drive fault (error %d)", _s.errorCode);
+    }
+
+    log("CMD 0x06 RUN: %s -> %s",
+        oldState == RUN_START ? "RUNNING" : "STOPPED",
+        _s.runState == RUN_START ? "RUNNING" : "STOPPED");
+
+    if (_s.runState == RUN_STOP) {
+      _s.targetRPM = 0;
+      // If stopped, reset mode to filter
+      if (_s.mode >= MODE_EXT_PROG_1 && _s.mode <= MODE_EXT_PROG_4) {
+        _s.mode = MODE_FILTER;
+      }
+    } else if (_s.runState == RUN_START) {
+      updateTargetFromMode();
+    }
+
+    // Send confirmation: echo back the run state
+    reply(answer(src, CMD_RUN).u8(_s.runState).finish());
+  }
+
+  // ---- Status Query (CMD 0x07) ----
+  void handleStatus(uint8_t src) {
+    // Status queries are always answered (even in local mode)
+    log("CMD 0x07 STATUS: Sending full status (%d bytes)", STAT_DATA_LEN);
+
+    // Build the 15-byte status response in place (exact Pentair format,
+    // fields in STAT_* order)
+    reply(answer(src, CMD_STATUS)
+            .u8(_s.runState)      // STAT_RUN
+            .u8(_s.mode)          // STAT_MODE
+            .u8(_s.driveState)    // STAT_DRIVE
+            .u16(_s.powerWatts)   // STAT_PWR_HI/LO
+            .u16(_s.currentRPM)   // STAT_RPM_HI/LO
+            .u8(_s.flowGPM)       // STAT_GPM
+            .u8(_s.ppcLevel)      // STAT_PPC
+            .u8(0x00)             // STAT_BYTE_9
+            .u8(_s.errorCode)     // STAT_ERR
+            .u8(0x00)             // STAT_BYTE_11
+            .u8(_s.timerMin)      // STAT_TIMER
+            .u8(_s.clockHour)     // STAT_CLK_HOUR
+            .u8(_s.clockMin)      // STAT_CLK_MIN
+            .finish());
+  }
+
+  // ---- Register Write (CMD 0x01) ----
+  void handleRegWrite(uint8_t src, const PentairFrameView& cmd) {
+    if (!cmd.has(4)) {
+      log("CMD 0x01 REG: Data too short (need 4 bytes)");
+      return;
+    }
+
+    uint16_t regAddr = cmd.u16(0);
+    uint16_t regVal  = cmd.u16(2);
+
+    log("CMD 0x01 REG: Addr=0x%04X  Value=0x%04X (%d)", regAddr, regVal, regVal);
+
+    switch (regAddr) {
+      case REG_SET_RPM:
+        // This is what nodejs-poolController uses to set VS pump speed
+        if (_s.extProgSelect != EPRG_OFF) {
+          log(">> Set RPM = %d ignored: external program selected", regVal);
+          break;
+        }
+        _s.targetRPM = regVal;
+        _s.mode = MODE_MANUAL;
+        log(">> Set RPM = %d (direct, from nodejs-poolController)", regVal);
+        break;
+
+      case REG_SET_GPM:
+        _s.flowGPM = regVal;
+        log(">> Set GPM = %d", regVal);
+        break;
+
+      case REG_EXT_PROG:
+        _s.extProgSelect = regVal;
+        _extProgAt = _now;
+        log(">> External program select = 0x%04X (%s)", regVal,
+            regVal == EPRG_OFF ? "OFF" : regVal == EPRG_1 ? "Program 1" :
+            regVal == EPRG_2 ? "Program 2" : regVal == EPRG_3 ? "Program 3" :
+            regVal == EPRG_4 ? "Program 4" : "?");
+
+        // Update mode based on program selection (OFF keeps the current mode)
+        if (regVal == EPRG_1)      _s.mode = MODE_EXT_PROG_1;
+        else if (regVal == EPRG_2) _s.mode = MODE_EXT_PROG_2;
+        else if (regVal == EPRG_3) _s.mode = MODE_EXT_PROG_3;
+        else if (regVal == EPRG_4) _s.mode = MODE_EXT_PROG_4;
+
+        updateTargetFromMode();
+        break;
+
+      case REG_EXT_PROG_1_RPM:
+      case REG_EXT_PROG_2_RPM:
+      case REG_EXT_PROG_3_RPM:
+      case REG_EXT_PROG_4_RPM: {
+        int prog = regAddr - REG_EXT_PROG_1_RPM + 1;
+        _s.extProgRPM[prog] = regVal;
+        log(">> Ext Program %d RPM = %d", prog, regVal);
+        if (_s.mode == MODE_EXT_PROG_1 + prog - 1) updateTargetFromMode();
+        break;
+      }
+
+      default:
+        log(">> Unknown register: 0x%04X", regAddr);
+        break;
+    }
+
+    // Send confirmation: echo back the VALUE only (2 bytes)
+    // (Real pumps echo the value, not the register address)
+    reply(answer(src, CMD_WRITE_REG).u16(regVal).finish());
+  }
+
+  // ---- Target RPM from mode ----
+  void updateTargetFromMode() {
+    if (_s.runState != RUN_START) return;  // Only update if running
+
+    switch (_s.mode) {
+      case MODE_FILTER:
+        _s.targetRPM = 0;  // Filter mode: controlled by schedule
+        break;
+      case MODE_MANUAL:
+        // Manual mode keeps whatever RPM was set
+        break;
+      case MODE_SPEED_1:
+      case MODE_SPEED_2:
+      case MODE_SPEED_3:
+      case MODE_SPEED_4:
+        _s.targetRPM = _s.speedPreset[_s.mode - MODE_SPEED_1 + 1];
+        break;
+      case MODE_EXT_PROG_1:
+      case MODE_EXT_PROG_2:
+      case MODE_EXT_PROG_3:
+      case MODE_EXT_PROG_4:
+        _s.targetRPM = _s.extProgRPM[_s.mode - MODE_EXT_PROG_1 + 1];
+        break;
+      default:
+        break;
+    }
+
+    log(">> Target RPM updated to %d (mode: %s)", _s.targetRPM, modeName(_s.mode));
+  }
+
+public:
+  void begin(uint8_t addr, SimTransmitFn transmit, void* ctx) {
+    _s.myAddress = addr;
+    snprintf(_tag, sizeof(_tag), "SIM %02X", addr);
+    _transmit = transmit;
+    _ctx = ctx;
+    seed(0x9E3779B9u ^ addr);   // Each address its own, repeatable sequence
+  }
+
+  void setVerbose(bool on) { _verbose = on; }
+  void setTurnaround(uint16_t ms) { _turnaroundMs = ms; }
+  uint8_t address() const { return _s.myAddress; }
+
+  PumpState& state() { return _s; }
+  const PumpState& state() const { return _s; }
+
+  // Replies made since boot (before any fault got to them)
+  uint32_t replies() const { return _replies; }
+
+  // ---- Faults ----
+  SimFaults& faults() { return _faults; }
+  const SimFaultCounts& faultCounts() const { return _counts; }
+  void seed(uint32_t s) { _rng = s ? s : 1; }
+
+  // Load a named profile; false if there is none
+  bool setProfile(const char* name) {
+    for (const SimProfile& p : SIM_PROFILES) {
+      if (strcmp(p.name, name) == 0) {
+        _faults = p.faults;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void printFaults() {
+    Serial.printf("[SIM] 0x%02X turnaround %u ms  delay %u+%u ms  drop %u%%  truncate %u%%  corrupt %u%%  "
+                  "garbage %u%% (max %u)  broadcast %u ms  error %d\n",
+                  _s.myAddress, _turnaroundMs, _faults.delayMs, _faults.jitterMs, _faults.dropPct,
+                  _faults.truncatePct, _faults.corruptPct, _faults.garbagePct,
+                  _faults.garbageMax, _faults.broadcastMs, _s.errorCode);
+    Serial.printf("[SIM]      %lu replies: %lu dropped, %lu truncated, %lu corrupted, "
+                  "%lu with noise, %lu lost (backlog); %lu broadcasts\n",
+                  (unsigned long)_replies, (unsigned long)_counts.dropped,
+                  (unsigned long)_counts.truncated, (unsigned long)_counts.corrupted,
+                  (unsigned long)_counts.garbage, (unsigned long)_counts.overflow,
+                  (unsigned long)_counts.broadcasts);
+  }
+
+  /*
+   * Run one script / console line (see SCRIPTING).
+   * Blank lines and # comments are fine. Returns false if not understood.
+   */
+  bool command(const char* line) {
+    while (*line == ' ' || *line == '\t') line++;
+    if (!*line || *line == '#' || *line == '\r' || *line == '\n') return true;
+
+    char word[12];
+    int n = 0;
+    while (*line && *line != ' ' && *line != '\t' && *line != '\r' && *line != '\n' &&
+           n < (int)sizeof(word) - 1) {
+      word[n++] = *line++;
+    }
+    word[n] = '\0';
+    char* end;
+    long a = strtol(line, &end, 10);
+    bool hasA = end != line;
+    long b = strtol(end, &end, 10);
+
+    if (strcmp(word, "profile") == 0) {
+      while (*line == ' ') line++;
+      char name[12];
+      int k = 0;
+      while (line[k] && line[k] != ' ' && line[k] != '\r' && line[k] != '\n' && k < 11) {
+        name[k] = line[k];
+        k++;
+      }
+      name[k] = '\0';
+      if (!setProfile(name)) return false;
+    } else if (strcmp(word, "faults") == 0) {
+      printFaults();
+      return true;
+    } else if (!hasA || a < 0) {
+      return false;
+    } else if (strcmp(word, "delay") == 0)     _faults.delayMs = a;
+    else if (strcmp(word, "jitter") == 0)      _faults.jitterMs = a;
+    else if (strcmp(word, "drop") == 0)        _faults.dropPct = a > 100 ? 100 : a;
+    else if (strcmp(word, "truncate") == 0)    _faults.truncatePct = a > 100 ? 100 : a;
+    else if (strcmp(word, "corrupt") == 0)     _faults.corruptPct = a > 100 ? 100 : a;
+    else if (strcmp(word, "garbage") == 0) {
+      _faults.garbagePct = a > 100 ? 100 : a;
+      if (b > 0) _faults.garbageMax = b > SIM_GARBAGE_MAX ? SIM_GARBAGE_MAX : b;
+    }
+    else if (strcmp(word, "broadcast") == 0)   _faults.broadcastMs = a;
+    else if (strcmp(word, "turnaround") == 0)  _turnaroundMs = a;
+    else if (strcmp(word, "seed") == 0)        seed(a);
+    else if (strcmp(word, "error") == 0 && a <= 255) {
+      setError(a);
+      return true;
+    }
+    else return false;
+
+    if (_verbose) printFaults();
+    return true;
+  }
+
+  /*
+   * One valid frame heard on the bus (checksum already verified).
+   * Frames for other addresses are ignored silently (several
+   * simulators may share one line); ours may reply at once through
+   * the transmit callback.
+   */
+  void onFrame(const uint8_t* data, size_t length, unsigned long now) {
+    PentairFrameView pkt(data, length);
+    if (pkt.size() < PENTAIR_MIN_PKT_LEN || pkt.dst() != _s.myAddress) return;
+
+    _now = now;
+    if (_verbose) LOG_HEX(LOG_TRACE, _tag, "RX", data, length);
+
+    uint8_t dst = pkt.dst();
+    uint8_t src = pkt.src();
+    uint8_t cmd = pkt.cmd();
+
+    log("Dst: 0x%02X  Src: 0x%02X  Cmd: 0x%02X  Len: %d", dst, src, cmd, pkt.dataLen());
+
+    switch (cmd) {
+      case CMD_CTRL:      handleCtrl(src, pkt);     break;   // 0x04 - Remote/Local Control
+      case CMD_MODE:      handleMode(src, pkt);     break;   // 0x05 - Set Mode
+      case CMD_RUN:       handleRun(src, pkt);      break;   // 0x06 - Run/Stop
+      case CMD_STATUS:    handleStatus(src);        break;   // 0x07 - Status Query
+      case CMD_WRITE_REG: handleRegWrite(src, pkt); break;   // 0x01 - Register Write
+      default:
+        log("UNKNOWN command: 0x%02X", cmd);
+        break;
+    }
+  }
+
+  // ---- Physics ----
+
+  // Milliseconds until step() has work: a held reply, a broadcast, the
+  // next ramp step while the motor is changing speed, else the next
+  // clock minute
+  unsigned long msUntilStep(unsigned long now) const {
+    unsigned long since, period;
+    if (_s.currentRPM != _s.targetRPM) {
+      since = now - _lastStep;
+      period = SIM_STEP_MS;
+    } else {
+      since = now - _lastClock;
+      period = SIM_CLOCK_STEP_MS;
+    }
+    unsigned long wait = since >= period ? 0 : period - since;
+    if (_faults.broadcastMs) {
+      unsigned long b = (long)(now - _nextBroadcast) >= 0 ? 0 : _nextBroadcast - now;
+      if (b < wait) wait = b;
+    }
+    for (const Pending& p : _pending) {
+      if (!p.used) continue;
+      unsigned long d = (long)(now - p.due) >= 0 ? 0 : p.due - now;
+      if (d < wait) wait = d;
+    }
+    if (_s.extProgSelect != EPRG_OFF) {
+      since = now - _extProgAt;
+      unsigned long lapse = since >= EXT_PROG_REPEAT_INTERVAL ? 0 : EXT_PROG_REPEAT_INTERVAL - since;
+      if (lapse < wait) wait = lapse;
+    }
+    return wait;
+  }
+
+  /*
+   * Advance the ramp and the pump clock to now.
+   * Returns true if the RPM changed.
+   */
+  bool step(unsigned long now) {
+    sendDue(now);
+    if (_faults.broadcastMs && (long)(now - _nextBroadcast) >= 0) {
+      // +-25%: the other master keeps its own time, and several
+      // simulators on one line don't all talk at once
+      _nextBroadcast = now + _faults.broadcastMs * 3 / 4 + rand32() % (_faults.broadcastMs / 2 + 1);
+      broadcast();
+    }
+
+    // External program not re-selected in time: the pump drops it
+    if (_s.extProgSelect != EPRG_OFF && now - _extProgAt >= EXT_PROG_REPEAT_INTERVAL) {
+      log(">> External program lapsed - stopping");
+      _s.extProgSelect = EPRG_OFF;
+      _s.runState = RUN_STOP;
+      _s.targetRPM = 0;
+      _s.mode = MODE_FILTER;
+    }
+
+    // Simulated clock (one minute per SIM_CLOCK_STEP_MS)
+    if (now - _lastClock >= SIM_CLOCK_STEP_MS) {
+      _lastClock = now;
+      if (++_s.clockMin >= 60) {
+        _s.clockMin = 0;
+        if (++_s.clockHour >= 24) _s.clockHour = 0;
+      }
+    }
+
+    if (now - _lastStep < SIM_STEP_MS) return false;
+    _lastStep = now;
+
+    uint16_t prevRPM = _s.currentRPM;
+
+    // Gradual acceleration/deceleration
+    if (_s.currentRPM < _s.targetRPM) {
+      _s.currentRPM += SIM_RAMP_UP_RPM;
+      if (_s.currentRPM > _s.targetRPM) _s.currentRPM = _s.targetRPM;
+    } else if (_s.currentRPM > _s.targetRPM) {
+      _s.currentRPM = (_s.currentRPM > SIM_RAMP_DOWN_RPM) ? _s.currentRPM - SIM_RAMP_DOWN_RPM : 0;
+      if (_s.currentRPM < _s.targetRPM) _s.currentRPM = _s.targetRPM;
+    }
+
+    // Update derived values
+    if (_s.currentRPM == 0) {
+      _s.powerWatts = 0;
+      _s.flowGPM = 0;
+    } else {
+      // Affinity laws: power ~ speed^3, flow ~ speed.
+      // ~20 W at 450 RPM, ~255 W at 1700, ~2015 W at 3450
+      float speed = (float)_s.currentRPM / SIM_MAX_RPM;
+      _s.powerWatts = (uint16_t)(SIM_DRIVE_WATTS + SIM_MAX_WATTS * speed * speed * speed);
+
+      // Real flow depends on the plumbing; ~20 GPM at 1000 RPM here
+      _s.flowGPM = (uint8_t)(SIM_MAX_GPM * speed);
+    }
+    updateDrive();
+
+    if (prevRPM == _s.currentRPM) return false;
+    if (_verbose) LOGI("PUMP", "0x%02X %d RPM -> %d RPM (target: %d)  |  %dW  |  %d GPM  |  %s",
+                       _s.myAddress, prevRPM, _s.currentRPM, _s.targetRPM, _s.powerWatts, _s.flowGPM,
+                       _s.runState == RUN_START ? "RUNNING" : "STOPPED");
+    return true;
+  }
+};
+
+#endif // PUMP_SIMULATOR_H
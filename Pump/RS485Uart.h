@@ -0,0 +1,263 @@
+/*
+ * =============================================
+ * RS485Uart.h - Interrupt-driven RS-485 UART
+ * =============================================
+ *
+ * Shared by the Controller and the Pump simulator
+ * (keep both copies identical, like PentairProtocol.h).
+ *
+ * Uses the ESP-IDF UART driver directly instead of HardwareSerial:
+ *   - RX interrupts push bytes into the driver and post events on a
+ *     FreeRTOS queue, so the owning task can block until data arrives
+ *   - The RX timeout (idle line) interrupt fires when the bus has been
+ *     quiet for RS485_RX_IDLE_SYMBOLS byte times after the last byte.
+ *     A frame still half-parsed at that point is known to be cut off
+ *     and is discarded, so frame boundaries come from the hardware.
+ *
+ * DATA PATH:
+ *   UART FIFO -> driver buffer --(event)--> ByteRing --> PentairParser
+ *
+ * DIRECTION CONTROL (DE/RE):
+ *   RS485_HW_DIRECTION 1 (default): the UART runs in
+ *     UART_MODE_RS485_HALF_DUPLEX with RTS routed to the DE/RE pin.
+ *     The hardware asserts DE when the first start bit goes out and
+ *     releases it right after the last stop bit - no guard delays.
+ *   RS485_HW_DIRECTION 0: the old GPIO path - DE driven by
+ *     digitalWrite() with fixed delays around the write. Use it if a
+ *     transceiver misbehaves with the hardware timing.
+ *
+ * USAGE:
+ *   rs485.begin(UART_NUM_2, 9600, RX_PIN, TX_PIN, DE_PIN);
+ *   xQueueReceive(rs485.eventQueue(), &event, timeout);   // block
+ *   rs485.handleEvent(event);
+ *   while ((r = rs485.poll()) != PentairParser::PENDING) { ... rs485.frame() ... }
+ */
+
+#ifndef RS485_UART_H
+#define RS485_UART_H
+
+#include <Arduino.h>
+#include <driver/uart.h>
+#include "PentairProtocol.h"
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define RS485_DRIVER_RX_BUF     512   // ESP-IDF driver RX buffer (must be > 128 FIFO)
+#define RS485_EVENT_QUEUE_LEN   16    // UART events waiting for the owning task
+#define RS485_RING_SIZE         256   // Our RX ring (power of two)
+#define RS485_RX_FULL_THRESHOLD 16    // Wake up every N bytes mid-frame...
+#define RS485_RX_IDLE_SYMBOLS   4     // ...or after N quiet byte times (~4 ms at 9600)
+#define RS485_TX_TIMEOUT_MS     100   // Max wait for a frame to leave the FIFO
+
+#ifndef RS485_HW_DIRECTION
+#define RS485_HW_DIRECTION      1     // 1 = UART drives DE via RTS, 0 = GPIO + delays
+#endif
+
+// =============================================
+// RS485Uart CLASS
+// =============================================
+class RS485Uart {
+private:
+  uart_port_t   _port = UART_NUM_2;
+  uint8_t       _dePin = 0;
+  QueueHandle_t _events = nullptr;
+
+  ByteRing<RS485_RING_SIZE> _ring;
+  PentairParser _parser;
+  bool          _lineIdle = false;     // RX timeout seen since the ring was last drained
+
+  uint32_t _overruns = 0;              // Driver FIFO/buffer overflows
+  uint32_t _truncated = 0;             // Frames cut off by an idle line
+  uint32_t _rxBytes = 0;
+  uint32_t _txBytes = 0;
+
+  // Move everything the driver has buffered into the ring
+  void drainDriver() {
+    size_t buffered = 0;
+    uart_get_buffered_data_len(_port, &buffered);
+    while (buffered > 0) {
+      size_t room;
+      uint8_t* dst = _ring.writeBegin(room);
+      if (room == 0) break;   // Parser is behind; the rest stays in the driver
+      int n = uart_read_bytes(_port, dst, (buffered < room) ? buffered : room, 0);
+      if (n <= 0) break;
+      _ring.writeCommit(n);
+      _rxBytes += n;
+      buffered -= n;
+    }
+  }
+
+public:
+  /*
+   * Install the UART driver and route the pins.
+   * Starts in receive mode (DE low).
+   */
+  bool begin(uart_port_t port, uint32_t baud, int rxPin, int txPin, uint8_t dePin) {
+    _port = port;
+    _dePin = dePin;
+
+#if !RS485_HW_DIRECTION
+    // RS-485 direction control
+    pinMode(_dePin, OUTPUT);
+    digitalWrite(_dePin, LOW);  // Start in receive mode
+#endif
+
+    // Pentair: 9600 baud, 8N1
+    uart_config_t cfg = {};
+    cfg.baud_rate  = (int)baud;
+    cfg.data_bits  = UART_DATA_8_BITS;
+    cfg.parity     = UART_PARITY_DISABLE;
+    cfg.stop_bits  = UART_STOP_BITS_1;
+    cfg.flow_ctrl  = UART_HW_FLOWCTRL_DISABLE;
+#if SOC_UART_SUPPORT_REF_TICK
+    cfg.source_clk = UART_SCLK_REF_TICK;   // 1 MHz, unaffected by CPU/APB frequency scaling
+#else
+    cfg.source_clk = UART_SCLK_APB;
+#endif
+
+    if (uart_driver_install(_port, RS485_DRIVER_RX_BUF, 0,
+                            RS485_EVENT_QUEUE_LEN, &_events, 0) != ESP_OK) {
+      Serial.println("[RS-485] UART driver install FAILED");
+      return false;
+    }
+    uart_param_config(_port, &cfg);
+
+#if RS485_HW_DIRECTION
+    // RTS becomes DE/RE; the UART toggles it around every transmission
+    uart_set_pin(_port, txPin, rxPin, _dePin, UART_PIN_NO_CHANGE);
+    if (uart_set_mode(_port, UART_MODE_RS485_HALF_DUPLEX) != ESP_OK) {
+      Serial.println("[RS-485] Half-duplex mode FAILED");
+      return false;
+    }
+#else
+    uart_set_pin(_port, txPin, rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+#endif
+
+    // Interrupt on every N bytes, or when the line goes idle
+    uart_set_rx_full_threshold(_port, RS485_RX_FULL_THRESHOLD);
+    uart_set_rx_timeout(_port, RS485_RX_IDLE_SYMBOLS);
+
+    Serial.printf("[RS-485] UART%d %lu baud, DE/RE on GPIO %d (%s)\n", (int)_port,
+                  (unsigned long)baud, _dePin,
+                  RS485_HW_DIRECTION ? "hardware half-duplex" : "software");
+    return true;
+  }
+
+  // Queue the owning task blocks on (also usable in a queue set)
+  QueueHandle_t eventQueue() const { return _events; }
+
+  /*
+   * Process one event taken from eventQueue().
+   * Received bytes are moved into the ring; call poll() afterwards.
+   */
+  void handleEvent(const uart_event_t& event) {
+    switch (event.type) {
+      case UART_DATA:
+        drainDriver();
+        if (event.timeout_flag) _lineIdle = true;
+        break;
+
+      case UART_FIFO_OVF:
+      case UART_BUFFER_FULL:
+        // Bytes were lost: nothing in flight can be trusted
+        _overruns++;
+        // Events still queued are left for the owner to take: the
+        // driver is empty now, so they drain 0 bytes. Resetting the
+        // queue would strand their entries in the owner's queue set.
+        uart_flush_input(_port);
+        _ring.clear();
+        _parser.reset();
+        break;
+
+      default:
+        // Break / parity / frame errors: the checksum will catch any damage
+        break;
+    }
+  }
+
+  /*
+   * Feed ring bytes to the parser until a frame completes.
+   * Returns FRAME_OK / FRAME_BAD_CHECKSUM with the frame in frame(),
+   * or PENDING once the ring is empty.
+   */
+  PentairParser::Result poll() {
+    for (;;) {
+      int b;
+      while ((b = _ring.pop()) >= 0) {
+        PentairParser::Result r = _parser.feed((uint8_t)b);
+        if (r != PentairParser::PENDING) return r;
+      }
+
+      // Ring empty; fetch anything the driver kept back while it was full
+      drainDriver();
+      if (_ring.available() == 0) break;
+    }
+
+    // Line went quiet mid-frame: the rest of that frame is never coming
+    if (_lineIdle) {
+      _lineIdle = false;
+      if (_parser.inFrame()) {
+        _truncated++;
+        _parser.reset();
+      }
+    }
+    return PentairParser::PENDING;
+  }
+
+  // A frame is partly received, or bytes are waiting to be parsed (in
+  // the ring, or still in the driver / FIFO)
+  bool receiving() const {
+    if (_parser.inFrame() || _ring.available() > 0) return true;
+    size_t buffered = 0;
+    uart_get_buffered_data_len(_port, &buffered);
+    return buffered > 0;
+  }
+
+  // Last frame returned by poll()
+  const uint8_t* frame() const { return _parser.frame(); }
+  size_t frameLength() const { return _parser.length(); }
+
+  /*
+   * Transmit one frame (blocks until it is on the wire).
+   * Drives DE high for the duration, back to receive afterwards.
+   */
+  void write(const uint8_t* data, size_t length) {
+    _txBytes += length;
+#if RS485_HW_DIRECTION
+    // DE follows the shift register: up on the first start bit, down
+    // after the last stop bit. We only wait (blocked, not spinning)
+    // so the caller's reply timeout starts once the frame is out.
+    uart_write_bytes(_port, (const char*)data, length);
+    uart_wait_tx_done(_port, pdMS_TO_TICKS(RS485_TX_TIMEOUT_MS));
+#else
+    // Enable transmitter and start data IMMEDIATELY after —
+    // minimizing the dead time where the bus is driven but no data flows.
+    // (Long dead time causes the receiver to pick up phantom bytes from the bus transition.)
+    digitalWrite(_dePin, HIGH);
+    delayMicroseconds(500);  // MAX3485 DE needs 0.2μs; 500μs is 2500× margin
+
+    // Bulk write all bytes at once into the 128-byte UART TX FIFO
+    uart_write_bytes(_port, (const char*)data, length);
+    uart_wait_tx_done(_port, pdMS_TO_TICKS(RS485_TX_TIMEOUT_MS));  // Wait for FIFO to drain
+
+    // The last byte may still be in the shift register.
+    // At 9600 baud (8N1): 1 byte = 10 bits / 9600 = 1.042ms.
+    // Wait for (all bytes × 1.1ms) + 5ms margin, just in case.
+    unsigned int safetyMs = ((length * 11) / 10) + 5;
+    delay(safetyMs);
+
+    digitalWrite(_dePin, LOW);   // Switch back to receive mode
+#endif
+  }
+
+  // ---- Counters ----
+  uint32_t overruns() const { return _overruns; }
+  uint32_t truncatedFrames() const { return _truncated; }
+  uint32_t resyncs() const { return _parser.resyncs(); }
+  uint32_t skippedBytes() const { return _parser.skippedBytes(); }
+  uint32_t rxBytes() const { return _rxBytes; }
+  uint32_t txBytes() const { return _txBytes; }
+};
+
+#endif // RS485_UART_H
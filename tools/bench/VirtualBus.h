@@ -0,0 +1,127 @@
+/*
+ * =============================================
+ * VirtualBus.h - In-process RS-485 line for the host bench
+ * =============================================
+ *
+ * One half-duplex pair shared by every attached node. A frame is put
+ * on the line a byte at a time (10 bits per byte at the bus baud rate)
+ * and each byte is handed to every other node when its stop bit
+ * would have arrived.
+ *
+ * Like the real thing:
+ *   - nobody arbitrates: two nodes driving the line at once garble
+ *     each other, and the overlapping bytes arrive corrupted
+ *   - a node doesn't hear the line while it is transmitting
+ *     (DE and /RE are tied together on the MAX3485)
+ *
+ * Time is the bench's virtual microsecond clock; run(now) delivers
+ * everything due by then.
+ */
+
+#ifndef VIRTUAL_BUS_H
+#define VIRTUAL_BUS_H
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+class VirtualBus {
+public:
+  // Receives one byte from the line
+  typedef void (*ReceiveFn)(void* ctx, uint8_t b);
+
+  explicit VirtualBus(uint32_t baud) : _byteUs(10 * 1000000.0 / baud) {}
+
+  // Add a node; returns its id for transmit()
+  int attach(ReceiveFn rx, void* ctx) {
+    _nodes.push_back(Node{rx, ctx, 0, 0});
+    return (int)_nodes.size() - 1;
+  }
+
+  /*
+   * Put a frame on the line from node, starting at atUs (or when the
+   * node's own previous frame is out). Returns when its last byte ends.
+   */
+  uint64_t transmit(int node, const uint8_t* data, size_t len, uint64_t atUs) {
+    Node& n = _nodes[node];
+    uint64_t start = atUs > n.txEnd ? atUs : n.txEnd;
+    for (size_t i = 0; i < _nodes.size(); i++) {
+      if ((int)i != node && _nodes[i].txEnd > start) {
+        _collisions++;
+        break;
+      }
+    }
+    for (size_t i = 0; i < len; i++) {
+      uint64_t end = start + (uint64_t)((i + 1) * _byteUs);
+      _wire.insert(std::make_pair(end, Byte{data[i], node}));
+    }
+    n.txStart = start;
+    n.txEnd = start + (uint64_t)(len * _byteUs);
+    _frames++;
+    return n.txEnd;
+  }
+
+  // Deliver every byte whose stop bit has arrived by nowUs
+  void run(uint64_t nowUs) {
+    while (!_wire.empty() && _wire.begin()->first <= nowUs) {
+      auto first = _wire.begin();
+      uint64_t at = first->first;
+      Byte b = first->second;
+      _wire.erase(first);
+      bool garbled = false;
+
+      // Another node's byte overlapping this one: both are lost, the
+      // receivers see a mix of the two
+      while (!_wire.empty() && _wire.begin()->first - at < _byteUs &&
+             _wire.begin()->second.from != b.from) {
+        b.value ^= _wire.begin()->second.value ^ 0x55;
+        _wire.erase(_wire.begin());
+        garbled = true;
+      }
+      if (garbled) _garbled++;
+      _bytes++;
+      _busyUs += _byteUs;
+
+      for (size_t i = 0; i < _nodes.size(); i++) {
+        const Node& n = _nodes[i];
+        if ((int)i == b.from || (at > n.txStart && at <= n.txEnd)) continue;
+        n.rx(n.ctx, b.value);
+      }
+    }
+  }
+
+  // Time the next byte arrives (UINT64_MAX when the line is quiet)
+  uint64_t nextAt() const { return _wire.empty() ? UINT64_MAX : _wire.begin()->first; }
+  bool quiet() const { return _wire.empty(); }
+
+  // ---- Counters ----
+  uint32_t frames() const { return _frames; }
+  uint64_t bytes() const { return _bytes; }
+  uint32_t collisions() const { return _collisions; }   // Frames started over someone else
+  uint32_t garbledBytes() const { return _garbled; }
+  double   busyUs() const { return _busyUs; }
+
+private:
+  struct Node {
+    ReceiveFn rx;
+    void*     ctx;
+    uint64_t  txStart;      // Latest frame this node sent
+    uint64_t  txEnd;
+  };
+  struct Byte {
+    uint8_t value;
+    int     from;
+  };
+
+  double   _byteUs;
+  std::vector<Node> _nodes;
+  std::multimap<uint64_t, Byte> _wire;   // By arrival time
+
+  uint32_t _frames = 0;
+  uint64_t _bytes = 0;
+  uint32_t _collisions = 0;
+  uint32_t _garbled = 0;
+  double   _busyUs = 0;
+};
+
+#endif // VIRTUAL_BUS_H
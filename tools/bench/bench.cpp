@@ -0,0 +1,734 @@
+/*
+ * =============================================
+ * bench.cpp - RS-485 load test on the host
+ * =============================================
+ *
+ * Runs the Controller's transport (TransactionTable + PentairParser,
+ * the same headers the firmware builds) against N PumpSimulators on
+ * a VirtualBus, in virtual time:
+ *
+ *   controller --TransactionTable--> VirtualBus <--> PumpSimulator x N
+ *
+ * The workload is poll cycles: every cycle sends each pump a status
+ * query, and every Nth cycle also a set-RPM write. Closed loop: up to
+ * -d requests are handed to the table at once (default one per pump,
+ * like the Controller's poller) and the next one starts as soon as one
+ * finishes, so the line runs as fast as the transport lets it.
+ *
+ * REPORTS:
+ *   round trip   start() -> reply parsed, p50/p90/p99/max
+ *                (queueing + our frame + pump turnaround + reply)
+ *   wire         frames/s and line utilisation, collisions
+ *   parser       host CPU per byte / per frame for PentairParser,
+ *                replaying every frame of the run
+ *
+ * Every run first feeds PentairParser a few preamble edge cases (noise
+ * or a cut-off preamble right before a good frame) and exits 1 if one
+ * loses the frame.
+ *
+ * Virtual time makes a run deterministic: the same options give the
+ * same round trip and wire numbers on every machine, so a change to
+ * PentairProtocol.h or Transactions.h that moves them is a real
+ * change. Only the parser CPU figures depend on the host.
+ *
+ * BUILD + RUN:
+ *   make -C tools/bench
+ *   tools/bench/bench [-p pumps] [-n cycles] [-c every] [-t turnaround_ms]
+ *                     [-d depth] [-P profile] [-f script] [-s] [-v]
+ *     -p  simulated pumps, 1-4 (4)
+ *     -d  requests outstanding, 1-4 (= pumps)
+ *     -n  poll cycles (5000)
+ *     -c  set-RPM write every N cycles, 0 = never (10)
+ *     -t  pump reply turnaround in ms (2)
+ *     -P  pump fault profile: clean real noisy lossy hostile (clean)
+ *     -f  pump fault script, one PumpSimulator::command() per line,
+ *         run on every pump after -P
+ *     -w  also write the run as a capture file, as the Controller
+ *         would have recorded it (its TX plus every frame it parsed)
+ *     -s  one key=value summary line (for scripts / diffs)
+ *     -v  echo the firmware's Serial logging
+ *
+ * SCHEDULE OVERRIDE:
+ *   tools/bench/bench -o [-t turnaround_ms] [-P profile] [-f script] [-v]
+ *     Pump 1 runs a scheduled external program, then a manual full
+ *     start overrides it: the sequences Controller.ino builds for that
+ *     (runExtProgramSequence, then runFullSpeedSequence with its
+ *     "program off" step first), run by a CommandSequencer. Passes if
+ *     the pump holds the manual speed with the program deselected,
+ *     past the point where a program left selected would have lapsed.
+ *
+ * CAPTURE REPLAY:
+ *   tools/bench/bench -r capture.fpc [-s]
+ *     Reads a capture from a real bus (GET /api/capture, or -w above)
+ *     instead of simulating one. Every frame goes back through
+ *     PentairParser and its verdict is checked against the one the
+ *     firmware recorded, so a parser change that would have read the
+ *     field differently shows up as a mismatch. Also reports frames by
+ *     sender, TX -> reply latency as seen on the line (millisecond
+ *     timestamps), and the parser CPU figure on the captured bytes.
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <map>
+#include "CaptureFormat.h"
+#include "PentairProtocol.h"
+#include "Transactions.h"
+#include "CommandSequencer.h"
+#include "PumpSimulator.h"
+#include "VirtualBus.h"
+
+uint64_t   hostNowUs = 0;
+HostSerial Serial;
+HostEsp    ESP;
+Logger     logger;       // Log.h: straight to Serial on the host
+
+// =============================================
+// CONFIGURATION
+// =============================================
+#define BENCH_BAUD          9600
+#define BENCH_TICK_US       250       // Controller "bus task" iteration
+#define BENCH_RX_IDLE_US    (4 * 10 * 1000000UL / BENCH_BAUD)   // RS485_RX_IDLE_SYMBOLS byte times
+#define BENCH_PARSE_BYTES   (16UL << 20)   // Replayed through the parser for the CPU figure
+#define BENCH_CONTROLLER    ADDR_REMOTE_CONTROLLER
+
+static const uint8_t PUMP_ADDRS[] = { ADDR_PUMP_1, ADDR_PUMP_2, ADDR_PUMP_3, ADDR_PUMP_4 };
+
+struct Options {
+  int      pumps = 4;
+  uint32_t cycles = 5000;
+  uint32_t cmdEvery = 10;
+  uint32_t turnaroundMs = 2;
+  int      depth = 0;             // 0 = one per pump
+  const char* profile = "clean";
+  const char* script = nullptr;
+  const char* writePath = nullptr;
+  const char* replayPath = nullptr;
+  bool     override = false;
+  bool     summary = false;
+};
+
+// =============================================
+// NODES
+// =============================================
+VirtualBus line(BENCH_BAUD);
+
+// A simulated pump: parses what it hears, answers after its turnaround
+struct PumpNode {
+  int           id;
+  PentairParser parser;
+  PumpSimulator sim;
+  uint32_t      turnaroundUs;
+
+  static void receive(void* ctx, uint8_t b) {
+    PumpNode& self = *static_cast<PumpNode*>(ctx);
+    if (self.parser.feed(b) == PentairParser::FRAME_OK) {
+      self.sim.onFrame(self.parser.frame(), self.parser.length(), millis());
+    }
+  }
+  static void transmit(void* ctx, const uint8_t* frame, size_t len) {
+    PumpNode& self = *static_cast<PumpNode*>(ctx);
+    line.transmit(self.id, frame, len, hostNowUs + self.turnaroundUs);
+  }
+};
+
+std::vector<PumpNode*> pumpNodes;
+
+// The Controller's end: bytes wait in its "UART buffer" for the next tick
+struct ControllerNode {
+  int                  id;
+  std::vector<uint8_t> rx;
+  PentairParser        parser;
+  TransactionTable     txns;
+  uint32_t             badFrames = 0;
+  uint32_t             truncated = 0;      // Frames cut off by an idle line
+  uint64_t             lastRxUs = 0;
+
+  static void receive(void* ctx, uint8_t b) {
+    static_cast<ControllerNode*>(ctx)->rx.push_back(b);
+  }
+} controller;
+
+// -w: what the Controller's Capture would have written
+FILE* captureOut = nullptr;
+
+static void writeRecord(uint8_t flags, const uint8_t* frame, size_t len, uint64_t atUs) {
+  if (!captureOut) return;
+  CaptureRecord r;
+  uint8_t buf[CAPTURE_RECORD_HDR + CAPTURE_MAX_FRAME];
+  r.set((uint32_t)(atUs / 1000), flags, frame, len);
+  fwrite(buf, 1, captureEncode(r, buf), captureOut);
+}
+
+// Move virtual time to t, delivering bytes and stepping the pumps
+static void advanceTo(uint64_t t) {
+  while (hostNowUs < t) {
+    uint64_t next = line.nextAt();
+    hostNowUs = next < t ? next : t;
+    line.run(hostNowUs);
+    for (PumpNode* p : pumpNodes) p->sim.step(millis());
+  }
+}
+
+// TransactionTable's TransmitFn: like RS485Uart::write(), returns once
+// the frame has left
+static void controllerTransmit(const uint8_t* frame, size_t len) {
+  uint64_t end = line.transmit(controller.id, frame, len, hostNowUs);
+  writeRecord(CAPTURE_TX, frame, len, end);
+  advanceTo(end);
+}
+
+// One bus task iteration: parse what arrived, run the table
+static void controllerTick() {
+  bool heard = !controller.rx.empty();
+  for (uint8_t b : controller.rx) {
+    PentairParser::Result r = controller.parser.feed(b);
+    if (r != PentairParser::PENDING) {
+      writeRecord(r == PentairParser::FRAME_OK ? 0 : CAPTURE_BAD,
+                  controller.parser.frame(), controller.parser.length(), hostNowUs);
+    }
+    if (r == PentairParser::FRAME_OK) {
+      const uint8_t* f = controller.parser.frame();
+      if (f[PKT_IDX_DST] == BENCH_CONTROLLER) {
+        controller.txns.onFrame(f[PKT_IDX_SRC], f[PKT_IDX_CMD]);
+      }
+    } else if (r == PentairParser::FRAME_BAD_CHECKSUM) {
+      controller.badFrames++;
+      controller.txns.onBadFrame(controller.parser.frame()[PKT_IDX_SRC]);
+    }
+  }
+  controller.rx.clear();
+  if (heard) {
+    controller.lastRxUs = hostNowUs;
+    controller.txns.noteLineActivity();
+  } else if (controller.parser.inFrame() && hostNowUs - controller.lastRxUs >= BENCH_RX_IDLE_US) {
+    // RS485Uart's idle-line interrupt: the rest of that frame is never coming
+    controller.truncated++;
+    controller.parser.reset();
+  }
+  controller.txns.loop(!controller.parser.inFrame());
+}
+
+// =============================================
+// WORKLOAD
+// =============================================
+struct Request {
+  bool     busy = false;
+  uint64_t startedUs;
+};
+
+Request                requests[TXN_MAX_INFLIGHT];
+std::vector<uint32_t>  roundTripUs;
+uint32_t               failed = 0;
+
+static void onDone(void* ctx, bool ok) {
+  Request& r = *static_cast<Request*>(ctx);
+  r.busy = false;
+  if (ok) roundTripUs.push_back((uint32_t)(hostNowUs - r.startedUs));
+  else    failed++;
+}
+
+// Next frame of the workload: cycle-major, pump-minor
+struct Workload {
+  const Options& opt;
+  uint32_t cycle = 0;
+  int      pump = 0;
+  bool     wroteRpm = false;      // This pump's write for this cycle is out
+  uint32_t seed = 12345;
+
+  explicit Workload(const Options& o) : opt(o) {}
+
+  bool done() const { return cycle >= opt.cycles; }
+
+  // Frame + expected reply CFI for the next request
+  size_t next(uint8_t* buf, size_t size, uint8_t& expect) {
+    uint8_t addr = PUMP_ADDRS[pump];
+    bool write = opt.cmdEvery && cycle % opt.cmdEvery == 0 && !wroteRpm;
+    PentairFrameWriter w(buf, size);
+    if (write) {
+      seed = seed * 1103515245 + 12345;
+      uint16_t rpm = 1000 + (seed >> 16) % 2451;
+      w.begin(addr, BENCH_CONTROLLER, CMD_WRITE_REG).u16(REG_SET_RPM).u16(rpm);
+      expect = CMD_WRITE_REG;
+      wroteRpm = true;
+    } else {
+      w.begin(addr, BENCH_CONTROLLER, CMD_STATUS);
+      expect = CMD_STATUS;
+      wroteRpm = false;
+      if (++pump == opt.pumps) {
+        pump = 0;
+        cycle++;
+      }
+    }
+    return w.finish();
+  }
+};
+
+// =============================================
+// SCHEDULE OVERRIDE (-o)
+// =============================================
+#define BENCH_OVERRIDE_PROGRAM   2
+#define BENCH_OVERRIDE_PROG_RPM  2500
+#define BENCH_OVERRIDE_RPM       1800
+#define BENCH_OVERRIDE_RUN_MS    10000                            // On the schedule first
+#define BENCH_OVERRIDE_HOLD_MS   (2 * EXT_PROG_REPEAT_INTERVAL)   // Then by hand
+
+CommandSequencer overrideLane;
+bool             overrideDone = false;
+bool             overrideOk = false;
+
+static void onOverrideStep(uint8_t, bool ok) {
+  overrideDone = true;
+  overrideOk = ok;
+}
+
+// One frame with a single data byte (run, control) or a register write
+static size_t pumpFrame(uint8_t* buf, uint8_t addr, uint8_t cmd, uint8_t value) {
+  return PentairFrameWriter(buf, SEQ_MAX_FRAME_LEN).begin(addr, BENCH_CONTROLLER, cmd).u8(value).finish();
+}
+static size_t regFrame(uint8_t* buf, uint8_t addr, uint16_t reg, uint16_t value) {
+  return PentairFrameWriter(buf, SEQ_MAX_FRAME_LEN)
+           .begin(addr, BENCH_CONTROLLER, CMD_WRITE_REG).u16(reg).u16(value).finish();
+}
+
+// Run the bus task until seq has finished; false if a step went unanswered
+static bool runSequence(const CommandSequence& seq) {
+  overrideDone = false;
+  overrideLane.run(seq);
+  while (!overrideDone) {
+    overrideLane.loop();
+    controllerTick();
+    advanceTo(hostNowUs + BENCH_TICK_US);
+  }
+  return overrideOk;
+}
+
+static void idleFor(uint32_t ms) {
+  uint64_t until = hostNowUs + ms * 1000ULL;
+  while (hostNowUs < until) {
+    controllerTick();
+    advanceTo(hostNowUs + BENCH_TICK_US);
+  }
+}
+
+static int scheduleOverride() {
+  uint8_t addr = ADDR_PUMP_1;
+  uint8_t frame[SEQ_MAX_FRAME_LEN];
+  size_t len;
+  overrideLane.begin(controller.txns);
+
+  // runExtProgramSequence: remote, program RPM, select program, run
+  CommandSequence seq;
+  seq.begin("extprog", onOverrideStep, true);
+  len = pumpFrame(frame, addr, CMD_CTRL, CTRL_REMOTE);
+  seq.addFrame("Setting remote control", frame, len, CMD_CTRL, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  len = regFrame(frame, addr, REG_EXT_PROG_1_RPM + BENCH_OVERRIDE_PROGRAM - 1, BENCH_OVERRIDE_PROG_RPM);
+  seq.addFrame("Setting program RPM", frame, len, CMD_WRITE_REG, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  len = regFrame(frame, addr, REG_EXT_PROG, BENCH_OVERRIDE_PROGRAM * EPRG_1);
+  seq.addFrame("Selecting program", frame, len, CMD_WRITE_REG, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  len = pumpFrame(frame, addr, CMD_RUN, RUN_START);
+  seq.addFrame("Starting motor", frame, len, CMD_RUN, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  bool ok = runSequence(seq);
+  idleFor(BENCH_OVERRIDE_RUN_MS);
+  const PumpState& pump = pumpNodes[0]->sim.state();
+  uint16_t scheduledRpm = pump.currentRPM;
+
+  // runFullSpeedSequence on a scheduled pump: program off goes first
+  seq.begin("fullstart", onOverrideStep, true);
+  len = regFrame(frame, addr, REG_EXT_PROG, EPRG_OFF);
+  seq.addFrame("Program off", frame, len, CMD_WRITE_REG, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  len = pumpFrame(frame, addr, CMD_RUN, RUN_START);
+  seq.addFrame("Starting motor", frame, len, CMD_RUN, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  len = regFrame(frame, addr, REG_SET_RPM, BENCH_OVERRIDE_RPM);
+  seq.addFrame("Setting RPM", frame, len, CMD_WRITE_REG, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  seq.addWait("Waiting 1 second", 1000);
+  len = PentairFrameWriter(frame, sizeof(frame)).begin(addr, BENCH_CONTROLLER, CMD_STATUS).finish();
+  seq.addFrame("Requesting pump status", frame, len, CMD_STATUS, TXN_ATTEMPT_TIMEOUT_MS, 500);
+  len = pumpFrame(frame, addr, CMD_CTRL, CTRL_REMOTE);
+  seq.addFrame("Setting remote control", frame, len, CMD_CTRL, TXN_ATTEMPT_TIMEOUT_MS, 0);
+  ok = runSequence(seq) && ok;
+  idleFor(BENCH_OVERRIDE_HOLD_MS);
+
+  bool held = pump.extProgSelect == EPRG_OFF && pump.runState == RUN_START &&
+              pump.currentRPM == BENCH_OVERRIDE_RPM;
+  printf("Schedule override: program %d at %d RPM, then %d RPM by hand\n",
+         BENCH_OVERRIDE_PROGRAM, scheduledRpm, BENCH_OVERRIDE_RPM);
+  printf("  sequences    %s\n", ok ? "every step answered" : "some steps unanswered");
+  printf("  after %lu s  %s, %d RPM, external program %s  -> %s\n",
+         (unsigned long)(BENCH_OVERRIDE_HOLD_MS / 1000),
+         pump.runState == RUN_START ? "running" : "stopped", pump.currentRPM,
+         pump.extProgSelect == EPRG_OFF ? "off" : "still selected",
+         held ? "ok" : "FAILED");
+  return ok && held ? 0 : 1;
+}
+
+// =============================================
+// PARSER CPU (host time, replaying the run's frames)
+// =============================================
+std::vector<uint8_t> capture;   // Every frame put on the line, back to back
+
+static void captureFrame(const uint8_t* frame, size_t len) {
+  if (capture.size() < BENCH_PARSE_BYTES) capture.insert(capture.end(), frame, frame + len);
+}
+
+// Host time to parse `capture` over and over, BENCH_PARSE_BYTES in all
+static void parserCpu(double& nsPerByte, double& nsPerFrame) {
+  PentairParser parser;
+  uint64_t bytes = 0, frames = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  while (bytes < BENCH_PARSE_BYTES && !capture.empty()) {
+    for (uint8_t b : capture) {
+      if (parser.feed(b) == PentairParser::FRAME_OK) frames++;
+    }
+    bytes += capture.size();
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  nsPerByte  = bytes ? ns / bytes : 0;
+  nsPerFrame = frames ? ns / frames : 0;
+}
+
+// =============================================
+// PARSER CHECKS (run before every bench)
+// =============================================
+// Line noise that ends in something preamble-like must not eat the
+// frame behind it. Each case is a prefix followed by one good frame.
+static bool parserChecks() {
+  static const struct { const char* name; uint8_t prefix[6]; uint8_t len; } cases[] = {
+    { "clean",                 {},                             0 },
+    { "noise",                 { 0x12, 0x34, 0xA5 },           3 },
+    { "repeated FF",           { 0xFF, 0xFF },                 2 },
+    { "cut-off preamble",      { 0xFF, 0x00, 0xFF },           3 },
+    { "cut-off preamble + FF", { 0xFF, 0x00, 0xFF, 0xFF },     4 },
+    { "FF 00 FF 00 FF A5",     { 0xFF, 0x00 },                 2 },
+  };
+  uint8_t frame[TXN_MAX_FRAME_LEN];
+  PentairFrameWriter w(frame, sizeof(frame));
+  size_t len = w.begin(ADDR_PUMP_1, BENCH_CONTROLLER, CMD_STATUS).finish();
+
+  bool ok = true;
+  for (const auto& c : cases) {
+    PentairParser parser;
+    int frames = 0;
+    for (uint8_t i = 0; i < c.len; i++) {
+      if (parser.feed(c.prefix[i]) == PentairParser::FRAME_OK) frames++;
+    }
+    for (size_t i = 0; i < len; i++) {
+      if (parser.feed(frame[i]) == PentairParser::FRAME_OK) frames++;
+    }
+    if (frames != 1) {
+      fprintf(stderr, "parser check \"%s\": %d frame(s), expected 1\n", c.name, frames);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+static double percentile(const std::vector<uint32_t>& sorted, double q) {
+  if (sorted.empty()) return 0;
+  size_t i = (size_t)(q * (sorted.size() - 1) + 0.5);
+  return sorted[i] / 1000.0;
+}
+
+// =============================================
+// CAPTURE REPLAY (-r)
+// =============================================
+struct CaptureFile {
+  FILE* f;
+  size_t read(uint8_t* buf, size_t n) { return fread(buf, 1, n, f); }
+};
+
+struct SenderCount {
+  uint32_t frames = 0;
+  uint32_t bad = 0;
+};
+
+static int replayCapture(const Options& opt) {
+  CaptureFile in = { fopen(opt.replayPath, "rb") };
+  if (!in.f) {
+    perror(opt.replayPath);
+    return 2;
+  }
+  uint32_t baud;
+  if (!captureReadHeader(in, baud)) {
+    fprintf(stderr, "bench: %s is not a capture file\n", opt.replayPath);
+    fclose(in.f);
+    return 2;
+  }
+
+  uint32_t records = 0, tx = 0, rx = 0, cut = 0, mismatched = 0;
+  uint32_t prevT = 0, at = 0;     // at: capture ms since the first record (captureGap)
+  uint64_t wireBytes = 0;
+  std::map<uint8_t, SenderCount> senders;
+  std::vector<uint32_t> replyMs;
+
+  // Our last request still waiting for its reply
+  bool     waiting = false;
+  uint8_t  waitSrc = 0, waitDst = 0;
+  uint32_t waitT = 0;
+
+  CaptureRecord r;
+  PentairParser parser;
+  while (captureRead(in, r)) {
+    if (records++) at += captureGap(prevT, r.t);
+    prevT = r.t;
+    wireBytes += r.len;
+    capture.insert(capture.end(), r.data, r.data + r.len);
+
+    // One record is one frame: the parser must reach the same verdict
+    PentairParser::Result verdict = PentairParser::PENDING;
+    for (int i = 0; i < r.len; i++) {
+      PentairParser::Result v = parser.feed(r.data[i]);
+      if (v != PentairParser::PENDING) verdict = v;
+    }
+    parser.reset();
+    if (r.flags & CAPTURE_CUT) {
+      cut++;
+    } else {
+      PentairParser::Result recorded = (r.flags & CAPTURE_BAD) ? PentairParser::FRAME_BAD_CHECKSUM
+                                                               : PentairParser::FRAME_OK;
+      if (verdict != recorded) {
+        mismatched++;
+        if (Serial.echo) printf("  mismatch at t=%lu (%u bytes, recorded %s)\n", (unsigned long)r.t,
+                                r.len, (r.flags & CAPTURE_BAD) ? "bad" : "ok");
+      }
+    }
+    if (r.len <= PKT_IDX_SRC) continue;
+
+    uint8_t src = r.data[PKT_IDX_SRC], dst = r.data[PKT_IDX_DST];
+    if (r.flags & CAPTURE_TX) {
+      tx++;
+      waiting = true;
+      waitSrc = src;
+      waitDst = dst;
+      waitT = at;
+      continue;
+    }
+    rx++;
+    SenderCount& c = senders[src];
+    c.frames++;
+    if (r.flags & CAPTURE_BAD) c.bad++;
+    if (waiting && src == waitDst && dst == waitSrc && !(r.flags & CAPTURE_BAD)) {
+      replyMs.push_back(at - waitT);
+      waiting = false;
+    }
+  }
+  fclose(in.f);
+
+  if (!records) {
+    fprintf(stderr, "bench: %s has no records\n", opt.replayPath);
+    return 2;
+  }
+  double spanS = at / 1000.0;
+  double perS = spanS > 0 ? records / spanS : 0;
+  std::sort(replyMs.begin(), replyMs.end());
+  // percentile() works in thousandths
+  for (uint32_t& ms : replyMs) ms *= 1000;
+  double nsPerByte, nsPerFrame;
+  parserCpu(nsPerByte, nsPerFrame);
+
+  if (opt.summary) {
+    printf("capture=%s baud=%lu records=%lu tx=%lu rx=%lu cut=%lu mismatched=%lu span_s=%.1f "
+           "frames_per_s=%.1f utilisation=%.3f replies=%zu reply_p50_ms=%.0f reply_p99_ms=%.0f "
+           "reply_max_ms=%.0f parse_ns_per_byte=%.2f parse_ns_per_frame=%.1f\n",
+           opt.replayPath, (unsigned long)baud, (unsigned long)records, (unsigned long)tx,
+           (unsigned long)rx, (unsigned long)cut, (unsigned long)mismatched, spanS, perS,
+           spanS > 0 ? wireBytes * 10.0 / baud / spanS : 0, replyMs.size(),
+           percentile(replyMs, 0.5), percentile(replyMs, 0.99), percentile(replyMs, 1.0),
+           nsPerByte, nsPerFrame);
+    return mismatched ? 1 : 0;
+  }
+
+  printf("RS-485 capture %s: %lu frames over %.1f s, %lu baud\n",
+         opt.replayPath, (unsigned long)records, spanS, (unsigned long)baud);
+  printf("  frames       %lu sent, %lu received, %lu cut short, %.1f frames/s, utilisation %.1f%%\n",
+         (unsigned long)tx, (unsigned long)rx, (unsigned long)cut, perS,
+         spanS > 0 ? 100.0 * wireBytes * 10 / baud / spanS : 0);
+  for (const auto& s : senders) {
+    printf("  from 0x%02X    %lu frames, %lu bad checksum\n", s.first,
+           (unsigned long)s.second.frames, (unsigned long)s.second.bad);
+  }
+  printf("  parser       %lu verdicts differ from the recording%s\n", (unsigned long)mismatched,
+         mismatched && !Serial.echo ? " (-v lists them)" : "");
+  printf("  replies      %zu, p50 %.0f  p99 %.0f  max %.0f ms   (our TX end -> reply parsed)\n",
+         replyMs.size(), percentile(replyMs, 0.5), percentile(replyMs, 0.99), percentile(replyMs, 1.0));
+  printf("  parser CPU   %.2f ns/byte, %.1f ns/frame (host CPU)\n", nsPerByte, nsPerFrame);
+  return mismatched ? 1 : 0;
+}
+
+// =============================================
+// MAIN
+// =============================================
+static void usage() {
+  fprintf(stderr, "usage: bench [-p pumps] [-n cycles] [-c every] [-t turnaround_ms] [-d depth]\n"
+                  "             [-P profile] [-f script] [-w capture.fpc] [-s] [-v]\n"
+                  "       bench -o [-t turnaround_ms] [-P profile] [-f script] [-v]\n"
+                  "       bench -r capture.fpc [-s] [-v]\n");
+  exit(2);
+}
+
+// -P and -f, on one pump; false if either didn't take
+static bool applyFaults(PumpSimulator& sim, const Options& opt) {
+  if (!sim.setProfile(opt.profile)) {
+    fprintf(stderr, "bench: no fault profile '%s'\n", opt.profile);
+    return false;
+  }
+  if (!opt.script) return true;
+  FILE* f = fopen(opt.script, "r");
+  if (!f) {
+    perror(opt.script);
+    return false;
+  }
+  char buf[128];
+  int lineNo = 0;
+  bool ok = true;
+  while (fgets(buf, sizeof(buf), f)) {
+    lineNo++;
+    if (!sim.command(buf)) {
+      fprintf(stderr, "%s:%d: not understood: %s", opt.script, lineNo, buf);
+      ok = false;
+    }
+  }
+  fclose(f);
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  Options opt;
+  for (int i = 1; i < argc; i++) {
+    const char* a = argv[i];
+    bool value = i + 1 < argc;
+    if      (!strcmp(a, "-p") && value) opt.pumps = atoi(argv[++i]);
+    else if (!strcmp(a, "-n") && value) opt.cycles = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(a, "-c") && value) opt.cmdEvery = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(a, "-t") && value) opt.turnaroundMs = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(a, "-d") && value) opt.depth = atoi(argv[++i]);
+    else if (!strcmp(a, "-P") && value) opt.profile = argv[++i];
+    else if (!strcmp(a, "-f") && value) opt.script = argv[++i];
+    else if (!strcmp(a, "-w") && value) opt.writePath = argv[++i];
+    else if (!strcmp(a, "-r") && value) opt.replayPath = argv[++i];
+    else if (!strcmp(a, "-o")) opt.override = true;
+    else if (!strcmp(a, "-s")) opt.summary = true;
+    else if (!strcmp(a, "-v")) Serial.echo = true;
+    else usage();
+  }
+  if (!parserChecks()) return 1;
+  if (opt.replayPath) return replayCapture(opt);
+  if (!opt.depth) opt.depth = opt.pumps;
+  if (opt.pumps < 1 || opt.pumps > 4 || opt.cycles == 0 ||
+      opt.depth < 1 || opt.depth > TXN_MAX_INFLIGHT) usage();
+
+  if (opt.writePath) {
+    uint8_t header[CAPTURE_HEADER_LEN];
+    captureHeader(header, BENCH_BAUD);
+    captureOut = fopen(opt.writePath, "wb");
+    if (!captureOut || fwrite(header, 1, sizeof(header), captureOut) != sizeof(header)) {
+      perror(opt.writePath);
+      return 2;
+    }
+  }
+
+  controller.id = line.attach(ControllerNode::receive, &controller);
+  controller.txns.begin([](const uint8_t* frame, size_t len) {
+    captureFrame(frame, len);
+    controllerTransmit(frame, len);
+  });
+  for (int i = 0; i < opt.pumps; i++) {
+    PumpNode* p = new PumpNode();
+    p->id = line.attach(PumpNode::receive, p);
+    p->turnaroundUs = opt.turnaroundMs * 1000;
+    p->sim.begin(PUMP_ADDRS[i], [](void* ctx, const uint8_t* frame, size_t len) {
+      captureFrame(frame, len);
+      PumpNode::transmit(ctx, frame, len);
+    }, p);
+    p->sim.setVerbose(Serial.echo);
+    if (!applyFaults(p->sim, opt)) return 2;
+    pumpNodes.push_back(p);
+  }
+  if (opt.override) return scheduleOverride();
+
+  // Closed loop: refill the table whenever a slot frees up
+  Workload work(opt);
+  uint8_t frame[TXN_MAX_FRAME_LEN];
+  uint8_t expect = 0;
+  size_t  pendingLen = 0;           // Built but not accepted by start() yet
+  auto wall0 = std::chrono::steady_clock::now();
+
+  while (!work.done() || pendingLen || controller.txns.active()) {
+    for (int i = 0; i < opt.depth; i++) {
+      Request& r = requests[i];
+      if (r.busy) continue;
+      if (!pendingLen && !work.done()) pendingLen = work.next(frame, sizeof(frame), expect);
+      if (!pendingLen) break;
+      r.busy = true;
+      r.startedUs = hostNowUs;
+      if (!controller.txns.start(frame, pendingLen, expect, TXN_ATTEMPT_TIMEOUT_MS, onDone, &r)) {
+        r.busy = false;
+        break;
+      }
+      pendingLen = 0;
+    }
+    controllerTick();
+    advanceTo(hostNowUs + BENCH_TICK_US);
+  }
+
+  if (captureOut) fclose(captureOut);
+  double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0).count();
+  double virtS = hostNowUs / 1e6;
+  std::sort(roundTripUs.begin(), roundTripUs.end());
+  double nsPerByte, nsPerFrame;
+  parserCpu(nsPerByte, nsPerFrame);
+  const LatencyHistogram& h = controller.txns.latency();
+  SimFaultCounts faults;
+  for (PumpNode* p : pumpNodes) {
+    const SimFaultCounts& c = p->sim.faultCounts();
+    faults.dropped += c.dropped;
+    faults.truncated += c.truncated;
+    faults.corrupted += c.corrupted;
+    faults.garbage += c.garbage;
+    faults.broadcasts += c.broadcasts;
+    faults.overflow += c.overflow;
+  }
+
+  if (opt.summary) {
+    printf("pumps=%d depth=%d cycles=%lu turnaround_ms=%lu requests=%zu failed=%lu retries=%lu "
+           "rtt_p50_ms=%.2f rtt_p90_ms=%.2f rtt_p99_ms=%.2f rtt_max_ms=%.2f "
+           "frames_per_s=%.1f utilisation=%.3f collisions=%lu profile=%s "
+           "injected_drop=%lu injected_truncate=%lu injected_corrupt=%lu injected_garbage=%lu "
+           "broadcasts=%lu parse_ns_per_byte=%.2f parse_ns_per_frame=%.1f\n",
+           opt.pumps, opt.depth, (unsigned long)opt.cycles, (unsigned long)opt.turnaroundMs,
+           roundTripUs.size(), (unsigned long)failed, (unsigned long)controller.txns.retries(),
+           percentile(roundTripUs, 0.5), percentile(roundTripUs, 0.9),
+           percentile(roundTripUs, 0.99), percentile(roundTripUs, 1.0),
+           line.frames() / virtS, line.busyUs() / hostNowUs, (unsigned long)line.collisions(),
+           opt.profile, (unsigned long)faults.dropped, (unsigned long)faults.truncated,
+           (unsigned long)faults.corrupted, (unsigned long)faults.garbage,
+           (unsigned long)faults.broadcasts, nsPerByte, nsPerFrame);
+    return failed ? 1 : 0;
+  }
+
+  printf("RS-485 bench: %d pump(s), depth %d, %lu cycles, set-RPM every %lu, turnaround %lu ms, %d baud\n",
+         opt.pumps, opt.depth, (unsigned long)opt.cycles, (unsigned long)opt.cmdEvery,
+         (unsigned long)opt.turnaroundMs, BENCH_BAUD);
+  printf("  pump faults  %s%s%s: %lu dropped, %lu truncated, %lu corrupted, %lu noise bursts, "
+         "%lu broadcasts\n", opt.profile, opt.script ? " + " : "", opt.script ? opt.script : "",
+         (unsigned long)faults.dropped, (unsigned long)faults.truncated,
+         (unsigned long)faults.corrupted, (unsigned long)faults.garbage,
+         (unsigned long)faults.broadcasts);
+  printf("  requests     %zu ok, %lu failed, %lu retries, %lu timeouts, %lu bad frames, %lu cut off\n",
+         roundTripUs.size(), (unsigned long)failed, (unsigned long)controller.txns.retries(),
+         (unsigned long)controller.txns.timeouts(), (unsigned long)controller.badFrames,
+         (unsigned long)controller.truncated);
+  printf("  round trip   p50 %.2f  p90 %.2f  p99 %.2f  max %.2f ms   (start -> reply)\n",
+         percentile(roundTripUs, 0.5), percentile(roundTripUs, 0.9),
+         percentile(roundTripUs, 0.99), percentile(roundTripUs, 1.0));
+  printf("  on the wire  p50 %.1f  p99 %.1f ms   (TransactionTable histogram, TX end -> reply)\n",
+         h.quantile(0.5f), h.quantile(0.99f));
+  printf("  wire         %.1f frames/s, %.1f requests/s, utilisation %.1f%%, %lu collisions (%lu bytes garbled)\n",
+         line.frames() / virtS, roundTripUs.size() / virtS, 100.0 * line.busyUs() / hostNowUs,
+         (unsigned long)line.collisions(), (unsigned long)line.garbledBytes());
+  printf("  parser       %.2f ns/byte, %.1f ns/frame (host CPU)\n", nsPerByte, nsPerFrame);
+  printf("  run          %.1f s virtual in %.2f s wall\n", virtS, wallS);
+  return failed ? 1 : 0;
+}
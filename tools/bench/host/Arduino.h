@@ -0,0 +1,53 @@
+/*
+ * =============================================
+ * host/Arduino.h - Just enough Arduino core for the host bench
+ * =============================================
+ *
+ * The firmware headers the bench compiles (Transactions.h,
+ * BusMetrics.h, PumpSimulator.h, Log.h) only need a clock, Serial and ESP.
+ * Time is virtual: millis() / micros() read hostNowUs, which the bench
+ * advances, so runs are repeatable and never wait on a real clock.
+ *
+ * Serial output is dropped unless Serial.echo is set (bench -v), so the
+ * firmware's logging doesn't end up in the measurements.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Virtual time in microseconds (defined and advanced by the bench)
+extern uint64_t hostNowUs;
+
+inline unsigned long millis() { return (unsigned long)(hostNowUs / 1000); }
+inline unsigned long micros() { return (unsigned long)hostNowUs; }
+
+struct HostSerial {
+  bool echo = false;
+
+  int printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    if (!echo) return 0;
+    va_list args;
+    va_start(args, fmt);
+    int n = vprintf(fmt, args);
+    va_end(args);
+    return n;
+  }
+  void print(const char* s) { if (echo) fputs(s, stdout); }
+  void println(const char* s = "") { if (echo) puts(s); }
+};
+
+struct HostEsp {
+  uint32_t getFreeHeap() { return 0; }
+};
+
+extern HostSerial Serial;
+extern HostEsp ESP;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+webui_embed.py - Build Controller/WebUI.h from webui/index.html
+
+The Controller serves its control panel straight from flash as a
+gzip'd byte array, with an ETag so browsers only download it again
+after a firmware update changes the page.
+
+Run this after editing webui/index.html and commit both files:
+
+    python3 tools/webui_embed.py
+
+Output is deterministic (no timestamp in the gzip header), so running
+it on an unchanged page gives an identical WebUI.h.
+"""
+
+import gzip
+import hashlib
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SRC = os.path.join(ROOT, "webui", "index.html")
+DST = os.path.join(ROOT, "Controller", "WebUI.h")
+
+HEADER = """\
+/*
+ * =============================================
+ * WebUI.h - Web Interface for FlexPool Controller
+ * =============================================
+ *
+ * GENERATED by tools/webui_embed.py from webui/index.html - do not edit.
+ *
+ * Mobile-friendly HTML control panel.
+ * Uses MQTT over WebSocket so it works from ANYWHERE:
+ *   - On your home WiFi (local)
+ *   - On cellular data (remote)
+ *   - From another country (cloud)
+ *
+ * MAIN INTERFACE:
+ *   Speed 1 - Speed 4 buttons (each sends full start sequence)
+ *   Custom RPM slider
+ *   Stop button
+ *   Status display
+ *
+ * The ESP32 serves this page at http://flexpool.local, gzip'd
+ * ({raw} bytes -> {size} bytes). The page asks /api/status for the
+ * device ID, then connects to the MQTT broker via WebSocket.
+ * Commands and status flow through MQTT.
+ */
+
+#ifndef WEBUI_H
+#define WEBUI_H
+
+#include <Arduino.h>
+
+// Changes whenever the page does (quoted, as sent in the ETag header)
+#define WEBUI_ETAG  "\\"{etag}\\""
+
+const size_t WEBUI_HTML_GZ_LEN = {size};
+
+const uint8_t WEBUI_HTML_GZ[] PROGMEM = {{
+{body}
+}};
+
+#endif // WEBUI_H
+"""
+
+
+def main():
+    with open(SRC, "rb") as f:
+        html = f.read()
+
+    gz = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = hashlib.sha1(html).hexdigest()[:16]
+
+    rows = []
+    for i in range(0, len(gz), 16):
+        rows.append("  " + ", ".join("0x%02X" % b for b in gz[i:i + 16]) + ",")
+
+    with open(DST, "w", newline="\n") as f:
+        f.write(HEADER.format(raw=len(html), size=len(gz), etag=etag,
+                              body="\n".join(rows)))
+
+    print("%s: %d bytes -> %d bytes gzip'd, ETag %s"
+          % (os.path.relpath(DST, ROOT), len(html), len(gz), etag))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())